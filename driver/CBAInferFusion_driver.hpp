@@ -274,21 +274,22 @@ int CBAInferFusionDriver<Tgpu, Tref>::ParseCmdLineArgs(int argc, char* argv[])
         miopen::FusionMDGraph mdg;
         if(op == "ConvForward")
         {
-            miopen::FusionMDGraph::InitConv(mdg);
+            miopen::FusionMDGraph::Init(mdg, miopen::miopenFusionOpConvForward);
         }
         else if(op == "BatchNormInference")
         {
-            miopen::FusionMDGraph::InitBN(mdg);
+            miopen::FusionMDGraph::Init(mdg, miopen::miopenFusionOpBatchNormInference);
         }
         else
         {
             std::cerr
                 << "Invalid Graph specified, valid values are ConvForward or BatchNormInference"
                 << std::endl;
+            DriverExit(EXIT_FAILURE);
         }
         mdg.WriteToFile("/tmp/mdgraph.dot");
         std::cerr << "Graph written to /tmp/mdgraph.dot" << std::endl;
-        exit(EXIT_SUCCESS);
+        DriverExit(EXIT_SUCCESS);
     }
 
     if(inflags.GetValueInt("time") == 1)
@@ -300,7 +301,7 @@ int CBAInferFusionDriver<Tgpu, Tref>::ParseCmdLineArgs(int argc, char* argv[])
     if(fusion_mode > 6 || fusion_mode < 0)
     {
         std::cout << "Fusion mode out of range.\n Exiting..." << std::endl;
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
     if(fusion_mode != miopen_fusion_cba && fusion_mode != miopen_fusion_ca &&
        fusion_mode != miopen_fusion_cb)
@@ -466,7 +467,7 @@ int CBAInferFusionDriver<Tgpu, Tref>::SetBNParametersFromCmdLineArgs()
     else
     {
         printf("Incorrect Batch Normalization Mode\n");
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
 
     return miopenStatusSuccess;
@@ -592,7 +593,7 @@ int CBAInferFusionDriver<Tgpu, Tref>::createRunningBuffers()
         if(status != CL_SUCCESS)
         {
             printf("Error copying data to GPU\n");
-            exit(EXIT_FAILURE);
+            DriverExit(EXIT_FAILURE);
         }
     }
     else
@@ -761,7 +762,7 @@ void CBAInferFusionDriver<Tgpu, Tref>::runGPUBatchNormActivInference()
     if(miopenError != miopenStatusSuccess)
     {
         std::cerr << "BatchNormActivInference plan not supported." << std::endl;
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
 
     for(int it = 0; it < iters; it++)
@@ -844,7 +845,7 @@ void CBAInferFusionDriver<Tgpu, Tref>::runGPUConvBatchNormActivInference()
     if(miopenError != miopenStatusSuccess)
     {
         std::cerr << plan_error_str << " plan not supported." << std::endl;
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
 
     for(int it = 0; it < iters; it++)
@@ -901,7 +902,7 @@ void CBAInferFusionDriver<Tgpu, Tref>::runGPUConvActivInference()
             std::cerr << "ConvBiasActivInference plan not supported." << std::endl;
         else
             std::cerr << "ConvActivInference plan not supported." << std::endl;
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
 
     for(int it = 0; it < iters; it++)
@@ -1139,7 +1140,7 @@ void CBAInferFusionDriver<Tgpu, Tref>::runCPUBNFwdInference()
     {
         printf("Something went wrong.\nBad batch normalization mode in host kernel "
                "selection.\nExiting...\n\n");
-        exit(EXIT_FAILURE);
+        DriverExit(EXIT_FAILURE);
     }
     // C+N mode so we are done
     if(fusion_mode == miopen_fusion_cn)
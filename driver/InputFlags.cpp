@@ -24,10 +24,24 @@
  *
  *******************************************************************************/
 #include "InputFlags.hpp"
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <vector>
 
+bool& DriverExitThrows()
+{
+    static thread_local bool throws = false;
+    return throws;
+}
+
+void DriverExit(int status)
+{
+    if(DriverExitThrows())
+        throw DriverExitError{status};
+    exit(status);
+}
+
 InputFlags::InputFlags() { AddInputFlag("help", 'h', "", "Print Help Message", "string"); }
 
 void InputFlags::AddInputFlag(const std::string& _long_name,
@@ -79,7 +93,7 @@ void InputFlags::AddInputFlag(const std::string& _long_name,
             std::cout << std::setw(37) << " " << *help_next_line << std::endl;
         }
     }
-    exit(0);
+    DriverExit(0);
 }
 
 char InputFlags::FindShortName(const std::string& long_name) const
@@ -94,7 +108,7 @@ char InputFlags::FindShortName(const std::string& long_name) const
     if(short_name == '\0')
     {
         std::cout << "Long Name: " << long_name << " Not Found !";
-        exit(0);
+        DriverExit(0);
     }
 
     return short_name;
@@ -136,7 +150,7 @@ void InputFlags::Parse(int argc, char* argv[])
             if(MapInputs.find(short_name) == MapInputs.end())
             {
                 std::cout << "Input Flag: " << short_name << " Not Found !";
-                exit(0);
+                DriverExit(0);
             }
             if(short_name == 'h')
                 Print();
@@ -27,8 +27,26 @@
 #define MIOPEN_INPUT_FLAGS_HPP_
 
 #include <map>
+#include <stdexcept>
 #include <string>
 
+// What DriverExit() throws on the threads running the command lines of a batch.
+struct DriverExitError : std::runtime_error
+{
+    explicit DriverExitError(int s)
+        : std::runtime_error("Exited with status " + std::to_string(s)), status(s)
+    {
+    }
+    int status;
+};
+
+// True on the threads running the command lines of a batch.
+bool& DriverExitThrows();
+
+// Ends a driver run which cannot go on: exits the process, or throws DriverExitError
+// when DriverExitThrows(), so that one command line does not end the whole batch.
+[[gnu::noreturn]] void DriverExit(int status);
+
 struct Input
 {
     std::string long_name;
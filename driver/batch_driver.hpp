@@ -0,0 +1,377 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_BATCH_DRIVER_HPP
+#define GUARD_MIOPEN_BATCH_DRIVER_HPP
+
+// Batch mode: runs the driver command lines of a file, or of stdin with "-i -", in one
+// process. A line is the arguments of one driver run, and everything up to the
+// "MIOpenDriver" word is dropped, so the commands MIOPEN_ENABLE_LOGGING_CMD prints can be
+// used as is once grepped out of the log. Empty lines and lines starting with '#' are
+// skipped.
+//
+// All the drivers of a job use the same handle, so the find-db, the perf-db and the built
+// kernels are loaded once instead of once per command. With "-j N" the lines are shared
+// by N jobs, each with its own handle and stream. The result of a line is written and
+// flushed as soon as it completes, as a CSV row or a JSON array element carrying the line
+// number; with several jobs they come in the order the lines complete. On stdout they are
+// mixed with the output of the drivers. The times are the wall time of the Run*GPU()
+// calls, or the median of the samples for the lines with --bench_iter.
+//
+// Every line starts from the same random sequence as a driver run on its own, each job
+// having its own generator (random.hpp), so the data of a line does not depend on -j or on
+// the lines before it. With several jobs, what the drivers write to std::cout is held until
+// their line completes and written at once, but printf() and stderr are not captured: their
+// output of concurrent lines may interleave. Use -j 1 when this output matters.
+//
+// A driver giving up on a line (DriverExit(), e.g. on invalid arguments) fails that line
+// only, the batch goes on with the next one.
+
+#include "InputFlags.hpp"
+#include "bench.hpp"
+#include "driver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BatchResult
+{
+    std::size_t line = 0;
+    std::string cmd;
+    int rc          = 0;
+    double fwd_ms   = 0;
+    double bwd_ms   = 0;
+    double total_ms = 0;
+    std::string error;
+};
+
+// Arguments of a line, base argument first, empty when the line has no command.
+std::vector<std::string> ParseBatchLine(const std::string& line)
+{
+    std::istringstream ss(line);
+    std::vector<std::string> words{std::istream_iterator<std::string>{ss},
+                                   std::istream_iterator<std::string>{}};
+    if(words.empty() || words.front()[0] == '#')
+        return {};
+
+    const std::string driver = "MIOpenDriver";
+    const auto last          = std::find_if(words.rbegin(), words.rend(), [&](auto& w) {
+        return w.size() >= driver.size() &&
+               w.compare(w.size() - driver.size(), driver.size(), driver) == 0;
+    });
+    words.erase(words.begin(), last.base());
+    return words;
+}
+
+std::string CsvQuote(const std::string& s)
+{
+    std::string r = "\"";
+    for(auto c : s)
+    {
+        if(c == '"')
+            r += '"';
+        r += c;
+    }
+    return r + "\"";
+}
+
+// Installed on std::cout while several jobs run: keeps what a thread writes between Begin()
+// and End() and writes it at once on End(), anything else is written as is.
+class BatchCoutCapture : public std::streambuf
+{
+    public:
+    BatchCoutCapture() : original(std::cout.rdbuf(this)) {}
+    BatchCoutCapture(const BatchCoutCapture&) = delete;
+    BatchCoutCapture& operator=(const BatchCoutCapture&) = delete;
+    ~BatchCoutCapture() override { std::cout.rdbuf(original); }
+
+    void Begin()
+    {
+        Captured().clear();
+        Capturing() = true;
+    }
+
+    void End()
+    {
+        Capturing() = false;
+        Emit(Captured().data(), Captured().size());
+        Captured().clear();
+    }
+
+    protected:
+    int_type overflow(int_type c) override
+    {
+        if(traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        const auto ch = traits_type::to_char_type(c);
+        xsputn(&ch, 1);
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        if(Capturing())
+            Captured().append(s, n);
+        else
+            Emit(s, n);
+        return n;
+    }
+
+    int sync() override
+    {
+        if(Capturing())
+            return 0;
+        const std::lock_guard<std::mutex> lock(mutex);
+        return original->pubsync();
+    }
+
+    private:
+    void Emit(const char* s, std::streamsize n)
+    {
+        const std::lock_guard<std::mutex> lock(mutex);
+        original->sputn(s, n);
+        original->pubsync();
+    }
+
+    static bool& Capturing()
+    {
+        static thread_local bool capturing = false;
+        return capturing;
+    }
+
+    static std::string& Captured()
+    {
+        static thread_local std::string captured;
+        return captured;
+    }
+
+    std::streambuf* original;
+    std::mutex mutex;
+};
+
+// Writes each result as soon as its command line completes, so the results of the lines
+// which ran are kept whatever happens to the rest of the batch. A result is written with
+// one call, so that it stays in one piece on a captured std::cout.
+class BatchResultWriter
+{
+    public:
+    BatchResultWriter(std::ostream& output, const std::string& format)
+        : os(output), json(format == "json")
+    {
+        if(json)
+            os << "[";
+        else
+            os << "line,command,rc,fwd_ms,bwd_ms,total_ms,error\n";
+        os.flush();
+    }
+
+    void Write(const BatchResult& r)
+    {
+        std::ostringstream ss;
+        const std::lock_guard<std::mutex> lock(mutex);
+        if(json)
+        {
+            ss << (count == 0 ? "\n" : ",\n") << "  {\"line\": " << r.line
+               << ", \"command\": " << JsonQuote(r.cmd) << ", \"rc\": " << r.rc
+               << ", \"fwd_ms\": " << r.fwd_ms << ", \"bwd_ms\": " << r.bwd_ms
+               << ", \"total_ms\": " << r.total_ms << ", \"error\": " << JsonQuote(r.error)
+               << "}";
+        }
+        else
+        {
+            ss << r.line << "," << CsvQuote(r.cmd) << "," << r.rc << "," << r.fwd_ms << ","
+               << r.bwd_ms << "," << r.total_ms << "," << CsvQuote(r.error) << "\n";
+        }
+        ++count;
+        os << ss.str();
+        os.flush();
+    }
+
+    void Finish()
+    {
+        if(json)
+            os << "\n]\n";
+        os.flush();
+    }
+
+    private:
+    std::ostream& os;
+    bool json;
+    std::size_t count = 0;
+    std::mutex mutex;
+};
+
+// run(args, result) runs the driver of one line, args has the base argument first.
+template <class F>
+int RunBatch(int argc, char* argv[], F run)
+{
+    InputFlags inflags;
+    inflags.AddInputFlag(
+        "input", 'i', "-", "Driver command lines, - for stdin (Default=-)", "string");
+    inflags.AddInputFlag("output", 'o', "-", "Results, - for stdout (Default=-)", "string");
+    inflags.AddInputFlag(
+        "format", 'f', "csv", "Results format, csv or json (Default=csv)", "string");
+    inflags.AddInputFlag(
+        "jobs", 'j', "1", "Handles the lines are shared by, one thread each (Default=1)", "int");
+    inflags.Parse(argc, argv);
+
+    const auto format = inflags.GetValueStr("format");
+    if(format != "csv" && format != "json")
+    {
+        std::cout << "Unknown results format: " << format << std::endl;
+        return -1;
+    }
+
+    std::vector<BatchResult> results;
+    {
+        const auto input = inflags.GetValueStr("input");
+        std::ifstream file;
+        if(input != "-")
+        {
+            file.open(input);
+            if(!file)
+            {
+                std::cout << "Cannot open " << input << std::endl;
+                return -1;
+            }
+        }
+        std::istream& is = input == "-" ? std::cin : file;
+
+        std::string line;
+        for(std::size_t n = 1; std::getline(is, line); ++n)
+        {
+            const auto args = ParseBatchLine(line);
+            if(args.empty())
+                continue;
+            results.emplace_back();
+            results.back().line = n;
+            for(const auto& arg : args)
+                results.back().cmd += (results.back().cmd.empty() ? "" : " ") + arg;
+        }
+    }
+
+    const auto output = inflags.GetValueStr("output");
+    std::ofstream output_file;
+    if(output != "-")
+    {
+        output_file.open(output);
+        if(!output_file)
+        {
+            std::cout << "Cannot write " << output << std::endl;
+            return -1;
+        }
+    }
+    BatchResultWriter writer(output == "-" ? std::cout : output_file, format);
+
+    const auto jobs = std::max(inflags.GetValueInt("jobs"), 1);
+    std::unique_ptr<BatchCoutCapture> capture;
+    if(jobs > 1)
+        capture = std::make_unique<BatchCoutCapture>();
+
+    std::atomic<std::size_t> next{0};
+    const auto job = [&] {
+        miopenHandle_t handle;
+#if MIOPEN_BACKEND_OPENCL
+        miopenCreate(&handle);
+#elif MIOPEN_BACKEND_HIP
+        hipStream_t s;
+        hipStreamCreate(&s);
+        miopenCreateWithStream(&handle, s);
+#endif
+        BatchHandle()      = handle;
+        DriverExitThrows() = true;
+
+        for(auto i = next++; i < results.size(); i = next++)
+        {
+            auto& res = results[i];
+            if(capture)
+                capture->Begin();
+            SET_SEED();
+            const auto start = std::chrono::steady_clock::now();
+            try
+            {
+                run(ParseBatchLine(res.cmd), res);
+            }
+            catch(const DriverExitError& ex)
+            {
+                // Even with status 0, the driver gave up on the line.
+                res.rc    = ex.status != 0 ? ex.status : -1;
+                res.error = ex.what();
+            }
+            catch(const std::exception& ex)
+            {
+                res.rc    = -1;
+                res.error = ex.what();
+            }
+            res.total_ms = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+            if(capture)
+                capture->End();
+            writer.Write(res);
+        }
+
+        DriverExitThrows() = false;
+        BatchHandle()      = nullptr;
+        miopenDestroy(handle);
+#if MIOPEN_BACKEND_HIP
+        hipStreamDestroy(s);
+#endif
+    };
+
+    std::vector<std::thread> threads;
+    for(auto i = 1; i < jobs; ++i)
+        threads.emplace_back(job);
+    job();
+    for(auto& t : threads)
+        t.join();
+    capture.reset();
+
+    writer.Finish();
+    if(output != "-" && !output_file)
+    {
+        std::cout << "Cannot write " << output << std::endl;
+        return -1;
+    }
+
+    const auto failed = std::count_if(
+        results.begin(), results.end(), [](const BatchResult& r) { return r.rc != 0; });
+    std::cout << "Batch: " << results.size() - failed << " of " << results.size()
+              << " command lines passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+#endif // GUARD_MIOPEN_BATCH_DRIVER_HPP
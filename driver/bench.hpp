@@ -0,0 +1,225 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_BENCH_HPP
+#define GUARD_MIOPEN_BENCH_HPP
+
+// Statistical timing of the Run*GPU() calls of any driver, enabled by --bench_iter.
+//
+// Each sample is one call: the kernel time of its last launch when the driver times the
+// kernels (--time 1), the wall time of the call up to the end of the stream otherwise.
+// The calls of --bench_warmup are not sampled. With --bench_cv the sampling stops as soon
+// as the coefficient of variation of the samples drops to the target, --bench_iter is the
+// limit then. Samples out of the Tukey fences (1.5 interquartile ranges beyond the
+// quartiles) are dropped before computing the statistics. --bench_out appends one JSON
+// line per direction to a file. With --verify 1 the driver verifies a single call of each
+// direction before benchmarking it (see RunDriver() in main.cpp).
+
+#include "InputFlags.hpp"
+#include "driver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+struct BenchStats
+{
+    std::size_t samples  = 0;
+    std::size_t rejected = 0;
+    double min           = 0;
+    double median        = 0;
+    double p90           = 0;
+    double p99           = 0;
+    double mean          = 0;
+    double cv            = 0;
+};
+
+std::string JsonQuote(const std::string& s)
+{
+    std::string r = "\"";
+    for(auto c : s)
+    {
+        if(c == '"' || c == '\\')
+            r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+// p-th percentile of sorted values, interpolated between the closest ranks.
+double Percentile(const std::vector<double>& sorted, double p)
+{
+    if(sorted.empty())
+        return 0;
+    const auto rank = p / 100 * (sorted.size() - 1);
+    const auto lo   = static_cast<std::size_t>(rank);
+    const auto hi   = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+BenchStats ComputeBenchStats(std::vector<double> samples)
+{
+    BenchStats stats;
+    if(samples.empty())
+        return stats;
+
+    std::sort(samples.begin(), samples.end());
+    const auto q1  = Percentile(samples, 25);
+    const auto q3  = Percentile(samples, 75);
+    const auto iqr = q3 - q1;
+    const auto kept_end =
+        std::remove_if(samples.begin(), samples.end(), [&](double x) {
+            return x < q1 - 1.5 * iqr || x > q3 + 1.5 * iqr;
+        });
+    stats.rejected = std::distance(kept_end, samples.end());
+    samples.erase(kept_end, samples.end());
+
+    stats.samples = samples.size();
+    stats.min     = samples.front();
+    stats.median  = Percentile(samples, 50);
+    stats.p90     = Percentile(samples, 90);
+    stats.p99     = Percentile(samples, 99);
+    stats.mean    = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+
+    double var = 0;
+    for(auto x : samples)
+        var += (x - stats.mean) * (x - stats.mean);
+    const auto stddev = std::sqrt(var / samples.size());
+    stats.cv          = stats.mean > 0 ? stddev / stats.mean : 0;
+    return stats;
+}
+
+class BenchHarness
+{
+    public:
+    static void AddCmdLineArgs(InputFlags& inflags)
+    {
+        inflags.AddInputFlag(
+            "bench_iter", 'J', "0", "Benchmark, max number of samples (Default=0, off)", "int");
+        inflags.AddInputFlag(
+            "bench_warmup", 'E', "3", "Benchmark, calls before sampling (Default=3)", "int");
+        inflags.AddInputFlag("bench_cv",
+                             'Q',
+                             "0",
+                             "Benchmark, stop when the coefficient of variation is below this "
+                             "percentage\n(Default=0, take bench_iter samples)",
+                             "double");
+        inflags.AddInputFlag(
+            "bench_out", 'T', "", "Benchmark, append the results to this file as JSON", "string");
+    }
+
+    explicit BenchHarness(const InputFlags& inflags)
+        : max_iter(inflags.GetValueInt("bench_iter")),
+          warmup(inflags.GetValueInt("bench_warmup")),
+          target_cv(inflags.GetValueDouble("bench_cv") / 100),
+          kernel_time(inflags.GetValueInt("time") != 0),
+          out(inflags.GetValueStr("bench_out"))
+    {
+    }
+
+    bool Enabled() const { return max_iter > 0; }
+
+    // Samples run(), which returns the status of one Run*GPU() call, and stops at the
+    // first failure.
+    template <class F>
+    int Run(Driver& drv, F run, BenchStats& stats) const
+    {
+        for(auto i = 0; i < warmup; ++i)
+        {
+            const int rc = run();
+            if(rc != 0)
+                return rc;
+        }
+
+        // Small samples make a meaningless variation.
+        const auto min_iter = static_cast<std::size_t>(std::min(max_iter, 10));
+        std::vector<double> samples;
+        while(samples.size() < static_cast<std::size_t>(max_iter))
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const int rc     = run();
+            if(rc != 0)
+                return rc;
+            if(kernel_time)
+            {
+                float time = 0.0;
+                miopenGetKernelTime(drv.GetHandle(), &time);
+                samples.push_back(time);
+            }
+            else
+            {
+#if MIOPEN_BACKEND_OPENCL
+                clFinish(drv.GetStream());
+#elif MIOPEN_BACKEND_HIP
+                hipStreamSynchronize(drv.GetStream());
+#endif
+                samples.push_back(std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+            }
+
+            if(target_cv > 0 && samples.size() >= min_iter &&
+               ComputeBenchStats(samples).cv <= target_cv)
+                break;
+        }
+        stats = ComputeBenchStats(samples);
+        return 0;
+    }
+
+    void Print(const std::string& cmd, const std::string& direction, const BenchStats& s) const
+    {
+        std::cout << "Benchmark " << direction << " (" << (kernel_time ? "kernel" : "wall")
+                  << "): " << s.samples << " samples, " << s.rejected << " outliers, min "
+                  << s.min << " ms, median " << s.median << " ms, p90 " << s.p90 << " ms, p99 "
+                  << s.p99 << " ms, mean " << s.mean << " ms, cv " << s.cv * 100 << "%"
+                  << std::endl;
+
+        if(out.empty())
+            return;
+        std::ofstream file(out, std::ios::app);
+        file << "{\"command\": " << JsonQuote(cmd) << ", \"direction\": \"" << direction
+             << "\", \"time\": \"" << (kernel_time ? "kernel" : "wall")
+             << "\", \"samples\": " << s.samples << ", \"rejected\": " << s.rejected
+             << ", \"min\": " << s.min << ", \"median\": " << s.median << ", \"p90\": " << s.p90
+             << ", \"p99\": " << s.p99 << ", \"mean\": " << s.mean << ", \"cv\": " << s.cv << "}"
+             << std::endl;
+        if(!file)
+            std::cout << "Cannot write " << out << std::endl;
+    }
+
+    private:
+    int max_iter;
+    int warmup;
+    double target_cv;
+    bool kernel_time;
+    std::string out;
+};
+
+#endif // GUARD_MIOPEN_BENCH_HPP
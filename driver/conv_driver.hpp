@@ -843,7 +843,7 @@ int ConvDriver<Tgpu, Tref>::SetConvDescriptorFromCmdLineArgs()
            group_count > out_c)
         {
             printf("Invalid group number\n");
-            exit(0);
+            DriverExit(0);
         }
     }
 
@@ -859,7 +859,7 @@ int ConvDriver<Tgpu, Tref>::SetConvDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect Convolution Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     // adjust padding based on user-defined padding mode
@@ -1138,7 +1138,7 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
 
     /* Unless seed is persistent between runs validation using cache stored in file is impossible.
      */
-    srand(0);
+    SET_SEED(0);
 
     bool dataRead = false;
     if(is_fwd || is_wrw)
@@ -1163,11 +1163,11 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
                         static_cast<Tgpu>(Data_scale * RAN_GEN<float>(static_cast<float>(0.0),
                                                                       static_cast<float>(1.0)));
                 else /// \anchor move_rand
-                    /// Move rand() forward, even if buffer is unused. This provides the same
+                    /// Move the generator forward, even if buffer is unused. This provides the same
                     /// initialization of input buffers regardless of which kinds of
                     /// convolutions are currently selectedfor testing (see the "-F" option).
                     /// Verification cache would be broken otherwise.
-                    rand();
+                    GET_RAND();
             }
         }
 
@@ -1197,7 +1197,7 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
                     wei.data[i] =
                         static_cast<Tgpu>(Data_scale * 2 * detail::RanGenWeights<float>());
                 else /// \ref move_rand
-                    rand();
+                    GET_RAND();
         }
     }
     else
@@ -1217,7 +1217,7 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
                     in.data[i] =
                         Data_scale * RAN_GEN<Tgpu>(static_cast<Tgpu>(0.0), static_cast<Tgpu>(1.0));
                 else /// \ref move_rand
-                    rand();
+                    GET_RAND();
             }
         }
 
@@ -1228,7 +1228,7 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
                     dout.data[i] =
                         Data_scale * RAN_GEN<Tgpu>(static_cast<Tgpu>(0.0), static_cast<Tgpu>(1.0));
                 else /// \ref move_rand
-                    rand();
+                    GET_RAND();
         }
 
         if(inflags.GetValueInt("bias") != 0)
@@ -1262,7 +1262,7 @@ int ConvDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
                 if(is_fwd || is_bwd)
                     wei.data[i] = Data_scale * detail::RanGenWeights<Tgpu>();
                 else /// \ref move_rand
-                    rand();
+                    GET_RAND();
         }
     }
 
@@ -165,8 +165,9 @@ int CTCDriver<Tgpu, Tref>::AddCmdLineArgs()
     inflags.AddInputFlag("verify", 'V', "1", "Verify CTC losses and gradients (Default=1)", "int");
     inflags.AddInputFlag("verify_path",
                          'v',
-                         "1",
-                         "Verify Path for CTC losses and gradients: fast 1, regular 0 (Default=1)",
+                         "0",
+                         "Verify Path for CTC losses and gradients: host 0, kernel emulator 1 "
+                         "(Default=0)",
                          "int");
     inflags.AddInputFlag("time", 't', "0", "Time Each Layer (Default=0)", "int");
     inflags.AddInputFlag(
@@ -254,7 +255,7 @@ int CTCDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
 
     for(int i = 0; i < labels_sz; i++)
     {
-        labels[i] = static_cast<int>(rand() % num_class + 1);
+        labels[i] = static_cast<int>(GET_RAND() % num_class + 1);
         if(blank_lb > num_class)
             labels[i] = labels[i] == num_class ? num_class - 1 : labels[i];
         else if(blank_lb < 0)
@@ -302,12 +303,12 @@ int CTCDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     workspace      = std::vector<Tgpu>(workSpaceSize / sizeof(Tgpu), 0);
     workspace_host = std::vector<Tref>(workSpaceSizeCPU / sizeof(Tref), 0);
 
-    srand(0);
+    SET_SEED(0);
     double scale = 0.01;
 
     for(int i = 0; i < probs_sz; i++)
     {
-        probs[i] = static_cast<Tgpu>((static_cast<double>(scale * rand()) * (1.0 / RAND_MAX)));
+        probs[i] = static_cast<Tgpu>((static_cast<double>(scale * GET_RAND()) * (1.0 / RAND_MAX)));
     }
     if(apply_softmax)
     {
@@ -130,7 +130,7 @@ void PadBufferSize(size_t& sz, int datatype_sz)
     printf(
         "Supported Base Arguments: conv[fp16|int8|bfp16], CBAInfer[fp16], pool[fp16], lrn[fp16], "
         "activ[fp16], softmax[fp16], bnorm[fp16], rnn[fp16], gemm, ctc, dropout[fp16], "
-        "tensorop[fp16], reduce[fp16]\n");
+        "tensorop[fp16], reduce[fp16], batch\n");
     exit(0);
 }
 
@@ -150,7 +150,7 @@ std::string ParseBaseArg(int argc, char* argv[])
        arg != "softmax" && arg != "softmaxfp16" && arg != "bnorm" && arg != "bnormfp16" &&
        arg != "rnn" && arg != "rnnfp16" && arg != "gemm" /*&& arg != "gemmfp16"*/ && arg != "ctc" &&
        arg != "dropout" && arg != "dropoutfp16" && arg != "tensorop" && arg != "tensoropfp16" &&
-       arg != "reduce" && arg != "reducefp16" && arg != "--version")
+       arg != "reduce" && arg != "reducefp16" && arg != "batch" && arg != "--version")
     {
         printf("Invalid Base Input Argument\n");
         Usage();
@@ -161,19 +161,36 @@ std::string ParseBaseArg(int argc, char* argv[])
         return arg;
 }
 
+// Handle of the batch mode for the drivers created on this thread, null otherwise.
+// The drivers use it instead of creating their own, so the caches of the handle
+// are shared between the command lines of a batch.
+miopenHandle_t& BatchHandle()
+{
+    static thread_local miopenHandle_t handle = nullptr;
+    return handle;
+}
+
 class Driver
 {
     public:
     Driver()
     {
         data_type = miopenFloat;
+        if(BatchHandle() != nullptr)
+        {
+            handle     = BatchHandle();
+            own_handle = false;
+        }
+        else
+        {
 #if MIOPEN_BACKEND_OPENCL
-        miopenCreate(&handle);
+            miopenCreate(&handle);
 #elif MIOPEN_BACKEND_HIP
-        hipStream_t s;
-        hipStreamCreate(&s);
-        miopenCreateWithStream(&handle, s);
+            hipStream_t s;
+            hipStreamCreate(&s);
+            miopenCreateWithStream(&handle, s);
 #endif
+        }
 
         miopenGetStream(handle, &q);
     }
@@ -186,7 +203,11 @@ class Driver
 #elif MIOPEN_BACKEND_HIP
     hipStream_t& GetStream() { return q; }
 #endif
-    virtual ~Driver() { miopenDestroy(handle); }
+    virtual ~Driver()
+    {
+        if(own_handle)
+            miopenDestroy(handle);
+    }
 
     // TODO: add timing APIs
     virtual int AddCmdLineArgs() = 0;
@@ -203,6 +224,7 @@ class Driver
     template <typename Tgpu>
     void InitDataType();
     miopenHandle_t handle;
+    bool own_handle = true;
     miopenDataType_t data_type;
 
 #if MIOPEN_BACKEND_OPENCL
@@ -40,112 +40,15 @@
 #include <array>
 #include <miopen/dropout.hpp>
 #include <miopen/float_equal.hpp>
-#include <miopen/precalc_xorwow_skipahead_matrices.hpp>
-#include <miopen/precalc_xorwow_skipahead_sequence_matrices.hpp>
+#include <miopen/par_for.hpp>
 #include "xorwow_skipahead_generator.hpp"
-
-#define ROCRAND_2POW32_INV (2.3283064e-10f)
-
-float uniform_distribution_emu(size_t v) { return ROCRAND_2POW32_INV + (v * ROCRAND_2POW32_INV); }
-
-void xorwow_skipahead_emu(unsigned long long skp,
-                          prngStates* state,
-                          const unsigned int skipahead_mat[XORWOW_PRECALC_MATRICES_NUM]
-                                                          [XORWOW_PRECALC_MATRICES_SZ])
-{
-    unsigned int xor_vec[XORWOW_DIM];
-    unsigned int* p = &(state->x);
-    std::copy(p, p + XORWOW_DIM, std::begin(xor_vec));
-
-    unsigned int mat_idx = 0;
-    while(bool(skp)
-#if(XORWOW_PRECALC_MATRICES_NUM * XORWOW_JUMP_LOG2) < 64
-          &&
-          mat_idx < XORWOW_PRECALC_MATRICES_NUM
-#endif
-          )
-    {
-        for(unsigned int i = 0; i < static_cast<unsigned int>(skp & XORWOW_JUMP_LOG2_MASK); i++)
-        {
-            mat_vec(skipahead_mat[mat_idx], xor_vec);
-        }
-        skp >>= XORWOW_JUMP_LOG2;
-        mat_idx++;
-    }
-
-#if(XORWOW_PRECALC_MATRICES_NUM * XORWOW_JUMP_LOG2) < 64
-    if(skp)
-    {
-        unsigned int matrixA[XORWOW_PRECALC_MATRICES_SZ], matrixB[XORWOW_PRECALC_MATRICES_SZ];
-        std::copy(&(skipahead_mat[XORWOW_PRECALC_MATRICES_NUM - 1][0]),
-                  &(skipahead_mat[XORWOW_PRECALC_MATRICES_NUM - 1][0]) + XORWOW_PRECALC_MATRICES_SZ,
-                  std::begin(matrixA));
-
-        while(skp)
-        {
-            mat_pow(matrixB, matrixA, 1ULL << XORWOW_JUMP_LOG2);
-            std::copy(std::begin(matrixB), std::end(matrixB), std::begin(matrixA));
-
-            for(unsigned int i = 0; i < static_cast<unsigned int>(skp & XORWOW_JUMP_LOG2_MASK); i++)
-            {
-                mat_vec(matrixA, xor_vec);
-            }
-            skp >>= XORWOW_JUMP_LOG2;
-        }
-    }
-#endif
-
-    std::copy(std::begin(xor_vec), std::end(xor_vec), p);
-}
-
-void xorwow_lite_init_emu(prngStates* cur_state,
-                          const unsigned long long seed,
-                          const unsigned long long subsequence,
-                          const unsigned long long offset)
-{
-    cur_state->x = 123456789;
-    cur_state->y = 362436069;
-    cur_state->z = 521288629;
-    cur_state->w = 88675123;
-    cur_state->v = 5783321;
-
-    cur_state->d = 6615241;
-
-    // Adopt constants choice of rocRAND (https://github.com/ROCmSoftwarePlatform/rocRAND)
-    const unsigned int s0 = static_cast<unsigned int>(seed) ^ 0x2c7f967fU;
-    const unsigned int s1 = static_cast<unsigned int>(seed >> 32) ^ 0xa03697cbU;
-    const unsigned int t0 = 1228688033 * s0;
-    const unsigned int t1 = 2073658381 * s1;
-    cur_state->x += t0;
-    cur_state->y ^= t0;
-    cur_state->z += t1;
-    cur_state->w ^= t1;
-    cur_state->v += t0;
-    cur_state->d += t1 + t0;
-
-    xorwow_skipahead_emu(subsequence, cur_state, precalc_xorwow_skipahead_sequence_matrices);
-
-    xorwow_skipahead_emu(offset, cur_state, precalc_xorwow_skipahead_matrices);
-    cur_state->d += static_cast<unsigned int>(offset) * 362437;
-}
+#include "../test/cpu_dropout.hpp"
 
 void InitKernelStateEmulator(std::vector<prngStates>& states,
                              const miopenDropoutDescriptor_t dropoutDesc)
 {
     size_t states_num = miopen::deref(dropoutDesc).stateSizeInBytes / sizeof(prngStates);
-    size_t wk_grp_num = std::min(size_t(MAX_PRNG_STATE / 256), (states_num + 255) / 256);
-    size_t glb_sz     = wk_grp_num * 256;
-
-    for(size_t j = 0; j < (states_num + glb_sz - 1) / glb_sz; j++)
-    {
-        for(size_t i = 0; i < glb_sz; i++)
-        {
-            size_t gid                = i + j * glb_sz;
-            unsigned long long seq    = gid;
-            unsigned long long offset = 0;
-            xorwow_lite_init_emu(&states[gid], miopen::deref(dropoutDesc).seed, seq, offset);
-        }
-    }
+    cpu_dropout::init_states(states.data(), states_num, miopen::deref(dropoutDesc).seed);
 }
 
 template <typename T>
@@ -200,7 +103,7 @@ void RunDropoutForwardEmulator(miopenHandle_t handle,
                                const miopenTensorDescriptor_t outputTensor,
                                std::vector<Tref>& out,
                                std::vector<unsigned char>& reservespace,
-                               std::vector<prngStates>& states,
+                               const std::vector<prngStates>& states,
                                size_t in_offset    = 0,
                                size_t out_offset   = 0,
                                size_t rsvsp_offset = 0)
@@ -253,30 +156,30 @@ void RunDropoutForwardEmulator(miopenHandle_t handle,
             ((in_len[4] * in_len[3] * in_len[2] * in_len[1] * in_len[0] + 255) / 256)) *
         256;
 
-    for(int i0 = 0; i0 < in_len[0]; i0++)
-        for(int i1 = 0; i1 < in_len[1]; i1++)
-            for(int i2 = 0; i2 < in_len[2]; i2++)
-                for(int i3 = 0; i3 < in_len[3]; i3++)
-                    for(int i4 = 0; i4 < in_len[4]; i4++)
-                    {
-                        size_t oi = out_offset + i0 * out_str[0] + i1 * out_str[1] +
-                                    i2 * out_str[2] + i3 * out_str[3] + i4;
-                        size_t ii = in_offset + i0 * in_str[0] + i1 * in_str[1] + i2 * in_str[2] +
-                                    i3 * in_str[3] + i4;
-                        size_t si = i0 * in_len[1] * in_len[2] * in_len[3] * in_len[4] +
-                                    i1 * in_len[2] * in_len[3] * in_len[4] +
-                                    i2 * in_len[3] * in_len[4] + i3 * in_len[4] + i4;
-                        size_t ri = rsvsp_offset + si;
-
-                        if(!use_mask)
-                            reservespace[ri] =
-                                uniform_distribution_emu(xorwow_next(&states[si % glb_sz])) >
-                                dropout_rate;
-
-                        out[oi] = bool(reservespace[ri]) && !miopen::float_equal(dropout_rate, 1.0)
-                                      ? static_cast<Tref>(in[ii] / (1 - dropout_rate))
-                                      : 0;
-                    }
+    if(!use_mask)
+        cpu_dropout::generate_mask(states.data(),
+                                   glb_sz,
+                                   in_len[4] * in_len[3] * in_len[2] * in_len[1] * in_len[0],
+                                   dropout_rate,
+                                   reservespace.data() + rsvsp_offset);
+
+    // One task per innermost row
+    miopen::par_for(in_len[0] * in_len[1] * in_len[2] * in_len[3], [&](size_t row) {
+        size_t i3 = row % in_len[3];
+        size_t i2 = row / in_len[3] % in_len[2];
+        size_t i1 = row / (in_len[3] * in_len[2]) % in_len[1];
+        size_t i0 = row / (in_len[3] * in_len[2] * in_len[1]);
+        size_t oi =
+            out_offset + i0 * out_str[0] + i1 * out_str[1] + i2 * out_str[2] + i3 * out_str[3];
+        size_t ii = in_offset + i0 * in_str[0] + i1 * in_str[1] + i2 * in_str[2] + i3 * in_str[3];
+        size_t ri = rsvsp_offset + row * in_len[4];
+
+        for(size_t i4 = 0; i4 < in_len[4]; i4++)
+            out[oi + i4] =
+                bool(reservespace[ri + i4]) && !miopen::float_equal(dropout_rate, 1.0)
+                    ? static_cast<Tref>(in[ii + i4] / (1 - dropout_rate))
+                    : 0;
+    });
 }
 
 template <typename Tgpu, typename Tref = Tgpu>
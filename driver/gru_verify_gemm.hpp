@@ -212,8 +212,7 @@ void RunGRUForwardGEMMCPUVerify(miopenHandle_t handle,
             int prelayer_shift = (li - 1) * batch_n * hy_stride + bi * 3 * hy_h;
             if(use_dropout)
             {
-                auto dropout_states_tmp = dropout_states_host;
-                size_t drop_out_offset  = (li - 1) * batch_n * hy_h * bi;
+                size_t drop_out_offset = (li - 1) * batch_n * hy_h * bi;
 
                 RunDropoutForwardEmulator<Tref>(handle,
                                                 dropoutDesc,
@@ -223,7 +222,7 @@ void RunGRUForwardGEMMCPUVerify(miopenHandle_t handle,
                                                 dropout_outputTensor,
                                                 dropout_hid_state,
                                                 dropout_reservespace_host,
-                                                dropout_states_tmp,
+                                                dropout_states_host,
                                                 prelayer_shift,
                                                 drop_out_offset,
                                                 drop_out_offset);
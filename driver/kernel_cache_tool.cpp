@@ -0,0 +1,160 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Inspects and trims the user kernel caches: the per-version databases (*.ukdb) and
+// the content-addressed databases shared by all versions (*.ckdb).
+//
+//   MIOpenKernelCache list
+//   MIOpenKernelCache stats [files...]
+//   MIOpenKernelCache evict <size in MB> [files...]
+//   MIOpenKernelCache clear [files...]
+//   MIOpenKernelCache vacuum [files...]
+//
+// Without files, all the databases of both caches are processed.
+
+#include <miopen/binary_cache.hpp>
+#include <miopen/kern_db.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void Usage()
+{
+    std::cerr << "Usage: MIOpenKernelCache list" << std::endl
+              << "       MIOpenKernelCache stats [files...]" << std::endl
+              << "       MIOpenKernelCache evict <size in MB> [files...]" << std::endl
+              << "       MIOpenKernelCache clear [files...]" << std::endl
+              << "       MIOpenKernelCache vacuum [files...]" << std::endl;
+}
+
+static void FindDatabases(const boost::filesystem::path& dir,
+                          const std::string& extension,
+                          std::vector<std::string>& files)
+{
+    boost::system::error_code ec;
+    if(dir.empty() || !boost::filesystem::exists(dir, ec))
+        return;
+    for(boost::filesystem::directory_iterator it{dir, ec}, end; !ec && it != end;
+        it.increment(ec))
+    {
+        if(it->path().extension() == extension)
+            files.push_back(it->path().string());
+    }
+}
+
+static std::vector<std::string> FindDatabases()
+{
+    std::vector<std::string> files;
+    FindDatabases(miopen::GetCachePath(false), ".ukdb", files);
+    FindDatabases(miopen::GetContentCachePath(), ".ckdb", files);
+    return files;
+}
+
+static void PrintStats(const std::string& file, const miopen::KernelCacheStats& stats)
+{
+    const auto lookups = stats.hits + stats.misses;
+    std::cout << file << std::endl
+              << "  entries:       " << stats.entries << std::endl
+              << "  size:          " << std::fixed << std::setprecision(1)
+              << static_cast<double>(stats.bytes) / (1024 * 1024) << " MB" << std::endl
+              << "  hits:          " << stats.hits << std::endl
+              << "  misses:        " << stats.misses << std::endl
+              << "  hit rate:      "
+              << (lookups == 0 ? 0.0 : 100.0 * static_cast<double>(stats.hits) / lookups) << " %"
+              << std::endl
+              << "  decompression: " << stats.decompress_ms << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 2)
+    {
+        Usage();
+        return EXIT_FAILURE;
+    }
+
+    const std::string command = argv[1];
+    auto first_file           = 2;
+    std::size_t max_bytes     = 0;
+    if(command == "evict")
+    {
+        if(argc < 3)
+        {
+            Usage();
+            return EXIT_FAILURE;
+        }
+        max_bytes  = std::stoull(argv[2]) * 1024 * 1024;
+        first_file = 3;
+    }
+    else if(command != "list" && command != "stats" && command != "clear" && command != "vacuum")
+    {
+        Usage();
+        return EXIT_FAILURE;
+    }
+
+    auto files = std::vector<std::string>(argv + first_file, argv + argc);
+    if(files.empty())
+        files = FindDatabases();
+
+    try
+    {
+        for(const auto& file : files)
+        {
+            if(!boost::filesystem::exists(file))
+            {
+                std::cerr << file << ": not found" << std::endl;
+                continue;
+            }
+            if(command == "list")
+            {
+                std::cout << file << " (" << std::fixed << std::setprecision(1)
+                          << static_cast<double>(boost::filesystem::file_size(file)) /
+                                 (1024 * 1024)
+                          << " MB)" << std::endl;
+                continue;
+            }
+            miopen::KernDb db(file, false, "", 0);
+            if(command == "evict" || command == "clear")
+                std::cout << file << ": evicted " << db.EvictUnsafe(max_bytes) << " kernels"
+                          << std::endl;
+            if(command == "vacuum" || command == "clear")
+                db.sql.Exec("VACUUM;");
+            if(command == "stats")
+                PrintStats(file, db.GetStatsUnsafe());
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -210,7 +210,7 @@ int LRNDriver<Tgpu, Tref>::SetLRNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect LRN Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     return (miopenSetLRNDescriptor(lrnDesc, mode, lrnN, lrnAlpha, lrnBeta, lrnK));
@@ -220,8 +220,7 @@ void RunLSTMForwardGEMMCPUVerify(
             int prelayer_shift = (li - 1) * batch_n * hy_stride + bi * 5 * hy_h;
             if(use_dropout)
             {
-                auto dropout_states_tmp = dropout_states_host;
-                size_t drop_out_offset  = (li - 1) * batch_n * hy_h * bi;
+                size_t drop_out_offset = (li - 1) * batch_n * hy_h * bi;
 
                 RunDropoutForwardEmulator<Tref>(handle,
                                                 dropoutDesc,
@@ -231,7 +230,7 @@ void RunLSTMForwardGEMMCPUVerify(
                                                 dropout_outputTensor,
                                                 dropout_hid_state,
                                                 dropout_reservespace_host,
-                                                dropout_states_tmp,
+                                                dropout_states_host,
                                                 prelayer_shift,
                                                 drop_out_offset,
                                                 drop_out_offset);
@@ -23,10 +23,16 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <chrono>
 #include <iostream>
 #include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "activ_driver.hpp"
+#include "batch_driver.hpp"
+#include "bench.hpp"
 #include "bn_driver.hpp"
 #include "conv_driver.hpp"
 #include "CBAInferFusion_driver.hpp"
@@ -42,153 +48,138 @@
 #include "reduce_driver.hpp"
 #include "miopen/config.h"
 
-int main(int argc, char* argv[])
+static Driver* MakeDriver(const std::string& base_arg)
 {
-
-    std::string base_arg = ParseBaseArg(argc, argv);
-
-    if(base_arg == "--version")
-    {
-        size_t major, minor, patch;
-        miopenGetVersion(&major, &minor, &patch);
-        std::cout << "MIOpen (version: " << major << "." << minor << "." << patch << ")"
-                  << std::endl;
-        exit(0);
-    }
-
-    // show command
-    std::cout << "MIOpenDriver";
-    for(int i = 1; i < argc; i++)
-        std::cout << " " << argv[i];
-    std::cout << std::endl;
-
-    Driver* drv;
     if(base_arg == "conv")
     {
-        drv = new ConvDriver<float, float>();
+        return new ConvDriver<float, float>();
     }
     else if(base_arg == "convfp16")
     {
-        drv = new ConvDriver<float16, float>();
+        return new ConvDriver<float16, float>();
     }
     else if(base_arg == "convbfp16")
     {
-        drv = new ConvDriver<bfloat16, float>();
+        return new ConvDriver<bfloat16, float>();
     }
     else if(base_arg == "convint8")
     {
-        drv = new ConvDriver<int8_t, float>();
+        return new ConvDriver<int8_t, float>();
     }
     else if(base_arg == "CBAInfer")
     {
-        drv = new CBAInferFusionDriver<float, double>();
+        return new CBAInferFusionDriver<float, double>();
     }
     else if(base_arg == "CBAInferfp16")
     {
-        drv = new CBAInferFusionDriver<float16, double>();
+        return new CBAInferFusionDriver<float16, double>();
     }
     else if(base_arg == "pool")
     {
-        drv = new PoolDriver<float, double>();
+        return new PoolDriver<float, double>();
     }
     else if(base_arg == "poolfp16")
     {
-        drv = new PoolDriver<float16, double>();
+        return new PoolDriver<float16, double>();
     }
     else if(base_arg == "lrn")
     {
-        drv = new LRNDriver<float, double>();
+        return new LRNDriver<float, double>();
     }
     else if(base_arg == "lrnfp16")
     {
-        drv = new LRNDriver<float16, double>();
+        return new LRNDriver<float16, double>();
     }
     else if(base_arg == "activ")
     {
-        drv = new ActivationDriver<float, double>();
+        return new ActivationDriver<float, double>();
     }
     else if(base_arg == "activfp16")
     {
-        drv = new ActivationDriver<float16, double>();
+        return new ActivationDriver<float16, double>();
     }
     else if(base_arg == "softmax")
     {
-        drv = new SoftmaxDriver<float, double>();
+        return new SoftmaxDriver<float, double>();
     }
     else if(base_arg == "softmaxfp16")
     {
-        drv = new SoftmaxDriver<float16, double>();
+        return new SoftmaxDriver<float16, double>();
     }
 #if MIOPEN_USE_GEMM
     else if(base_arg == "gemm")
     {
-        drv = new GemmDriver<float>();
+        return new GemmDriver<float>();
     }
 // TODO half is not supported in gemm
 //    else if(base_arg == "gemmfp16")
 //    {
-//        drv = new GemmDriver<float16>();
+//        return new GemmDriver<float16>();
 //    }
 #endif
     else if(base_arg == "bnorm")
     {
-        drv = new BatchNormDriver<float, double>();
+        return new BatchNormDriver<float, double>();
     }
     else if(base_arg == "bnormfp16")
     {
-        drv = new BatchNormDriver<float16, double, float>();
+        return new BatchNormDriver<float16, double, float>();
     }
     else if(base_arg == "rnn")
     {
-        drv = new RNNDriver<float, double>();
+        return new RNNDriver<float, double>();
     }
     else if(base_arg == "rnnfp16")
     {
-        drv = new RNNDriver<float16, double>();
+        return new RNNDriver<float16, double>();
     }
     else if(base_arg == "ctc")
     {
-        drv = new CTCDriver<float>();
+        return new CTCDriver<float>();
     }
     else if(base_arg == "dropout")
     {
-        drv = new DropoutDriver<float, float>();
+        return new DropoutDriver<float, float>();
     }
     else if(base_arg == "dropoutfp16")
     {
-        drv = new DropoutDriver<float16, float>();
+        return new DropoutDriver<float16, float>();
     }
     else if(base_arg == "tensorop")
     {
-        drv = new TensorOpDriver<float, float>();
+        return new TensorOpDriver<float, float>();
     }
     else if(base_arg == "tensoropfp16")
     {
-        drv = new TensorOpDriver<float16, float>();
+        return new TensorOpDriver<float16, float>();
     }
     else if(base_arg == "reduce")
     {
-        drv = new ReduceDriver<float, float>();
+        return new ReduceDriver<float, float>();
     }
     else if(base_arg == "reducefp16")
     {
-        drv = new ReduceDriver<float16, float>();
-    }
-    else
-    {
-        printf("Incorrect BaseArg\n");
-        exit(0);
+        return new ReduceDriver<float16, float>();
     }
+    return nullptr;
+}
 
-    drv->AddCmdLineArgs();
-    int rc = drv->ParseCmdLineArgs(argc, argv);
+static int RunDriver(Driver& drv,
+                     const std::string& base_arg,
+                     int argc,
+                     char* argv[],
+                     BatchResult* res = nullptr)
+{
+    drv.AddCmdLineArgs();
+    BenchHarness::AddCmdLineArgs(drv.GetInputFlags());
+    int rc = drv.ParseCmdLineArgs(argc, argv);
     if(rc != 0)
     {
         std::cout << "ParseCmdLineArgs() failed, rc = " << rc << std::endl;
         return rc;
     }
-    drv->GetandSetData();
-    rc = drv->AllocateBuffersAndCopy();
+    drv.GetandSetData();
+    rc = drv.AllocateBuffersAndCopy();
     if(rc != 0)
     {
         std::cout << "AllocateBuffersAndCopy() failed, rc = " << rc << std::endl;
@@ -196,33 +187,132 @@ int main(int argc, char* argv[])
     }
 
     int fargval = ((base_arg != "CBAInfer") && (base_arg != "CBAInferfp16"))
-                      ? drv->GetInputFlags().GetValueInt("forw")
+                      ? drv.GetInputFlags().GetValueInt("forw")
                       : 1;
     bool bnFwdInVer   = (fargval == 2 && (base_arg == "bnorm"));
-    bool verifyarg    = (drv->GetInputFlags().GetValueInt("verify") == 1);
+    bool verifyarg    = (drv.GetInputFlags().GetValueInt("verify") == 1);
     int cumulative_rc = 0; // Do not stop running tests in case of errors.
 
-    if(fargval & 1 || fargval == 0 || bnFwdInVer)
-    {
-        rc = drv->RunForwardGPU();
-        cumulative_rc |= rc;
-        if(rc != 0)
-            std::cout << "RunForwardGPU() failed, rc = "
-                      << "0x" << std::hex << rc << std::dec << std::endl;
-        if(verifyarg) // Verify even if Run() failed.
-            cumulative_rc |= drv->VerifyForward();
+    const BenchHarness bench(drv.GetInputFlags());
+    std::string cmd = base_arg;
+    for(int i = 2; i < argc; i++)
+        cmd += std::string(" ") + argv[i];
+
+    const bool forward  = fargval & 1 || fargval == 0 || bnFwdInVer;
+    const bool backward = fargval != 1;
+    const auto run_fwd  = [&] { return drv.RunForwardGPU(); };
+    const auto run_bwd  = [&] { return drv.RunBackwardGPU(); };
+    const auto check    = [&](int status, const char* what) {
+        cumulative_rc |= status;
+        if(status != 0)
+            std::cout << what << " failed, rc = "
+                      << "0x" << std::hex << status << std::dec << std::endl;
+    };
+    const auto run_once = [&](auto run, double& ms) {
+        const auto start = std::chrono::steady_clock::now();
+        const int status = run();
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                 .count();
+        return status;
+    };
+    const auto run_bench = [&](const std::string& direction, auto run, double& ms) {
+        BenchStats stats;
+        const int status = bench.Run(drv, run, stats);
+        if(status == 0)
+            bench.Print(cmd, direction, stats);
+        ms = stats.median;
+        return status;
+    };
+    // The time of a direction is the median of the benchmark samples when it is enabled,
+    // the wall time of the single call otherwise.
+    double fwd_ms = 0;
+    double bwd_ms = 0;
+
+    // Verification checks single calls made before any benchmark call: the drivers with
+    // state (batch norm running mean and variance, RNN reserve space, dropout states) no
+    // longer match their reference after the repeated calls of the benchmark.
+    if(!bench.Enabled() || verifyarg)
+    {
+        if(forward)
+        {
+            check(run_once(run_fwd, fwd_ms), "RunForwardGPU()");
+            if(verifyarg) // Verify even if Run() failed.
+                cumulative_rc |= drv.VerifyForward();
+        }
+        if(backward)
+        {
+            check(run_once(run_bwd, bwd_ms), "RunBackwardGPU()");
+            if(verifyarg) // Verify even if Run() failed.
+                cumulative_rc |= drv.VerifyBackward();
+        }
     }
 
-    if(fargval != 1)
+    if(bench.Enabled())
     {
-        rc = drv->RunBackwardGPU();
-        cumulative_rc |= rc;
-        if(rc != 0)
-            std::cout << "RunBackwardGPU() failed, rc = "
-                      << "0x" << std::hex << rc << std::dec << std::endl;
-        if(verifyarg) // Verify even if Run() failed.
-            cumulative_rc |= drv->VerifyBackward();
+        if(forward)
+            check(run_bench("forward", run_fwd, fwd_ms), "RunForwardGPU()");
+        if(backward)
+            check(run_bench("backward", run_bwd, bwd_ms), "RunBackwardGPU()");
     }
 
+    if(res != nullptr)
+    {
+        res->fwd_ms = fwd_ms;
+        res->bwd_ms = bwd_ms;
+    }
     return cumulative_rc;
 }
+
+int main(int argc, char* argv[])
+{
+
+    std::string base_arg = ParseBaseArg(argc, argv);
+
+    if(base_arg == "--version")
+    {
+        size_t major, minor, patch;
+        miopenGetVersion(&major, &minor, &patch);
+        std::cout << "MIOpen (version: " << major << "." << minor << "." << patch << ")"
+                  << std::endl;
+        exit(0);
+    }
+
+    if(base_arg == "batch")
+    {
+        return RunBatch(argc, argv, [](const std::vector<std::string>& args, BatchResult& res) {
+            std::vector<char*> line_argv = {const_cast<char*>("MIOpenDriver")};
+            for(const auto& arg : args)
+                line_argv.push_back(const_cast<char*>(arg.c_str()));
+
+            std::cout << "MIOpenDriver";
+            for(const auto& arg : args)
+                std::cout << " " << arg;
+            std::cout << std::endl;
+
+            const std::unique_ptr<Driver> drv{MakeDriver(args.front())};
+            if(drv == nullptr)
+            {
+                res.rc    = -1;
+                res.error = "Incorrect BaseArg";
+                return;
+            }
+            res.rc = RunDriver(
+                *drv, args.front(), static_cast<int>(line_argv.size()), line_argv.data(), &res);
+        });
+    }
+
+    // show command
+    std::cout << "MIOpenDriver";
+    for(int i = 1; i < argc; i++)
+        std::cout << " " << argv[i];
+    std::cout << std::endl;
+
+    Driver* drv = MakeDriver(base_arg);
+    if(drv == nullptr)
+    {
+        printf("Incorrect BaseArg\n");
+        exit(0);
+    }
+
+    return RunDriver(*drv, base_arg, argc, argv);
+}
@@ -33,84 +33,13 @@
 #include <cassert>
 #include <cmath>
 
+#include "../test/cpu_reduce.hpp"
 #include "../test/cpu_reduce_util.hpp"
 
 #include "tensor_driver.hpp"
 
 using float16 = half_float::half;
 
-static inline void
-get_all_indexes(const std::vector<int>& dimLengths, int dim, std::vector<std::vector<int>>& indexes)
-{
-    if(dim < dimLengths.size())
-    {
-        std::vector<std::vector<int>> updated_indexes;
-
-        if(dim == 0)
-        {
-            for(int i = 0; i < dimLengths[dim]; i++)
-            {
-                std::vector<int> index = {i};
-
-                updated_indexes.push_back(index);
-            };
-        }
-        else
-        {
-            // go through all the current indexes
-            for(const auto& index : indexes)
-                for(int i = 0; i < dimLengths[dim]; i++)
-                {
-                    auto index_new = index; // explicit copying
-
-                    index_new.push_back(i);
-
-                    updated_indexes.push_back(index_new);
-                };
-        };
-
-        // update to the indexes (output)
-        indexes = updated_indexes;
-
-        // further to construct the indexes from the updated status
-        get_all_indexes(dimLengths, dim + 1, indexes);
-    };
-};
-
-static inline int get_offset_from_index(const std::vector<int>& strides,
-                                        const std::vector<int>& index)
-{
-    int offset = 0;
-
-    assert(index.size() == strides.size());
-    for(int i = 0; i < index.size(); i++)
-        offset += strides[i] * index[i];
-
-    return (offset);
-};
-
-static inline int get_flatten_offset(const std::vector<int>& lengths, const std::vector<int>& index)
-{
-    int offset = 0;
-
-    assert(lengths.size() == index.size() && lengths.size() > 0);
-
-    int len    = lengths.size();
-    int stride = 1;
-
-    // for len==1, the loop is not executed
-    for(int i = len - 1; i > 0; i--)
-    {
-        offset += stride * index[i];
-
-        stride *= lengths[i];
-    };
-
-    offset += stride * index[0];
-
-    return (offset);
-};
-
 template <typename Tgpu, typename Tref>
 class miopenReductionHost
 {
@@ -130,19 +59,15 @@ class miopenReductionHost
         this->inStrides  = GetTensorStrides(inDesc);
         this->outStrides = GetTensorStrides(outDesc);
 
-        this->invariantDims = invariantDims_;
-        this->toReduceDims  = toReduceDims_;
-
         assert(this->inLengths.size() == this->outLengths.size());
-        assert(!this->toReduceDims.empty());
-
-        for(const auto dim : this->invariantDims)
-            this->invariantLengths.push_back(this->inLengths[dim]);
-
-        for(const auto dim : this->toReduceDims)
-            toReduceLengths.push_back(this->inLengths[dim]);
-
-        this->reduceAllDims = this->invariantDims.empty();
+        assert(!toReduceDims_.empty());
+        assert(invariantDims_.size() + toReduceDims_.size() == this->inLengths.size());
+        (void)invariantDims_;
+        (void)toReduceDims_;
+
+        // The reduced dimensions are the ones of length 1 in the output
+        this->plan = cpu_reduce::make_plan(
+            this->inLengths, this->inStrides, this->outLengths, this->outStrides);
     };
 
     ~miopenReductionHost(){};
@@ -179,13 +104,7 @@ class miopenReductionHost
     std::vector<int> inStrides;
     std::vector<int> outStrides;
 
-    std::vector<int> invariantLengths;
-    std::vector<int> toReduceLengths;
-
-    std::vector<int> invariantDims;
-    std::vector<int> toReduceDims;
-
-    bool reduceAllDims;
+    cpu_reduce::plan plan;
 
     template <typename compType>
     void RunImpl(Tgpu alpha, const Tgpu* in_data, Tgpu beta, Tref* out_data, int* indices)
@@ -206,108 +125,22 @@ class miopenReductionHost
     {
         using reduce::ReduceOpFn2;
         using reduce::ReduceOpZeroVal;
-        using reduce::float_equal_one;
-        using reduce::float_equal_zero;
         using reduce::convert_type;
-        using reduce::binop_with_nan_check;
         using reduce::binop_with_nan_check2;
 
         auto opReduce = ReduceOpFn2<compType>(this->reduceOp);
 
-        if(reduceAllDims)
-        {
-            std::vector<std::vector<int>> indexes_1;
-
-            get_all_indexes(inLengths, 0, indexes_1); // generate the input indexes space
-
-            auto accuVal  = ReduceOpZeroVal<compType>(this->reduceOp);
-            int accuIndex = 0;
-
-            // go through indexes of the invariant dimensions
-            for(const auto& src_index : indexes_1)
-            {
-                auto src_offset = get_offset_from_index(this->inStrides, src_index);
-
-                auto currVal = convert_type<compType>(in_data[src_offset]);
-
-                auto currIndex = get_flatten_offset(inLengths, src_index);
-                binop_with_nan_check2(nanOpt, opReduce, accuVal, currVal, accuIndex, currIndex);
-            };
-
-            // scale the accumulated value
-            if(!float_equal_one(alpha))
-                accuVal *= convert_type<compType>(alpha);
-
-            // scale the prior dst value and add it to the accumulated value
-            if(!float_equal_zero(beta))
-                accuVal += convert_type<compType>(out_data[0] * convert_type<Tref>(beta));
-
-            // store the reduced value to dst location
-            out_data[0] = convert_type<Tref>(accuVal);
-            indices[0]  = accuIndex;
-        }
-        else
-        {
-            std::vector<std::vector<int>> indexes_1, indexes_2;
-
-            get_all_indexes(
-                this->invariantLengths, 0, indexes_1); // generate the invariant indexes space
-            get_all_indexes(
-                this->toReduceLengths, 0, indexes_2); // generate the toReduce indexes space
-
-            // go through indexes of the invariant dimensions
-            for(const auto& index_1 : indexes_1)
-            {
-                std::vector<int> src_index;
-                std::vector<int> dst_index;
-
-                src_index.resize(this->inLengths.size());
-                dst_index.resize(this->inLengths.size());
-
-                // initialize the src index
-                std::fill(dst_index.begin(), dst_index.end(), 0);
-
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    dst_index[invariantDims[k]] = index_1[k];
-
-                int dst_offset = get_offset_from_index(this->outStrides, dst_index);
-
-                // generate the part of src index belonging to invariant dims
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    src_index[invariantDims[k]] = index_1[k];
-
-                compType accuVal = ReduceOpZeroVal<compType>(this->reduceOp);
-                int accuIndex    = 0;
-
-                // go through indexes of the toReduce dimensions
-                for(const auto& index_2 : indexes_2)
-                {
-                    // generate the part of src index belonging to toReduce dims
-                    for(int k                      = 0; k < toReduceDims.size(); k++)
-                        src_index[toReduceDims[k]] = index_2[k];
-
-                    auto src_offset = get_offset_from_index(this->inStrides, src_index);
-
-                    auto currVal = convert_type<compType>(in_data[src_offset]);
-
-                    auto currIndex = get_flatten_offset(toReduceLengths, index_2);
-                    binop_with_nan_check2(nanOpt, opReduce, accuVal, currVal, accuIndex, currIndex);
-                };
-
-                // scale the accumulated value
-                if(!float_equal_one(alpha))
-                    accuVal *= convert_type<compType>(alpha);
-
-                // scale the prior dst value and add it to the accumulated value
-                if(!float_equal_zero(beta))
-                    accuVal +=
-                        convert_type<compType>(out_data[dst_offset] * convert_type<Tref>(beta));
-
-                // store the reduced value to dst location
-                out_data[dst_offset] = convert_type<Tref>(accuVal);
-                indices[dst_offset]  = accuIndex;
-            };
-        };
+        cpu_reduce::run(
+            this->plan,
+            ReduceOpZeroVal<compType>(this->reduceOp),
+            [&](size_t src_offset) { return convert_type<compType>(in_data[src_offset]); },
+            [&](cpu_reduce::partial<compType>& accu, compType currVal, int currIndex) {
+                binop_with_nan_check2(nanOpt, opReduce, accu.value, currVal, accu.index, currIndex);
+            },
+            [&](size_t dst_offset, const cpu_reduce::partial<compType>& accu) {
+                StoreScaled<compType>(alpha, beta, accu.value, out_data[dst_offset]);
+                indices[dst_offset] = accu.index;
+            });
     }; // end of RunImpl_with_indices()
 
     template <typename compType>
@@ -315,103 +148,42 @@ class miopenReductionHost
     {
         using reduce::ReduceOpFn;
         using reduce::ReduceOpZeroVal;
-        using reduce::float_equal_one;
-        using reduce::float_equal_zero;
         using reduce::convert_type;
         using reduce::binop_with_nan_check;
-        using reduce::binop_with_nan_check2;
 
         auto opReduce = ReduceOpFn<compType>(this->reduceOp);
 
-        if(reduceAllDims)
-        {
-            std::vector<std::vector<int>> indexes_1;
-
-            get_all_indexes(inLengths, 0, indexes_1); // generate the input indexes space
-
-            auto accuVal = ReduceOpZeroVal<compType>(this->reduceOp);
-
-            // go through indexes of the invariant dimensions
-            for(const auto& src_index : indexes_1)
-            {
-                auto src_offset = get_offset_from_index(this->inStrides, src_index);
-
-                auto currVal = convert_type<compType>(in_data[src_offset]);
-
-                binop_with_nan_check(nanOpt, opReduce, accuVal, currVal);
-            };
-
-            // scale the accumulated value
-            if(!float_equal_one(alpha))
-                accuVal *= convert_type<compType>(alpha);
-
-            // scale the prior dst value and add it to the accumulated value
-            if(!float_equal_zero(beta))
-                accuVal += convert_type<compType>(out_data[0] * convert_type<Tref>(beta));
-
-            // store the reduced value to dst location
-            out_data[0] = convert_type<Tref>(accuVal);
-        }
-        else
-        {
-            std::vector<std::vector<int>> indexes_1, indexes_2;
-
-            get_all_indexes(
-                this->invariantLengths, 0, indexes_1); // generate the invariant indexes space
-            get_all_indexes(
-                this->toReduceLengths, 0, indexes_2); // generate the toReduce indexes space
-
-            // go through indexes of the invariant dimensions
-            for(const auto& index_1 : indexes_1)
-            {
-                std::vector<int> src_index;
-                std::vector<int> dst_index;
-
-                src_index.resize(this->inLengths.size());
-                dst_index.resize(this->inLengths.size());
-
-                // initialize the src index
-                std::fill(dst_index.begin(), dst_index.end(), 0);
-
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    dst_index[invariantDims[k]] = index_1[k];
-
-                int dst_offset = get_offset_from_index(this->outStrides, dst_index);
-
-                // generate the part of src index belonging to invariant dims
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    src_index[invariantDims[k]] = index_1[k];
-
-                compType accuVal = ReduceOpZeroVal<compType>(this->reduceOp);
-
-                // go through indexes of the toReduce dimensions
-                for(const auto& index_2 : indexes_2)
-                {
-                    // generate the part of src index belonging to toReduce dims
-                    for(int k                      = 0; k < toReduceDims.size(); k++)
-                        src_index[toReduceDims[k]] = index_2[k];
-
-                    auto src_offset = get_offset_from_index(this->inStrides, src_index);
-
-                    auto currVal = convert_type<compType>(in_data[src_offset]);
+        cpu_reduce::run(
+            this->plan,
+            ReduceOpZeroVal<compType>(this->reduceOp),
+            [&](size_t src_offset) { return convert_type<compType>(in_data[src_offset]); },
+            [&](cpu_reduce::partial<compType>& accu, compType currVal, int) {
+                binop_with_nan_check(nanOpt, opReduce, accu.value, currVal);
+            },
+            [&](size_t dst_offset, const cpu_reduce::partial<compType>& accu) {
+                StoreScaled<compType>(alpha, beta, accu.value, out_data[dst_offset]);
+            });
+    }; // end of RunImpl_no_indices()
 
-                    binop_with_nan_check(nanOpt, opReduce, accuVal, currVal);
-                };
+    // dst = alpha * accuVal + beta * dst
+    template <typename compType>
+    static void StoreScaled(Tgpu alpha, Tgpu beta, compType accuVal, Tref& dst)
+    {
+        using reduce::float_equal_one;
+        using reduce::float_equal_zero;
+        using reduce::convert_type;
 
-                // scale the accumulated value
-                if(!float_equal_one(alpha))
-                    accuVal *= convert_type<compType>(alpha);
+        // scale the accumulated value
+        if(!float_equal_one(alpha))
+            accuVal *= convert_type<compType>(alpha);
 
-                // scale the prior dst value and add it to the accumulated value
-                if(!float_equal_zero(beta))
-                    accuVal +=
-                        convert_type<compType>(out_data[dst_offset] * convert_type<Tref>(beta));
+        // scale the prior dst value and add it to the accumulated value
+        if(!float_equal_zero(beta))
+            accuVal += convert_type<compType>(dst * convert_type<Tref>(beta));
 
-                // store the reduced value to dst location
-                out_data[dst_offset] = convert_type<Tref>(accuVal);
-            };
-        };
-    }; // end of RunImpl_no_indices()
+        // store the reduced value to dst location
+        dst = convert_type<Tref>(accuVal);
+    };
 };
 
 #endif
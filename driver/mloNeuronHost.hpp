@@ -32,11 +32,16 @@
 #pragma clang diagnostic ignored "-Wfloat-equal"
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <vector>
 
 #include "miopen/float_equal.hpp"
+#include <miopen/par_for.hpp>
+
+#include "../test/cpu_activ.hpp"
 
 ////////////////////////////////////////////////////////////
 //
@@ -56,14 +61,26 @@
 #define MIOPEN_NEURON_TOTAL 10
 #endif
 
-const float kBNLL_THRESHOLD = 50.;
-
 template <typename T>
 T calculate_relative_error(T uref, T u)
 {
     return std::abs(u - uref) / std::max(std::numeric_limits<T>::epsilon(), std::abs(uref));
 }
 
+// Host activation in blocks of this many elements, one block per task. The
+// blocks run the vectorized loops of cpu_activ.
+const size_t kNeuronHostBlock = 4096;
+
+template <typename F>
+void mloNeuronRunBlocks(size_t size, F f)
+{
+    const size_t n_blocks = (size + kNeuronHostBlock - 1) / kNeuronHostBlock;
+    miopen::par_for(n_blocks, miopen::min_grain{1}, [&](size_t blk) {
+        const size_t begin = blk * kNeuronHostBlock;
+        f(begin, std::min(kNeuronHostBlock, size - begin));
+    });
+}
+
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloNeuronForwardRunHostAndVerify(int neuron_type,
@@ -75,57 +92,19 @@ int mloNeuronForwardRunHostAndVerify(int neuron_type,
                                      const _Tgpu* top_ptr,
                                      _Tcheck allowedEps)
 {
+    if(neuron_type < MIOPEN_NEURON_PASTHRU || neuron_type >= MIOPEN_NEURON_TOTAL)
+        printf("ERROR: unknown neuron type: %d\n", neuron_type);
 
-    int match      = 1;
-    _Tcheck* c_res = new _Tcheck[size];
-    _Tcheck* data  = new _Tcheck[size];
-    for(size_t k = 0; k < size; k++)
-        data[k]  = static_cast<_Tcheck>(bot_ptr[k]);
+    int match = 1;
+    std::vector<_Tcheck> c_res(size);
+    const cpu_activ::params p{static_cast<miopenActivationMode_t>(neuron_type),
+                              static_cast<double>(alpha),
+                              static_cast<double>(beta),
+                              static_cast<double>(gamma)};
 
-    std::function<_Tcheck(_Tcheck)> f;
-
-    switch(neuron_type)
-    {
-    case MIOPEN_NEURON_PASTHRU: //	x
-        f = [=](_Tcheck x) { return x; };
-        break;
-    case MIOPEN_NEURON_LOGISTIC: //	1 / (1 + e^-x)	//Sigmoid
-        f = [=](_Tcheck x) { return 1 / (1 + std::exp(-x)); };
-        break;
-    case MIOPEN_NEURON_TANH: //	beta * tanh(alpha * x)
-        f = [=](_Tcheck x) { return beta * std::tanh(alpha * x); };
-        break;
-    case MIOPEN_NEURON_RELU: //	max(0, x)
-        f = [=](_Tcheck x) { return (x > 0) ? x : 0; };
-        break;
-    case MIOPEN_NEURON_SOFTRELU: //	log(1 + e^x)   // bonomial normal log likelihood
-        f = [=](_Tcheck x) {
-            return (x > 0.) ? (x + std::log1p(std::exp(-x))) : (std::log1p(std::exp(x)));
-        };
-        break;
-    case MIOPEN_NEURON_ABS: //	abs(x)
-        f = [=](_Tcheck x) { return std::abs(x); };
-        break;
-    case MIOPEN_NEURON_POWER: // (alpha + beta * x) ^ gamma
-        f = [=](_Tcheck x) {
-            _Tcheck v = alpha + beta * x;
-            return v <= std::numeric_limits<_Tcheck>::epsilon() ? 0 : pow(v, gamma);
-        };
-        break;
-    case MIOPEN_NEURON_CLIPPED_RELU: // min(alpha, max(0, x))
-        f = [=](_Tcheck x) { return std::min(alpha, std::max(_Tcheck(0), x)); };
-        break;
-    case MIOPEN_NEURON_LEAKY_RELU: // alpha * x | x<=0; x | x>0
-        f = [=](_Tcheck x) { return (x > 0) ? x : x * alpha; };
-        break;
-    case MIOPEN_NEURON_ELU: // alpah * (exp(x)-1) | x<=0; x | x>0
-        f = [=](_Tcheck x) { return (x > 0) ? x : alpha * std::expm1(x); };
-        break;
-    default: printf("ERROR: unknown neuron type: %d\n", neuron_type); break;
-    }
-
-    for(size_t i = 0; i < size; i++)
-        c_res[i] = f(data[i]);
+    mloNeuronRunBlocks(size, [&](size_t begin, size_t len) {
+        cpu_activ::forward(p, len, bot_ptr + begin, c_res.data() + begin);
+    });
 
     for(size_t i = 0; i < size && match; i++)
     {
@@ -138,22 +117,13 @@ int mloNeuronForwardRunHostAndVerify(int neuron_type,
            !std::isfinite(c_val) || !std::isfinite(g_val))
         {
             std::cout << "Difference in neuron layer: " << err << " too large at " << i
-                      << " x = " << data[i] << " "
+                      << " x = " << static_cast<_Tcheck>(bot_ptr[i]) << " "
                       << " c_v = " << c_val << " vs g_val = " << g_val
                       << " tolerance = " << allowedEps << std::endl;
             match = 0;
         }
     }
 
-    if(c_res)
-    {
-        delete[] c_res;
-    }
-    if(data)
-    {
-        delete[] data;
-    }
-
     return (match);
 }
 
@@ -170,66 +140,24 @@ int mloNeuronBackwardRunHostAndVerify(int neuron_type,
                                       const _Tgpu* top_df_ptr,
                                       _Tcheck allowedEps)
 {
-
-    int match           = 1;
-    _Tcheck* bot_cpu    = new _Tcheck[size];
-    _Tcheck* top_cpu    = new _Tcheck[size];
-    _Tcheck* bot_df_cpu = new _Tcheck[size];
-    _Tcheck* top_df_cpu = new _Tcheck[size];
-
-    for(size_t k = 0; k < size; k++)
-    {
-        bot_cpu[k]    = static_cast<_Tcheck>(bot_ptr[k]);
-        top_cpu[k]    = static_cast<_Tcheck>(top_ptr[k]);
-        top_df_cpu[k] = static_cast<_Tcheck>(top_df_ptr[k]);
-    }
-
-    std::function<_Tcheck(_Tcheck, _Tcheck, _Tcheck)> f;
-
-    switch(neuron_type)
-    {
-    case MIOPEN_NEURON_PASTHRU: //	x
-        f = [=](_Tcheck dy, _Tcheck, _Tcheck) { return dy; };
-        break;
-    case MIOPEN_NEURON_LOGISTIC: //	1 / (1 + e^-x)	//Sigmoid
-        f = [=](_Tcheck dy, _Tcheck, _Tcheck y) { return dy * y * (1 - y); };
-        break;
-    case MIOPEN_NEURON_TANH: //	beta * tanh(alpha * x)
-        f = [=](_Tcheck dy, _Tcheck, _Tcheck y) { return dy * alpha * (beta - y * y / beta); };
-        break;
-    case MIOPEN_NEURON_RELU: //	max(0, x)
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck) { return (x > 0) ? dy : 0; };
-        break;
-    case MIOPEN_NEURON_SOFTRELU: //	log(1 + e^x)   // bonomial normal log likelihood
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck) {
-            _Tcheck threshold = kBNLL_THRESHOLD;
-            _Tcheck expval    = std::exp(std::min(x, threshold));
-            return dy * expval / (expval + 1.0);
-        };
-        break;
-    case MIOPEN_NEURON_ABS: //	abs(x)
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck) { return dy * ((x > 0) ? 1 : -1); };
-        break;
-    case MIOPEN_NEURON_POWER: // (alpha + beta * x) ^ gamma
-        f = [=](_Tcheck, _Tcheck x, _Tcheck y) {
-            _Tcheck v = alpha + beta * x;
-            return v <= std::numeric_limits<_Tcheck>::epsilon() ? 0 : gamma * beta * y / v;
-        };
-        break;
-    case MIOPEN_NEURON_CLIPPED_RELU: // min(alpha, max(0, x))
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck) { return (x > 0 && x < alpha) ? dy : 0; };
-        break;
-    case MIOPEN_NEURON_LEAKY_RELU: // alpha * x | x<=0; x | x>0
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck) { return dy * ((x > 0) ? 1 : alpha); };
-        break;
-    case MIOPEN_NEURON_ELU: // alpah * (exp(x)-1) | x<=0; x | x>0
-        f = [=](_Tcheck dy, _Tcheck x, _Tcheck y) { return dy * ((x > 0) ? 1 : y + alpha); };
-        break;
-    default: printf("ERROR: unknown neuron type: %d\n", neuron_type); break;
-    }
-
-    for(size_t i      = 0; i < size; i++)
-        bot_df_cpu[i] = f(top_df_cpu[i], bot_cpu[i], top_cpu[i]);
+    if(neuron_type < MIOPEN_NEURON_PASTHRU || neuron_type >= MIOPEN_NEURON_TOTAL)
+        printf("ERROR: unknown neuron type: %d\n", neuron_type);
+
+    int match = 1;
+    std::vector<_Tcheck> bot_df_cpu(size);
+    const cpu_activ::params p{static_cast<miopenActivationMode_t>(neuron_type),
+                              static_cast<double>(alpha),
+                              static_cast<double>(beta),
+                              static_cast<double>(gamma)};
+
+    mloNeuronRunBlocks(size, [&](size_t begin, size_t len) {
+        cpu_activ::backward(p,
+                            len,
+                            top_df_ptr + begin,
+                            bot_ptr + begin,
+                            top_ptr + begin,
+                            bot_df_cpu.data() + begin);
+    });
 
     for(size_t i = 0; i < size && match; ++i)
     {
@@ -242,21 +170,15 @@ int mloNeuronBackwardRunHostAndVerify(int neuron_type,
            !std::isfinite(c_val) || !std::isfinite(g_val))
         {
             std::cout << "Difference in neuron back-propagation: " << err << " too large at " << i
-                      << " dy = " << top_df_cpu[i] << " x = " << bot_cpu[i] << " y = " << top_cpu[i]
-                      << " "
+                      << " dy = " << static_cast<_Tcheck>(top_df_ptr[i])
+                      << " x = " << static_cast<_Tcheck>(bot_ptr[i])
+                      << " y = " << static_cast<_Tcheck>(top_ptr[i]) << " "
                       << " c_v = " << c_val << " vs g_val = " << g_val
                       << " tolerance = " << allowedEps << std::endl;
             match = 0;
         }
     }
 
-    if(bot_df_cpu)
-    {
-        delete[] bot_cpu;
-        delete[] top_cpu;
-        delete[] bot_df_cpu;
-        delete[] top_df_cpu;
-    }
     return (match);
 }
 
@@ -27,8 +27,13 @@
 #ifndef MLO_NORMHOST_H_
 #define MLO_NORMHOST_H_
 
+#include <miopen/par_for.hpp>
+
 #include <cmath>
 #include <iomanip>
+#include <vector>
+
+#include "../test/cpu_lrn.hpp"
 
 ////////////////////////////////////////////////////////////
 //
@@ -39,6 +44,16 @@
 #define MLO_LRN_ACROSS_CHANNELS 1
 #endif
 
+// Number of window positions along one axis of the within channel LRN, the
+// window is clipped at the end of the axis plus the padding only.
+inline int mloLRNWindowSize(int i, int size, int lo, int hi)
+{
+    return std::min(lo + hi + 1, size - i + lo + hi);
+}
+
+// The window of the output (or input gradient) i covers [i - lo, i + hi]. The
+// sums are computed with sliding windows, across channels for one image row
+// at a time, within channel for one plane at a time, in parallel.
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
           typename _Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloLRNForwardRunHost(bool do_scale,
@@ -77,188 +92,81 @@ int mloLRNForwardRunHost(bool do_scale,
         return -1;
     }
 
+    const int lo = local_area - 1 - pad;
+    const int hi = pad;
+
+    const auto bot = [&](int b, int c, int j, int i) {
+        return static_cast<double>(
+            bot_ptr[b * bot_batch_stride + c * bot_channel_stride + j * bot_stride + i]);
+    };
+    const auto store = [&](int b, int o, int j, int i, _Tcheck scale) {
+        if(do_scale)
+        {
+            scale_v_ptr[b * scale_v_batch_stride + o * scale_v_channel_stride +
+                        j * scale_v_stride + i] = scale;
+        }
+        const _Tcheck bot_val = o < n_inputs ? static_cast<_Tcheck>(bot(b, o, j, i)) : 0;
+        top_v_ptr[b * top_v_batch_stride + o * top_v_channel_stride + j * top_v_stride + i] =
+            bot_val * pow(scale, -beta);
+    };
+
     if(norm_region == MLO_LRN_ACROSS_CHANNELS)
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int j = 0; j < top_height; j++)
+        // The window runs over n_inputs channels padded to n_outputs.
+        const int n_lines = std::max(n_inputs, n_outputs);
+        miopen::par_for(n_batchs * top_height, miopen::min_grain{1}, [&](int bj) {
+            const int b = bj / top_height;
+            const int j = bj % top_height;
+            std::vector<double> sqr(n_lines * top_width, 0.0);
+            std::vector<double> sums(n_lines * top_width);
+            for(int c = 0; c < n_inputs; c++)
             {
                 for(int i = 0; i < top_width; i++)
                 {
-                    // c-emulator
-                    _Tcheck accum_scale = _Tcheck{0};
-                    int head            = 0;
-                    _Tcheck bot_val;
-                    while(head < pad)
-                    {
-                        bot_val = (head < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    head * bot_channel_stride + j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale += bot_val * bot_val;
-                        ++head;
-                    }
-                    // until we reach size, nothing needs to be subtracted
-                    while(head < local_area)
-                    {
-                        bot_val = (head < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    head * bot_channel_stride + j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale += bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        bot_val =
-                            ((head - pad) >= 0 && (head - pad) < n_inputs)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck s     = pow(scale, -beta);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
-                    }
-                    // both add and subtract
-                    while(head < n_inputs)
-                    {
-                        bot_val = static_cast<_Tcheck>(
-                            bot_ptr[b * bot_batch_stride + head * bot_channel_stride +
-                                    j * bot_stride + i]);
-                        accum_scale += bot_val * bot_val;
-                        bot_val = ((head - local_area) >= 0)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    (head - local_area) * bot_channel_stride +
-                                                    j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale -= bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        _Tcheck s = pow(scale, -beta);
-                        bot_val =
-                            ((head - pad) >= 0)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
-                    }
-                    // subtract only
-                    while(head < n_inputs + pad)
-                    {
-                        bot_val = ((head - local_area) >= 0 && (head - local_area) < n_inputs)
-                                      ? static_cast<_Tcheck>(
-                                            bot_ptr[b * bot_batch_stride +
-                                                    (head - local_area) * bot_channel_stride +
-                                                    j * bot_stride + i])
-                                      : static_cast<_Tcheck>(0);
-                        accum_scale -= bot_val * bot_val;
-                        _Tcheck scale = K + accum_scale * alphaoverarea;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs && do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride +
-                                        (head - pad) * scale_v_channel_stride + j * scale_v_stride +
-                                        i] = scale;
-                        }
-                        bot_val =
-                            ((head - pad) >= 0 && (head - pad) < n_inputs)
-                                ? static_cast<_Tcheck>(bot_ptr[b * bot_batch_stride +
-                                                               (head - pad) * bot_channel_stride +
-                                                               j * bot_stride + i])
-                                : static_cast<_Tcheck>(0);
-                        _Tcheck s     = pow(scale, -beta);
-                        _Tcheck c_val = bot_val * s;
-                        if((head - pad) >= 0 && (head - pad) < n_outputs)
-                        {
-                            top_v_ptr[b * top_v_batch_stride + (head - pad) * top_v_channel_stride +
-                                      j * top_v_stride + i] = c_val;
-                        }
-                        ++head;
-                    }
+                    const auto bot_val     = bot(b, c, j, i);
+                    sqr[c * top_width + i] = bot_val * bot_val;
+                }
+            }
+            cpu_lrn::sliding_sums(n_lines, top_width, lo, hi, sqr.data(), sums.data());
 
-                } // for (int i = 0; i < top_width; i++)
-            }     // for (int j = 0; j < top_height; j++)
-        }         // for (int b = 0; b < batch; b++)
+            for(int o = 0; o < n_outputs; o++)
+            {
+                for(int i = 0; i < top_width; i++)
+                {
+                    const auto accum = static_cast<_Tcheck>(sums[o * top_width + i]);
+                    store(b, o, j, i, K + accum * alphaoverarea);
+                }
+            }
+        });
     }
     else
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int o = 0; o < n_outputs; o++)
+        miopen::par_for(n_batchs * n_outputs, miopen::min_grain{1}, [&](int bo) {
+            const int b = bo / n_outputs;
+            const int o = bo % n_outputs;
+            std::vector<double> sqr(bot_height * bot_width);
+            std::vector<double> sums(bot_height * bot_width);
+            for(int j = 0; j < bot_height; j++)
             {
-                for(int j = 0; j < top_height; j++)
+                for(int i = 0; i < bot_width; i++)
                 {
-                    for(int i = 0; i < top_width; i++)
-                    {
-                        // c-emulator
-                        _Tcheck scale     = static_cast<_Tcheck>(0);
-                        int hstart        = j - (local_area - 1 - pad);
-                        int wstart        = i - (local_area - 1 - pad);
-                        int hend          = std::min(hstart + local_area, bot_height + pad);
-                        int wend          = std::min(wstart + local_area, bot_width + pad);
-                        int adj_area_size = (hend - hstart) * (wend - wstart);
-                        hstart            = std::max(hstart, 0);
-                        wstart            = std::max(wstart, 0);
-                        hend              = std::min(hend, bot_height);
-                        wend              = std::min(wend, bot_width);
-                        _Tcheck accum     = static_cast<_Tcheck>(0);
-                        for(int h = hstart; h < hend; ++h)
-                        {
-                            for(int w = wstart; w < wend; ++w)
-                            {
-
-                                _Tcheck bot_val = static_cast<_Tcheck>(
-                                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride +
-                                            h * bot_stride + w]);
-                                accum += bot_val * bot_val;
-                            }
-                        }
-
-                        alphaoverarea = alpha / adj_area_size;
-                        scale         = K + accum * alphaoverarea;
-                        if(do_scale)
-                        {
-                            scale_v_ptr[b * scale_v_batch_stride + o * scale_v_channel_stride +
-                                        j * scale_v_stride + i] = scale;
-                        }
-
-                        _Tcheck s       = pow(scale, -beta);
-                        _Tcheck bot_val = static_cast<_Tcheck>(
-                            bot_ptr[b * bot_batch_stride + o * bot_channel_stride + j * bot_stride +
-                                    i]);
-                        _Tcheck c_val = bot_val * s;
-
-                        top_v_ptr[b * top_v_batch_stride + o * top_v_channel_stride +
-                                  j * top_v_stride + i] = c_val;
+                    const auto bot_val     = bot(b, o, j, i);
+                    sqr[j * bot_width + i] = bot_val * bot_val;
+                }
+            }
+            cpu_lrn::box_sums(bot_height, bot_width, lo, hi, sqr.data(), sums.data());
 
-                    } // for (int i = 0; i < top_width; i++)
-                }     // for (int j = 0; j < top_height; j++)
-            }         // for (int o = 0; o < outputs; o++)
-        }             // for (int b = 0; b < batch; b++)
-    }                 // (norm_region == ACROSS_CHANNELS)
+            for(int j = 0; j < top_height; j++)
+            {
+                for(int i = 0; i < top_width; i++)
+                {
+                    const int adj_area_size = mloLRNWindowSize(j, bot_height, lo, hi) *
+                                              mloLRNWindowSize(i, bot_width, lo, hi);
+                    store(b, o, j, i, K + sums[j * bot_width + i] * alpha / adj_area_size);
+                }
+            }
+        });
+    } // (norm_region == ACROSS_CHANNELS)
 
     return (ret);
 }
@@ -310,257 +218,84 @@ int mloLRNBackwardRunHost(int norm_region,
         return -1;
     }
 
+    const int lo = pad;
+    const int hi = pre_pad;
+
+    const auto top_df = [&](int b, int c, int j, int i) {
+        return static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride + c * top_df_channel_stride +
+                                               j * top_df_stride + i]);
+    };
+    const auto scale = [&](int b, int c, int j, int i) {
+        return static_cast<_Tcheck>(
+            scale_ptr[b * scale_batch_stride + c * scale_channel_stride + j * scale_stride + i]);
+    };
+    const auto ratio = [&](int b, int c, int j, int i) {
+        return static_cast<double>(
+            top_df(b, c, j, i) *
+            static_cast<_Tcheck>(
+                top_ptr[b * top_batch_stride + c * top_channel_stride + j * top_stride + i]) /
+            scale(b, c, j, i));
+    };
+    const auto store = [&](int b, int o, int j, int i, _Tcheck ratio_dta_bwd, double accum_ratio) {
+        bot_df_v_ptr[b * bot_df_v_batch_stride + o * bot_df_v_channel_stride +
+                     j * bot_df_v_stride + i] =
+            top_df(b, o, j, i) * pow(scale(b, o, j, i), negative_beta) -
+            ratio_dta_bwd *
+                static_cast<_Tcheck>(
+                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride + j * bot_stride + i]) *
+                static_cast<_Tcheck>(accum_ratio);
+    };
+
     if(norm_region == MLO_LRN_ACROSS_CHANNELS)
     {
 
         _Tcheck ratio_dta_bwd =
             static_cast<_Tcheck>(2.) * alpha * beta / static_cast<_Tcheck>(local_area);
 
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int j = 0; j < bot_height; j++)
+        miopen::par_for(n_batchs * bot_height, miopen::min_grain{1}, [&](int bj) {
+            const int b = bj / bot_height;
+            const int j = bj % bot_height;
+            std::vector<double> ratios(n_inputs * bot_width);
+            std::vector<double> sums(n_inputs * bot_width);
+            for(int c = 0; c < n_inputs; c++)
             {
                 for(int i = 0; i < bot_width; i++)
-                {
-
-                    // c-emulator
-                    int head            = 0;
-                    _Tcheck accum_ratio = static_cast<_Tcheck>(0);
-
-                    // accumulate values
-                    while(head < pre_pad)
-                    {
-                        if(head < n_inputs)
-                        {
-                            _Tcheck adder =
-                                (static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                 head * top_df_channel_stride +
-                                                                 j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio += adder;
-                        }
-
-                        ++head;
-                    }
-
-                    // until we reach size, nothing needs to be subtracted
-                    while(head < local_area)
-                    {
-
-                        if(head < n_inputs)
-                        {
-                            _Tcheck adder =
-                                (static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                 head * top_df_channel_stride +
-                                                                 j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio += adder;
-                        }
-
-                        if(head - pre_pad >= 0 && head - pre_pad < n_inputs)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pre_pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pre_pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pre_pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd * static_cast<_Tcheck>(
-                                                    bot_ptr[b * bot_batch_stride +
-                                                            (head - pre_pad) * bot_channel_stride +
-                                                            j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-                        ++head;
-                    }
-
-                    // both add and subtract
-                    while(head < n_inputs)
-                    {
-
-                        _Tcheck adder =
-                            static_cast<_Tcheck>(
-                                top_df_ptr[b * top_df_batch_stride + head * top_df_channel_stride +
-                                           j * top_df_stride + i]) *
-                            static_cast<_Tcheck>(
-                                top_ptr[b * top_batch_stride + head * top_channel_stride +
-                                        j * top_stride + i]) /
-                            static_cast<_Tcheck>(
-                                scale_ptr[b * scale_batch_stride + head * scale_channel_stride +
-                                          j * scale_stride + i]);
-
-                        accum_ratio += adder;
-
-                        if(head - local_area >= 0)
-                        {
-                            _Tcheck subs =
-                                (static_cast<_Tcheck>(
-                                     top_df_ptr[b * top_df_batch_stride +
-                                                (head - local_area) * top_df_channel_stride +
-                                                j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride +
-                                             (head - local_area) * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride +
-                                              (head - local_area) * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio -= subs;
-                        }
-                        if(head - pre_pad >= 0)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pre_pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pre_pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pre_pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd * static_cast<_Tcheck>(
-                                                    bot_ptr[b * bot_batch_stride +
-                                                            (head - pre_pad) * bot_channel_stride +
-                                                            j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-
-                        ++head;
-                    }
-                    // subtract only
-                    while(head < n_inputs + pre_pad)
-                    {
-                        if(head - local_area >= 0 && head - local_area < n_inputs)
-                        {
-                            _Tcheck subs =
-                                (static_cast<_Tcheck>(
-                                     top_df_ptr[b * top_df_batch_stride +
-                                                (head - local_area) * top_df_channel_stride +
-                                                j * top_df_stride + i]) *
-                                 static_cast<_Tcheck>(
-                                     top_ptr[b * top_batch_stride +
-                                             (head - local_area) * top_channel_stride +
-                                             j * top_stride + i])) /
-                                static_cast<_Tcheck>(
-                                    scale_ptr[b * scale_batch_stride +
-                                              (head - local_area) * scale_channel_stride +
-                                              j * scale_stride + i]);
-
-                            accum_ratio -= subs;
-                        }
-                        if(head - pre_pad >= 0 && head - pre_pad < n_inputs)
-                        {
-                            bot_df_v_ptr[b * bot_df_v_batch_stride +
-                                         (head - pre_pad) * bot_df_v_channel_stride +
-                                         j * bot_df_v_stride + i] =
-                                static_cast<_Tcheck>(
-                                    top_df_ptr[b * top_df_batch_stride +
-                                               (head - pre_pad) * top_df_channel_stride +
-                                               j * top_df_stride + i]) *
-                                    pow(static_cast<_Tcheck>(
-                                            scale_ptr[b * scale_batch_stride +
-                                                      (head - pre_pad) * scale_channel_stride +
-                                                      j * scale_stride + i]),
-                                        negative_beta) -
-                                ratio_dta_bwd * static_cast<_Tcheck>(
-                                                    bot_ptr[b * bot_batch_stride +
-                                                            (head - pre_pad) * bot_channel_stride +
-                                                            j * bot_stride + i]) *
-                                    accum_ratio;
-                        }
-
-                        ++head;
-                    }
+                    ratios[c * bot_width + i] = ratio(b, c, j, i);
+            }
+            cpu_lrn::sliding_sums(n_inputs, bot_width, lo, hi, ratios.data(), sums.data());
 
-                } // for (int i = 0; i < bot_width; i++)
-            }     // for (int j = 0; j < bot_height; j++)
-        }         // for (int b = 0; b < n_batchs; b++)
-    }             // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
+            for(int o = 0; o < n_inputs; o++)
+            {
+                for(int i = 0; i < bot_width; i++)
+                    store(b, o, j, i, ratio_dta_bwd, sums[o * bot_width + i]);
+            }
+        });
+    } // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
     else
     {
-        for(int b = 0; b < n_batchs; b++)
-        {
-            for(int o = 0; o < n_inputs; o++)
+        miopen::par_for(n_batchs * n_inputs, miopen::min_grain{1}, [&](int bo) {
+            const int b = bo / n_inputs;
+            const int o = bo % n_inputs;
+            std::vector<double> ratios(top_height * top_width);
+            std::vector<double> sums(top_height * top_width);
+            for(int j = 0; j < top_height; j++)
             {
-                for(int j = 0; j < bot_height; j++)
-                {
-
-                    for(int i = 0; i < bot_width; i++)
-                    {
-                        _Tcheck accum_ratio = static_cast<_Tcheck>(0);
-
-                        int hstart        = j - pad;
-                        int wstart        = i - pad;
-                        int hend          = std::min(hstart + local_area, top_height + pre_pad);
-                        int wend          = std::min(wstart + local_area, top_width + pre_pad);
-                        int adj_area_size = (hend - hstart) * (wend - wstart);
-                        hstart            = std::max(hstart, 0);
-                        wstart            = std::max(wstart, 0);
-                        hend              = std::min(hend, top_height);
-                        wend              = std::min(wend, top_width);
-                        for(int h = hstart; h < hend; ++h)
-                        {
-                            for(int w = wstart; w < wend; ++w)
-                            {
-                                _Tcheck adder =
-                                    static_cast<_Tcheck>(top_df_ptr[b * top_df_batch_stride +
-                                                                    o * top_df_channel_stride +
-                                                                    h * top_df_stride + w]) *
-                                    static_cast<_Tcheck>(
-                                        top_ptr[b * top_batch_stride + o * top_channel_stride +
-                                                h * top_stride + w]) /
-                                    static_cast<_Tcheck>(
-                                        scale_ptr[b * scale_batch_stride +
-                                                  o * scale_channel_stride + h * scale_stride + w]);
-
-                                accum_ratio += adder;
-                            }
-                        }
-
-                        _Tcheck ratio_dta_bwd = static_cast<_Tcheck>(2.) * alpha * beta /
-                                                static_cast<_Tcheck>(adj_area_size);
+                for(int i = 0; i < top_width; i++)
+                    ratios[j * top_width + i] = ratio(b, o, j, i);
+            }
+            cpu_lrn::box_sums(top_height, top_width, lo, hi, ratios.data(), sums.data());
 
-                        bot_df_v_ptr[b * bot_df_v_batch_stride + o * bot_df_v_channel_stride +
-                                     j * bot_df_v_stride + i] =
-                            static_cast<_Tcheck>(
-                                top_df_ptr[b * top_df_batch_stride + o * top_df_channel_stride +
-                                           j * top_df_stride + i]) *
-                                pow(static_cast<_Tcheck>(
-                                        scale_ptr[b * scale_batch_stride +
-                                                  o * scale_channel_stride + j * scale_stride + i]),
-                                    negative_beta) -
-                            ratio_dta_bwd *
-                                static_cast<_Tcheck>(
-                                    bot_ptr[b * bot_batch_stride + o * bot_channel_stride +
-                                            j * bot_stride + i]) *
-                                accum_ratio;
-                    }
+            for(int j = 0; j < bot_height; j++)
+            {
+                for(int i = 0; i < bot_width; i++)
+                {
+                    const int adj_area_size  = mloLRNWindowSize(j, top_height, lo, hi) *
+                                               mloLRNWindowSize(i, top_width, lo, hi);
+                    const auto ratio_dta_bwd = 2 * alpha * beta / adj_area_size;
+                    store(b, o, j, i, ratio_dta_bwd, sums[j * top_width + i]);
                 }
             }
-        }
+        });
 
     } // if (norm_region == MLO_LRN_ACROSS_CHANNELS)
 
@@ -32,11 +32,16 @@
 #pragma clang diagnostic ignored "-Wfloat-equal"
 #endif
 
+#include <miopen/par_for.hpp>
+
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <iomanip>
+#include <mutex>
 
 #include "calcerr.hpp"
+#include "../test/cpu_pooling.hpp"
 
 #if 0
 template<typename _T>
@@ -112,158 +117,173 @@ bool mloPoolingForwardRunHostAndVerify(int pooling_method,
                                        _Tcheck allowedEps,
                                        int index_position = 1)
 {
-
-    bool match = true;
+    if(pooling_method != MLO_POOLING_OP_MAX && pooling_method != MLO_POOLING_OP_AVE &&
+       pooling_method != MLO_POOLING_OP_AVE_INCLUSIVE)
+    {
+        std::cout << "ERROR: unknown operator : layer: pooling." << std::endl;
+        return false;
+    }
+    const bool is_max = pooling_method == MLO_POOLING_OP_MAX;
+
+    // The windows of a plane are reduced with sliding windows, see cpu_pooling.hpp.
+    const std::vector<std::size_t> bot_lens = {static_cast<std::size_t>(n_batchs),
+                                               static_cast<std::size_t>(n_outputs),
+                                               static_cast<std::size_t>(bot_depth),
+                                               static_cast<std::size_t>(bot_height),
+                                               static_cast<std::size_t>(bot_width)};
+    const std::vector<std::size_t> bot_strides = {static_cast<std::size_t>(bot_batch_stride),
+                                                  static_cast<std::size_t>(bot_channel_stride),
+                                                  static_cast<std::size_t>(bot_depth_stride),
+                                                  static_cast<std::size_t>(bot_stride),
+                                                  1};
+    const std::vector<std::size_t> top_lens = {static_cast<std::size_t>(n_batchs),
+                                               static_cast<std::size_t>(n_outputs),
+                                               static_cast<std::size_t>(top_depth),
+                                               static_cast<std::size_t>(top_height),
+                                               static_cast<std::size_t>(top_width)};
+    const std::vector<std::size_t> top_strides = {static_cast<std::size_t>(top_batch_stride),
+                                                  static_cast<std::size_t>(top_channel_stride),
+                                                  static_cast<std::size_t>(top_depth_stride),
+                                                  static_cast<std::size_t>(top_stride),
+                                                  1};
+    const auto pb = cpu_pooling::make_problem(
+        is_max ? miopenPoolingMax
+               : pooling_method == MLO_POOLING_OP_AVE ? miopenPoolingAverage
+                                                      : miopenPoolingAverageInclusive,
+        bot_lens,
+        bot_strides,
+        top_lens,
+        top_strides,
+        std::vector<int>{filter_size_d, filter_size_h, filter_size_w},
+        std::vector<int>{pool_stride_d, pool_stride_h, pool_stride_w},
+        std::vector<int>{pad_d, pad_h, pad_w});
+
+    // The planes are checked in parallel, the first mismatch stops the others.
+    std::atomic<bool> match{true};
+    std::mutex log_mutex;
     _Tcheck MAX_VAL(3.402823466e+38);
     _Tgpu G_MAX_VAL = (sizeof(_Tgpu) == 4 || sizeof(_Tgpu) == 8)
                           ? static_cast<_Tgpu>(3.402823466e+38)
                           : static_cast<_Tgpu>(65504);
-    // c-emulator
-    _Tcheck res = static_cast<_Tcheck>(0);
 
-    for(int b = 0; b < n_batchs && match; b++)
-    {
-        for(int o = 0; o < n_outputs && match; o++)
+    miopen::par_for(n_batchs * n_outputs, miopen::min_grain{1}, [&](int bo) {
+        const int b = bo / n_outputs;
+        const int o = bo % n_outputs;
+        if(!match)
+            return;
+
+        const auto pooled = cpu_pooling::pool_plane(pb, bo, bot_ptr, is_max);
+        std::size_t p     = 0;
+        for(int k = 0; k < top_depth && match; k++)
         {
-            for(int k = 0; k < top_depth && match; k++)
+            for(int j = 0; j < top_height && match; j++)
             {
-                for(int j = 0; j < top_height && match; j++)
+                for(int i = 0; i < top_width && match; i++, p++)
                 {
-                    for(int i = 0; i < top_width && match; i++)
+                    int dstart = k * pool_stride_d - pad_d;
+                    int hstart = j * pool_stride_h - pad_h;
+                    int wstart = i * pool_stride_w - pad_w;
+                    int dend   = std::min(dstart + filter_size_d, bot_depth);
+                    int hend   = std::min(hstart + filter_size_h, bot_height);
+                    int wend   = std::min(wstart + filter_size_w, bot_width);
+                    dstart     = std::max(dstart, 0);
+                    hstart     = std::max(hstart, 0);
+                    wstart     = std::max(wstart, 0);
+
+                    int pool_size;
+                    if(pooling_method == MLO_POOLING_OP_AVE)
+                        pool_size = (dend - dstart) * (hend - hstart) * (wend - wstart);
+                    else
+                        pool_size = filter_size_w * filter_size_h * filter_size_d;
+                    pool_size     = (pool_size == 0) ? 1 : pool_size;
+
+                    _Tcheck res          = static_cast<_Tcheck>(pooled.values[p]);
+                    size_t res_index     = 0;
+                    size_t res_index_gpu = 0;
+                    // The first maximum in the scan order, when it is above -MAX_VAL.
+                    const bool found = is_max && res > -MAX_VAL;
+                    if(found)
                     {
-                        // c-emulator
-                        if(pooling_method == MLO_POOLING_OP_MAX)
-                        {
-                            res = -MAX_VAL;
-                        }
-                        else if(pooling_method == MLO_POOLING_OP_AVE ||
-                                pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
-                        {
-                            res = static_cast<_Tcheck>(0);
-                        }
+                        const auto arg = pooled.args[p];
+                        const int d    = arg / (bot_height * bot_width);
+                        const int h    = arg / bot_width % bot_height;
+                        const int w    = arg % bot_width;
+
+                        res_index = b * bot_batch_stride + o * bot_channel_stride +
+                                    d * bot_depth_stride + h * bot_stride + w;
+                        res_index_gpu =
+                            index_position == 1
+                                ? arg
+                                : ((d - k * pool_stride_d + pad_d) * filter_size_w *
+                                   filter_size_h) +
+                                      ((h - j * pool_stride_h + pad_h) * filter_size_w) +
+                                      (w - i * pool_stride_w + pad_w);
+                    }
+                    else if(is_max)
+                    {
+                        res = -MAX_VAL;
+                    }
+                    // special index value is used to mark top points which has no associated
+                    // bottom
+                    // points
+                    if(!found)
+                    {
+                        res_index     = std::numeric_limits<size_t>::max();
+                        res_index_gpu = std::numeric_limits<uint8_t>::max();
+                    }
 
-                        int dstart = k * pool_stride_d - pad_d;
-                        int hstart = j * pool_stride_h - pad_h;
-                        int wstart = i * pool_stride_w - pad_w;
-                        int dend   = std::min(dstart + filter_size_d, bot_depth);
-                        int hend   = std::min(hstart + filter_size_h, bot_height);
-                        int wend   = std::min(wstart + filter_size_w, bot_width);
-                        dstart     = std::max(dstart, 0);
-                        hstart     = std::max(hstart, 0);
-                        wstart     = std::max(wstart, 0);
-
-                        int pool_size;
-                        if(pooling_method == MLO_POOLING_OP_AVE)
-                            pool_size = (dend - dstart) * (hend - hstart) * (wend - wstart);
-                        else
-                            pool_size        = filter_size_w * filter_size_h * filter_size_d;
-                        pool_size            = (pool_size == 0) ? 1 : pool_size;
-                        size_t res_index     = 0;
-                        size_t res_index_gpu = 0;
-                        bool found           = false;
-                        for(int d = dstart; d < dend; ++d)
+                    size_t top_index = b * top_batch_stride + o * top_channel_stride +
+                                       k * top_depth_stride + j * top_stride + i;
+                    if(pooling_method == MLO_POOLING_OP_MAX)
+                    {
+                        // the case with the odd input, the even kernel size and 2*pad == kernel
+                        // size
+                        mask_ptr[top_index] = res_index;
+                        if(do_backward)
                         {
-                            for(int h = hstart; h < hend; ++h)
+                            size_t mg = mask_gpu[top_index];
+                            if(mg != res_index_gpu)
                             {
-                                for(int w = wstart; w < wend; ++w)
-                                {
-                                    size_t bot_index = b * bot_batch_stride +
-                                                       o * bot_channel_stride +
-                                                       d * bot_depth_stride + h * bot_stride + w;
-                                    if(pooling_method == MLO_POOLING_OP_MAX)
-                                    {
-                                        if(static_cast<_Tcheck>(bot_ptr[bot_index]) > res)
-                                        {
-                                            res       = static_cast<_Tcheck>(bot_ptr[bot_index]);
-                                            res_index = bot_index;
-                                            res_index_gpu =
-                                                index_position == 1
-                                                    ? (d * bot_height * bot_width + h * bot_width +
-                                                       w)
-                                                    : ((d - k * pool_stride_d + pad_d) *
-                                                       filter_size_w * filter_size_h) +
-                                                          ((h - j * pool_stride_h + pad_h) *
-                                                           filter_size_w) +
-                                                          (w - i * pool_stride_w + pad_w);
-                                            found = true;
-                                        }
-                                    }
-                                    else if(pooling_method == MLO_POOLING_OP_AVE ||
-                                            pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
-                                    {
-
-                                        res += static_cast<_Tcheck>(bot_ptr[bot_index]);
-                                    }
-                                    else
-                                    {
-                                        std::cout << "ERROR: unknown operator : layer: pooling."
-                                                  << std::endl;
-                                        match = false;
-                                        continue;
-                                    }
-                                }
+                                std::lock_guard<std::mutex> lock(log_mutex);
+                                std::cout << "Mask mismatch, gpu " << mg << " cpu "
+                                          << res_index_gpu << "(" << res_index << ")"
+                                          << std::endl;
+                                match = false;
                             }
                         }
-                        // special index value is used to mark top points which has no associated
-                        // bottom
-                        // points
-                        if(!found)
-                        {
-                            res_index     = std::numeric_limits<size_t>::max();
-                            res_index_gpu = std::numeric_limits<uint8_t>::max();
-                        }
-
-                        size_t top_index = b * top_batch_stride + o * top_channel_stride +
-                                           k * top_depth_stride + j * top_stride + i;
-                        if(pooling_method == MLO_POOLING_OP_MAX)
-                        {
-                            // the case with the odd input, the even kernel size and 2*pad == kernel
-                            // size
-                            mask_ptr[top_index] = res_index;
-                            if(do_backward)
-                            {
-                                size_t mg = mask_gpu[top_index];
-                                if(mg != res_index_gpu)
-                                {
-                                    std::cout << "Mask mismatch, gpu " << mg << " cpu "
-                                              << res_index_gpu << "(" << res_index << ")"
-                                              << std::endl;
-                                    match = false;
-                                }
-                            }
-                        }
-                        if(pooling_method == MLO_POOLING_OP_AVE ||
-                           pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
-                        {
-                            res /= pool_size;
-                        }
-                        _Tcheck c_val = res;
+                    }
+                    if(pooling_method == MLO_POOLING_OP_AVE ||
+                       pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
+                    {
+                        res /= pool_size;
+                    }
+                    _Tcheck c_val = res;
 
-                        _Tgpu gg_val = (top_ptr[top_index]);
+                    _Tgpu gg_val = (top_ptr[top_index]);
 
-                        gg_val = (_Tgpu(gg_val) == _Tgpu(-G_MAX_VAL)) ? _Tgpu(0) : _Tgpu(gg_val);
+                    gg_val = (_Tgpu(gg_val) == _Tgpu(-G_MAX_VAL)) ? _Tgpu(0) : _Tgpu(gg_val);
 
-                        c_val = (c_val == -MAX_VAL) ? 0 : c_val;
+                    c_val = (c_val == -MAX_VAL) ? 0 : c_val;
 
-                        _Tcheck g_val(gg_val);
+                    _Tcheck g_val(gg_val);
 
-                        double err = std::abs(c_val - g_val);
+                    double err = std::abs(c_val - g_val);
 
-                        if(err > allowedEps || std::isnan(c_val) || std::isnan(g_val) ||
-                           !std::isfinite(c_val) || !std::isfinite(g_val))
-                        {
-                            std::cout << "Difference " << err << " too large at " << b << ", " << o
-                                      << ", " << j << ", " << i << " c_v = " << c_val
-                                      << " vs g_val = " << g_val << std::endl;
-                            match = false;
-                        }
+                    if(err > allowedEps || std::isnan(c_val) || std::isnan(g_val) ||
+                       !std::isfinite(c_val) || !std::isfinite(g_val))
+                    {
+                        std::lock_guard<std::mutex> lock(log_mutex);
+                        std::cout << "Difference " << err << " too large at " << b << ", " << o
+                                  << ", " << j << ", " << i << " c_v = " << c_val
+                                  << " vs g_val = " << g_val << std::endl;
+                        match = false;
                     }
                 }
             }
         }
-    }
+    });
 
-    return (match);
+    return (match.load());
 }
 
 template <typename _Tgpu /* the data type used in GPU computations (usually half) */,
@@ -305,110 +325,109 @@ int mloPoolingBackwardRunHost(
 
     int ret = 0;
 
-    for(int b = 0; b < n_batchs; b++)
-    {
-        for(int o = 0; o < n_outputs; o++)
-        {
-            int bot_df_v_off = b * bot_df_v_batch_stride + o * bot_df_v_channel_stride;
-            int top_df_off   = b * top_df_batch_stride + o * top_df_channel_stride;
+    miopen::par_for(n_batchs * n_outputs, miopen::min_grain{1}, [&](int bo) {
+        const int b = bo / n_outputs;
+        const int o = bo % n_outputs;
+
+        int bot_df_v_off = b * bot_df_v_batch_stride + o * bot_df_v_channel_stride;
+        int top_df_off   = b * top_df_batch_stride + o * top_df_channel_stride;
 
-            if(pooling_method == MLO_POOLING_OP_MAX)
+        if(pooling_method == MLO_POOLING_OP_MAX)
+        {
+            for(int k = 0; k < top_depth; k++)
             {
-                for(int k = 0; k < top_depth; k++)
+                for(int j = 0; j < top_height; j++)
                 {
-                    for(int j = 0; j < top_height; j++)
+                    for(int i = 0; i < top_width; i++)
                     {
-                        for(int i = 0; i < top_width; i++)
-                        {
-                            size_t top_idx =
-                                top_df_off + k * top_df_depth_stride + j * top_df_stride + i;
-                            size_t bot_idx = mask_ptr[top_idx];
-                            // skip top points that don't have associated bottom points
-                            if(bot_idx == std::numeric_limits<size_t>::max())
-                                continue;
-                            bot_df_v_ptr[bot_idx] += static_cast<_Tcheck>(top_df_ptr[top_idx]);
-                        }
+                        size_t top_idx =
+                            top_df_off + k * top_df_depth_stride + j * top_df_stride + i;
+                        size_t bot_idx = mask_ptr[top_idx];
+                        // skip top points that don't have associated bottom points
+                        if(bot_idx == std::numeric_limits<size_t>::max())
+                            continue;
+                        bot_df_v_ptr[bot_idx] += static_cast<_Tcheck>(top_df_ptr[top_idx]);
                     }
                 }
             }
-            else if(pooling_method == MLO_POOLING_OP_AVE ||
-                    pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
-            {
+        }
+        else if(pooling_method == MLO_POOLING_OP_AVE ||
+                pooling_method == MLO_POOLING_OP_AVE_INCLUSIVE)
+        {
 
-                for(int k = 0; k < bot_depth; k++)
+            for(int k = 0; k < bot_depth; k++)
+            {
+                for(int j = 0; j < bot_height; j++)
                 {
-                    for(int j = 0; j < bot_height; j++)
+                    for(int i = 0; i < bot_width; i++)
                     {
-                        for(int i = 0; i < bot_width; i++)
+                        // c-emulator
+                        bot_df_v_ptr[bot_df_v_off + k * bot_df_v_depth_stride +
+                                     j * bot_df_v_stride + i] = static_cast<_Tcheck>(0);
+                        int d                                 = k + pad_d;
+                        int h                                 = j + pad_h;
+                        int w                                 = i + pad_w;
+                        int pdstart =
+                            (d < filter_size_d) ? 0 : (d - filter_size_d) / pool_stride_d + 1;
+                        int pdend = std::min(d / pool_stride_d + 1, top_depth);
+                        int phstart =
+                            (h < filter_size_h) ? 0 : (h - filter_size_h) / pool_stride_h + 1;
+                        int phend = std::min(h / pool_stride_h + 1, top_height);
+                        int pwstart =
+                            (w < filter_size_w) ? 0 : (w - filter_size_w) / pool_stride_w + 1;
+                        int pwend        = std::min(w / pool_stride_w + 1, top_width);
+                        _Tcheck gradient = static_cast<_Tcheck>(0);
+                        for(int pd = pdstart; pd < pdend; ++pd)
                         {
-                            // c-emulator
-                            bot_df_v_ptr[bot_df_v_off + k * bot_df_v_depth_stride +
-                                         j * bot_df_v_stride + i] = static_cast<_Tcheck>(0);
-                            int d                                 = k + pad_d;
-                            int h                                 = j + pad_h;
-                            int w                                 = i + pad_w;
-                            int pdstart =
-                                (d < filter_size_d) ? 0 : (d - filter_size_d) / pool_stride_d + 1;
-                            int pdend = std::min(d / pool_stride_d + 1, top_depth);
-                            int phstart =
-                                (h < filter_size_h) ? 0 : (h - filter_size_h) / pool_stride_h + 1;
-                            int phend = std::min(h / pool_stride_h + 1, top_height);
-                            int pwstart =
-                                (w < filter_size_w) ? 0 : (w - filter_size_w) / pool_stride_w + 1;
-                            int pwend        = std::min(w / pool_stride_w + 1, top_width);
-                            _Tcheck gradient = static_cast<_Tcheck>(0);
-                            for(int pd = pdstart; pd < pdend; ++pd)
+                            for(int ph = phstart; ph < phend; ++ph)
                             {
-                                for(int ph = phstart; ph < phend; ++ph)
+                                for(int pw = pwstart; pw < pwend; ++pw)
                                 {
-                                    for(int pw = pwstart; pw < pwend; ++pw)
-                                    {
-                                        // figure out the pooling size
-                                        int dstart = pd * pool_stride_d - pad_d;
-                                        int hstart = ph * pool_stride_h - pad_h;
-                                        int wstart = pw * pool_stride_w - pad_w;
-                                        int dend   = std::min(dstart + filter_size_d, bot_depth);
-                                        int hend   = std::min(hstart + filter_size_h, bot_height);
-                                        int wend   = std::min(wstart + filter_size_w, bot_width);
-                                        dstart     = std::max(dstart, 0);
-                                        hstart     = std::max(hstart, 0);
-                                        wstart     = std::max(wstart, 0);
-
-                                        int pool_size;
-                                        if(pooling_method == MLO_POOLING_OP_AVE)
-                                            pool_size = ((dend - dstart) * (hend - hstart) *
-                                                             (wend - wstart) ==
-                                                         0)
-                                                            ? 1
-                                                            : (dend - dstart) * (hend - hstart) *
-                                                                  (wend - wstart);
-                                        else
-                                            pool_size =
-                                                (filter_size_w * filter_size_h * filter_size_d == 0)
-                                                    ? 1
-                                                    : filter_size_w * filter_size_h * filter_size_d;
-                                        gradient +=
-                                            static_cast<_Tcheck>(
-                                                top_df_ptr[top_df_off + pd * top_df_depth_stride +
-                                                           ph * top_df_stride + pw]) /
-                                            static_cast<_Tcheck>(pool_size);
-                                    }
+                                    // figure out the pooling size
+                                    int dstart = pd * pool_stride_d - pad_d;
+                                    int hstart = ph * pool_stride_h - pad_h;
+                                    int wstart = pw * pool_stride_w - pad_w;
+                                    int dend   = std::min(dstart + filter_size_d, bot_depth);
+                                    int hend   = std::min(hstart + filter_size_h, bot_height);
+                                    int wend   = std::min(wstart + filter_size_w, bot_width);
+                                    dstart     = std::max(dstart, 0);
+                                    hstart     = std::max(hstart, 0);
+                                    wstart     = std::max(wstart, 0);
+
+                                    int pool_size;
+                                    if(pooling_method == MLO_POOLING_OP_AVE)
+                                        pool_size = ((dend - dstart) * (hend - hstart) *
+                                                         (wend - wstart) ==
+                                                     0)
+                                                        ? 1
+                                                        : (dend - dstart) * (hend - hstart) *
+                                                              (wend - wstart);
+                                    else
+                                        pool_size =
+                                            (filter_size_w * filter_size_h * filter_size_d == 0)
+                                                ? 1
+                                                : filter_size_w * filter_size_h * filter_size_d;
+                                    gradient +=
+                                        static_cast<_Tcheck>(
+                                            top_df_ptr[top_df_off + pd * top_df_depth_stride +
+                                                       ph * top_df_stride + pw]) /
+                                        static_cast<_Tcheck>(pool_size);
                                 }
                             }
-                            bot_df_v_ptr[bot_df_v_off + k * bot_df_v_depth_stride +
-                                         j * bot_df_v_stride + i] = gradient;
                         }
+                        bot_df_v_ptr[bot_df_v_off + k * bot_df_v_depth_stride +
+                                     j * bot_df_v_stride + i] = gradient;
                     }
                 }
             }
-            else
-            {
-                std::cout << "ERROR: unknown operator : layer: pooling back-propagation."
-                          << std::endl;
-                continue;
-            }
         }
-    }
+        else
+        {
+            std::cout << "ERROR: unknown operator : layer: pooling back-propagation."
+                      << std::endl;
+            return;
+        }
+    });
     return (ret);
 }
 
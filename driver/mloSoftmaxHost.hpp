@@ -25,6 +25,17 @@ POSSIBILITY OF SUCH DAMAGE.
 #ifndef MLO_SOFTMAXHOST_H_
 #define MLO_SOFTMAXHOST_H_
 
+#include <miopen/miopen.h>
+#include <miopen/tensor.hpp>
+#include <miopen/tensor_extra.hpp>
+
+#include "../test/cpu_math.hpp"
+#include "../test/cpu_softmax.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
 ////////////////////////////////////////////////////////////
 //
 ///////////////////////////////////////////////////////////
@@ -39,9 +50,45 @@ T logaddexp(T x, T y, T neg_inf)
     T b = std::min(x, y);
     T c = b - a;
 
-    return c <= neg_inf ? std::max(a, neg_inf) : std::max(T(a + log(T(1) + exp(b - a))), neg_inf);
+    // Both sides are computed, the loops over the pixels stay vectorizable
+    const double sum = a + cpu_math::log1p(cpu_math::exp(c));
+    return std::max(static_cast<T>(cpu_math::select(c <= neg_inf, a, sum)), neg_inf);
+}
+
+// Lengths of one descriptor with the strides of another, the driver keeps the
+// gradients in the layout of the data they belong to.
+inline cpu_softmax::view mloSoftmaxView(miopenTensorDescriptor_t lensTensor,
+                                        miopenTensorDescriptor_t stridesTensor)
+{
+    int n, c, h, w, nstr, cstr, hstr, wstr;
+    miopenGet4dTensorDescriptorLengths(lensTensor, &n, &c, &h, &w);
+    miopenGet4dTensorDescriptorStrides(stridesTensor, &nstr, &cstr, &hstr, &wstr);
+    return {{{static_cast<size_t>(n),
+              static_cast<size_t>(c),
+              static_cast<size_t>(h),
+              static_cast<size_t>(w)}},
+            {{static_cast<size_t>(nstr),
+              static_cast<size_t>(cstr),
+              static_cast<size_t>(hstr),
+              static_cast<size_t>(wstr)}}};
+}
+
+// The statistics are kept per pixel of the part. Instance mode then folds them
+// into the one of the image.
+template <typename Tcheck, typename Op>
+void mloSoftmaxFoldStats(miopenSoftmaxMode_t mode, std::vector<Tcheck>& stats, Op op)
+{
+    if(mode != MIOPEN_SOFTMAX_MODE_INSTANCE || stats.empty())
+        return;
+    Tcheck acc = stats[0];
+    for(size_t s = 1; s < stats.size(); s++)
+        acc = op(acc, stats[s]);
+    std::fill(stats.begin(), stats.end(), acc);
 }
 
+// The parts of the problem (images in instance mode, blocks of pixels in
+// channel mode) run in parallel. Each part is copied to a channels x pixels
+// array, the loops over its pixels vectorize.
 template <typename Tgpu, typename Tcheck /* the data type used in CPU checkings (usually double) */>
 int mloSoftmaxForwardRunHost(miopenTensorDescriptor_t inputTensor,
                              miopenTensorDescriptor_t outputTensor,
@@ -52,187 +99,75 @@ int mloSoftmaxForwardRunHost(miopenTensorDescriptor_t inputTensor,
                              miopenSoftmaxAlgorithm_t algo,
                              miopenSoftmaxMode_t mode)
 {
-    int n, c, h, w, in_nstr, in_cstr, in_hstr, in_wstr;
-    int out_nstr, out_cstr, out_hstr, out_wstr;
-    miopenGet4dTensorDescriptorLengths(inputTensor, &n, &c, &h, &w);
-    miopenGet4dTensorDescriptorStrides(inputTensor, &in_nstr, &in_cstr, &in_hstr, &in_wstr);
-    miopenGet4dTensorDescriptorStrides(outputTensor, &out_nstr, &out_cstr, &out_hstr, &out_wstr);
-    (void)in_wstr;
-    (void)out_wstr;
+    const auto in_view  = mloSoftmaxView(inputTensor, inputTensor);
+    const auto out_view = mloSoftmaxView(inputTensor, outputTensor);
+    const size_t c      = in_view.lens[1];
 
     Tcheck max_val = (sizeof(Tgpu) == 4) ? 3.402823466e+38f : 65504.;
-    std::vector<Tcheck> channel_max((mode == MIOPEN_SOFTMAX_MODE_INSTANCE ? n : n * h * w),
-                                    static_cast<Tcheck>(-max_val));
-    std::vector<Tcheck> results(n * c * h * w, static_cast<Tcheck>(0.0));
+    Tcheck neg_inf = static_cast<Tcheck>(
+        miopen::deref(inputTensor).GetType() == miopenHalf ? NEGATIVE_INF_FP16 : NEGATIVE_INF_FP32);
 
-    int ret = 0;
+    cpu_softmax::for_each_part(in_view, mode, [&](size_t i, size_t first, size_t count) {
+        std::vector<Tcheck> results(c * count);
+        std::vector<Tcheck> stats(count);
+        for(size_t j = 0; j < c; j++)
+            for(size_t s = 0; s < count; s++)
+                results[j * count + s] = static_cast<Tcheck>(in[in_view.offset(i, j, first + s)]);
 
-    if(mode == MIOPEN_SOFTMAX_MODE_INSTANCE)
-    {
-        for(int i = 0; i < n; i++)
+        if(algo != MIOPEN_SOFTMAX_FAST)
         {
-            if(algo == MIOPEN_SOFTMAX_FAST)
-            {
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] = static_cast<Tcheck>(
-                                in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]);
-                        }
-            }
-            else
-            {
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            channel_max[i] =
-                                std::max(static_cast<Tcheck>(
-                                             in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]),
-                                         channel_max[i]);
-                        }
-
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]) -
-                                channel_max[i];
-                        }
-            }
-
-            if(algo == MIOPEN_SOFTMAX_LOG)
-            {
-                Tcheck neg_inf = static_cast<Tcheck>(
-                    miopen::deref(inputTensor).GetType() == miopenHalf ? NEGATIVE_INF_FP16
-                                                                       : NEGATIVE_INF_FP32);
-                channel_max[i] = neg_inf;
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            channel_max[i] = logaddexp(results[(i * c + j) * h * w + s0 * w + s1],
-                                                       channel_max[i],
-                                                       neg_inf);
-                        }
+            std::fill(stats.begin(), stats.end(), -max_val);
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    stats[s] = std::max(results[j * count + s], stats[s]);
+            mloSoftmaxFoldStats(mode, stats, [](Tcheck x, Tcheck y) { return std::max(x, y); });
+
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    results[j * count + s] -= stats[s];
+        }
 
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1] =
-                                alpha *
-                                    (results[(i * c + j) * h * w + s0 * w + s1] - channel_max[i]) +
-                                beta * outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1];
-                        }
-            }
-            else
+        if(algo == MIOPEN_SOFTMAX_LOG)
+        {
+            std::fill(stats.begin(), stats.end(), neg_inf);
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    stats[s] = logaddexp(results[j * count + s], stats[s], neg_inf);
+            mloSoftmaxFoldStats(
+                mode, stats, [&](Tcheck x, Tcheck y) { return logaddexp(y, x, neg_inf); });
+
+            for(size_t j = 0; j < c; j++)
             {
-                channel_max[i] = 0.0;
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                exp(results[(i * c + j) * h * w + s0 * w + s1]);
-                            channel_max[i] += results[(i * c + j) * h * w + s0 * w + s1];
-                        }
-
-                for(int j = 0; j < c; j++)
-                    for(int s0 = 0; s0 < h; s0++)
-                        for(int s1 = 0; s1 < w; s1++)
-                        {
-                            outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1] =
-                                alpha *
-                                    (results[(i * c + j) * h * w + s0 * w + s1] / channel_max[i]) +
-                                beta * outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1];
-                        }
+                for(size_t s = 0; s < count; s++)
+                {
+                    Tcheck& out = outhost[out_view.offset(i, j, first + s)];
+                    out         = alpha * (results[j * count + s] - stats[s]) + beta * out;
+                }
             }
         }
-    }
-    else
-    {
-        for(int i = 0; i < n; i++)
+        else
         {
-            for(int s0 = 0; s0 < h; s0++)
-                for(int s1 = 0; s1 < w; s1++)
-                {
-                    if(algo == MIOPEN_SOFTMAX_FAST)
-                    {
-                        for(int j = 0; j < c; j++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] = static_cast<Tcheck>(
-                                in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]);
-                        }
-                    }
-                    else
-                    {
-                        for(int j = 0; j < c; j++)
-                        {
-                            channel_max[i * h * w + s0 * w + s1] =
-                                std::max(static_cast<Tcheck>(
-                                             in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]),
-                                         channel_max[i * h * w + s0 * w + s1]);
-                        }
+            for(auto& r : results)
+                r = static_cast<Tcheck>(cpu_math::exp(r));
 
-                        for(int j = 0; j < c; j++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    in[i * in_nstr + j * in_cstr + s0 * in_hstr + s1]) -
-                                channel_max[i * h * w + s0 * w + s1];
-                        }
-                    }
+            std::fill(stats.begin(), stats.end(), Tcheck(0));
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    stats[s] += results[j * count + s];
+            mloSoftmaxFoldStats(mode, stats, std::plus<Tcheck>{});
 
-                    if(algo == MIOPEN_SOFTMAX_LOG)
-                    {
-                        Tcheck neg_inf = static_cast<Tcheck>(
-                            miopen::deref(inputTensor).GetType() == miopenHalf ? NEGATIVE_INF_FP16
-                                                                               : NEGATIVE_INF_FP32);
-                        channel_max[i * h * w + s0 * w + s1] = results[i * c * h * w + s0 * w + s1];
-                        for(int j = 1; j < c; j++)
-                        {
-                            channel_max[i * h * w + s0 * w + s1] =
-                                logaddexp(results[(i * c + j) * h * w + s0 * w + s1],
-                                          channel_max[i * h * w + s0 * w + s1],
-                                          neg_inf);
-                        }
-
-                        for(int j = 0; j < c; j++)
-                        {
-                            outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1] =
-                                alpha * (results[(i * c + j) * h * w + s0 * w + s1] -
-                                         channel_max[i * h * w + s0 * w + s1]) +
-                                beta * outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1];
-                        }
-                    }
-                    else
-                    {
-                        channel_max[i * h * w + s0 * w + s1] = 0.0;
-                        for(int j = 0; j < c; j++)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                exp(results[(i * c + j) * h * w + s0 * w + s1]);
-                            channel_max[i * h * w + s0 * w + s1] +=
-                                results[(i * c + j) * h * w + s0 * w + s1];
-                        }
-
-                        for(int j = 0; j < c; j++)
-                        {
-                            outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1] =
-                                alpha * (results[(i * c + j) * h * w + s0 * w + s1] /
-                                         channel_max[i * h * w + s0 * w + s1]) +
-                                beta * outhost[i * out_nstr + j * out_cstr + s0 * out_hstr + s1];
-                        }
-                    }
+            for(size_t j = 0; j < c; j++)
+            {
+                for(size_t s = 0; s < count; s++)
+                {
+                    Tcheck& out = outhost[out_view.offset(i, j, first + s)];
+                    out         = alpha * (results[j * count + s] / stats[s]) + beta * out;
                 }
+            }
         }
-    }
+    });
 
-    return ret;
+    return 0;
 }
 
 template <typename Tgpu /* the data type used in GPU computations (usually half) */,
@@ -247,121 +182,64 @@ int mloSoftmaxBackwardRunHost(miopenTensorDescriptor_t dInputTensor,
                               miopenSoftmaxAlgorithm_t algo,
                               miopenSoftmaxMode_t mode)
 {
-    int n, c, h, w, in_nstr, in_cstr, in_hstr, in_wstr;
-    int out_nstr, out_cstr, out_hstr, out_wstr;
-    miopenGet4dTensorDescriptorLengths(dOutputTensor, &n, &c, &h, &w);
-    miopenGet4dTensorDescriptorStrides(dInputTensor, &in_nstr, &in_cstr, &in_hstr, &in_wstr);
-    miopenGet4dTensorDescriptorStrides(dOutputTensor, &out_nstr, &out_cstr, &out_hstr, &out_wstr);
-    (void)in_wstr;
-    (void)out_wstr;
-
-    std::vector<Tcheck> channel_dot((mode == MIOPEN_SOFTMAX_MODE_INSTANCE ? n : n * h * w),
-                                    static_cast<Tcheck>(0.0));
-    std::vector<Tcheck> results(n * c * h * w, static_cast<Tcheck>(0.0));
-
-    int ret = 0;
-
-    for(int i = 0; i < n; i++)
-    {
-        if(mode == MIOPEN_SOFTMAX_MODE_INSTANCE)
+    const auto out_view = mloSoftmaxView(dOutputTensor, dOutputTensor);
+    const auto in_view  = mloSoftmaxView(dOutputTensor, dInputTensor);
+    const size_t c      = out_view.lens[1];
+
+    cpu_softmax::for_each_part(out_view, mode, [&](size_t i, size_t first, size_t count) {
+        std::vector<Tcheck> y(c * count);
+        std::vector<Tcheck> dy(c * count);
+        std::vector<Tcheck> channel_dot(count, Tcheck(0));
+        for(size_t j = 0; j < c; j++)
         {
-            for(int j = 0; j < c; j++)
-                for(int s0 = 0; s0 < h; s0++)
-                    for(int s1 = 0; s1 < w; s1++)
-                    {
-                        if(algo == MIOPEN_SOFTMAX_LOG)
-                        {
-                            channel_dot[i] += static_cast<Tcheck>(
-                                dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        else
-                        {
-                            channel_dot[i] +=
-                                static_cast<Tcheck>(
-                                    out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) *
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                    }
-
-            for(int j = 0; j < c; j++)
-                for(int s0 = 0; s0 < h; s0++)
-                    for(int s1 = 0; s1 < w; s1++)
-                    {
-                        if(algo == MIOPEN_SOFTMAX_LOG)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) -
-                                channel_dot[i] *
-                                    std::exp(out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        else
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) -
-                                channel_dot[i];
+            for(size_t s = 0; s < count; s++)
+            {
+                const size_t offset = out_view.offset(i, j, first + s);
+                y[j * count + s]    = static_cast<Tcheck>(out[offset]);
+                dy[j * count + s]   = static_cast<Tcheck>(dout[offset]);
+            }
+        }
 
-                            results[(i * c + j) * h * w + s0 * w + s1] *= static_cast<Tcheck>(
-                                out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        dinhost[i * in_nstr + j * in_cstr + s0 * in_hstr + s1] =
-                            alpha * results[(i * c + j) * h * w + s0 * w + s1] +
-                            beta * dinhost[i * in_nstr + j * in_cstr + s0 * in_hstr + s1];
-                    }
+        if(algo == MIOPEN_SOFTMAX_LOG)
+        {
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    channel_dot[s] += dy[j * count + s];
         }
         else
         {
-            for(int s0 = 0; s0 < h; s0++)
-                for(int s1 = 0; s1 < w; s1++)
-                {
-                    for(int j = 0; j < c; j++)
-                    {
-                        if(algo == MIOPEN_SOFTMAX_LOG)
-                        {
-                            channel_dot[i * h * w + s0 * w + s1] += static_cast<Tcheck>(
-                                dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        else
-                        {
-                            channel_dot[i * h * w + s0 * w + s1] +=
-                                static_cast<Tcheck>(
-                                    out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) *
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                    }
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    channel_dot[s] += y[j * count + s] * dy[j * count + s];
+        }
+        mloSoftmaxFoldStats(mode, channel_dot, std::plus<Tcheck>{});
 
-                    for(int j = 0; j < c; j++)
-                    {
-                        if(algo == MIOPEN_SOFTMAX_LOG)
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) -
-                                channel_dot[i * h * w + s0 * w + s1] *
-                                    std::exp(out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        else
-                        {
-                            results[(i * c + j) * h * w + s0 * w + s1] =
-                                static_cast<Tcheck>(
-                                    dout[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]) -
-                                channel_dot[i * h * w + s0 * w + s1];
+        // The results replace dy
+        if(algo == MIOPEN_SOFTMAX_LOG)
+        {
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    dy[j * count + s] -=
+                        channel_dot[s] * static_cast<Tcheck>(cpu_math::exp(y[j * count + s]));
+        }
+        else
+        {
+            for(size_t j = 0; j < c; j++)
+                for(size_t s = 0; s < count; s++)
+                    dy[j * count + s] = (dy[j * count + s] - channel_dot[s]) * y[j * count + s];
+        }
 
-                            results[(i * c + j) * h * w + s0 * w + s1] *= static_cast<Tcheck>(
-                                out[i * out_nstr + j * out_cstr + s0 * out_hstr + s1]);
-                        }
-                        dinhost[i * in_nstr + j * in_cstr + s0 * in_hstr + s1] =
-                            alpha * results[(i * c + j) * h * w + s0 * w + s1] +
-                            beta * dinhost[i * in_nstr + j * in_cstr + s0 * in_hstr + s1];
-                    }
-                }
+        for(size_t j = 0; j < c; j++)
+        {
+            for(size_t s = 0; s < count; s++)
+            {
+                Tcheck& din = dinhost[in_view.offset(i, j, first + s)];
+                din         = alpha * dy[j * count + s] + beta * din;
+            }
         }
-    }
+    });
 
-    return ret;
+    return 0;
 }
 
 #endif
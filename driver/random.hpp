@@ -1,10 +1,69 @@
 #ifndef GUARD_RANDOM_GEN_
 #define GUARD_RANDOM_GEN_
 
+#include <cstdint>
+#include <cstdlib>
+
+/// The additive feedback generator behind glibc's rand(), with its state kept per thread.
+/// Drivers generate the same data as they did with rand()/srand(), but the jobs of a
+/// parallel batch (see batch_driver.hpp) no longer draw from one shared sequence.
+class DriverRandom
+{
+    public:
+    explicit DriverRandom(unsigned seed = 1) { Seed(seed); }
+
+    void Seed(unsigned seed)
+    {
+        int64_t word = static_cast<int32_t>(seed == 0 ? 1 : seed);
+        state[0]     = static_cast<uint32_t>(word);
+        for(int i = 1; i < deg; ++i)
+        {
+            // 16807 * word % 2147483647 without overflow
+            const int64_t hi = word / 127773;
+            const int64_t lo = word % 127773;
+            word             = 16807 * lo - 2836 * hi;
+            if(word < 0)
+                word += 2147483647;
+            state[i] = static_cast<uint32_t>(word);
+        }
+        front = sep;
+        rear  = 0;
+        for(int i = 0; i < 10 * deg; ++i)
+            Next();
+    }
+
+    int Next()
+    {
+        state[front] += state[rear];
+        const auto result = static_cast<int>(state[front] >> 1);
+        front             = (front + 1) % deg;
+        rear              = (rear + 1) % deg;
+        return result;
+    }
+
+    private:
+    static constexpr int deg = 31;
+    static constexpr int sep = 3;
+    uint32_t state[deg];
+    int front = sep;
+    int rear  = 0;
+};
+
+inline DriverRandom& ThreadRandom()
+{
+    static thread_local DriverRandom gen;
+    return gen;
+}
+
+/// Drop-in replacements for rand() and srand().
+inline int GET_RAND() { return ThreadRandom().Next(); }
+
+inline void SET_SEED(unsigned seed = 1) { ThreadRandom().Seed(seed); }
+
 template <typename T>
 static T FRAND(void)
 {
-    double d = static_cast<double>(rand() / (static_cast<double>(RAND_MAX)));
+    double d = static_cast<double>(GET_RAND() / (static_cast<double>(RAND_MAX)));
     return static_cast<T>(d);
 }
 
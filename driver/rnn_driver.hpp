@@ -402,7 +402,7 @@ int RNNDriver<Tgpu, Tref>::SetRNNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect RNN Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     miopenRNNBiasMode_t biasMode;
@@ -417,7 +417,7 @@ int RNNDriver<Tgpu, Tref>::SetRNNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect bias Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     miopenRNNDirectionMode_t directionMode;
@@ -432,7 +432,7 @@ int RNNDriver<Tgpu, Tref>::SetRNNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect direction Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     miopenRNNInputMode_t inMode;
@@ -447,7 +447,7 @@ int RNNDriver<Tgpu, Tref>::SetRNNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect input Mode\n");
-        exit(0);
+        DriverExit(0);
     }
 
     miopenRNNAlgo_t algo;
@@ -462,7 +462,7 @@ int RNNDriver<Tgpu, Tref>::SetRNNDescriptorFromCmdLineArgs()
     else
     {
         printf("Incorrect RNN algorithm\n");
-        exit(0);
+        DriverExit(0);
     }
 
     if(inflags.GetValueInt("use_dropout"))
@@ -651,7 +651,7 @@ int RNNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
         std::string weiFileName = inflags.GetValueStr("weights");*/
 
     // Unless seed is persistent between runs validation using cache stored in file is impossible.
-    srand(0);
+    SET_SEED(0);
     double scale = 0.01;
 
     /*    bool dataRead = false;
@@ -667,19 +667,19 @@ int RNNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
 
     for(int i = 0; i < in_sz; i++)
     {
-        in[i] = static_cast<Tgpu>((static_cast<double>(scale * rand()) * (1.0 / RAND_MAX)));
+        in[i] = static_cast<Tgpu>((static_cast<double>(scale * GET_RAND()) * (1.0 / RAND_MAX)));
     }
 
     for(int i = 0; i < hy_sz; i++)
     {
-        hx[i] = static_cast<Tgpu>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
+        hx[i] = static_cast<Tgpu>((scale * static_cast<double>(GET_RAND()) * (1.0 / RAND_MAX)));
     }
 
     if((inflags.GetValueStr("mode")) == "lstm")
     {
         for(int i = 0; i < hy_sz; i++)
         {
-            cx[i] = static_cast<Tgpu>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
+            cx[i] = static_cast<Tgpu>((scale * static_cast<double>(GET_RAND()) * (1.0 / RAND_MAX)));
         }
     }
 
@@ -687,12 +687,14 @@ int RNNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     {
         for(int i = 0; i < out_sz; i++)
         {
-            dout[i] = static_cast<Tgpu>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
+            dout[i] =
+                static_cast<Tgpu>((scale * static_cast<double>(GET_RAND()) * (1.0 / RAND_MAX)));
         }
 
         for(int i = 0; i < hy_sz; i++)
         {
-            dhy[i] = static_cast<Tgpu>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
+            dhy[i] =
+                static_cast<Tgpu>((scale * static_cast<double>(GET_RAND()) * (1.0 / RAND_MAX)));
         }
 
         if((inflags.GetValueStr("mode")) == "lstm")
@@ -700,7 +702,7 @@ int RNNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
             for(int i = 0; i < hy_sz; i++)
             {
                 dcy[i] =
-                    static_cast<Tgpu>((scale * static_cast<double>(rand()) * (1.0 / RAND_MAX)));
+                    static_cast<Tgpu>((scale * static_cast<double>(GET_RAND()) * (1.0 / RAND_MAX)));
             }
         }
     }
@@ -718,7 +720,7 @@ int RNNDriver<Tgpu, Tref>::AllocateBuffersAndCopy()
     for(int i = 0; i < wei_sz; i++)
     {
         wei[i] =
-            static_cast<Tgpu>((scale * static_cast<double>((rand()) * (1.0 / RAND_MAX) - 0.5)));
+            static_cast<Tgpu>((scale * static_cast<double>((GET_RAND()) * (1.0 / RAND_MAX) - 0.5)));
     }
 
     if(inflags.GetValueInt("dump_output"))
@@ -258,8 +258,7 @@ void RunRNNForwardGEMMCPUVerify(miopenHandle_t handle,
             int prelayer_shift = (li - 1) * batch_n * hy_h * bi;
             if(use_dropout)
             {
-                auto dropout_states_tmp = dropout_states_host;
-                size_t drop_out_offset  = (li - 1) * batch_n * hy_h * bi;
+                size_t drop_out_offset = (li - 1) * batch_n * hy_h * bi;
 
                 RunDropoutForwardEmulator<Tref>(handle,
                                                 dropoutDesc,
@@ -269,7 +268,7 @@ void RunRNNForwardGEMMCPUVerify(miopenHandle_t handle,
                                                 dropout_outputTensor,
                                                 dropout_hid_state,
                                                 dropout_reservespace_host,
-                                                dropout_states_tmp,
+                                                dropout_states_host,
                                                 prelayer_shift,
                                                 drop_out_offset,
                                                 drop_out_offset);
@@ -187,7 +187,7 @@ int TensorOpDriver<Tgpu, Tref>::SetTensorOpFromCmdLineArgs()
         else
         {
             Usage();
-            exit(-1);
+            DriverExit(-1);
         }
     }
     return miopenStatusSuccess;
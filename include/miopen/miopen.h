@@ -245,6 +245,57 @@ MIOPEN_EXPORT miopenStatus_t miopenGetKernelTime(miopenHandle_t handle, float* t
  * @return           miopenStatus_t
 */
 MIOPEN_EXPORT miopenStatus_t miopenEnableProfiling(miopenHandle_t handle, bool enable);
+
+/*! @enum miopenCounterSource_t
+ * Caches and databases MIOpen keeps runtime counters for.
+ */
+typedef enum {
+    miopenCounterSourceKernelCache  = 0, /*!< Compiled kernels kept by the handles */
+    miopenCounterSourceInvokerCache = 1, /*!< Prepared invokers kept by the handles */
+    miopenCounterSourceSystemDb     = 2, /*!< System find and perf databases loaded in memory */
+    miopenCounterSourceTextDb       = 3, /*!< Text find and perf databases */
+    miopenCounterSourceSQLitePerfDb = 4, /*!< SQLite perf databases */
+    miopenCounterSourceBinaryCache  = 5, /*!< Binary kernel cache and the kernels built on a miss */
+} miopenCounterSource_t;
+
+/*! @brief Runtime counters of a cache or database
+ *
+ * @see miopenGetCounters
+ */
+typedef struct
+{
+    size_t lookups;    /*!< Number of lookups */
+    size_t hits;       /*!< Lookups that found an entry */
+    size_t misses;     /*!< Lookups that found none */
+    size_t bytesRead;  /*!< Bytes read from the files or databases */
+    size_t compiles;   /*!< Kernels compiled, only for miopenCounterSourceBinaryCache */
+    float compileTime; /*!< Time spent compiling in milliseconds */
+} miopenCounters_t;
+
+/*! @brief Get the runtime counters of a cache or database
+ *
+ * The counters are kept by every thread without synchronization and summed on this call,
+ * so they are cheap enough to be always on. The caches and databases are shared by the
+ * handles of the process, and so are the counters.
+ *
+ * The counters can also be written periodically as JSON lines, every
+ * MIOPEN_COUNTERS_DUMP_INTERVAL seconds, to MIOPEN_COUNTERS_DUMP_FILE or stderr.
+ *
+ * @param handle     MIOpen handle (input)
+ * @param source     Cache or database to get the counters of (input)
+ * @param counters   Pointer to the counters since the start or the last reset (output)
+ * @return           miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenGetCounters(miopenHandle_t handle,
+                                               miopenCounterSource_t source,
+                                               miopenCounters_t* counters);
+
+/*! @brief Reset the runtime counters of all caches and databases to zero
+ *
+ * @param handle     MIOpen handle (input)
+ * @return           miopenStatus_t
+*/
+MIOPEN_EXPORT miopenStatus_t miopenResetCounters(miopenHandle_t handle);
 /** @} */
 // CLOSEOUT HANDLE DOXYGEN GROUP
 
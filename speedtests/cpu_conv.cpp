@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Compares the host convolution engine with the direct definitions on the
+// shapes of test/conv2d.cpp.
+//
+//   speedtest_cpu_conv [batch size factor] [max GMACs]
+//
+// Problems larger than max GMACs (default 2) are skipped, the direct
+// definitions take minutes on them.
+
+#include "serialize.hpp"
+#include "cpu_conv.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+struct pattern
+{
+    template <class... Ts>
+    double operator()(Ts... xs) const
+    {
+        std::array<std::size_t, sizeof...(Ts)> ids = {{static_cast<std::size_t>(xs)...}};
+        const auto dot = std::accumulate(
+            ids.begin(), ids.end(), std::size_t{173}, [](auto a, auto x) { return a * 31 + x; });
+        return static_cast<double>(dot % 17);
+    }
+};
+
+template <class F>
+static double measure_ms(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+static void print_ratio(const std::string& dir, double naive_ms, double blocked_ms)
+{
+    std::cout << "  " << std::setw(4) << dir << std::fixed << std::setprecision(1) << std::setw(12)
+              << naive_ms << " ms" << std::setw(12) << blocked_ms << " ms" << std::setw(9)
+              << naive_ms / blocked_ms << "x" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    const auto batch_factor = argc > 1 ? std::atoi(argv[1]) : 8;
+    const auto max_gmacs    = argc > 2 ? std::atof(argv[2]) : 2.0;
+
+    const std::vector<int> pads      = {1, 1};
+    const std::vector<int> strides   = {1, 1};
+    const std::vector<int> dilations = {1, 1};
+
+    std::cout << "direction       direct      blocked  speedup" << std::endl;
+    for(const auto& in_lens : get_inputs(batch_factor))
+    {
+        for(const auto& wei_lens : get_weights(batch_factor))
+        {
+            if(in_lens[1] != wei_lens[1] || wei_lens[2] > in_lens[2] + 2 ||
+               wei_lens[3] > in_lens[3] + 2)
+                continue;
+
+            const std::vector<std::size_t> out_lens = {
+                static_cast<std::size_t>(in_lens[0]),
+                static_cast<std::size_t>(wei_lens[0]),
+                static_cast<std::size_t>(in_lens[2] + 2 - wei_lens[2] + 1),
+                static_cast<std::size_t>(in_lens[3] + 2 - wei_lens[3] + 1)};
+            const double macs = 1e-9 * out_lens[0] * out_lens[1] * out_lens[2] * out_lens[3] *
+                                wei_lens[1] * wei_lens[2] * wei_lens[3];
+            if(macs > max_gmacs)
+                continue;
+
+            auto in  = tensor<float>{in_lens}.generate(pattern{});
+            auto wei = tensor<float>{wei_lens}.generate(pattern{});
+            auto out = tensor<float>{out_lens}.generate(pattern{});
+
+            std::cout << "in " << in_lens[0] << "x" << in_lens[1] << "x" << in_lens[2] << "x"
+                      << in_lens[3] << ", wei " << wei_lens[0] << "x" << wei_lens[1] << "x"
+                      << wei_lens[2] << "x" << wei_lens[3] << " (" << std::setprecision(3)
+                      << macs << " GMACs)" << std::endl;
+
+            print_ratio("fwd",
+                        measure_ms([&] {
+                            cpu_convolution_forward_impl<2>(
+                                in, wei, out, pads, strides, dilations, 1);
+                        }),
+                        measure_ms([&] {
+                            cpu_conv::forward<2>(in, wei, out, pads, strides, dilations, 1);
+                        }));
+            print_ratio("bwd",
+                        measure_ms([&] {
+                            cpu_convolution_backward_data_impl<2>(
+                                in, wei, out, pads, strides, dilations, 1);
+                        }),
+                        measure_ms([&] {
+                            cpu_conv::backward_data<2>(in, wei, out, pads, strides, dilations, 1);
+                        }));
+            print_ratio("wrw",
+                        measure_ms([&] {
+                            cpu_convolution_backward_weight_impl<2>(
+                                in, wei, out, pads, strides, dilations, 1);
+                        }),
+                        measure_ms([&] {
+                            cpu_conv::backward_weight<2>(
+                                in, wei, out, pads, strides, dilations, 1);
+                        }));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Compares the branch free math of cpu_math with the C library, and the
+// activation references of cpu_activ element by element (one switch on the
+// mode per element) with their array versions.
+//
+//   speedtest_cpu_math [elements]
+//
+// Each loop runs single threaded on the same data, the best of five runs is
+// reported.
+
+#include "cpu_activ.hpp"
+#include "cpu_math.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+template <class F>
+static double measure_ms(F f)
+{
+    double best = 0;
+    for(int run = 0; run < 5; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+                .count();
+        best = run == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+static void print_ratio(const std::string& name, double ref_ms, double fast_ms)
+{
+    std::cout << std::setw(12) << name << std::fixed << std::setprecision(2) << std::setw(12)
+              << ref_ms << " ms" << std::setw(12) << fast_ms << " ms" << std::setw(9)
+              << ref_ms / fast_ms << "x" << std::endl;
+}
+
+template <class F, class G>
+static void compare(const std::string& name, const std::vector<double>& x, F ref, G fast)
+{
+    std::vector<double> y(x.size());
+    print_ratio(name,
+                measure_ms([&] {
+                    for(std::size_t i = 0; i < x.size(); ++i)
+                        y[i] = ref(x[i]);
+                }),
+                measure_ms([&] {
+                    for(std::size_t i = 0; i < x.size(); ++i)
+                        y[i] = fast(x[i]);
+                }));
+}
+
+int main(int argc, const char* argv[])
+{
+    const auto n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : (1ul << 22);
+
+    std::mt19937_64 gen(17);
+    std::vector<double> x(n);
+    std::vector<double> positive(n);
+    std::uniform_real_distribution<double> dist(-20, 20);
+    std::generate(x.begin(), x.end(), [&] { return dist(gen); });
+    std::transform(x.begin(), x.end(), positive.begin(), [](double v) { return std::abs(v); });
+
+    std::cout << "function           libm      cpu_math  speedup" << std::endl;
+    compare("exp", x, [](double v) { return std::exp(v); }, [](double v) {
+        return cpu_math::exp(v);
+    });
+    compare("expm1", x, [](double v) { return std::expm1(v); }, [](double v) {
+        return cpu_math::expm1(v);
+    });
+    compare("log", positive, [](double v) { return std::log(v); }, [](double v) {
+        return cpu_math::log(v);
+    });
+    compare("log1p", positive, [](double v) { return std::log1p(v); }, [](double v) {
+        return cpu_math::log1p(v);
+    });
+    compare("tanh", x, [](double v) { return std::tanh(v); }, [](double v) {
+        return cpu_math::tanh(v);
+    });
+    compare("pow", positive, [](double v) { return std::pow(v, 1.7); }, [](double v) {
+        return cpu_math::pow(v, 1.7);
+    });
+
+    std::vector<float> xf(x.begin(), x.end());
+    std::vector<float> yf(n);
+    std::vector<float> dyf(n, 1.0f);
+    std::vector<float> dxf(n);
+    std::cout << std::endl << "activation      element         array  speedup" << std::endl;
+    for(int mode = miopenActivationPASTHRU; mode <= miopenActivationELU; ++mode)
+    {
+        const cpu_activ::params p{static_cast<miopenActivationMode_t>(mode), 0.5, 1.5, 2.0};
+        print_ratio("fwd " + std::to_string(mode),
+                    measure_ms([&] {
+                        for(std::size_t i = 0; i < n; ++i)
+                            yf[i] = static_cast<float>(cpu_activ::forward(p, xf[i]));
+                    }),
+                    measure_ms([&] { cpu_activ::forward(p, n, xf.data(), yf.data()); }));
+        print_ratio("bwd " + std::to_string(mode),
+                    measure_ms([&] {
+                        for(std::size_t i = 0; i < n; ++i)
+                            dxf[i] = static_cast<float>(
+                                cpu_activ::backward(p, dyf[i], xf[i], yf[i]));
+                    }),
+                    measure_ms([&] {
+                        cpu_activ::backward(p, n, dyf.data(), xf.data(), yf.data(), dxf.data());
+                    }));
+    }
+    return 0;
+}
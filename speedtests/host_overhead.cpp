@@ -0,0 +1,268 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host side cost of the API dispatch paths: descriptors, network configs, find-db and
+// perf-db lookups, IsApplicable scans, invoker lookups and fusion plan building. Meant for
+// the HIPNOGPU backend, where nothing waits on a device. The dispatch of whole primitives
+// also needs MIOPEN_NOGPU_HOST_EXECUTION=1 and runs on a single element, so the primitive
+// itself is negligible. Host execution skips the solvers: conv/forward_immediate_host times
+// the argument validation and the host convolution, not the invoker path of a device.
+//
+//   speedtest_host_overhead [name filter] [min time per benchmark in s]
+//
+// Each benchmark doubles its iteration count until a run takes the min time (default
+// 0.1 s), the best time per iteration of five such runs is reported.
+
+#include <miopen/any_solver.hpp>
+#include <miopen/conv/context.hpp>
+#include <miopen/find_db.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/host_exec.hpp>
+#include <miopen/invoker.hpp>
+#include <miopen/miopen.h>
+#include <miopen/mlo_internal.hpp>
+#include <miopen/problem_description.hpp>
+#include <miopen/solver.hpp>
+#include <miopen/solver_id.hpp>
+#include <miopen/tensor.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+template <class T>
+static void keep(const T& x)
+{
+    asm volatile("" : : "g"(&x) : "memory");
+}
+
+struct benchmark
+{
+    std::string name;
+    std::function<void()> body;
+};
+
+static double run_ns(const std::function<void()>& body, std::size_t iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < iterations; ++i)
+        body();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// The benchmarks measure the successful paths only.
+static void check(miopenStatus_t status, const char* what)
+{
+    if(status == miopenStatusSuccess)
+        return;
+    std::cerr << what << " failed: " << miopenGetErrorString(status) << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+// The best solution the immediate mode reports for the problem.
+static miopen::solver::Id applicable_solver(miopenHandle_t h,
+                                            miopen::TensorDescriptor& x_desc,
+                                            miopen::TensorDescriptor& w_desc,
+                                            miopen::ConvolutionDescriptor& conv,
+                                            miopen::TensorDescriptor& y_desc)
+{
+    std::size_t count = 0;
+    check(miopenConvolutionForwardGetSolutionCount(h, &w_desc, &x_desc, &conv, &y_desc, &count),
+          "miopenConvolutionForwardGetSolutionCount");
+    std::vector<miopenConvSolution_t> solutions(count);
+    check(miopenConvolutionForwardGetSolution(
+              h, &w_desc, &x_desc, &conv, &y_desc, count, &count, solutions.data()),
+          "miopenConvolutionForwardGetSolution");
+    if(count == 0)
+    {
+        std::cerr << "No applicable convolution solver" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return miopen::solver::Id{solutions.front().solution_id};
+}
+
+static void run(const benchmark& b, double min_time_s)
+{
+    std::size_t iterations = 1;
+    while(run_ns(b.body, iterations) < min_time_s * 1e9 && iterations < (1ul << 30))
+        iterations *= 2;
+
+    double best = run_ns(b.body, iterations);
+    for(int i = 1; i < 5; ++i)
+        best = std::min(best, run_ns(b.body, iterations));
+
+    std::cout << std::left << std::setw(44) << b.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12) << best / iterations << " ns"
+              << std::setw(12) << iterations << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    const std::string filter = argc > 1 ? argv[1] : "";
+    const auto min_time_s    = argc > 2 ? std::atof(argv[2]) : 0.1;
+
+    miopenHandle_t h;
+    check(miopenCreate(&h), "miopenCreate");
+    auto& handle = miopen::deref(h);
+
+    // A 3x3 convolution of a ResNet stage.
+    // The C API takes non-const descriptors.
+    miopen::TensorDescriptor x_desc{miopenFloat, {16, 64, 56, 56}};
+    miopen::TensorDescriptor w_desc{miopenFloat, {64, 64, 3, 3}};
+    miopen::ConvolutionDescriptor conv{{1, 1}, {1, 1}, {1, 1}};
+    auto y_desc = conv.GetForwardOutputTensor(x_desc, w_desc);
+    const auto dir    = miopen::conv::Direction::Forward;
+    const miopen::ProblemDescription problem{x_desc, w_desc, y_desc, conv, dir};
+
+    auto ctx = miopen::ConvolutionContext{problem};
+    ctx.SetStream(&handle);
+    ctx.DetectRocm();
+    ctx.SetupFloats();
+
+    const auto config    = problem.BuildConfKey();
+    const auto solver_id = applicable_solver(h, x_desc, w_desc, conv, y_desc);
+    handle.RegisterInvoker([](const miopen::Handle&, const miopen::AnyInvokeParams&) {},
+                           config,
+                           solver_id,
+                           miopen::AlgorithmName{"miopenConvolutionFwdAlgoDirect"});
+
+    std::vector<benchmark> benchmarks = {
+        {"tensor_descriptor/create_set_destroy",
+         [] {
+             miopenTensorDescriptor_t desc;
+             miopenCreateTensorDescriptor(&desc);
+             miopenSet4dTensorDescriptor(desc, miopenFloat, 16, 64, 56, 56);
+             miopenDestroyTensorDescriptor(desc);
+         }},
+        {"conv_descriptor/create_init_destroy",
+         [] {
+             miopenConvolutionDescriptor_t desc;
+             miopenCreateConvolutionDescriptor(&desc);
+             miopenInitConvolutionDescriptor(desc, miopenConvolution, 1, 1, 1, 1, 1, 1);
+             miopenDestroyConvolutionDescriptor(desc);
+         }},
+        {"conv/problem_description",
+         [&] { keep(miopen::ProblemDescription{x_desc, w_desc, y_desc, conv, dir}); }},
+        {"conv/network_config", [&] { keep(problem.BuildConfKey()); }},
+        {"conv/find_db_lookup",
+         [&] {
+             const miopen::FindDbRecord record{handle, problem};
+             keep(record.empty());
+         }},
+        {"conv/perf_db_lookup", [&] { keep(miopen::GetDb(ctx).FindRecord(ctx)); }},
+        {"conv/is_applicable_scan",
+         [&] {
+             std::size_t applicable = 0;
+             for(const auto& solver : miopen::solver::GetMapValueToAnySolver())
+                 applicable += solver.second.IsApplicable(ctx) ? 1 : 0;
+             keep(applicable);
+         }},
+        {"conv/invoker_lookup",
+         [&] { keep(handle.GetInvoker(problem.BuildConfKey(), solver_id)); }},
+        {"conv/immediate_get_solution",
+         [&] {
+             std::size_t count = 0;
+             miopenConvolutionForwardGetSolutionCount(h, &w_desc, &x_desc, &conv, &y_desc, &count);
+             std::vector<miopenConvSolution_t> solutions(count);
+             miopenConvolutionForwardGetSolution(
+                 h, &w_desc, &x_desc, &conv, &y_desc, count, &count, solutions.data());
+             keep(solutions);
+         }},
+        {"fusion/plan_build",
+         [&] {
+             miopenFusionPlanDescriptor_t plan;
+             miopenFusionOpDescriptor_t conv_op;
+             miopenFusionOpDescriptor_t bias_op;
+             miopenFusionOpDescriptor_t activ_op;
+             miopen::TensorDescriptor b_desc{miopenFloat, {1, 64, 1, 1}};
+             miopenCreateFusionPlan(&plan, miopenVerticalFusion, &x_desc);
+             miopenCreateOpConvForward(plan, &conv_op, &conv, &w_desc);
+             miopenCreateOpBiasForward(plan, &bias_op, &b_desc);
+             miopenCreateOpActivationForward(plan, &activ_op, miopenActivationRELU);
+             miopenDestroyFusionPlan(plan);
+         }},
+    };
+
+#if MIOPEN_MODE_NOGPU
+    // One element, the host primitive costs next to nothing.
+    miopen::TensorDescriptor one_desc{miopenFloat, {1, 1, 1, 1}};
+    miopen::ConvolutionDescriptor one_conv{{0, 0}, {1, 1}, {1, 1}};
+    std::vector<float> a(1, 1.0f);
+    std::vector<float> b(1, 2.0f);
+    std::vector<float> c(1, 0.0f);
+    const float alpha = 1.0f;
+    const float beta  = 0.0f;
+    if(miopen::IsHostExecution(handle))
+    {
+        const auto one_solver_id = applicable_solver(h, one_desc, one_desc, one_conv, one_desc);
+        const auto op_tensor     = [&] {
+            return miopenOpTensor(h,
+                                  miopenTensorOpAdd,
+                                  &alpha,
+                                  &one_desc,
+                                  a.data(),
+                                  &alpha,
+                                  &one_desc,
+                                  b.data(),
+                                  &beta,
+                                  &one_desc,
+                                  c.data());
+        };
+        const auto forward_immediate = [&, one_solver_id] {
+            return miopenConvolutionForwardImmediate(h,
+                                                     &one_desc,
+                                                     b.data(),
+                                                     &one_desc,
+                                                     a.data(),
+                                                     &one_conv,
+                                                     &one_desc,
+                                                     c.data(),
+                                                     nullptr,
+                                                     0,
+                                                     one_solver_id.Value());
+        };
+        check(op_tensor(), "miopenOpTensor");
+        check(forward_immediate(), "miopenConvolutionForwardImmediate");
+        benchmarks.push_back({"tensor/op_tensor_dispatch", [=] { keep(op_tensor()); }});
+        benchmarks.push_back({"conv/forward_immediate_host", [=] { keep(forward_immediate()); }});
+    }
+#endif
+
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right << std::setw(15)
+              << "time" << std::setw(12) << "iterations" << std::endl;
+    for(const auto& b : benchmarks)
+        if(b.name.find(filter) != std::string::npos)
+            run(b, min_time_s);
+
+    miopenDestroy(h);
+    return 0;
+}
@@ -38,9 +38,19 @@
 #include <miopen/db.hpp>
 #include <miopen/db_path.hpp>
 #include <miopen/target_properties.hpp>
+#include <miopen/kernel.hpp>
+#include <miopen/perf_counters.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <ctime>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <vector>
 
 namespace miopen {
 
@@ -80,6 +90,25 @@ static boost::filesystem::path ComputeUserCachePath()
 #endif
 }
 
+/// Unlike the user cache, the content-addressed cache is shared between MIOpen
+/// versions, so it lives in the root of the cache directory.
+static boost::filesystem::path ComputeContentCachePath()
+{
+#ifdef MIOPEN_CACHE_DIR
+    auto p = boost::filesystem::path{miopen::ExpandUser(MIOPEN_CACHE_DIR)};
+
+    const char* const custom = miopen::GetStringEnv(MIOPEN_CUSTOM_CACHE_DIR{});
+    if(custom != nullptr && strlen(custom) > 0)
+        p = boost::filesystem::path{miopen::ExpandUser(custom)};
+
+    if(!boost::filesystem::exists(p) && !MIOPEN_DISABLE_USERDB)
+        boost::filesystem::create_directories(p);
+    return p;
+#else
+    return {};
+#endif
+}
+
 boost::filesystem::path GetCachePath(bool is_system)
 {
     static const boost::filesystem::path user_path = ComputeUserCachePath();
@@ -138,6 +167,93 @@ boost::filesystem::path GetCacheFile(const std::string& device,
     return GetCachePath(false) / miopen::md5(device + ":" + args) / filename;
 }
 
+static bool IsDefineOption(const std::string& option)
+{
+    return StartsWith(option, "-D") || StartsWith(option, "-Wa,-defsym,");
+}
+
+std::string NormalizeCompileOptions(const std::string& options)
+{
+    // Options that consume the next token must stay attached to it.
+    static const std::vector<std::string> dont_split = {
+        "-isystem", "-include", "-Xclang", "-mllvm", "-x"};
+
+    std::vector<std::string> others;
+    std::map<std::string, std::string> defines;
+    for(const auto& option : SplitSpaceSeparated(options, dont_split))
+    {
+        // -U interacts with definitions in order, keep the options verbatim then.
+        if(StartsWith(option, "-U"))
+            return options;
+        if(!IsDefineOption(option))
+        {
+            others.push_back(option);
+            continue;
+        }
+        const auto prefix_len = StartsWith(option, "-D") ? 2 : std::strlen("-Wa,-defsym,");
+        const auto eq         = option.find('=', prefix_len);
+        const auto name       = option.substr(prefix_len, eq - prefix_len);
+        defines[option.substr(0, prefix_len) + name] = option;
+    }
+
+    for(const auto& define : defines)
+        others.push_back(define.second);
+    return JoinStrings(others, " ");
+}
+
+// Bump when the way kernels are built changes without changes of their sources
+// or options, e.g. when internal compiler options are modified. This invalidates
+// the content-addressed cache.
+static constexpr int kernel_content_cache_version = 1;
+
+static const std::string& GetToolchainId()
+{
+    static const std::string id = [] {
+        std::ostringstream ss;
+        ss << "v" << kernel_content_cache_version                       //
+           << ":backend=" << MIOPEN_BACKEND_HIP << MIOPEN_BACKEND_OPENCL //
+           << ":comgr=" << MIOPEN_USE_COMGR                              //
+           << ":dev=" << MIOPEN_BUILD_DEV                                //
+           << ":hip=" << HIP_PACKAGE_VERSION_FLAT;
+#if MIOPEN_USE_COMGR
+        ss << ":comgr_ver=" << MIOPEN_AMD_COMGR_VERSION_MAJOR << '.'
+           << MIOPEN_AMD_COMGR_VERSION_MINOR << '.' << MIOPEN_AMD_COMGR_VERSION_PATCH;
+#endif
+        return ss.str();
+    }();
+    return id;
+}
+
+// The kernels include these headers by name, so their contents are part of the
+// content of every kernel.
+static const std::string& GetKernelIncludesHash()
+{
+    static const std::string hash = [] {
+        std::string all;
+        for(const auto& inc : GetKernelIncList())
+            all += inc + '\n' + GetKernelInc(inc) + '\n';
+        return md5(all);
+    }();
+    return hash;
+}
+
+std::string GetKernelContentKey(const TargetProperties& target,
+                                const std::string& name,
+                                const std::string& args,
+                                const bool is_kernel_str,
+                                const std::string& kernel_src)
+{
+    // Keep in sync with the selection of the source in HIPOCProgram and LoadProgram.
+    const auto filename = is_kernel_str ? std::string{"tinygemm.cl"} : name;
+    const auto src =
+        !kernel_src.empty() ? kernel_src : is_kernel_str ? name : GetKernelSrc(name);
+
+    const auto key = GetToolchainId() + '\n' + target.DbId() + '\n' + filename + '\n' +
+                     NormalizeCompileOptions(args) + '\n' + md5(src) + '\n' +
+                     GetKernelIncludesHash();
+    return md5(key);
+}
+
 #if MIOPEN_ENABLE_SQLITE_KERN_CACHE
 static inline std::string GetFilenameForInfo2Logging(const bool is_kernel_str,
                                                      const std::string& filename,
@@ -198,7 +314,94 @@ void SaveBinary(const std::string& hsaco,
     MIOPEN_LOG_I2("Saving binary for: " << verbose_name << "; args: " << args);
     db.StoreRecord(cfg);
 }
+
+boost::filesystem::path GetContentCachePath()
+{
+    static const auto content_dir = ComputeContentCachePath();
+    if(MIOPEN_DISABLE_USERDB)
+        return {};
+    return content_dir;
+}
+
+static KernDb& GetContentDb(const TargetProperties& target)
+{
+    const auto content_dir = GetContentCachePath();
+    const auto path        = content_dir.empty() ? boost::filesystem::path{}
+                                          : content_dir / (target.DbId() + ".ckdb");
+    return KernDb::GetCached(path.string(), false, target.DbId(), 0);
+}
+
+std::string LoadBinaryByContent(const TargetProperties& target, const std::string& key)
+{
+    if(miopen::IsCacheDisabled())
+        return {};
+
+    auto record = GetContentDb(target).FindRecordUnsafe(KernelConfig{key, "", ""});
+    if(record)
+    {
+        MIOPEN_LOG_I2("Sucessfully loaded binary for content key: " << key);
+        return record.get();
+    }
+    return {};
+}
+
+void SaveBinaryByContent(const std::string& hsaco,
+                         const TargetProperties& target,
+                         const std::string& key)
+{
+    if(miopen::IsCacheDisabled())
+        return;
+
+    MIOPEN_LOG_I2("Saving binary for content key: " << key);
+    GetContentDb(target).StoreRecordUnsafe(KernelConfig{key, "", hsaco});
+}
 #else
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_KERNEL_CACHE_SIZE_LIMIT)
+
+/// Removes the least recently used binaries (by modification time, which is updated
+/// on every load) once the cache directory grows over the limit.
+static void EvictLeastRecentlyUsed(const boost::filesystem::path& cache_dir)
+{
+    const std::size_t limit = Value(MIOPEN_KERNEL_CACHE_SIZE_LIMIT{}) * 1024 * 1024;
+    if(limit == 0 || cache_dir.empty())
+        return;
+    // Directory scans are expensive, so check the size only once in a while.
+    static std::atomic<std::size_t> saves{0};
+    if(saves++ % 64 != 0)
+        return;
+
+    boost::system::error_code ec;
+    std::vector<std::tuple<std::time_t, std::uintmax_t, boost::filesystem::path>> files;
+    std::uintmax_t total = 0;
+    for(boost::filesystem::recursive_directory_iterator it{cache_dir, ec}, end; !ec && it != end;
+        it.increment(ec))
+    {
+        if(!boost::filesystem::is_regular_file(it->status()) || it->path().extension() != ".o")
+            continue;
+        const auto size = boost::filesystem::file_size(it->path(), ec);
+        if(ec)
+            continue;
+        files.emplace_back(boost::filesystem::last_write_time(it->path(), ec), size, it->path());
+        total += size;
+    }
+    if(total <= limit)
+        return;
+
+    std::sort(files.begin(), files.end());
+    std::size_t evicted = 0;
+    for(const auto& file : files)
+    {
+        if(total <= limit * 9 / 10)
+            break;
+        if(boost::filesystem::remove(std::get<2>(file), ec))
+        {
+            total -= std::get<1>(file);
+            ++evicted;
+        }
+    }
+    MIOPEN_LOG_I("Evicted " << evicted << " kernels from " << cache_dir);
+}
+
 boost::filesystem::path LoadBinary(const TargetProperties& target,
                                    const size_t num_cu,
                                    const std::string& name,
@@ -212,10 +415,18 @@ boost::filesystem::path LoadBinary(const TargetProperties& target,
     auto f = GetCacheFile(target.DbId(), name, args, is_kernel_str);
     if(boost::filesystem::exists(f))
     {
+        // Keeps the binary from being evicted.
+        boost::system::error_code ec;
+        boost::filesystem::last_write_time(f, std::time(nullptr), ec);
+        const auto size = boost::filesystem::file_size(f, ec);
+        if(!ec)
+            counters::Add(counters::Source::KernDb, counters::Counter::BytesRead, size);
+        counters::AddLookup(counters::Source::KernDb, true);
         return f.string();
     }
     else
     {
+        counters::AddLookup(counters::Source::KernDb, false);
         return {};
     }
 }
@@ -235,7 +446,101 @@ void SaveBinary(const boost::filesystem::path& binary_path,
         auto p = GetCacheFile(target.DbId(), name, args, is_kernel_str);
         boost::filesystem::create_directories(p.parent_path());
         boost::filesystem::rename(binary_path, p);
+        EvictLeastRecentlyUsed(GetCachePath(false));
     }
 }
 #endif
+
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE && !MIOPEN_DISABLE_USERDB
+static KernDb& GetUserDb(const TargetProperties& target, size_t num_cu)
+{
+    static const auto user_dir = ComputeUserCachePath();
+    const auto user_path =
+        user_dir.empty() ? user_dir : user_dir / (Handle::GetDbBasename(target, num_cu) + ".ukdb");
+    return KernDb::GetCached(user_path.string(), false, target.DbId(), num_cu);
+}
+
+boost::optional<float> LoadCompileTime(const TargetProperties& target,
+                                       const std::size_t num_cu,
+                                       const std::string& name,
+                                       const std::string& args)
+{
+    if(miopen::IsCacheDisabled())
+        return boost::none;
+
+    return GetUserDb(target, num_cu).FindCompileTimeUnsafe({name, args});
+}
+
+void SaveCompileTime(const float compile_time_ms,
+                     const TargetProperties& target,
+                     const std::size_t num_cu,
+                     const std::string& name,
+                     const std::string& args)
+{
+    if(miopen::IsCacheDisabled())
+        return;
+
+    MIOPEN_LOG_I2("Saving compile time for: " << name << "; args: " << args << "; "
+                                              << compile_time_ms << " ms");
+    GetUserDb(target, num_cu).StoreCompileTimeUnsafe({name, args, compile_time_ms});
+}
+
+static std::string GetApplicationId()
+{
+    // Manifests are per application, the same device is commonly shared by several of them.
+    static const std::string app = [] {
+        boost::system::error_code ec;
+        const auto exe = boost::filesystem::read_symlink("/proc/self/exe", ec);
+        return ec || exe.empty() ? std::string{"unknown"} : exe.filename().string();
+    }();
+    return app;
+}
+
+std::vector<std::pair<std::string, std::string>>
+LoadProgramManifest(const TargetProperties& target, const std::size_t num_cu)
+{
+    std::vector<std::pair<std::string, std::string>> programs;
+    if(miopen::IsCacheDisabled())
+        return programs;
+    for(const auto& entry : GetUserDb(target, num_cu).LoadManifestUnsafe(GetApplicationId()))
+        programs.emplace_back(entry.kernel_name, entry.kernel_args);
+    return programs;
+}
+
+void AddToProgramManifest(const TargetProperties& target,
+                          const std::size_t num_cu,
+                          const std::string& name,
+                          const std::string& args)
+{
+    if(miopen::IsCacheDisabled())
+        return;
+    GetUserDb(target, num_cu).StoreManifestEntryUnsafe({GetApplicationId(), name, args});
+}
+#else
+boost::optional<float> LoadCompileTime(const TargetProperties&,
+                                       std::size_t,
+                                       const std::string&,
+                                       const std::string&)
+{
+    return boost::none;
+}
+
+void SaveCompileTime(
+    float, const TargetProperties&, std::size_t, const std::string&, const std::string&)
+{
+}
+
+std::vector<std::pair<std::string, std::string>> LoadProgramManifest(const TargetProperties&,
+                                                                      std::size_t)
+{
+    return {};
+}
+
+void AddToProgramManifest(const TargetProperties&,
+                          std::size_t,
+                          const std::string&,
+                          const std::string&)
+{
+}
+#endif
 } // namespace miopen
@@ -43,6 +43,7 @@
 #include <exception>
 #include <cstddef>
 #include <cstring>
+#include <memory>
 #include <tuple> // std::ignore
 #include <vector>
 
@@ -566,28 +567,19 @@ class Dataset : ComgrOwner
         d.SetName(name);
         d.SetBytes(content);
         AddData(d);
+        if(type == AMD_COMGR_DATA_KIND_SOURCE || type == AMD_COMGR_DATA_KIND_INCLUDE)
+            LogSourceText(content);
+    }
+    static void LogSourceText(const std::string& content)
+    {
         const auto show_first = miopen::Value(MIOPEN_DEBUG_COMGR_LOG_SOURCE_TEXT{}, 0);
-        if(show_first > 0 && miopen::IsLogging(miopen::LoggingLevel::Info) &&
-           (type == AMD_COMGR_DATA_KIND_SOURCE || type == AMD_COMGR_DATA_KIND_INCLUDE))
+        if(show_first > 0 && miopen::IsLogging(miopen::LoggingLevel::Info))
         {
             const auto text_length = (content.size() > show_first) ? show_first : content.size();
             const std::string text(content, 0, text_length);
             MIOPEN_LOG_I(text);
         }
     }
-#if COMGR_SUPPORTS_PCH
-    void AddDataHipPch(const char* const content, const size_t size) const
-    {
-        const char name[] = "hip.pch";
-        const Data d(AMD_COMGR_DATA_KIND_PRECOMPILED_HEADER);
-        if(miopen::IsEnabled(MIOPEN_DEBUG_COMGR_LOG_SOURCE_NAMES{}))
-            MIOPEN_LOG_I(
-                name << ' ' << size << " bytes,  ptr = " << static_cast<const void*>(content));
-        d.SetName(name);
-        d.SetFromBuffer(content, size);
-        AddData(d);
-    }
-#endif
     size_t GetDataCount(const amd_comgr_data_kind_t kind) const
     {
         std::size_t count = 0;
@@ -697,6 +689,82 @@ static void SetIsaName(const ActionInfo& action, const std::string& device)
     action.SetIsaName(isaName);
 }
 
+/// Inputs that are the same for every HIP build during the process lifetime:
+/// the exported include files and the HIP PCH. comgr data objects are reference
+/// counted, so these are created once and then shared by the datasets of all
+/// subsequent builds, instead of being copied into comgr on every compilation.
+class HipSession
+{
+    std::vector<std::string> include_names;
+    std::vector<std::size_t> include_sizes;
+    std::vector<std::unique_ptr<const Data>> includes;
+#if COMGR_SUPPORTS_PCH
+    std::unique_ptr<const Data> pch;
+    const char* pch_buffer = nullptr;
+    unsigned int pch_size  = 0;
+#endif
+
+    HipSession()
+    {
+        include_names = miopen::GetHipKernelIncList();
+        includes.reserve(include_names.size());
+        for(const auto& inc : include_names)
+        {
+            const auto content = miopen::GetKernelInc(inc);
+            auto d             = std::make_unique<const Data>(AMD_COMGR_DATA_KIND_INCLUDE);
+            d->SetName(inc);
+            d->SetBytes(content);
+            include_sizes.push_back(content.size());
+            includes.emplace_back(std::move(d));
+        }
+        MIOPEN_LOG_I2("comgr HIP session: " << includes.size() << " include files");
+#if COMGR_SUPPORTS_PCH
+        if(compiler::lc::hip::IsPchEnabled())
+        {
+            __hipGetPCH(&pch_buffer, &pch_size);
+            pch = std::make_unique<const Data>(AMD_COMGR_DATA_KIND_PRECOMPILED_HEADER);
+            pch->SetName("hip.pch");
+            pch->SetFromBuffer(pch_buffer, pch_size);
+            MIOPEN_LOG_I2("comgr HIP session: hip.pch " << pch_size << " bytes");
+        }
+#endif
+    }
+
+    public:
+    static const HipSession& Get()
+    {
+        // Initialization may throw ComgrError, then it is retried during the next build.
+        static const HipSession session;
+        return session;
+    }
+
+    /// Logs the includes as Dataset::AddData() does for the data it creates.
+    void AddIncludes(const Dataset& inputs) const
+    {
+        const auto log_names = miopen::IsEnabled(MIOPEN_DEBUG_COMGR_LOG_SOURCE_NAMES{});
+        for(std::size_t i = 0; i < includes.size(); ++i)
+        {
+            if(log_names)
+                MIOPEN_LOG_I(include_names[i] << ' ' << include_sizes[i] << " bytes");
+            inputs.AddData(*includes[i]);
+            if(miopen::Value(MIOPEN_DEBUG_COMGR_LOG_SOURCE_TEXT{}, 0) > 0)
+                Dataset::LogSourceText(miopen::GetKernelInc(include_names[i]));
+        }
+    }
+
+#if COMGR_SUPPORTS_PCH
+    void AddPch(const Dataset& inputs) const
+    {
+        if(!pch)
+            return;
+        if(miopen::IsEnabled(MIOPEN_DEBUG_COMGR_LOG_SOURCE_NAMES{}))
+            MIOPEN_LOG_I("hip.pch " << pch_size << " bytes,  ptr = "
+                                    << static_cast<const void*>(pch_buffer));
+        inputs.AddData(*pch);
+    }
+#endif
+};
+
 static std::string GetDebugCompilerOptionsInsert()
 {
     const char* p = miopen::GetStringEnv(MIOPEN_DEBUG_COMGR_COMPILER_OPTIONS_INSERT{});
@@ -722,18 +790,12 @@ void BuildHip(const std::string& name,
         // of the addkernels tool. We don't do that for HIP sources, and, therefore
         // have to export include files prior compilation.
         // Note that we do not need any "subdirs" in the include "pathnames" so far.
-        const auto incNames = miopen::GetHipKernelIncList();
-        for(const auto& inc : incNames)
-            inputs.AddData(inc, miopen::GetKernelInc(inc), AMD_COMGR_DATA_KIND_INCLUDE);
+        const auto& session = HipSession::Get();
+        session.AddIncludes(inputs);
 
 #if COMGR_SUPPORTS_PCH
         if(compiler::lc::hip::IsPchEnabled())
-        {
-            const char* pch       = nullptr;
-            unsigned int pch_size = 0;
-            __hipGetPCH(&pch, &pch_size);
-            inputs.AddDataHipPch(pch, pch_size);
-        }
+            session.AddPch(inputs);
 #endif
 
         const ActionInfo action;
@@ -29,6 +29,7 @@
 #include <miopen/lock_file.hpp>
 #include <miopen/logger.hpp>
 #include <miopen/md5.hpp>
+#include <miopen/perf_counters.hpp>
 
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/filesystem.hpp>
@@ -157,10 +158,12 @@ boost::optional<DbRecord> PlainTextDb::FindRecordUnsafe(const std::string& key,
         else
             MIOPEN_LOG_I2("File is unreadable: " << filename);
 
+        counters::AddLookup(counters::Source::PlainTextDb, false);
         return boost::none;
     }
 
-    int n_line = 0;
+    int n_line               = 0;
+    std::uint64_t bytes_read = 0;
     while(true)
     {
         std::string line;
@@ -168,6 +171,7 @@ boost::optional<DbRecord> PlainTextDb::FindRecordUnsafe(const std::string& key,
         if(!std::getline(file, line))
             break;
         ++n_line;
+        bytes_read += line.size() + 1;
         const auto next_line_begin = file.tellg();
 
         const auto key_size = line.find('=');
@@ -215,9 +219,13 @@ boost::optional<DbRecord> PlainTextDb::FindRecordUnsafe(const std::string& key,
             pos->begin = line_begin;
             pos->end   = next_line_begin;
         }
+        counters::Add(counters::Source::PlainTextDb, counters::Counter::BytesRead, bytes_read);
+        counters::AddLookup(counters::Source::PlainTextDb, true);
         return record;
     }
     // Record was not found
+    counters::Add(counters::Source::PlainTextDb, counters::Counter::BytesRead, bytes_read);
+    counters::AddLookup(counters::Source::PlainTextDb, false);
     return boost::none;
 }
 
@@ -36,9 +36,25 @@
 #include <algorithm>
 #include <string>
 #include <half.hpp>
+#include <mutex>
 
 namespace miopen {
 
+// The launch of a compiled plan: the kernel and its arguments in kernel order.
+// Compile fills the values known then, Execute patches the tensor pointers and
+// binds the operator arguments again only when their version changes.
+struct FusionPlanInvoker
+{
+    std::size_t handle_id = 0;
+    Kernel kernel;
+    std::vector<OpKernelArg> args;
+    std::vector<std::size_t> input_slots;
+    std::vector<std::size_t> output_slots;
+    std::vector<std::size_t> op_slots;
+    std::size_t bound_version = 0;
+    std::mutex mutex;
+};
+
 FusionPlanDescriptor::FusionPlanDescriptor(const miopenFusionDirection_t dir,
                                            const TensorDescriptor& inDesc)
     : fusion_dir(dir),
@@ -58,6 +74,7 @@ FusionPlanDescriptor::~FusionPlanDescriptor() { op_map.clear(); }
 
 miopenStatus_t FusionPlanDescriptor::AddOp(std::shared_ptr<FusionOpDescriptor> desc)
 {
+    invoker.reset();
     // load the md graph for the first op
     if(op_count == 0)
     {
@@ -169,6 +186,7 @@ miopenStatus_t FusionPlanDescriptor::GetConvAlgos(int reqAlgoCount,
 
 miopenStatus_t FusionPlanDescriptor::SetConvAlgo(miopenConvFwdAlgorithm_t algo)
 {
+    invoker.reset();
     bool res = lu.SetConvAlgo(algo);
 
     if(res)
@@ -916,6 +934,7 @@ OpKernelArg FusionPlanDescriptor::GetDevAttribute(const std::string& k, const Ha
 miopenStatus_t FusionPlanDescriptor::Compile(Handle& handle)
 {
     miopenStatus_t status = miopenStatusUnknownError;
+    invoker.reset();
     if(!isValid() || (lu.GetCurVertex(handle) == nullptr))
     {
         MIOPEN_LOG_I2(
@@ -1059,6 +1078,33 @@ miopenStatus_t FusionPlanDescriptor::Compile(Handle& handle)
         }
     }
     arg_list = CalcArgOrder(handle);
+    if(arg_list.empty())
+    {
+        MIOPEN_THROW("Kernel arguments not setup properly");
+    }
+
+    const auto& built = handle.GetKernelsImpl(algorithm_name, network_config);
+    if(built.empty())
+    {
+        MIOPEN_THROW(miopenStatusInternalError, "The fused kernel was not built");
+    }
+    invoker            = std::make_unique<FusionPlanInvoker>();
+    invoker->handle_id = handle.GetId();
+    invoker->kernel    = built.front();
+    for(std::size_t idx = 0; idx < arg_list.size(); idx++)
+    {
+        const auto& arg = arg_list[idx];
+        switch(arg.type)
+        {
+        case Input_Ptr: invoker->input_slots.push_back(idx); break;
+        case Output_Ptr: invoker->output_slots.push_back(idx); break;
+        case Scalar:
+        case Pointer: invoker->op_slots.push_back(idx); break;
+        case Padding:
+        case Default: break;
+        }
+        invoker->args.push_back(arg.type == Padding ? OpKernelArg(0, arg.size) : arg.val);
+    }
     return status;
 }
 
@@ -1236,7 +1282,7 @@ miopenStatus_t FusionPlanDescriptor::Execute(const Handle& handle,
                                              Data_t output,
                                              const OperatorArgs& op_args)
 {
-    if(!isValid() || (lu.GetCurVertex(handle) == nullptr))
+    if(!isValid())
     {
         MIOPEN_THROW(miopenStatusBadParm, "Attempting to execute an invalid fusion plan.");
     }
@@ -1250,51 +1296,52 @@ miopenStatus_t FusionPlanDescriptor::Execute(const Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "The input descriptors dont match.");
     }
 
-    auto ops_head = op_map[0];
-
-    auto&& kernels = handle.GetKernels(algorithm_name, network_config);
-    MIOPEN_LOG_I(algorithm_name << ',' << network_config);
-    if(kernels.empty())
+    if(invoker == nullptr)
     {
         MIOPEN_THROW(miopenStatusBadParm, "The FusionPlan was not compiled for execution");
     }
-    KernelInvoke kernel = kernels.front();
+    MIOPEN_LOG_I(algorithm_name << ',' << network_config);
 
-    std::vector<OpKernelArg> args;
-    if(arg_list.empty())
-    {
-        MIOPEN_THROW("Kernel arguments not setup properly");
-    }
-    for(auto& arg : arg_list)
+    std::lock_guard<std::mutex> lock(invoker->mutex);
+    if(invoker->bound_version != op_args.version)
     {
-        MIOPEN_LOG_I2("Key: " + arg.key);
-        switch(arg.type)
+        for(auto idx : invoker->op_slots)
         {
-        case Input_Ptr: args.emplace_back(OpKernelArg(input)); break;
-        case Output_Ptr: args.emplace_back(OpKernelArg(output)); break;
-        case Padding: args.emplace_back(OpKernelArg(0, arg.size)); break;
-        case Scalar:
-        case Pointer:
-        {
-            auto it = op_args.args_map.find(arg.key);
-            if(it != op_args.args_map.end())
-            {
-                args.push_back(it->second);
-            }
-            else
+            const auto& key = arg_list[idx].key;
+            MIOPEN_LOG_I2("Key: " + key);
+            auto it = op_args.args_map.find(key);
+            if(it == op_args.args_map.end())
             {
-                MIOPEN_THROW(miopenStatusInternalError, "Argument Not Set: " + arg.key);
+                MIOPEN_THROW(miopenStatusInternalError, "Argument Not Set: " + key);
             }
-            break;
-        }
-        case Default: args.push_back(arg.val); break;
+            invoker->args[idx] = it->second;
         }
+        invoker->bound_version = op_args.version;
+    }
+    for(auto idx : invoker->input_slots)
+        invoker->args[idx] = OpKernelArg(input);
+    for(auto idx : invoker->output_slots)
+        invoker->args[idx] = OpKernelArg(output);
+
+    // The kernel is compiled in the cache of the handle given to Compile
+    if(handle.GetId() == invoker->handle_id)
+    {
+        handle.Run(invoker->kernel)(invoker->args);
     }
-    if(args.empty())
+    else
     {
-        MIOPEN_THROW("Operator args not populated properly");
+        if(lu.GetCurVertex(handle) == nullptr)
+        {
+            MIOPEN_THROW(miopenStatusBadParm, "Attempting to execute an invalid fusion plan.");
+        }
+        auto&& kernels = handle.GetKernels(algorithm_name, network_config);
+        if(kernels.empty())
+        {
+            MIOPEN_THROW(miopenStatusBadParm, "The FusionPlan was not compiled for execution");
+        }
+        KernelInvoke kernel = kernels.front();
+        kernel(invoker->args);
     }
-    kernel(args);
     return miopenStatusSuccess;
 }
 
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include <miopen/fusion_planner.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/logger.hpp>
+
+#include <limits>
+#include <utility>
+
+namespace miopen {
+
+// Nodes whose outputs are read by the next node only, the runs of a chain are
+// the candidates for fusion
+static std::vector<std::vector<int>> SplitChains(const std::vector<FusionGraphNode>& nodes,
+                                                 const std::vector<int>& consumers)
+{
+    std::vector<int> next(nodes.size(), -1);
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        if(nodes[i].input >= 0)
+            next[nodes[i].input] = static_cast<int>(i);
+    }
+
+    std::vector<std::vector<int>> chains;
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const auto input = nodes[i].input;
+        if(input >= 0 && consumers[input] == 1)
+            continue;
+        std::vector<int> chain = {static_cast<int>(i)};
+        while(consumers[chain.back()] == 1)
+            chain.push_back(next[chain.back()]);
+        chains.push_back(std::move(chain));
+    }
+    return chains;
+}
+
+// A plan of the nodes chain[first] .. chain[last - 1], null when the metadata
+// graph stops matching before last. supported[len] tells if the plan of the
+// first len nodes has a kernel for the device.
+static std::shared_ptr<FusionPlanDescriptor> AddNodes(const Handle& handle,
+                                                      const std::vector<FusionGraphNode>& nodes,
+                                                      const std::vector<int>& chain,
+                                                      const TensorDescriptor& input,
+                                                      std::size_t first,
+                                                      std::size_t last,
+                                                      std::vector<bool>& supported)
+{
+    auto plan = std::make_shared<FusionPlanDescriptor>(miopenVerticalFusion, input);
+    supported.assign(last - first + 1, false);
+    for(auto k = first; k < last; k++)
+    {
+        try
+        {
+            if(plan->AddOp(nodes[chain[k]].op) != miopenStatusSuccess)
+                return nullptr;
+        }
+        catch(const miopen::Exception&)
+        {
+            // Operators that cannot lead a plan
+            return nullptr;
+        }
+        supported[k - first + 1] = plan->isSupported(handle);
+    }
+    return plan;
+}
+
+std::vector<FusionGroup> PlanFusion(const Handle& handle,
+                                    const std::vector<FusionGraphNode>& nodes)
+{
+    std::vector<TensorDescriptor> in_descs(nodes.size());
+    std::vector<TensorDescriptor> out_descs(nodes.size());
+    std::vector<int> consumers(nodes.size(), 0);
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const auto& node = nodes[i];
+        if(node.op == nullptr)
+            MIOPEN_THROW(miopenStatusBadParm, "Fusion graph node without an operator");
+        if(node.input >= static_cast<int>(i))
+            MIOPEN_THROW(miopenStatusBadParm, "Fusion graph nodes are not in topological order");
+        if(node.input >= 0)
+        {
+            in_descs[i] = out_descs[node.input];
+            consumers[node.input]++;
+        }
+        else
+        {
+            in_descs[i] = node.input_desc;
+        }
+        node.op->SetInputDesc(in_descs[i]);
+        if(node.op->GetOutputDesc(out_descs[i]) != miopenStatusSuccess)
+            MIOPEN_THROW(miopenStatusBadParm, "Fusion graph node without an output tensor");
+    }
+
+    std::vector<FusionGroup> groups;
+    for(const auto& chain : SplitChains(nodes, consumers))
+    {
+        const auto m = chain.size();
+        // fuses[j][len]: chain[j] .. chain[j + len - 1] make a supported plan
+        std::vector<std::vector<bool>> fuses(m);
+        for(std::size_t j = 0; j < m; j++)
+            AddNodes(handle, nodes, chain, in_descs[chain[j]], j, m, fuses[j]);
+
+        // Least traffic, then fewest groups, of the first k nodes
+        using cost_t = std::pair<std::size_t, std::size_t>;
+        std::vector<cost_t> best(m + 1, {std::numeric_limits<std::size_t>::max(), 0});
+        std::vector<std::size_t> start(m + 1, 0);
+        best[0] = {0, 0};
+        for(std::size_t k = 1; k <= m; k++)
+        {
+            for(std::size_t j = 0; j < k; j++)
+            {
+                if(k - j > 1 && !fuses[j][k - j])
+                    continue;
+                const auto traffic =
+                    in_descs[chain[j]].GetNumBytes() + out_descs[chain[k - 1]].GetNumBytes();
+                const cost_t cost = {best[j].first + traffic, best[j].second + 1};
+                if(cost < best[k])
+                {
+                    best[k]  = cost;
+                    start[k] = j;
+                }
+            }
+        }
+
+        std::vector<FusionGroup> chain_groups;
+        for(auto k = m; k > 0; k = start[k])
+        {
+            FusionGroup group;
+            const auto j = start[k];
+            group.nodes.assign(chain.begin() + j, chain.begin() + k);
+            group.traffic = best[k].first - best[j].first;
+            if(k - j > 1)
+            {
+                std::vector<bool> supported;
+                group.plan = AddNodes(handle, nodes, chain, in_descs[chain[j]], j, k, supported);
+                if(group.plan == nullptr || !supported.back())
+                    MIOPEN_THROW(miopenStatusInternalError, "Fusion plan no longer matches");
+            }
+            else
+            {
+                nodes[chain[j]].op->SetIdx(0);
+                nodes[chain[j]].op->SetInputDesc(in_descs[chain[j]]);
+            }
+            MIOPEN_LOG_I2("Fusion group: nodes " << group.nodes.front() << ".."
+                                                 << group.nodes.back() << ", traffic "
+                                                 << group.traffic
+                                                 << (group.plan ? ", fused" : ", unfused"));
+            chain_groups.push_back(std::move(group));
+        }
+        groups.insert(groups.end(),
+                      std::make_move_iterator(chain_groups.rbegin()),
+                      std::make_move_iterator(chain_groups.rend()));
+    }
+    return groups;
+}
+
+} // namespace miopen
@@ -27,6 +27,7 @@
 #include <miopen/version.h>
 #include <miopen/errors.hpp>
 #include <miopen/handle.hpp>
+#include <miopen/perf_counters.hpp>
 
 extern "C" const char* miopenGetErrorString(miopenStatus_t error)
 {
@@ -112,3 +113,35 @@ extern "C" miopenStatus_t miopenEnableProfiling(miopenHandle_t handle, bool enab
 {
     return miopen::try_([&] { miopen::deref(handle).EnableProfiling(enable); });
 }
+
+static_assert(static_cast<int>(miopen::counters::Source::KernDb) == miopenCounterSourceBinaryCache,
+              "miopenCounterSource_t does not match miopen::counters::Source");
+
+extern "C" miopenStatus_t miopenGetCounters(miopenHandle_t handle,
+                                            miopenCounterSource_t source,
+                                            miopenCounters_t* counters)
+{
+    return miopen::try_([&] {
+        miopen::deref(handle);
+        if(source < miopenCounterSourceKernelCache || source > miopenCounterSourceBinaryCache)
+            MIOPEN_THROW(miopenStatusBadParm, "Unknown counter source");
+        using miopen::counters::Counter;
+        const auto values = miopen::counters::Get(static_cast<miopen::counters::Source>(source));
+        const auto get    = [&](Counter c) { return values[static_cast<std::size_t>(c)]; };
+        auto& out         = miopen::deref(counters);
+        out.lookups       = get(Counter::Lookups);
+        out.hits          = get(Counter::Hits);
+        out.misses        = get(Counter::Misses);
+        out.bytesRead     = get(Counter::BytesRead);
+        out.compiles      = get(Counter::Compiles);
+        out.compileTime   = get(Counter::CompileTimeUs) * 0.001f;
+    });
+}
+
+extern "C" miopenStatus_t miopenResetCounters(miopenHandle_t handle)
+{
+    return miopen::try_([&] {
+        miopen::deref(handle);
+        miopen::counters::Reset();
+    });
+}
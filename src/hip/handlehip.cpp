@@ -35,9 +35,12 @@
 #include <miopen/invoker.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/perf_counters.hpp>
+#include <miopen/par_for.hpp>
 #include <miopen/rocm_features.hpp>
 #include <miopen/target_properties.hpp>
 #include <miopen/timer.hpp>
+#include <miopen/trace.hpp>
 
 #if !MIOPEN_ENABLE_SQLITE_KERN_CACHE
 #include <miopen/write_file.hpp>
@@ -53,8 +56,10 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <future>
 #include <thread>
 
 #define MIOPEN_WORKAROUND_ROCM_COMPILER_SUPPORT_ISSUE_30 (MIOPEN_USE_COMGR && BUILD_SHARED_LIBS)
@@ -152,6 +157,9 @@ struct HandleImpl
 
     HandleImpl() : ctx(get_ctx()) {}
 
+    // Joins the preload threads before the rest of the members go away.
+    ~HandleImpl() { stop_preload = true; }
+
     StreamPtr create_stream()
     {
         hipStream_t result;
@@ -197,6 +205,60 @@ struct HandleImpl
         return name;
     }
 
+    struct PreloadJob
+    {
+        std::string name;
+        std::string params;
+        std::promise<Program> program;
+    };
+
+    /// Loads the programs used by the application in the previous runs from the
+    /// kernel cache in background, so that the first calls do not wait for them.
+    void start_preload(std::size_t num_cu)
+    {
+        if(!KernelCache::IsPreloadEnabled())
+            return;
+        const auto manifest = miopen::LoadProgramManifest(target_properties, num_cu);
+        if(manifest.empty())
+            return;
+        MIOPEN_LOG_I2("Preloading " << manifest.size() << " programs");
+
+        auto jobs = std::make_shared<std::vector<PreloadJob>>(manifest.size());
+        for(std::size_t i = 0; i < manifest.size(); ++i)
+        {
+            auto& job  = (*jobs)[i];
+            job.name   = manifest[i].first;
+            job.params = manifest[i].second;
+            cache.AddPreload(job.name, job.params, job.program.get_future().share());
+        }
+
+        auto next            = std::make_shared<std::atomic<std::size_t>>(0);
+        const auto n_threads = std::min<std::size_t>(jobs->size(), 4);
+        for(std::size_t t = 0; t < n_threads; ++t)
+        {
+            preload_threads.emplace_back([this, jobs, next, num_cu, target = target_properties] {
+                for(auto i = (*next)++; i < jobs->size() && !stop_preload; i = (*next)++)
+                {
+                    auto& job = (*jobs)[i];
+                    try
+                    {
+                        miopen::set_ctx(ctx);
+                        // Keep in sync with Handle::LoadProgram().
+                        const auto hsaco = miopen::LoadBinary(
+                            target, num_cu, job.name, job.params + " -mcpu=" + target.Name());
+                        if(hsaco.empty())
+                            MIOPEN_THROW("Not found in the kernel cache");
+                        job.program.set_value(HIPOCProgram{job.name, hsaco});
+                    }
+                    catch(...)
+                    {
+                        job.program.set_exception(std::current_exception());
+                    }
+                }
+            });
+        }
+    }
+
     bool enable_profiling  = false;
     StreamPtr stream       = nullptr;
     float profiling_result = 0.0;
@@ -205,6 +267,9 @@ struct HandleImpl
     KernelCache cache;
     hipCtx_t ctx;
     TargetProperties target_properties;
+    std::atomic<bool> stop_preload{false};
+    // Must be the last member, the threads use all of the above.
+    std::vector<joinable_thread> preload_threads;
 };
 
 Handle::Handle(miopenAcceleratorQueue_t stream) : impl(new HandleImpl())
@@ -224,6 +289,7 @@ Handle::Handle(miopenAcceleratorQueue_t stream) : impl(new HandleImpl())
 #endif
     this->impl->target_properties.Init(this);
     MIOPEN_LOG_NQI(*this);
+    this->impl->start_preload(this->GetMaxComputeUnits());
 }
 
 Handle::Handle() : impl(new HandleImpl())
@@ -244,6 +310,7 @@ Handle::Handle() : impl(new HandleImpl())
 #endif
     this->impl->target_properties.Init(this);
     MIOPEN_LOG_NQI(*this);
+    this->impl->start_preload(this->GetMaxComputeUnits());
 }
 
 Handle::~Handle() {}
@@ -340,6 +407,7 @@ KernelInvoke Handle::AddKernel(const std::string& algorithm,
 Invoker Handle::PrepareInvoker(const InvokerFactory& factory,
                                const std::vector<solver::KernelInfo>& kernels) const
 {
+    MIOPEN_TRACE_SCOPE("Handle::PrepareInvoker");
     std::vector<Kernel> built;
     for(auto& k : kernels)
     {
@@ -388,30 +456,78 @@ Program Handle::LoadProgram(const std::string& program_name,
                             bool is_kernel_str,
                             const std::string& kernel_src) const
 {
+    MIOPEN_TRACE_SCOPE_DETAIL("Handle::LoadProgram", program_name);
     this->impl->set_ctx();
+    // Compile times are keyed the same way as PrecompileKernels() looks them up.
+    const auto compile_time_args = params;
     params += " -mcpu=" + this->GetTargetProperties().Name();
     auto hsaco = miopen::LoadBinary(this->GetTargetProperties(),
                                     this->GetMaxComputeUnits(),
                                     program_name,
                                     params,
                                     is_kernel_str);
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+    std::string content_key;
+    if(hsaco.empty())
+    {
+        // An identical kernel may have been built by another MIOpen version
+        // or with an equivalent set of options.
+        content_key = miopen::GetKernelContentKey(
+            this->GetTargetProperties(), program_name, params, is_kernel_str, kernel_src);
+        hsaco = miopen::LoadBinaryByContent(this->GetTargetProperties(), content_key);
+        if(!hsaco.empty())
+            miopen::SaveBinary(hsaco,
+                               this->GetTargetProperties(),
+                               this->GetMaxComputeUnits(),
+                               program_name,
+                               params,
+                               is_kernel_str);
+    }
+#endif
     if(hsaco.empty())
     {
+        MIOPEN_TRACE_SCOPE_DETAIL("Handle::BuildProgram", program_name);
         CompileTimer ct;
+        Timer timer;
+        timer.start();
         auto p = HIPOCProgram{
             program_name, params, is_kernel_str, this->GetTargetProperties(), kernel_src};
         ct.Log("Kernel", is_kernel_str ? std::string() : program_name);
+        const auto compile_ms = timer.elapsed_ms();
+        counters::Add(counters::Source::KernDb, counters::Counter::Compiles);
+        counters::Add(counters::Source::KernDb,
+                      counters::Counter::CompileTimeUs,
+                      static_cast<std::uint64_t>(compile_ms * 1000));
+        if(!is_kernel_str)
+        {
+            // The compile time is only a hint, failing to record it must not fail the build.
+            try
+            {
+                miopen::SaveCompileTime(compile_ms,
+                                        this->GetTargetProperties(),
+                                        this->GetMaxComputeUnits(),
+                                        program_name,
+                                        compile_time_args);
+            }
+            catch(const std::exception& ex)
+            {
+                MIOPEN_LOG_W("Unable to save the compile time of " << program_name << ": "
+                                                                   << ex.what());
+            }
+        }
 
 // Save to cache
 #if MIOPEN_ENABLE_SQLITE_KERN_CACHE
-        miopen::SaveBinary(p.IsCodeObjectInMemory()
-                               ? p.GetCodeObjectBlob()
-                               : miopen::LoadFile(p.GetCodeObjectPathname().string()),
+        const auto binary = p.IsCodeObjectInMemory()
+                                ? p.GetCodeObjectBlob()
+                                : miopen::LoadFile(p.GetCodeObjectPathname().string());
+        miopen::SaveBinary(binary,
                            this->GetTargetProperties(),
                            this->GetMaxComputeUnits(),
                            program_name,
                            params,
                            is_kernel_str);
+        miopen::SaveBinaryByContent(binary, this->GetTargetProperties(), content_key);
 #else
         auto path      = miopen::GetCachePath(false) / boost::filesystem::unique_path();
         if(p.IsCodeObjectInMemory())
@@ -28,6 +28,7 @@
 #include <miopen/errors.hpp>
 #include <miopen/hipoc_kernel.hpp>
 #include <miopen/handle_lock.hpp>
+#include <miopen/trace.hpp>
 
 #include <hip/hip_ext.h>
 #include <hip/hip_runtime.h>
@@ -41,6 +42,7 @@ namespace miopen {
 
 void HIPOCKernelInvoke::run(void* args, std::size_t size) const
 {
+    MIOPEN_TRACE_SCOPE_DETAIL("Kernel::Launch", name);
     HipEventPtr start = nullptr;
     HipEventPtr stop  = nullptr;
     void* config[]    = {
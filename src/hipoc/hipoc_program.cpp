@@ -56,7 +56,9 @@ MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_OPENCL_ENFORCE_CODE_OBJECT_OPTION)
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEBUG_OPENCL_ENFORCE_CODE_OBJECT_VERSION)
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEVICE_ARCH)
 
-#define MIOPEN_WORKAROUND_SWDEV_225285 1
+/// hipModuleLoadData() is reliable starting from HIP 4.0, so code objects
+/// do not have to make a round trip through a temporary file.
+#define MIOPEN_WORKAROUND_SWDEV_225285 (HIP_PACKAGE_VERSION_FLAT < 4000000000ULL)
 
 #if MIOPEN_USE_COMGR
 #define MIOPEN_WORKAROUND_ROCM_COMPILER_SUPPORT_ISSUE_27 1
@@ -188,14 +190,10 @@ struct HIPOCProgramImpl
     HIPOCProgramImpl(const std::string& program_name, const std::string& blob)
         : program(program_name)
     {
-        TmpDir tmp_dir("miopen");
-        auto file_path =
-            tmp_dir.path / boost::filesystem::unique_path("miopen-%%%%-%%%%-%%%%-%%%%");
-        WriteFile(blob, file_path);
         const char* const arch = miopen::GetStringEnv(MIOPEN_DEVICE_ARCH{});
         if(arch == nullptr)
         {
-            this->module = CreateModule(file_path);
+            this->module = CreateModuleInMem(blob);
         }
     }
 
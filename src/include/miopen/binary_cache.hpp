@@ -30,7 +30,10 @@
 #include <miopen/config.h>
 #include <miopen/target_properties.hpp>
 #include <boost/filesystem/path.hpp>
+#include <boost/optional/optional.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace miopen {
 
@@ -67,6 +70,55 @@ void SaveBinary(const std::string& hsaco,
                 bool is_kernel_str = false);
 #endif
 
+/// Rewrites compiler options into a canonical form for content addressing:
+/// macro definitions (-D and -Wa,-defsym) are moved to the end in sorted order
+/// with the last definition of each name winning. All definitions are kept, the
+/// included headers may refer to the names the kernel source does not.
+std::string NormalizeCompileOptions(const std::string& options);
+
+/// Key of the content-addressed kernel cache. Unlike the key used by
+/// LoadBinary/SaveBinary, it depends on the kernel source text rather than
+/// its name and on the normalized options, and it does not depend on the
+/// MIOpen version.
+std::string GetKernelContentKey(const TargetProperties& target,
+                                const std::string& name,
+                                const std::string& args,
+                                bool is_kernel_str,
+                                const std::string& kernel_src);
+
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+/// Directory of the content-addressed kernel cache (*.ckdb), shared by all MIOpen
+/// versions. Empty when the user databases are disabled.
+boost::filesystem::path GetContentCachePath();
+std::string LoadBinaryByContent(const TargetProperties& target, const std::string& key);
+void SaveBinaryByContent(const std::string& hsaco,
+                         const TargetProperties& target,
+                         const std::string& key);
+#endif
+
+/// Returns the duration of the last build of a kernel file with the given compiler
+/// options on the target, or none if it has never been recorded.
+boost::optional<float> LoadCompileTime(const TargetProperties& target,
+                                       std::size_t num_cu,
+                                       const std::string& name,
+                                       const std::string& args);
+
+void SaveCompileTime(float compile_time_ms,
+                     const TargetProperties& target,
+                     std::size_t num_cu,
+                     const std::string& name,
+                     const std::string& args);
+
+/// Programs (name and compiler options) that the running application has loaded on
+/// the target in previous runs, in the order of their first use.
+std::vector<std::pair<std::string, std::string>>
+LoadProgramManifest(const TargetProperties& target, std::size_t num_cu);
+
+void AddToProgramManifest(const TargetProperties& target,
+                          std::size_t num_cu,
+                          const std::string& name,
+                          const std::string& args);
+
 } // namespace miopen
 
 #endif
@@ -28,6 +28,7 @@
 
 #include <miopen/db_record.hpp>
 #include <miopen/rank.hpp>
+#include <miopen/trace.hpp>
 
 #include <boost/core/explicit_operator_bool.hpp>
 #include <boost/none.hpp>
@@ -335,58 +336,59 @@ class DbTimer
     template <typename... U>
     auto FindRecord(const U&... args)
     {
-        return Measure("FindRecord", [&]() { return inner.FindRecord(args...); });
+        return Measure("Db::FindRecord", [&]() { return inner.FindRecord(args...); });
     }
 
     template <typename... U>
     auto StoreRecord(U&... record)
     {
-        return Measure("StoreRecord", [&]() { return inner.StoreRecord(record...); });
+        return Measure("Db::StoreRecord", [&]() { return inner.StoreRecord(record...); });
     }
 
     template <typename... U>
     auto UpdateRecord(U&... args)
     {
-        return Measure("UpdateRecord", [&]() { return inner.UpdateRecord(args...); });
+        return Measure("Db::UpdateRecord", [&]() { return inner.UpdateRecord(args...); });
     }
 
     template <typename... U>
     auto RemoveRecord(const U&... args)
     {
-        return Measure("RemoveRecord", [&]() { return inner.RemoveRecord(args...); });
+        return Measure("Db::RemoveRecord", [&]() { return inner.RemoveRecord(args...); });
     }
 
     template <typename... U>
     auto Update(const U&... args)
     {
-        return Measure("Update", [&]() { return inner.Update(args...); });
+        return Measure("Db::Update", [&]() { return inner.Update(args...); });
     }
 
     template <typename... U>
     bool Load(U&... args)
     {
-        return Measure("Load", [&]() { return inner.Load(args...); });
+        return Measure("Db::Load", [&]() { return inner.Load(args...); });
     }
 
     template <typename... U>
     bool Remove(const U&... args)
     {
-        return Measure("Remove", [&]() { return inner.Remove(args...); });
+        return Measure("Db::Remove", [&]() { return inner.Remove(args...); });
     }
 
     private:
     TInnerDb inner;
 
     template <class TFunc>
-    static auto Measure(const std::string& funcName, TFunc&& func)
+    static auto Measure(const char* funcName, TFunc&& func)
     {
+        MIOPEN_TRACE_SCOPE(funcName);
         if(!miopen::IsLogging(LoggingLevel::Info2))
             return func();
 
         const auto start = std::chrono::high_resolution_clock::now();
         auto ret         = func();
         const auto end   = std::chrono::high_resolution_clock::now();
-        MIOPEN_LOG_I2("Db::" << funcName << " time: " << (end - start).count() * .000001f << " ms");
+        MIOPEN_LOG_I2(funcName << " time: " << (end - start).count() * .000001f << " ms");
         return ret;
     }
 };
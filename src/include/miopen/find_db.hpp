@@ -33,6 +33,7 @@
 #include <miopen/env.hpp>
 #include <miopen/perf_field.hpp>
 #include <miopen/readonlyramdb.hpp>
+#include <miopen/trace.hpp>
 
 #include <boost/optional.hpp>
 
@@ -136,6 +137,7 @@ class FindDbRecord_t
                                           const TProblemDescription& problem,
                                           const std::function<void(DbRecord&)>& regenerator)
     {
+        MIOPEN_TRACE_SCOPE("FindDbRecord::TryLoad");
         auto ret = std::vector<PerfField>{};
         FindDbRecord_t<TDb> record{handle, problem};
 
@@ -56,6 +56,9 @@ struct OperatorArgs : miopenOperatorArgs
     friend std::ostream& operator<<(std::ostream& stream, const OperatorArgs& x);
     std::vector<OpKernelArg> args_vec;
     std::unordered_map<std::string, OpKernelArg> args_map;
+    // Unique over all the objects and changed by every ins_arg, so equal
+    // versions mean equal arguments
+    std::size_t version;
 };
 
 struct FusionOpDescriptor : miopenFusionOpDescriptor
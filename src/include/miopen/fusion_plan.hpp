@@ -7,6 +7,8 @@
 #include <miopen/fusion.hpp>
 #include <miopen/md_graph.hpp>
 
+#include <memory>
+
 namespace miopen {
 
 enum Exec_Arg_Type_t
@@ -35,11 +37,17 @@ struct Exec_arg_t
     }
 };
 
+struct FusionPlanInvoker;
+
 struct FusionPlanDescriptor : miopenFusionPlanDescriptor
 {
     FusionPlanDescriptor(miopenFusionDirection_t dir, const TensorDescriptor& inDesc);
     ~FusionPlanDescriptor();
     bool isValid() const { return is_valid; };
+    bool isSupported(const Handle& handle)
+    {
+        return is_valid && lu.GetCurVertex(handle) != nullptr;
+    }
     miopenStatus_t AddOp(std::shared_ptr<FusionOpDescriptor> desc);
     miopenStatus_t RemoveOp(FusionOpDescriptor& desc);
     TensorDescriptor DeriveOutputDescriptor();
@@ -90,6 +98,7 @@ struct FusionPlanDescriptor : miopenFusionPlanDescriptor
     std::string network_config;
     miopenDataType_t data_type;
     std::vector<Exec_arg_t> arg_list;
+    std::unique_ptr<FusionPlanInvoker> invoker;
 };
 
 } // namespace miopen
@@ -0,0 +1,66 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef MIOPEN_GUARD_MLOPEN_FUSION_PLANNER_HPP
+#define MIOPEN_GUARD_MLOPEN_FUSION_PLANNER_HPP
+
+#include <miopen/fusion_plan.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace miopen {
+
+struct Handle;
+
+// An operator of the graph to plan. Every operator has one input tensor, the
+// output of an earlier node or, when input is -1, a tensor of the graph.
+struct FusionGraphNode
+{
+    std::shared_ptr<FusionOpDescriptor> op;
+    int input = -1;
+    TensorDescriptor input_desc;
+};
+
+// Nodes that run as one fusion plan, or a single node that runs unfused when
+// plan is null. Traffic is the modeled size of the tensors read and written.
+struct FusionGroup
+{
+    std::vector<int> nodes;
+    std::shared_ptr<FusionPlanDescriptor> plan;
+    std::size_t traffic = 0;
+};
+
+// Splits the nodes, in topological order, into fusion plans and unfused
+// operators with the least tensor traffic, asking the metadata graph which
+// runs of operators fuse on the device. A run fuses only when the outputs
+// inside it have no other consumer. The plans are valid, not compiled, and the
+// groups are in an order that runs the producers first.
+std::vector<FusionGroup> PlanFusion(const Handle& handle,
+                                    const std::vector<FusionGraphNode>& nodes);
+
+} // namespace miopen
+
+#endif
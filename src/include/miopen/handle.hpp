@@ -42,6 +42,7 @@
 
 #include <boost/range/adaptor/transformed.hpp>
 
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <ios>
@@ -79,6 +80,10 @@ struct Handle : miopenHandle
     miopenAcceleratorQueue_t GetStream() const;
     void SetStream(miopenAcceleratorQueue_t streamID) const;
 
+    /// Unique in the process, unlike the address of a handle, which may be reused by a
+    /// handle created after this one is destroyed.
+    std::size_t GetId() const { return id; }
+
     void SetAllocator(miopenAllocatorFunction allocator,
                       miopenDeallocatorFunction deallocator,
                       void* allocatorContext) const;
@@ -259,6 +264,14 @@ struct Handle : miopenHandle
     private:
 #endif
     InvokerCache invokers;
+
+    static std::size_t NewId()
+    {
+        static std::atomic<std::size_t> next{0};
+        return ++next;
+    }
+
+    std::size_t id = NewId();
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Handle& handle) { return handle.Print(os); }
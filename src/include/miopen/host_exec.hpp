@@ -0,0 +1,220 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_HOST_EXEC_HPP_
+#define GUARD_MIOPEN_HOST_EXEC_HPP_
+
+#include <miopen/common.hpp>
+#include <miopen/miopen.h>
+
+#include <cstddef>
+
+namespace miopen {
+
+struct Handle;
+struct TensorDescriptor;
+struct ActivationDescriptor;
+struct PoolingDescriptor;
+struct ConvolutionDescriptor;
+
+/// True when the HIPNOGPU handle executes the primitives on the host
+/// (MIOPEN_NOGPU_HOST_EXECUTION=1). Buffers are host memory then.
+/// Only defined by the HIPNOGPU backend, guard the calls with MIOPEN_MODE_NOGPU.
+bool IsHostExecution(const Handle& handle);
+
+/// Host implementations of the primitives. Each one expects the arguments
+/// already validated by the library entry point that dispatches to it, and
+/// throws miopenStatusNotImplemented for unsupported data types.
+namespace host {
+
+void ActivationForward(const ActivationDescriptor& desc,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& yDesc,
+                       Data_t y,
+                       std::size_t xOffset,
+                       std::size_t yOffset);
+
+void ActivationBackward(const ActivationDescriptor& desc,
+                        const TensorDescriptor& yDesc,
+                        ConstData_t y,
+                        const TensorDescriptor& dyDesc,
+                        ConstData_t dy,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& dxDesc,
+                        Data_t dx,
+                        std::size_t yOffset,
+                        std::size_t dyOffset,
+                        std::size_t xOffset,
+                        std::size_t dxOffset);
+
+void SoftmaxForward(const void* alpha,
+                    const void* beta,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    miopenSoftmaxAlgorithm_t algorithm,
+                    miopenSoftmaxMode_t mode,
+                    std::size_t xOffset,
+                    std::size_t yOffset);
+
+void SoftmaxBackward(const void* alpha,
+                     const TensorDescriptor& yDesc,
+                     ConstData_t y,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const void* beta,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     miopenSoftmaxAlgorithm_t algorithm,
+                     miopenSoftmaxMode_t mode,
+                     std::size_t yOffset,
+                     std::size_t dyOffset,
+                     std::size_t dxOffset);
+
+void PoolingForward(const PoolingDescriptor& desc,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    bool save_index,
+                    Data_t workSpace);
+
+void PoolingBackward(const PoolingDescriptor& desc,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     ConstData_t workSpace);
+
+void BatchNormForwardTraining(miopenBatchNormMode_t bn_mode,
+                              const TensorDescriptor& xDesc,
+                              ConstData_t x,
+                              Data_t y,
+                              const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                              ConstData_t bnScale,
+                              ConstData_t bnBias,
+                              double expAvgFactor,
+                              Data_t resultRunningMean,
+                              Data_t resultRunningVariance,
+                              double epsilon,
+                              Data_t resultSaveMean,
+                              Data_t resultSaveInvVariance);
+
+void BatchNormForwardInference(miopenBatchNormMode_t bn_mode,
+                               const TensorDescriptor& xDesc,
+                               ConstData_t x,
+                               Data_t y,
+                               const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                               ConstData_t bnScale,
+                               ConstData_t bnBias,
+                               ConstData_t estimatedMean,
+                               ConstData_t estimatedVariance,
+                               double epsilon);
+
+void BatchNormBackward(miopenBatchNormMode_t bn_mode,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       ConstData_t dy,
+                       Data_t dx,
+                       const TensorDescriptor& bnScaleBiasDiffDesc,
+                       ConstData_t bnScale,
+                       Data_t resultBnScaleDiff,
+                       Data_t resultBnBiasDiff,
+                       double epsilon,
+                       ConstData_t savedMean,
+                       ConstData_t savedInvVariance);
+
+void ConvolutionForward(const ConvolutionDescriptor& conv,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& wDesc,
+                        ConstData_t w,
+                        const TensorDescriptor& yDesc,
+                        Data_t y);
+
+void ConvolutionBackwardData(const ConvolutionDescriptor& conv,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& wDesc,
+                             ConstData_t w,
+                             const TensorDescriptor& dxDesc,
+                             Data_t dx);
+
+void ConvolutionBackwardWeights(const ConvolutionDescriptor& conv,
+                                const TensorDescriptor& dyDesc,
+                                ConstData_t dy,
+                                const TensorDescriptor& xDesc,
+                                ConstData_t x,
+                                const TensorDescriptor& dwDesc,
+                                Data_t dw);
+
+void ConvolutionBackwardBias(const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& dbDesc,
+                             Data_t db);
+
+void CTCLoss(const TensorDescriptor& probsDesc,
+             ConstData_t probs,
+             const int* labels,
+             const int* labelLengths,
+             const int* inputLengths,
+             Data_t losses,
+             const TensorDescriptor& gradientsDesc,
+             Data_t gradients,
+             int blankLabelId,
+             bool applySoftmaxLayer);
+
+void OpTensor(miopenTensorOp_t tensorOp,
+              const void* alpha0,
+              const TensorDescriptor& aTensorDesc,
+              ConstData_t ATensor,
+              const void* alpha1,
+              const TensorDescriptor& bTensorDesc,
+              ConstData_t BTensor,
+              const void* beta,
+              const TensorDescriptor& cTensorDesc,
+              Data_t CTensor,
+              std::size_t Aoffset,
+              std::size_t Boffset,
+              std::size_t Coffset);
+
+void SetTensor(const TensorDescriptor& yDesc, Data_t y, const void* alpha, std::size_t offset);
+
+void ScaleTensor(const TensorDescriptor& yDesc, Data_t y, const void* alpha, std::size_t offset);
+
+void CopyTensor(const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset);
+
+} // namespace host
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_HOST_EXEC_HPP_
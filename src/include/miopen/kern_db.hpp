@@ -40,7 +40,11 @@
 
 #include <string>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace boost {
 namespace filesystem {
@@ -84,6 +88,102 @@ struct KernelConfig
     }
 };
 
+/// Wall-clock duration of the last build of a kernel, used to order parallel
+/// compilation so that the longest builds start first.
+struct KernelCompileTime
+{
+    static std::string table_name() { return "kern_compile_time"; }
+    std::string kernel_name;
+    std::string kernel_args;
+    float compile_time_ms = 0.0f;
+    static std::vector<std::string> FieldNames()
+    {
+        return {"kernel_name", "kernel_args", "compile_time_ms"};
+    }
+    static std::string CreateQuery()
+    {
+        std::ostringstream ss;
+        ss << "CREATE TABLE IF NOT EXISTS `" << KernelCompileTime::table_name() << "` ("
+           << "`id` INTEGER PRIMARY KEY ASC"
+           << ",`kernel_name` TEXT NOT NULL"
+           << ",`kernel_args` TEXT NOT NULL"
+           << ",`compile_time_ms` REAL NOT NULL"
+           << ");"
+           << "CREATE UNIQUE INDEX IF NOT EXISTS "
+           << "`idx_" << KernelCompileTime::table_name() << "` "
+           << "ON " << KernelCompileTime::table_name() << "(kernel_name, kernel_args);";
+        return ss.str();
+    }
+};
+
+/// Program loaded by an application in a previous run, used to warm up the
+/// kernel cache in the background when a new Handle is created.
+struct KernelManifestEntry
+{
+    static std::string table_name() { return "kern_manifest"; }
+    std::string app;
+    std::string kernel_name;
+    std::string kernel_args;
+    static std::vector<std::string> FieldNames() { return {"app", "kernel_name", "kernel_args"}; }
+    static std::string CreateQuery()
+    {
+        std::ostringstream ss;
+        ss << "CREATE TABLE IF NOT EXISTS `" << KernelManifestEntry::table_name() << "` ("
+           << "`id` INTEGER PRIMARY KEY ASC"
+           << ",`app` TEXT NOT NULL"
+           << ",`kernel_name` TEXT NOT NULL"
+           << ",`kernel_args` TEXT NOT NULL"
+           << ");"
+           << "CREATE UNIQUE INDEX IF NOT EXISTS "
+           << "`idx_" << KernelManifestEntry::table_name() << "` "
+           << "ON " << KernelManifestEntry::table_name() << "(app, kernel_name, kernel_args);";
+        return ss.str();
+    }
+};
+
+/// Time of the last load or store of a kern_db record, used to evict the least
+/// recently used kernels when the cache grows over the limit.
+struct KernelAccess
+{
+    static std::string table_name() { return "kern_access"; }
+    static std::vector<std::string> FieldNames() { return {"id", "last_access"}; }
+    static std::string CreateQuery()
+    {
+        std::ostringstream ss;
+        ss << "CREATE TABLE IF NOT EXISTS `" << KernelAccess::table_name() << "` ("
+           << "`id` INTEGER PRIMARY KEY ASC"
+           << ",`last_access` INTEGER NOT NULL"
+           << ");";
+        return ss.str();
+    }
+};
+
+/// Usage statistics of a kernel cache file. Hits, misses and decompression time are
+/// accumulated over all the runs, entries and bytes describe the current contents.
+struct KernelCacheStats
+{
+    static std::string table_name() { return "kern_stats"; }
+    std::size_t hits     = 0;
+    std::size_t misses   = 0;
+    double decompress_ms = 0.0;
+    std::size_t entries  = 0;
+    std::size_t bytes    = 0;
+    static std::vector<std::string> FieldNames() { return {"hits", "misses", "decompress_ms"}; }
+    static std::string CreateQuery()
+    {
+        std::ostringstream ss;
+        ss << "CREATE TABLE IF NOT EXISTS `" << KernelCacheStats::table_name() << "` ("
+           << "`id` INTEGER PRIMARY KEY ASC"
+           << ",`hits` INTEGER NOT NULL"
+           << ",`misses` INTEGER NOT NULL"
+           << ",`decompress_ms` REAL NOT NULL"
+           << ");"
+           << "INSERT OR IGNORE INTO " << KernelCacheStats::table_name()
+           << "(id, hits, misses, decompress_ms) VALUES(0, 0, 0, 0);";
+        return ss.str();
+    }
+};
+
 class KernDb : public SQLiteBase<KernDb>
 {
     std::function<std::string(std::string, bool*)> compress_fn;
@@ -101,6 +201,10 @@ class KernDb : public SQLiteBase<KernDb>
            std::size_t _num_cu,
            std::function<std::string(std::string, bool*)> _compress_fn,
            std::function<std::string(std::string, unsigned int)> _decompress_fn);
+    KernDb(KernDb&&) = default;
+    KernDb& operator=(KernDb&&) = default;
+    ~KernDb();
+
     template <typename T>
     bool RemoveRecordUnsafe(const T& problem_config)
     {
@@ -136,18 +240,31 @@ class KernDb : public SQLiteBase<KernDb>
             auto compressed_blob           = stmt.ColumnBlob(0);
             auto md5_hash                  = stmt.ColumnText(1);
             auto uncompressed_size         = stmt.ColumnInt64(2);
+            counters::Add(
+                counters::Source::KernDb, counters::Counter::BytesRead, compressed_blob.size());
             std::string& decompressed_blob = compressed_blob;
+            double decompress_ms           = 0.0;
             if(uncompressed_size != 0)
             {
+                const auto start  = std::chrono::steady_clock::now();
                 decompressed_blob = decompress_fn(compressed_blob, uncompressed_size);
+                decompress_ms     = std::chrono::duration<double, std::milli>(
+                                    std::chrono::steady_clock::now() - start)
+                                    .count();
             }
             auto new_md5 = md5(decompressed_blob);
             if(new_md5 != md5_hash)
                 MIOPEN_THROW(miopenStatusInternalError, "Possible database corruption");
+            RecordHit(problem_config.kernel_name, problem_config.kernel_args, decompress_ms);
+            counters::AddLookup(counters::Source::KernDb, true);
             return decompressed_blob;
         }
         else if(rc == SQLITE_DONE)
+        {
+            RecordMiss();
+            counters::AddLookup(counters::Source::KernDb, false);
             return boost::none;
+        }
         else
             MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
         return boost::none;
@@ -183,8 +300,48 @@ class KernDb : public SQLiteBase<KernDb>
         auto rc = stmt.Step(sql);
         if(rc != SQLITE_DONE)
             MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        RecordStore(problem_config.kernel_name, problem_config.kernel_args);
         return problem_config.kernel_blob;
     }
+
+    boost::optional<float> FindCompileTimeUnsafe(const KernelCompileTime& record);
+    bool StoreCompileTimeUnsafe(const KernelCompileTime& record);
+
+    /// Returns the programs recorded for the application in the order of their first use.
+    std::vector<KernelManifestEntry> LoadManifestUnsafe(const std::string& app);
+    bool StoreManifestEntryUnsafe(const KernelManifestEntry& entry);
+
+    /// Writes the batched access times and counters to the database and evicts the least
+    /// recently used kernels if the cache has grown over the size limit. This is done
+    /// automatically every few stores and on destruction.
+    void MaintainUnsafe();
+    /// Evicts the least recently used kernels until the binaries take at most max_bytes.
+    /// Returns the number of evicted kernels.
+    std::size_t EvictUnsafe(std::size_t max_bytes);
+    KernelCacheStats GetStatsUnsafe();
+    /// Zero means no limit. Defaults to MIOPEN_KERNEL_CACHE_SIZE_LIMIT megabytes, or to
+    /// 2 GB for the content-addressed cache when it is not set.
+    void SetSizeLimit(std::size_t bytes) { size_limit = bytes; }
+
+    private:
+    struct Usage
+    {
+        std::mutex mutex;
+        std::vector<std::pair<std::string, std::string>> accessed;
+        KernelCacheStats pending;
+        std::size_t stores = 0;
+    };
+
+    void RecordHit(const std::string& name, const std::string& args, double decompress_ms);
+    void RecordMiss();
+    void RecordStore(const std::string& name, const std::string& args);
+    std::size_t EvictImpl(std::size_t max_bytes);
+
+    bool has_compile_time = false;
+    bool has_manifest     = false;
+    // Only user databases track usage.
+    std::unique_ptr<Usage> usage;
+    std::size_t size_limit = 0;
 };
 } // namespace miopen
 #endif
@@ -46,6 +46,9 @@
 #include <miopen/kernel.hpp>
 #include <miopen/simple_hash.hpp>
 #include <miopen/miopen.h>
+#include <boost/optional.hpp>
+#include <future>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -89,11 +92,25 @@ class KernelCache
 
     void AddProgram(Program prog, const std::string& program_name, std::string params);
 
+    /// Registers a program that is being loaded in background. The first AddKernel()
+    /// which needs it waits for the result instead of loading the program again.
+    void AddPreload(const std::string& program_name,
+                    std::string params,
+                    std::shared_future<Program> program);
+
+    /// Whether the programs loaded by the application are recorded and loaded in
+    /// background on the next run (MIOPEN_ENABLE_CACHE_PRELOAD).
+    static bool IsPreloadEnabled();
+
     KernelCache();
 
     private:
+    boost::optional<Program> TakePreload(const Key& key);
+
     KernelMap kernel_map;
     ProgramMap program_map;
+    std::unordered_map<Key, std::shared_future<Program>, SimpleHash> preloads;
+    std::mutex preloads_mutex;
 };
 
 } // namespace miopen
@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <vector>
 #include <iostream>
 #include <sstream>
@@ -199,7 +200,7 @@ namespace debug {
 /// by MIOPEN_LOG_NQ* macros (that ignore this switch).
 ///
 /// WARNING: This switch is not intended for use in multi-threaded applications.
-extern bool LoggingQuiet;
+extern std::atomic<bool> LoggingQuiet;
 
 } // namespace debug
 
@@ -212,6 +213,14 @@ bool IsLogging(LoggingLevel level, bool disableQuieting = false);
 bool IsLoggingCmd();
 bool IsLoggingFunctionCalls();
 
+/// Writes formatted log records to stderr, or to MIOPEN_LOG_FILE. With MIOPEN_LOG_ASYNC
+/// the calling thread only queues the record and a background thread writes it out.
+/// Records at Error level and above are written out before returning.
+void LogWrite(LoggingLevel level, std::string text);
+void LogWrite(std::string text);
+/// Writes out all the records queued so far.
+void LogFlush();
+
 namespace logger {
 
 template <typename T, typename S>
@@ -275,7 +284,7 @@ std::ostream& LogParam(std::ostream& os, std::string name, const std::vector<T>&
         std::ostream& miopen_log_func_ostream = miopen_log_func_ss;             \
         miopen_log_func_ostream << miopen::LoggingPrefix();                     \
         miopen::LogParam(miopen_log_func_ostream, #param, param) << std::endl;  \
-        std::cerr << miopen_log_func_ss.str();                                  \
+        miopen::LogWrite(miopen_log_func_ss.str());                             \
     } while(false);
 
 #define MIOPEN_LOG_FUNCTION(...)                                                        \
@@ -285,11 +294,11 @@ std::ostream& LogParam(std::ostream& os, std::string name, const std::vector<T>&
             std::ostringstream miopen_log_func_ss;                                      \
             miopen_log_func_ss << miopen::LoggingPrefix() << __PRETTY_FUNCTION__ << "{" \
                                << std::endl;                                            \
-            std::cerr << miopen_log_func_ss.str();                                      \
+            miopen::LogWrite(miopen_log_func_ss.str());                                 \
             MIOPEN_PP_EACH_ARGS(MIOPEN_LOG_FUNCTION_EACH, __VA_ARGS__)                  \
             std::ostringstream().swap(miopen_log_func_ss);                              \
             miopen_log_func_ss << miopen::LoggingPrefix() << "}" << std::endl;          \
-            std::cerr << miopen_log_func_ss.str();                                      \
+            miopen::LogWrite(miopen_log_func_ss.str());                                 \
         }                                                                               \
     while(false)
 #else
@@ -309,7 +318,7 @@ std::string LoggingParseFunction(const char* func, const char* pretty_func);
             std::ostringstream miopen_log_ss;                                                \
             miopen_log_ss << miopen::LoggingPrefix() << LoggingLevelToCString(level) << " [" \
                           << fn_name << "] " << __VA_ARGS__ << std::endl;                    \
-            std::cerr << miopen_log_ss.str();                                                \
+            miopen::LogWrite(level, miopen_log_ss.str());                                    \
         }                                                                                    \
     } while(false)
 
@@ -340,7 +349,7 @@ std::string LoggingParseFunction(const char* func, const char* pretty_func);
                              << " [" << miopen::LoggingParseFunction(                   \
                                             __func__, __PRETTY_FUNCTION__) /* NOLINT */ \
                              << "] ./bin/MIOpenDriver " << __VA_ARGS__ << std::endl;    \
-        std::cerr << miopen_driver_cmd_ss.str();                                        \
+        miopen::LogWrite(miopen_driver_cmd_ss.str());                                   \
     } while(false)
 
 #if MIOPEN_LOG_FUNC_TIME_ENABLE
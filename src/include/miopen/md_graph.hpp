@@ -32,7 +32,10 @@
 #include <miopen/fusion.hpp>
 #include <miopen/any_solver.hpp>
 
+#include <functional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace miopen {
 
@@ -84,21 +87,87 @@ struct MDGraph_vertex
 using MDGraph_vertex_ptr = std::shared_ptr<MDGraph_vertex>;
 using cur_vertex_map     = std::unordered_map<std::string, boost::any>;
 
+// Symbols of the graph constraints, numbered in the order they are first seen
+struct MDGraph_symbols
+{
+    int Slot(const std::string& name);
+    std::vector<std::string> names;
+    std::unordered_map<std::string, int> slots;
+};
+
+// Values of the graph symbols for one operator: the attribute function is
+// called once per symbol, not once per occurrence in the constraints.
+struct MDGraph_attrs
+{
+    MDGraph_attrs(const MDGraph_symbols& s,
+                  std::function<bool(const std::string& sym, int& val)> f);
+    bool Lookup(int slot, int& val);
+
+    const MDGraph_symbols& symbols;
+    std::function<bool(const std::string& sym, int& val)> attr_fun;
+    std::vector<int> values;
+    std::vector<char> state;
+};
+
+// A constraint of an edge compiled to postfix code when the edge is added, so
+// matching an operator does not run the expression parser. An assignment can
+// only be the whole constraint, the right hand side is the code then.
+struct MDGraph_constraint
+{
+    enum Code
+    {
+        Push,
+        Load,
+        Apply
+    };
+    struct Instr
+    {
+        Code code;
+        MDGraph_op_t op;
+        int value;
+        bool b_value;
+    };
+
+    std::string text;
+    std::vector<Instr> code;
+    int assign = -1;
+};
+
+struct MDGraph_edge
+{
+    FusionMDGraph_Edge_Map map;
+    std::vector<MDGraph_constraint> constraints;
+};
+
+// The vertices and edges of the metadata graph of one leading operator. Built
+// once per process and never changed after, all the plans share it.
+struct MDGraph
+{
+    static const MDGraph& Get(miopenFusionOp_t op);
+    void AddEdge(MDGraph_vertex_ptr src, MDGraph_vertex_ptr dst, FusionMDGraph_Edge_Map& map);
+
+    MDGraph_symbols symbols;
+    std::unordered_map<MDGraph_vertex_ptr,
+                       std::unordered_map<MDGraph_vertex_ptr, std::vector<MDGraph_edge>>>
+        edge_list;
+};
+
+// The position of a plan in the metadata graph: the vertices its operators
+// reach, with the weight and algorithm of each path.
 struct FusionMDGraph
 {
     FusionMDGraph() { Reset(); }
     static void Init(FusionMDGraph& g, miopenFusionOp_t op);
-    static void InitConv(FusionMDGraph& g);
-    static void InitBN(FusionMDGraph& g);
-    static void InitBNFwd(FusionMDGraph& g);
-    static void InitBNBwd(FusionMDGraph& g);
+    static void InitConv(MDGraph& g);
+    static void InitBN(MDGraph& g);
+    static void InitBNFwd(MDGraph& g);
+    static void InitBNBwd(MDGraph& g);
     void Reset();
     bool Advance(std::shared_ptr<FusionOpDescriptor> op,
                  std::function<bool(const std::string& sym, int& val)> attr_fun);
-    void AddEdge(MDGraph_vertex_ptr src, MDGraph_vertex_ptr dst, FusionMDGraph_Edge_Map& map);
 
-    bool CmpOpKey(const FusionMDGraph_Edge_Map& edge_val,
-                  std::function<bool(const std::string& sym, int& val)> attr_fun,
+    bool CmpOpKey(const MDGraph_edge& edge,
+                  MDGraph_attrs& attrs,
                   std::unordered_map<std::string, int>& syms) const;
     MDGraph_vertex_ptr GetCurVertex(const Handle& handle);
     std::string GetProgramName(const Handle& handle);
@@ -112,10 +181,7 @@ struct FusionMDGraph
 
     std::vector<std::pair<MDGraph_vertex_ptr, cur_vertex_map>> cur_vertex;
     std::set<miopenConvFwdAlgorithm_t> conv_algo_set;
-
-    std::unordered_map<MDGraph_vertex_ptr,
-                       std::unordered_map<MDGraph_vertex_ptr, FusionMDGraph_Edge_Map_Vec>>
-        edge_list;
+    const MDGraph* graph = nullptr;
 };
 
 } // namespace miopen
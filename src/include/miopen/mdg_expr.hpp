@@ -57,6 +57,46 @@ struct MDGExprParser : qi::grammar<Iterator, spirit::utree(), ascii::space_type>
     qi::rule<Iterator, std::string(), ascii::space_type> variable;
 };
 
+// Maps an operator of the parse tree to the op. The parser does not roll back
+// the characters of a partially matched alternative, so == arrives as ====,
+// > as >> and < as <<.
+inline MDGraph_op_t MDGExprOp(const std::string& sym)
+{
+    if(sym == "+")
+        return OpAdd;
+    else if(sym == "-")
+        return OpSub;
+    else if(sym == "*")
+        return OpMul;
+    else if(sym == "/")
+        return OpDiv;
+    else if(sym == "%")
+        return OpModulo;
+    else if(sym == ">=")
+        return OpGTE;
+    else if(sym == "<=")
+        return OpLTE;
+    else if(sym == "====")
+        return OpEqual;
+    else if(sym == "!=")
+        return OpNotEqual;
+    else if(sym == "^")
+        return OpPow;
+    else if(sym == "&")
+        return OpAnd;
+    else if(sym == "|")
+        return OpOr;
+    else if(sym == "~")
+        return OpCeil;
+    else if(sym == "===")
+        return OpAssign;
+    else if(sym == ">>")
+        return OpGT;
+    else if(sym == "<<")
+        return OpLT;
+    MIOPEN_THROW(miopenStatusInternalError, "Parsing error: Unknown operator: " + sym);
+}
+
 struct visit_res
 {
     int res         = 0;
@@ -138,44 +178,8 @@ struct tree_visit
         using iterator = spirit::utf8_symbol_range_type::const_iterator;
         iterator i     = str.begin();
         std::string sym(i, str.end());
-        // This should return a function instead of a data struct
         visit_res r;
-        if(sym == "+")
-            r.op = OpAdd;
-        else if(sym == "-")
-            r.op = OpSub;
-        else if(sym == "*")
-            r.op = OpMul;
-        else if(sym == "/")
-            r.op = OpDiv;
-        else if(sym == "%")
-            r.op = OpModulo;
-        else if(sym == ">=")
-            r.op = OpGTE;
-        else if(sym == "<=")
-            r.op = OpLTE;
-        else if(sym == "====")
-            r.op = OpEqual;
-        else if(sym == "!=")
-            r.op = OpNotEqual;
-        else if(sym == "^")
-            r.op = OpPow;
-        else if(sym == "&")
-            r.op = OpAnd;
-        else if(sym == "|")
-            r.op = OpOr;
-        else if(sym == "~")
-            r.op = OpCeil;
-        else if(sym == "===")
-            r.op = OpAssign;
-        else if(sym == ">>")
-            r.op = OpGT;
-        else if(sym == "<<")
-            r.op = OpLT;
-        else
-        {
-            MIOPEN_THROW(miopenStatusInternalError, "Parsing error: Unknown operator: " + sym);
-        }
+        r.op = MDGExprOp(sym);
         return r;
     }
 
@@ -46,6 +46,7 @@ struct HandleImpl
     }
 
     bool enable_profiling  = false;
+    bool host_execution    = false;
     StreamPtr stream       = nullptr;
     float profiling_result = 0.0;
     int device             = -1;
@@ -28,6 +28,7 @@
 #define MIOPEN_GUARD_MLOPEN_PAR_FOR_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <functional>
@@ -136,6 +137,32 @@ void par_for(std::size_t n, max_threads mt, F f)
     par_for_impl(n, std::min(threadsize, n), f);
 }
 
+/// Unlike par_for(), hands out iterations one at a time in index order, so the
+/// items placed first are started first regardless of the number of threads.
+template <class F>
+void par_for_dynamic(std::size_t n, max_threads mt, F f)
+{
+    const auto threadsize =
+        std::min({static_cast<std::size_t>(std::thread::hardware_concurrency()), mt.n, n});
+    if(threadsize <= 1)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+
+    std::atomic<std::size_t> work{0};
+    std::vector<joinable_thread> threads;
+    threads.reserve(threadsize);
+    for(std::size_t t = 0; t < threadsize; t++)
+    {
+        threads.emplace_back([&] {
+            for(auto i = work++; i < n; i = work++)
+                f(i);
+        });
+    }
+}
+
 } // namespace miopen
 
 #endif
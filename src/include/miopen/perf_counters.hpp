@@ -0,0 +1,88 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_PERF_COUNTERS_HPP_
+#define GUARD_MIOPEN_PERF_COUNTERS_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace miopen {
+namespace counters {
+
+/// Caches and databases the counters are kept for. The order is the one of
+/// miopenCounterSource_t.
+enum class Source
+{
+    KernelCache,   // Kernels kept by the handles.
+    InvokerCache,  // Invokers kept by the handles.
+    ReadonlyRamDb, // System find and perf databases loaded into memory.
+    PlainTextDb,   // Text find and perf databases.
+    SQLitePerfDb,  // SQLite perf databases.
+    KernDb,        // Binary kernel cache, the compiles are those of its misses.
+    Count
+};
+
+enum class Counter
+{
+    Lookups,
+    Hits,
+    Misses,
+    BytesRead,
+    Compiles,
+    CompileTimeUs,
+    Count
+};
+
+using Values = std::array<std::uint64_t, static_cast<std::size_t>(Counter::Count)>;
+
+/// Adds to a counter of the calling thread. Each thread only writes its own
+/// counters, so this costs a thread local lookup and a relaxed store.
+void Add(Source source, Counter counter, std::uint64_t value = 1);
+
+inline void AddLookup(Source source, bool hit)
+{
+    Add(source, Counter::Lookups);
+    Add(source, hit ? Counter::Hits : Counter::Misses);
+}
+
+/// Sums of the counters of all threads, including the exited ones, since the
+/// last Reset().
+Values Get(Source source);
+
+void Reset();
+
+const char* ToString(Source source);
+const char* ToString(Counter counter);
+
+/// Writes all the counters as one line of JSON.
+void WriteJson(std::ostream& os);
+
+} // namespace counters
+} // namespace miopen
+
+#endif // GUARD_MIOPEN_PERF_COUNTERS_HPP_
@@ -27,6 +27,7 @@
 #define MIOPEN_GUARD_MLOPEN_READONLYRAMDB_HPP
 
 #include <miopen/db_record.hpp>
+#include <miopen/perf_counters.hpp>
 
 #include <boost/optional.hpp>
 
@@ -50,6 +51,7 @@ class ReadonlyRamDb
     {
         MIOPEN_LOG_I2("Looking for key " << problem << " in file " << db_path);
         const auto it = cache.find(problem);
+        counters::AddLookup(counters::Source::ReadonlyRamDb, it != cache.end());
 
         if(it == cache.end())
             return boost::none;
@@ -31,6 +31,7 @@
 
 #include <miopen/db_record.hpp>
 #include <miopen/manage_ptr.hpp>
+#include <miopen/perf_counters.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/stringutils.hpp>
 #include <miopen/lock_file.hpp>
@@ -428,16 +429,24 @@ class SQLitePerfDb : public SQLiteBase<SQLitePerfDb>
         // clang-format on
         auto stmt = SQLite::Statement{sql, select_query, values};
         DbRecord rec;
+        std::uint64_t bytes_read = 0;
         while(true)
         {
             auto rc = stmt.Step(sql);
             if(rc == SQLITE_ROW)
-                rec.SetValues(stmt.ColumnText(0), stmt.ColumnText(1));
+            {
+                const auto solver = stmt.ColumnText(0);
+                const auto params = stmt.ColumnText(1);
+                bytes_read += solver.size() + params.size();
+                rec.SetValues(solver, params);
+            }
             else if(rc == SQLITE_DONE)
                 break;
             else if(rc == SQLITE_ERROR || rc == SQLITE_MISUSE)
                 MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
         }
+        counters::Add(counters::Source::SQLitePerfDb, counters::Counter::BytesRead, bytes_read);
+        counters::AddLookup(counters::Source::SQLitePerfDb, rec.GetSize() != 0);
         if(rec.GetSize() == 0)
             return boost::none;
         else
@@ -0,0 +1,108 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_TRACE_HPP_
+#define GUARD_MIOPEN_TRACE_HPP_
+
+#include <miopen/config.h>
+#include <miopen/logger.hpp>
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+namespace miopen {
+namespace trace {
+
+/// Tracing of the library internals, for chrome://tracing or Perfetto.
+///
+/// MIOPEN_TRACE_FILE names the file the trace is written to when the process exits.
+/// Each thread records its spans into its own ring buffer of MIOPEN_TRACE_BUFFER_SIZE
+/// events (65536 by default), the oldest are dropped when it is full. The events of
+/// exited threads move to a shared pool of the same size and their buffers are freed.
+/// Without MIOPEN_TRACE_FILE a span costs one check of a cached flag, and builds with
+/// MIOPEN_ENABLE_TRACE off compile the spans out.
+bool IsEnabled();
+
+using Clock = std::chrono::steady_clock;
+
+/// Records a span of the calling thread. The name must outlive the process, the
+/// detail goes to the arguments of the event.
+void Record(const char* name, std::string detail, Clock::time_point begin, Clock::time_point end);
+
+/// Writes the events recorded so far as Chrome trace JSON.
+void Write(std::ostream& os);
+
+class Scope
+{
+    public:
+    explicit Scope(const char* name_) : name(IsEnabled() ? name_ : nullptr)
+    {
+        if(name != nullptr)
+            begin = Clock::now();
+    }
+
+    /// The detail is only computed when tracing is enabled.
+    template <class F>
+    Scope(const char* name_, F get_detail) : name(IsEnabled() ? name_ : nullptr)
+    {
+        if(name == nullptr)
+            return;
+        detail = get_detail();
+        begin  = Clock::now();
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope()
+    {
+        if(name != nullptr)
+            Record(name, std::move(detail), begin, Clock::now());
+    }
+
+    private:
+    const char* name;
+    std::string detail;
+    Clock::time_point begin;
+};
+
+} // namespace trace
+} // namespace miopen
+
+#if MIOPEN_ENABLE_TRACE
+#define MIOPEN_TRACE_SCOPE(name) \
+    const miopen::trace::Scope MIOPEN_PP_CAT(miopen_trace_scope_, __LINE__) { name }
+#define MIOPEN_TRACE_SCOPE_DETAIL(name, ...)                                \
+    const miopen::trace::Scope MIOPEN_PP_CAT(miopen_trace_scope_, __LINE__) \
+    {                                                                       \
+        name, [&]() -> std::string { return __VA_ARGS__; }                  \
+    }
+#else
+#define MIOPEN_TRACE_SCOPE(name)
+#define MIOPEN_TRACE_SCOPE_DETAIL(name, ...)
+#endif
+
+#endif // GUARD_MIOPEN_TRACE_HPP_
@@ -26,6 +26,7 @@
 
 #include <miopen/invoker_cache.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/perf_counters.hpp>
 
 namespace miopen {
 
@@ -33,9 +34,13 @@ boost::optional<const Invoker&> InvokerCache::operator[](const Key& key) const
 {
     const auto item = invokers.find(key.first);
     if(item == invokers.end())
+    {
+        counters::AddLookup(counters::Source::InvokerCache, false);
         return boost::none;
+    }
     const auto& item_invokers = item->second.invokers;
     const auto invoker        = item_invokers.find(key.second);
+    counters::AddLookup(counters::Source::InvokerCache, invoker != item_invokers.end());
     if(invoker == item_invokers.end())
         return boost::none;
     return invoker->second;
@@ -47,11 +52,13 @@ boost::optional<const Invoker&> InvokerCache::GetFound1_0(const std::string& net
     const auto item = invokers.find(network_config);
     if(item == invokers.end())
     {
+        counters::AddLookup(counters::Source::InvokerCache, false);
         MIOPEN_LOG_I2("No invokers found for " << network_config);
         return boost::none;
     }
     if(item->second.found_1_0.empty())
     {
+        counters::AddLookup(counters::Source::InvokerCache, false);
         MIOPEN_LOG_I2("Invokers found for " << network_config
                                             << " but there is no find 1.0 result.");
         return boost::none;
@@ -61,6 +68,7 @@ boost::optional<const Invoker&> InvokerCache::GetFound1_0(const std::string& net
     const auto found_1_0_id   = found_1_0_ids.find(algorithm);
     if(found_1_0_id == found_1_0_ids.end())
     {
+        counters::AddLookup(counters::Source::InvokerCache, false);
         MIOPEN_LOG_I2("Invokers found for " << network_config
                                             << " but there is no one with an algorithm "
                                             << algorithm);
@@ -70,6 +78,7 @@ boost::optional<const Invoker&> InvokerCache::GetFound1_0(const std::string& net
     if(invoker == item_invokers.end())
         MIOPEN_THROW("No invoker with solver_id of " + found_1_0_id->second +
                      " was registered for " + network_config);
+    counters::AddLookup(counters::Source::InvokerCache, true);
     return invoker->second;
 }
 
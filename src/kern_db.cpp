@@ -24,8 +24,31 @@
  *
  *******************************************************************************/
 #include <miopen/kern_db.hpp>
+#include <miopen/env.hpp>
+#include <miopen/stringutils.hpp>
 
 namespace miopen {
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_KERNEL_CACHE_SIZE_LIMIT)
+
+// Number of stores between writing the usage to the database.
+static constexpr std::size_t usage_flush_interval = 64;
+// Evict down to this share of the limit so that maintenance does not run on every store.
+static constexpr double eviction_target = 0.9;
+// The content-addressed cache (*.ckdb) is shared by all MIOpen versions and is not
+// removed with any of them, so unlike the per-version caches it is capped by default.
+static constexpr std::size_t default_content_cache_limit_mb = 2048;
+
+static std::size_t GetSizeLimit(const std::string& filename)
+{
+    const std::size_t limit_mb = Value(MIOPEN_KERNEL_CACHE_SIZE_LIMIT{});
+    if(limit_mb != 0)
+        return limit_mb * 1024 * 1024;
+    if(EndsWith(filename, ".ckdb"))
+        return default_content_cache_limit_mb * 1024 * 1024;
+    return 0;
+}
+
 KernDb::KernDb(const std::string& filename_,
                bool is_system,
                const std::string& arch_,
@@ -56,6 +79,10 @@ KernDb::KernDb(const std::string& filename_,
     {
         const std::string create_table = KernelConfig::CreateQuery();
         sql.Exec(create_table);
+        sql.Exec(KernelCompileTime::CreateQuery());
+        sql.Exec(KernelManifestEntry::CreateQuery());
+        sql.Exec(KernelAccess::CreateQuery());
+        sql.Exec(KernelCacheStats::CreateQuery());
         MIOPEN_LOG_I2("Database created successfully");
     }
     if(!CheckTableColumns(KernelConfig::table_name(), KernelConfig::FieldNames()))
@@ -65,7 +92,287 @@ KernDb::KernDb(const std::string& filename_,
            << filename;
         MIOPEN_LOG_W(ss.str());
         dbInvalid = true;
+        return;
+    }
+    // Compile times and manifests are optional, system databases do not carry them.
+    has_compile_time =
+        CheckTableColumns(KernelCompileTime::table_name(), KernelCompileTime::FieldNames());
+    has_manifest =
+        CheckTableColumns(KernelManifestEntry::table_name(), KernelManifestEntry::FieldNames());
+    if(!is_system &&
+       CheckTableColumns(KernelAccess::table_name(), KernelAccess::FieldNames()) &&
+       CheckTableColumns(KernelCacheStats::table_name(), KernelCacheStats::FieldNames()))
+    {
+        usage      = std::make_unique<Usage>();
+        size_limit = GetSizeLimit(filename);
+    }
+}
+
+KernDb::~KernDb()
+{
+    if(!usage)
+        return;
+    try
+    {
+        MaintainUnsafe();
+    }
+    catch(const std::exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to update kernel cache usage in " << filename << ": " << ex.what());
+    }
+}
+
+void KernDb::RecordHit(const std::string& name, const std::string& args, double decompress_ms)
+{
+    if(!usage)
+        return;
+    std::lock_guard<std::mutex> lock(usage->mutex);
+    usage->accessed.emplace_back(name, args);
+    ++usage->pending.hits;
+    usage->pending.decompress_ms += decompress_ms;
+}
+
+void KernDb::RecordMiss()
+{
+    if(!usage)
+        return;
+    std::lock_guard<std::mutex> lock(usage->mutex);
+    ++usage->pending.misses;
+}
+
+void KernDb::RecordStore(const std::string& name, const std::string& args)
+{
+    if(!usage)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(usage->mutex);
+        usage->accessed.emplace_back(name, args);
+        if(++usage->stores % usage_flush_interval != 0)
+            return;
+    }
+    // The kernel is already stored, failing to evict must not fail the store.
+    try
+    {
+        MaintainUnsafe();
+    }
+    catch(const std::exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to maintain the kernel cache " << filename << ": " << ex.what());
+    }
+}
+
+void KernDb::MaintainUnsafe()
+{
+    if(!usage || filename.empty() || dbInvalid)
+        return;
+
+    std::lock_guard<std::mutex> lock(usage->mutex);
+    sql.Exec("BEGIN;");
+    try
+    {
+        // The access time is a logical clock shared by all the processes using the file,
+        // so the order of accesses within a batch is preserved.
+        const auto clock = sql.Exec("SELECT COALESCE(MAX(last_access), 0) AS now FROM " +
+                                    KernelAccess::table_name() + ";");
+        auto now = clock.empty() ? 0LL : std::stoll(clock[0].at("now"));
+        const auto touch_query = "INSERT OR REPLACE INTO " + KernelAccess::table_name() +
+                                 "(id, last_access) SELECT id, ? FROM " +
+                                 KernelConfig::table_name() +
+                                 " WHERE (kernel_name = ?) AND (kernel_args = ?);";
+        for(const auto& kernel : usage->accessed)
+        {
+            auto stmt = SQLite::Statement{sql, touch_query};
+            stmt.BindInt64(1, ++now);
+            stmt.BindText(2, kernel.first);
+            stmt.BindText(3, kernel.second);
+            if(stmt.Step(sql) != SQLITE_DONE)
+                MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        }
+
+        const auto& pending = usage->pending;
+        if(pending.hits != 0 || pending.misses != 0)
+        {
+            const auto update_query = "UPDATE " + KernelCacheStats::table_name() +
+                                      " SET hits = hits + ?, misses = misses + ?,"
+                                      " decompress_ms = decompress_ms + ? WHERE id = 0;";
+            auto stmt = SQLite::Statement{sql,
+                                          update_query,
+                                          {std::to_string(pending.hits),
+                                           std::to_string(pending.misses),
+                                           std::to_string(pending.decompress_ms)}};
+            if(stmt.Step(sql) != SQLITE_DONE)
+                MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        }
+
+        if(size_limit != 0)
+        {
+            const auto evicted =
+                EvictImpl(static_cast<std::size_t>(static_cast<double>(size_limit) *
+                                                   eviction_target));
+            if(evicted != 0)
+                MIOPEN_LOG_I("Evicted " << evicted << " kernels from " << filename);
+        }
+        sql.Exec("COMMIT;");
     }
+    catch(...)
+    {
+        sql.Exec("ROLLBACK;");
+        throw;
+    }
+    usage->accessed.clear();
+    usage->pending = {};
+}
+
+std::size_t KernDb::EvictImpl(const std::size_t max_bytes)
+{
+    auto stats = GetStatsUnsafe();
+    if(stats.bytes <= max_bytes)
+        return 0;
+
+    // Kernels that have never been accessed since tracking has started go first.
+    const auto select_query = "SELECT k.id, length(k.kernel_blob) FROM " +
+                              KernelConfig::table_name() + " AS k LEFT JOIN " +
+                              KernelAccess::table_name() +
+                              " AS a ON a.id = k.id ORDER BY COALESCE(a.last_access, 0), k.id;";
+    auto stmt = SQLite::Statement{sql, select_query};
+    std::vector<int64_t> victims;
+    while(stats.bytes > max_bytes)
+    {
+        const auto rc = stmt.Step(sql);
+        if(rc == SQLITE_DONE)
+            break;
+        if(rc != SQLITE_ROW)
+            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        victims.push_back(stmt.ColumnInt64(0));
+        stats.bytes -= std::min<std::size_t>(stats.bytes, stmt.ColumnInt64(1));
+    }
+
+    for(const auto id : victims)
+    {
+        for(const auto& table : {KernelConfig::table_name(), KernelAccess::table_name()})
+        {
+            auto del = SQLite::Statement{sql, "DELETE FROM " + table + " WHERE id = ?;"};
+            del.BindInt64(1, id);
+            if(del.Step(sql) != SQLITE_DONE)
+                MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        }
+    }
+    return victims.size();
+}
+
+std::size_t KernDb::EvictUnsafe(const std::size_t max_bytes)
+{
+    if(filename.empty() || dbInvalid)
+        return 0;
+    sql.Exec("BEGIN;");
+    try
+    {
+        const auto evicted = EvictImpl(max_bytes);
+        sql.Exec("COMMIT;");
+        return evicted;
+    }
+    catch(...)
+    {
+        sql.Exec("ROLLBACK;");
+        throw;
+    }
+}
+
+KernelCacheStats KernDb::GetStatsUnsafe()
+{
+    KernelCacheStats stats;
+    if(filename.empty() || dbInvalid)
+        return stats;
+
+    const auto size = sql.Exec("SELECT COUNT(*) AS entries, "
+                               "COALESCE(SUM(length(kernel_blob)), 0) AS bytes FROM " +
+                               KernelConfig::table_name() + ";");
+    if(!size.empty())
+    {
+        stats.entries = std::stoull(size[0].at("entries"));
+        stats.bytes   = std::stoull(size[0].at("bytes"));
+    }
+    if(usage)
+    {
+        const auto counters = sql.Exec("SELECT hits, misses, decompress_ms FROM " +
+                                       KernelCacheStats::table_name() + " WHERE id = 0;");
+        if(!counters.empty())
+        {
+            stats.hits          = std::stoull(counters[0].at("hits"));
+            stats.misses        = std::stoull(counters[0].at("misses"));
+            stats.decompress_ms = std::stod(counters[0].at("decompress_ms"));
+        }
+    }
+    return stats;
+}
+
+boost::optional<float> KernDb::FindCompileTimeUnsafe(const KernelCompileTime& record)
+{
+    if(filename.empty() || dbInvalid || !has_compile_time)
+        return boost::none;
+    const auto select_query = "SELECT compile_time_ms FROM " + KernelCompileTime::table_name() +
+                              " WHERE (kernel_name = ?) AND (kernel_args = ?);";
+    auto stmt = SQLite::Statement{sql, select_query, {record.kernel_name, record.kernel_args}};
+
+    const auto rc = stmt.Step(sql);
+    if(rc == SQLITE_ROW)
+        return std::stof(stmt.ColumnText(0));
+    else if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return boost::none;
+}
+
+bool KernDb::StoreCompileTimeUnsafe(const KernelCompileTime& record)
+{
+    if(filename.empty() || dbInvalid || !has_compile_time)
+        return false;
+    const auto insert_query = "INSERT OR REPLACE INTO " + KernelCompileTime::table_name() +
+                              "(kernel_name, kernel_args, compile_time_ms) VALUES(?, ?, ?);";
+    auto stmt = SQLite::Statement{
+        sql,
+        insert_query,
+        {record.kernel_name, record.kernel_args, std::to_string(record.compile_time_ms)}};
+
+    const auto rc = stmt.Step(sql);
+    if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return true;
+}
+
+std::vector<KernelManifestEntry> KernDb::LoadManifestUnsafe(const std::string& app)
+{
+    std::vector<KernelManifestEntry> entries;
+    if(filename.empty() || dbInvalid || !has_manifest)
+        return entries;
+    const auto select_query = "SELECT kernel_name, kernel_args FROM " +
+                              KernelManifestEntry::table_name() + " WHERE (app = ?) ORDER BY id;";
+    auto stmt = SQLite::Statement{sql, select_query, {app}};
+
+    while(true)
+    {
+        const auto rc = stmt.Step(sql);
+        if(rc == SQLITE_DONE)
+            break;
+        if(rc != SQLITE_ROW)
+            MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+        entries.push_back({app, stmt.ColumnText(0), stmt.ColumnText(1)});
+    }
+    return entries;
+}
+
+bool KernDb::StoreManifestEntryUnsafe(const KernelManifestEntry& entry)
+{
+    if(filename.empty() || dbInvalid || !has_manifest)
+        return false;
+    const auto insert_query = "INSERT OR IGNORE INTO " + KernelManifestEntry::table_name() +
+                              "(app, kernel_name, kernel_args) VALUES(?, ?, ?);";
+    auto stmt =
+        SQLite::Statement{sql, insert_query, {entry.app, entry.kernel_name, entry.kernel_args}};
+
+    const auto rc = stmt.Step(sql);
+    if(rc != SQLITE_DONE)
+        MIOPEN_THROW(miopenStatusInternalError, sql.ErrorMessage());
+    return true;
 }
 
 } // namespace miopen
@@ -39,16 +39,19 @@
  * limitations under the License.
  * ************************************************************************ */
 
+#include <miopen/binary_cache.hpp>
 #include <miopen/env.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/perf_counters.hpp>
 #include <miopen/stringutils.hpp>
 
 #include <iostream>
 #include <iterator>
 
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_DEVICE_ARCH)
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_ENABLE_CACHE_PRELOAD)
 
 namespace miopen {
 
@@ -72,6 +75,7 @@ const std::vector<Kernel>& KernelCache::GetKernels(const std::string& algorithm,
     std::pair<std::string, std::string> key = std::make_pair(algorithm, network_config);
 
     const auto it = kernel_map.find(key);
+    counters::AddLookup(counters::Source::KernelCache, it != kernel_map.end());
     if(it != kernel_map.end())
     {
         MIOPEN_LOG_I2(it->second.size() << " kernels for key: " << key.first << " \"" << key.second
@@ -114,6 +118,44 @@ void KernelCache::AddProgram(Program prog, const std::string& program_name, std:
     program_map[std::make_pair(program_name, params)] = prog;
 }
 
+void KernelCache::AddPreload(const std::string& program_name,
+                             std::string params,
+                             std::shared_future<Program> program)
+{
+    ProcessParams(params);
+    std::lock_guard<std::mutex> lock(preloads_mutex);
+    preloads.emplace(std::make_pair(program_name, params), std::move(program));
+}
+
+boost::optional<Program> KernelCache::TakePreload(const Key& key)
+{
+    std::shared_future<Program> program;
+    {
+        std::lock_guard<std::mutex> lock(preloads_mutex);
+        const auto it = preloads.find(key);
+        if(it == preloads.end())
+            return boost::none;
+        program = std::move(it->second);
+        preloads.erase(it);
+    }
+
+    try
+    {
+        return program.get();
+    }
+    catch(const std::exception& ex)
+    {
+        MIOPEN_LOG_I2("Preload failed for " << key.first << ": " << ex.what());
+        return boost::none;
+    }
+}
+
+bool KernelCache::IsPreloadEnabled()
+{
+    static const bool enabled = miopen::IsEnabled(MIOPEN_ENABLE_CACHE_PRELOAD{});
+    return enabled;
+}
+
 Kernel KernelCache::AddKernel(const Handle& h,
                               const std::string& algorithm,
                               const std::string& network_config,
@@ -135,6 +177,7 @@ Kernel KernelCache::AddKernel(const Handle& h,
     Program program;
 
     auto program_it = program_map.find(std::make_pair(program_name, params));
+    counters::AddLookup(counters::Source::KernelCache, program_it != program_map.end());
     if(program_it != program_map.end())
     {
         program = program_it->second;
@@ -144,7 +187,19 @@ Kernel KernelCache::AddKernel(const Handle& h,
         if(!is_kernel_miopengemm_str) // default value
             is_kernel_miopengemm_str = algorithm.find("ImplicitGEMM") == std::string::npos &&
                                        algorithm.find("GEMM") != std::string::npos;
-        program = h.LoadProgram(program_name, params, is_kernel_miopengemm_str, kernel_src);
+        auto preloaded = TakePreload(std::make_pair(program_name, params));
+        if(preloaded)
+        {
+            program = *preloaded;
+        }
+        else
+        {
+            program = h.LoadProgram(program_name, params, is_kernel_miopengemm_str, kernel_src);
+            // Programs built from the strings can not be loaded by name on the next run.
+            if(IsPreloadEnabled() && !is_kernel_miopengemm_str && kernel_src.empty())
+                miopen::AddToProgramManifest(
+                    h.GetTargetProperties(), h.GetMaxComputeUnits(), program_name, params);
+        }
         program_map[std::make_pair(program_name, params)] = program;
     }
 
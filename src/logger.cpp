@@ -27,10 +27,18 @@
 #include <miopen/logger.hpp>
 #include <miopen/config.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <chrono>
+#include <fstream>
 #include <ios>
 #include <iomanip>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef __linux__
 #include <unistd.h>
@@ -60,9 +68,21 @@ MIOPEN_DECLARE_ENV_VAR(MIOPEN_ENABLE_LOGGING_ELAPSED_TIME)
 /// See LoggingLevel in the header.
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_LOG_LEVEL)
 
+/// Write the log into this file instead of stderr.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_LOG_FILE)
+
+/// Rotate the log file when it grows beyond this number of bytes, 0 disables rotation.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_LOG_FILE_MAX_SIZE)
+
+/// Number of rotated log files to keep, named <file>.1 (the newest) to <file>.N. 1 by default.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_LOG_FILE_BACKUPS)
+
+/// Only format the log records in the logging threads, a background thread writes them.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_LOG_ASYNC)
+
 namespace debug {
 
-bool LoggingQuiet = false;
+std::atomic<bool> LoggingQuiet{false};
 
 } // namespace debug
 
@@ -110,6 +130,263 @@ inline float GetTimeDiff()
     return rv;
 }
 
+int EnabledLoggingLevel(const bool quiet)
+{
+    auto enabled_level = static_cast<int>(miopen::Value(MIOPEN_LOG_LEVEL{}));
+    if(quiet)
+    {
+        // Disable all levels higher than fatal.
+        if(enabled_level > LoggingLevel::DebugQuietMax || enabled_level == LoggingLevel::Default)
+            enabled_level = static_cast<int>(LoggingLevel::DebugQuietMax);
+    }
+    if(enabled_level != LoggingLevel::Default)
+        return enabled_level;
+#ifdef NDEBUG // Simplest way.
+    return static_cast<int>(LoggingLevel::Warning);
+#else
+    return static_cast<int>(LoggingLevel::Info);
+#endif
+}
+
+/// Destination of the log records.
+///
+/// In the asynchronous mode each thread appends its records to its own queue, the
+/// lock of which is only contended when the writer thread swaps the queue out. The
+/// writer wakes up periodically or when a queue grows long, and writes the records
+/// in the order they were logged. Records of different threads logged at about the
+/// same time may come out of order. The queue of a thread is drained and removed
+/// when the thread exits.
+///
+/// The sink is never destroyed, so logging from destructors of static objects is
+/// fine. At exit the writer thread is stopped and the sink becomes synchronous.
+class LogSink
+{
+    public:
+    LogSink()
+    {
+        const auto path_env = miopen::GetStringEnv(MIOPEN_LOG_FILE{});
+        if(path_env != nullptr && *path_env != '\0')
+        {
+            path     = path_env;
+            max_size = miopen::Value(MIOPEN_LOG_FILE_MAX_SIZE{});
+            backups  = std::max<std::size_t>(miopen::Value(MIOPEN_LOG_FILE_BACKUPS{}, 1), 1);
+            Open();
+        }
+        if(miopen::IsEnabled(MIOPEN_LOG_ASYNC{}))
+        {
+            async  = true;
+            writer = std::thread([this]() { Run(); });
+        }
+        std::atexit([]() { Get().Stop(); });
+    }
+
+    static LogSink& Get()
+    {
+        static auto* const sink = new LogSink{};
+        return *sink;
+    }
+
+    void Write(std::string text, bool urgent)
+    {
+        if(!async)
+        {
+            if(file.is_open())
+            {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                Output(text);
+                if(urgent)
+                    file.flush();
+            }
+            else
+            {
+                std::cerr << text;
+            }
+            return;
+        }
+
+        // Destructors of thread_local and static objects may log after the holder is gone.
+        thread_local bool exited = false;
+        if(exited)
+        {
+            {
+                std::lock_guard<std::mutex> lock(queues_mutex);
+                retired.push_back({next_seq++, std::move(text)});
+            }
+            if(urgent)
+                Flush();
+            return;
+        }
+        thread_local QueueHolder holder{*this, exited};
+        auto& queue = holder.queue;
+        std::size_t queued;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.records.push_back({next_seq++, std::move(text)});
+            queued = queue.records.size();
+        }
+        if(urgent)
+            Flush();
+        else if(queued == wakeup_threshold)
+            wakeup.notify_one();
+    }
+
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        std::vector<Record> records;
+        {
+            std::lock_guard<std::mutex> queues_lock(queues_mutex);
+            records.swap(retired);
+            for(const auto queue : queues)
+            {
+                std::lock_guard<std::mutex> queue_lock(queue->mutex);
+                std::move(queue->records.begin(),
+                          queue->records.end(),
+                          std::back_inserter(records));
+                queue->records.clear();
+            }
+        }
+        std::sort(records.begin(), records.end(), [](const auto& l, const auto& r) {
+            return l.seq < r.seq;
+        });
+        for(const auto& record : records)
+            Output(record.text);
+        if(file.is_open())
+            file.flush();
+        else
+            std::cerr.flush();
+    }
+
+    private:
+    struct Record
+    {
+        std::uint64_t seq;
+        std::string text;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::vector<Record> records;
+    };
+
+    static constexpr std::size_t wakeup_threshold = 256;
+
+    std::string path;
+    std::size_t max_size = 0;
+    std::size_t backups  = 1;
+    std::ofstream file;
+    std::size_t file_size = 0;
+    std::mutex output_mutex;
+
+    std::atomic<bool> async{false};
+    std::atomic<std::uint64_t> next_seq{0};
+    std::mutex queues_mutex;
+    std::vector<Queue*> queues;
+    // Records of the threads that have exited, written by the next flush.
+    std::vector<Record> retired;
+
+    std::thread writer;
+    std::mutex wakeup_mutex;
+    std::condition_variable wakeup;
+    bool stopping = false;
+
+    // Drains the queue of the thread and unregisters it when the thread exits.
+    class QueueHolder
+    {
+        public:
+        QueueHolder(LogSink& sink_, bool& exited_) : sink(sink_), exited(exited_)
+        {
+            std::lock_guard<std::mutex> lock(sink.queues_mutex);
+            sink.queues.push_back(&queue);
+        }
+        QueueHolder(const QueueHolder&) = delete;
+        QueueHolder& operator=(const QueueHolder&) = delete;
+        ~QueueHolder()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sink.queues_mutex);
+                std::move(queue.records.begin(),
+                          queue.records.end(),
+                          std::back_inserter(sink.retired));
+                sink.queues.erase(std::find(sink.queues.begin(), sink.queues.end(), &queue));
+            }
+            exited = true;
+        }
+
+        Queue queue;
+
+        private:
+        LogSink& sink;
+        bool& exited;
+    };
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(wakeup_mutex);
+        while(!stopping)
+        {
+            wakeup.wait_for(lock, std::chrono::milliseconds(100));
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+
+    void Stop()
+    {
+        if(writer.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(wakeup_mutex);
+                stopping = true;
+            }
+            wakeup.notify_one();
+            writer.join();
+        }
+        async = false;
+        Flush();
+    }
+
+    void Open()
+    {
+        file.open(path, std::ios::out | std::ios::app);
+        if(!file.is_open())
+        {
+            // The logger is not usable yet.
+            std::cerr << "MIOpen: Unable to open the log file <" << path
+                      << ">, logging to stderr." << std::endl;
+            return;
+        }
+        file.seekp(0, std::ios::end);
+        file_size = static_cast<std::size_t>(file.tellp());
+    }
+
+    void Rotate()
+    {
+        file.close();
+        const auto backup = [&](std::size_t i) { return path + "." + std::to_string(i); };
+        std::remove(backup(backups).c_str());
+        for(auto i = backups; i > 1; --i)
+            std::rename(backup(i - 1).c_str(), backup(i).c_str());
+        std::rename(path.c_str(), backup(1).c_str());
+        Open();
+    }
+
+    void Output(const std::string& text)
+    {
+        if(!file.is_open())
+        {
+            std::cerr << text;
+            return;
+        }
+        file << text;
+        file_size += text.size();
+        if(max_size != 0 && file_size >= max_size)
+            Rotate();
+    }
+};
+
 } // namespace
 
 bool IsLoggingDebugQuiet()
@@ -124,22 +401,26 @@ bool IsLoggingFunctionCalls()
 
 bool IsLogging(const LoggingLevel level, const bool disableQuieting)
 {
-    auto enabled_level = miopen::Value(MIOPEN_LOG_LEVEL{});
-    if(IsLoggingDebugQuiet() && !disableQuieting)
-    {
-        // Disable all levels higher than fatal.
-        if(enabled_level > LoggingLevel::DebugQuietMax || enabled_level == LoggingLevel::Default)
-            enabled_level = static_cast<int>(LoggingLevel::DebugQuietMax);
-    }
-    if(enabled_level != LoggingLevel::Default)
-        return enabled_level >= level;
-#ifdef NDEBUG // Simplest way.
-    return LoggingLevel::Warning >= level;
-#else
-    return LoggingLevel::Info >= level;
-#endif
+    // The environment does not change, only the quiet switch is read on each call.
+    static const int enabled_level = EnabledLoggingLevel(false);
+    static const int quiet_level   = miopen::IsEnabled(MIOPEN_DEBUG_LOGGING_QUIETING_DISABLE{})
+                                       ? enabled_level
+                                       : EnabledLoggingLevel(true);
+    const auto quiet = !disableQuieting && debug::LoggingQuiet.load(std::memory_order_relaxed);
+    return (quiet ? quiet_level : enabled_level) >= level;
+}
+
+void LogWrite(const LoggingLevel level, std::string text)
+{
+    const auto urgent = static_cast<int>(level) <= static_cast<int>(LoggingLevel::Error) &&
+                        level != LoggingLevel::Default;
+    LogSink::Get().Write(std::move(text), urgent);
 }
 
+void LogWrite(std::string text) { LogSink::Get().Write(std::move(text), false); }
+
+void LogFlush() { LogSink::Get().Flush(); }
+
 const char* LoggingLevelToCString(const LoggingLevel level)
 {
     // Intentionally straightforward.
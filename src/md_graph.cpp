@@ -118,7 +118,7 @@ std::string FusionMDGraph::GetProgramName(const Handle& handle)
 
     if(ptr != nullptr)
     {
-        return ptr->vertex_data["program"];
+        return ptr->vertex_data.at("program");
     }
     else
     {
@@ -132,7 +132,7 @@ std::string FusionMDGraph::GetKernelName(const Handle& handle)
     auto ptr = GetCurVertex(handle);
     if(ptr != nullptr)
     {
-        return ptr->vertex_data["kernel"];
+        return ptr->vertex_data.at("kernel");
     }
     else
     {
@@ -146,7 +146,7 @@ std::string FusionMDGraph::GetAlgoName(const Handle& handle)
     auto ptr = GetCurVertex(handle);
     if(ptr != nullptr)
     {
-        return ptr->vertex_data["algorithm"];
+        return ptr->vertex_data.at("algorithm");
     }
     else
     {
@@ -216,23 +216,45 @@ bool FusionMDGraph::SetConvAlgo(miopenConvFwdAlgorithm_t algo)
     return (!new_list.empty());
 }
 
-void FusionMDGraph::Init(FusionMDGraph& g, miopenFusionOp_t op)
+const MDGraph& MDGraph::Get(miopenFusionOp_t op)
 {
+    const auto build = [](void (*init)(MDGraph&)) {
+        MDGraph g;
+        init(g);
+        return g;
+    };
     switch(op)
     {
-    case miopenFusionOpConvForward: InitConv(g); break;
-    case miopenFusionOpBatchNormInference: InitBN(g); break;
-    case miopenFusionOpBatchNormFwdTrain: InitBNFwd(g); break;
-    case miopenFusionOpBatchNormBwdTrain: InitBNBwd(g); break;
+    case miopenFusionOpConvForward:
+    {
+        static const auto g = build(FusionMDGraph::InitConv);
+        return g;
+    }
+    case miopenFusionOpBatchNormInference:
+    {
+        static const auto g = build(FusionMDGraph::InitBN);
+        return g;
+    }
+    case miopenFusionOpBatchNormFwdTrain:
+    {
+        static const auto g = build(FusionMDGraph::InitBNFwd);
+        return g;
+    }
+    case miopenFusionOpBatchNormBwdTrain:
+    {
+        static const auto g = build(FusionMDGraph::InitBNBwd);
+        return g;
+    }
     case miopenFusionOpActivForward:
     case miopenFusionOpActivBackward:
-    case miopenFusionOpBiasForward:
-        MIOPEN_THROW(
-            miopenStatusNotImplemented,
-            "Operators Activ and Bias are not supported as first ops in a Fusion Plan (yet)");
+    case miopenFusionOpBiasForward: break;
     }
+    MIOPEN_THROW(miopenStatusNotImplemented,
+                 "Operators Activ and Bias are not supported as first ops in a Fusion Plan (yet)");
 }
 
+void FusionMDGraph::Init(FusionMDGraph& g, miopenFusionOp_t op) { g.graph = &MDGraph::Get(op); }
+
 static std::vector<DefaultKernelArg> BNFwdArgs(miopenBatchNormMode_t mode)
 {
     if(mode == miopenBNPerActivation)
@@ -278,7 +300,7 @@ static std::vector<DefaultKernelArg> BNFwdArgs(miopenBatchNormMode_t mode)
     }
 }
 
-void FusionMDGraph::InitBNFwd(FusionMDGraph& g)
+void FusionMDGraph::InitBNFwd(MDGraph& g)
 {
     FusionMDGraph_Edge_Map empty_map;
     empty_map["constraints"] = {"weight === 0"};
@@ -368,7 +390,7 @@ static std::vector<DefaultKernelArg> BNBwdArgs(miopenBatchNormMode_t mode)
     }
 }
 
-void FusionMDGraph::InitBNBwd(FusionMDGraph& g)
+void FusionMDGraph::InitBNBwd(MDGraph& g)
 {
     FusionMDGraph_Edge_Map empty_map;
     empty_map["constraints"] = {"weight === 0"};
@@ -409,7 +431,7 @@ void FusionMDGraph::InitBNBwd(FusionMDGraph& g)
     }
 }
 
-void FusionMDGraph::InitBN(FusionMDGraph& g)
+void FusionMDGraph::InitBN(MDGraph& g)
 {
     FusionMDGraph_Edge_Map empty_map;
     empty_map["constraints"] = {"weight === 0"};
@@ -476,7 +498,7 @@ static std::vector<DefaultKernelArg> WinogradNodeArgs()
     };
 }
 
-void FusionMDGraph::InitConv(FusionMDGraph& g)
+void FusionMDGraph::InitConv(MDGraph& g)
 {
     const auto common_constr = {
         "group_count == 1",      "stride_h == stride_w",
@@ -938,70 +960,266 @@ void FusionMDGraph::InitConv(FusionMDGraph& g)
     }
 }
 
-void FusionMDGraph::AddEdge(MDGraph_vertex_ptr src,
-                            MDGraph_vertex_ptr dst,
-                            FusionMDGraph_Edge_Map& map)
+int MDGraph_symbols::Slot(const std::string& name)
 {
-    if(edge_list[src][dst].empty())
+    const auto it = slots.find(name);
+    if(it != slots.end())
+        return it->second;
+    names.push_back(name);
+    return slots[name] = static_cast<int>(names.size() - 1);
+}
+
+MDGraph_attrs::MDGraph_attrs(const MDGraph_symbols& s,
+                             std::function<bool(const std::string& sym, int& val)> f)
+    : symbols(s), attr_fun(std::move(f)), values(s.names.size()), state(s.names.size(), 0)
+{
+}
+
+bool MDGraph_attrs::Lookup(int slot, int& val)
+{
+    // 0: not asked yet, 1: attribute, 2: not an attribute
+    if(state[slot] == 0)
+        state[slot] = attr_fun(symbols.names[slot], values[slot]) ? 1 : 2;
+    val = values[slot];
+    return state[slot] == 1;
+}
+
+static MDGraph_op_t CompileOp(const boost::spirit::utree& t)
+{
+    if(t.which() != boost::spirit::utree_type::symbol_type)
+        MIOPEN_THROW("Unsupported op");
+    const auto sym = t.get<boost::spirit::utf8_symbol_range_type>();
+    return MDGExprOp(std::string(sym.begin(), sym.end()));
+}
+
+static std::string CompileVariable(const boost::spirit::utree& t)
+{
+    const auto str = t.get<boost::spirit::utf8_string_range_type>();
+    return {str.begin(), str.end()};
+}
+
+// Appends the postfix code of the parse tree, with the leaves as tree_visit reads them
+static void CompileExpr(const boost::spirit::utree& t,
+                        MDGraph_symbols& symbols,
+                        std::vector<MDGraph_constraint::Instr>& code)
+{
+    using boost::spirit::utree_type;
+    switch(t.which())
     {
-        edge_list[src][dst] = {map};
+    case utree_type::int_type:
+        code.push_back({MDGraph_constraint::Push, OpAny, t.get<int>(), false});
+        break;
+    case utree_type::double_type:
+        code.push_back(
+            {MDGraph_constraint::Push, OpAny, static_cast<int>(t.get<double>()), false});
+        break;
+    case utree_type::bool_type:
+        code.push_back({MDGraph_constraint::Push, OpAny, 0, t.get<bool>()});
+        break;
+    case utree_type::string_type:
+        code.push_back({MDGraph_constraint::Load, OpAny, symbols.Slot(CompileVariable(t)), false});
+        break;
+    case utree_type::list_type:
+    {
+        // A parenthesized primary and a hex constant are lists of one
+        std::vector<boost::spirit::utree> v(t.begin(), t.end());
+        if(v.size() == 1)
+        {
+            CompileExpr(v[0], symbols, code);
+            break;
+        }
+        assert(v.size() == 3);
+        const auto op = CompileOp(v[0]);
+        if(op == OpAssign)
+            MIOPEN_THROW(miopenStatusInternalError,
+                         "Assignment inside a graph constraint expression");
+        CompileExpr(v[1], symbols, code);
+        CompileExpr(v[2], symbols, code);
+        code.push_back({MDGraph_constraint::Apply, op, 0, false});
+        break;
+    }
+    default: code.push_back({MDGraph_constraint::Push, OpAny, 0, false}); break;
+    }
+}
+
+static MDGraph_constraint CompileConstraint(const std::string& text, MDGraph_symbols& symbols)
+{
+    using It = std::string::const_iterator;
+    It f(text.begin()), l(text.end());
+    MDGExprParser p;
+    boost::spirit::utree e;
+    auto parse_success = boost::spirit::qi::phrase_parse(f, l, p, boost::spirit::ascii::space, e);
+    if(!parse_success)
+    {
+        MIOPEN_LOG_I2("Remaining unparsed: " << text);
+        MIOPEN_THROW(miopenStatusInternalError, "Unable to parse graph constraint expression");
+    }
+
+    MDGraph_constraint c;
+    c.text = text;
+    std::vector<boost::spirit::utree> v;
+    if(e.which() == boost::spirit::utree_type::list_type)
+        v.assign(e.begin(), e.end());
+    if(v.size() == 3 && CompileOp(v[0]) == OpAssign)
+    {
+        if(v[1].which() != boost::spirit::utree_type::string_type)
+            MIOPEN_THROW("Invalid variable assignment: " + text);
+        c.assign = symbols.Slot(CompileVariable(v[1]));
+        CompileExpr(v[2], symbols, c.code);
     }
     else
     {
-        edge_list[src][dst].emplace_back(map);
+        CompileExpr(e, symbols, c.code);
     }
+    return c;
 }
 
-bool FusionMDGraph::CmpOpKey(const FusionMDGraph_Edge_Map& edge_val,
-                             std::function<bool(const std::string& sym, int& val)> attr_fun,
-                             std::unordered_map<std::string, int>& syms) const
+void MDGraph::AddEdge(MDGraph_vertex_ptr src, MDGraph_vertex_ptr dst, FusionMDGraph_Edge_Map& map)
 {
-    for(auto& kv : edge_val)
+    MDGraph_edge edge;
+    edge.map = map;
+    for(auto& kv : map)
     {
         if(kv.first == "constraints")
         {
-            tree_visit v(attr_fun);
             for(auto& edg_op : kv.second)
+                edge.constraints.push_back(CompileConstraint(edg_op, symbols));
+        }
+        else
+        {
+            assert(false);
+        }
+    }
+    edge_list[src][dst].push_back(std::move(edge));
+}
+
+namespace {
+
+struct MDGraph_value
+{
+    int res;
+    bool b_res;
+    int sym; // slot of an unresolved variable, or -1
+};
+
+} // namespace
+
+static MDGraph_value Apply(MDGraph_op_t op, const MDGraph_value& lhs, const MDGraph_value& rhs)
+{
+    const auto arith   = [](int x) { return MDGraph_value{x, false, -1}; };
+    const auto logical = [](bool x) { return MDGraph_value{static_cast<int>(x), x, -1}; };
+    switch(op)
+    {
+    // Arith ops
+    case OpAdd: return arith(lhs.res + rhs.res);
+    case OpSub: return arith(lhs.res - rhs.res);
+    case OpMul: return arith(lhs.res * rhs.res);
+    case OpDiv: return arith(lhs.res / rhs.res);
+    case OpModulo: return arith(lhs.res % rhs.res);
+    case OpPow: return arith(static_cast<int>(std::pow(lhs.res, rhs.res)));
+    case OpCeil:
+        return arith((lhs.res % rhs.res != 0) ? (lhs.res / rhs.res + 1) * rhs.res : lhs.res);
+    // Logical ops
+    case OpEqual: return logical(lhs.res == rhs.res);
+    case OpNotEqual: return logical(lhs.res != rhs.res);
+    case OpGTE: return logical(lhs.res >= rhs.res);
+    case OpLTE: return logical(lhs.res <= rhs.res);
+    case OpGT: return logical(lhs.res > rhs.res);
+    case OpLT: return logical(lhs.res < rhs.res);
+    case OpAnd: return logical(lhs.b_res && rhs.b_res);
+    case OpOr: return logical(lhs.b_res || rhs.b_res);
+    case OpAssign:
+    case OpAny:
+    case OpEval: break;
+    }
+    MIOPEN_THROW("Unsupported op");
+}
+
+bool FusionMDGraph::CmpOpKey(const MDGraph_edge& edge,
+                             MDGraph_attrs& attrs,
+                             std::unordered_map<std::string, int>& syms) const
+{
+    // Variables assigned by the earlier constraints of the edge
+    std::vector<std::pair<int, int>> locals;
+    const auto local = [&](int slot) {
+        return std::find_if(
+            locals.begin(), locals.end(), [&](const auto& x) { return x.first == slot; });
+    };
+    std::vector<MDGraph_value> stack;
+    bool satisfied = true;
+    for(const auto& c : edge.constraints)
+    {
+        stack.clear();
+        for(const auto& instr : c.code)
+        {
+            switch(instr.code)
             {
-                using It = std::string::const_iterator;
-                It f(edg_op.begin()), l(edg_op.end());
-                MDGExprParser p;
-                boost::spirit::utree e;
-                auto parse_success =
-                    boost::spirit::qi::phrase_parse(f, l, p, boost::spirit::ascii::space, e);
-                if(!parse_success)
-                {
-                    MIOPEN_LOG_I2(
-                        "Remaining unparsed: " << std::string(edg_op.begin(), edg_op.end()));
-                    MIOPEN_THROW(miopenStatusInternalError,
-                                 "Unable to parse graph constraint expression");
-                }
-                visit_res r = boost::spirit::utree::visit(e, v);
-                v.tabl.insert(r.tabl.begin(), r.tabl.end());
-                syms = v.tabl;
-                if(r.b_res)
-                {
-                    MIOPEN_LOG_I2("Constraint satisfied: " + edg_op);
-                }
-                else
+            case MDGraph_constraint::Push: stack.push_back({instr.value, instr.b_value, -1}); break;
+            case MDGraph_constraint::Load:
+            {
+                MDGraph_value v = {0, false, -1};
+                const auto it   = local(instr.value);
+                if(!attrs.Lookup(instr.value, v.res))
                 {
-                    MIOPEN_LOG_I("Condition unsuccessful while matching graph: " + edg_op);
-                    return false;
+                    v.res = 0;
+                    if(it != locals.end())
+                        v.res = it->second;
+                    else
+                        v.sym = instr.value;
                 }
+                stack.push_back(v);
+                break;
             }
+            case MDGraph_constraint::Apply:
+            {
+                const auto rhs = stack.back();
+                stack.pop_back();
+                auto& lhs = stack.back();
+                if(lhs.sym >= 0)
+                    MIOPEN_THROW("Invalid variable access: " + graph->symbols.names[lhs.sym]);
+                lhs = Apply(instr.op, lhs, rhs);
+                break;
+            }
+            }
+        }
+
+        bool b_res = stack.back().b_res;
+        if(c.assign >= 0)
+        {
+            const auto& name = graph->symbols.names[c.assign];
+            int val          = 0;
+            if(attrs.Lookup(c.assign, val))
+                MIOPEN_THROW("Invalid variable assignment: " + name);
+            MIOPEN_LOG_I2(" Adding variable: " + name);
+            if(local(c.assign) == locals.end())
+                locals.emplace_back(c.assign, stack.back().res);
+            b_res = true;
+        }
+
+        if(b_res)
+        {
+            MIOPEN_LOG_I2("Constraint satisfied: " + c.text);
         }
         else
         {
-            assert(false);
+            MIOPEN_LOG_I("Condition unsuccessful while matching graph: " + c.text);
+            satisfied = false;
+            break;
         }
     }
-    return true;
+    syms.clear();
+    for(const auto& l : locals)
+        syms[graph->symbols.names[l.first]] = l.second;
+    return satisfied;
 }
 
 bool FusionMDGraph::Advance(std::shared_ptr<FusionOpDescriptor> op,
                             std::function<bool(const std::string& sym, int& val)> attr_fun)
 {
     MIOPEN_LOG_I("Adding Op: " << *op);
+    if(graph == nullptr)
+        MIOPEN_THROW(miopenStatusInternalError, "The metadata graph is not initialized");
+    MDGraph_attrs attrs(graph->symbols, attr_fun);
     std::vector<std::pair<MDGraph_vertex_ptr, cur_vertex_map>> new_list;
     std::set<miopenConvFwdAlgorithm_t> new_set;
     // iterate over the list of current vertices
@@ -1017,9 +1235,11 @@ bool FusionMDGraph::Advance(std::shared_ptr<FusionOpDescriptor> op,
             MIOPEN_LOG_I2("Current vertex: " << *cur_vertex_ptr);
         }
         // get the children of the cur_vertex
-        auto& ch = edge_list[cur_vertex_ptr];
+        const auto ch = graph->edge_list.find(cur_vertex_ptr);
+        if(ch == graph->edge_list.end())
+            continue;
         // if op is in the children and the edge key satisfies update cur_vertex
-        for(auto& ch_it : ch)
+        for(auto& ch_it : ch->second)
         {
             auto cur_map = kinder.second;
             MIOPEN_LOG_I2("Current path weight: " << boost::any_cast<int>(cur_map["weight"]));
@@ -1031,7 +1251,7 @@ bool FusionMDGraph::Advance(std::shared_ptr<FusionOpDescriptor> op,
                 {
                     int weight = boost::any_cast<int>(cur_map["weight"]);
                     std::unordered_map<std::string, int> syms;
-                    if(CmpOpKey(edg_map, attr_fun, syms))
+                    if(CmpOpKey(edg_map, attrs, syms))
                     {
                         MIOPEN_LOG_I2("Key Match Successfull");
                         if(syms.count("weight") != 0)
@@ -1161,6 +1381,8 @@ void FusionMDGraph::WriteToFile(std::string filename)
                                                   miopenFusionOpBatchNormInference,
                                                   miopenFusionOpBiasForward));
 
+    if(graph == nullptr)
+        MIOPEN_THROW(miopenStatusInternalError, "The metadata graph is not initialized");
     if(filename.empty())
     {
         filename = "/tmp/mdgraph.dot";
@@ -1170,7 +1392,7 @@ void FusionMDGraph::WriteToFile(std::string filename)
     std::stringstream dot_graph;
     dot_file.open(filename);
 
-    for(auto& edge : edge_list)
+    for(auto& edge : graph->edge_list)
     {
         nodes.insert(edge.first);
         for(auto& edge2 : edge.second)
@@ -1195,7 +1417,7 @@ void FusionMDGraph::WriteToFile(std::string filename)
 
     int src_id, dst_id;
 
-    for(auto& edge : edge_list)
+    for(auto& edge : graph->edge_list)
     {
         if(edge.first != nullptr)
             src_id = edge.first->id;
@@ -1210,7 +1432,7 @@ void FusionMDGraph::WriteToFile(std::string filename)
             for(auto& edg_map : edge2.second)
             {
                 std::stringstream edge_label;
-                for(auto& edg_ops : edg_map)
+                for(auto& edg_ops : edg_map.map)
                 {
                     for(auto& e : edg_ops.second)
                     {
@@ -28,11 +28,14 @@
 #include <miopen/handle.hpp>
 #include <miopen/binary_cache.hpp>
 #include <miopen/target_properties.hpp>
+#include <miopen/env.hpp>
 #include <miopen/errors.hpp>
 #include <miopen/gemm_geometry.hpp>
 #include <miopen/handle_lock.hpp>
+#include <miopen/host_exec.hpp>
 #include <miopen/invoker.hpp>
 #include <miopen/kernel_cache.hpp>
+#include <miopen/kernel_info.hpp>
 #include <miopen/logger.hpp>
 #include <miopen/timer.hpp>
 
@@ -52,14 +55,49 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <miopen/nogpu/handle_impl.hpp>
 namespace miopen {
 
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_NOGPU_HOST_EXECUTION)
+
+namespace {
+
+// Buffers of the host execution mode. The alignment suits any vector load.
+constexpr std::size_t host_alignment = 64;
+
+void* default_host_allocator(void*, size_t sz)
+{
+    void* result = nullptr;
+    if(posix_memalign(&result, host_alignment, std::max<std::size_t>(sz, 1)) != 0)
+        return nullptr;
+    return result;
+}
+
+void default_host_deallocator(void*, void* mem) { std::free(mem); }
+
+// The primitives without a host implementation would reach the kernels, which do
+// nothing here, and report success with their outputs untouched.
+void CheckNoHostExecution(const HandleImpl& impl, const std::string& what)
+{
+    if(impl.host_execution)
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "No host execution of " + what + " with MIOPEN_NOGPU_HOST_EXECUTION");
+}
+
+} // namespace
+
 Handle::Handle(miopenAcceleratorQueue_t /* stream */) : Handle::Handle() {}
 
 Handle::Handle() : impl(new HandleImpl())
 {
+    if(IsEnabled(MIOPEN_NOGPU_HOST_EXECUTION{}))
+    {
+        this->impl->host_execution = true;
+        this->impl->allocator      = {default_host_allocator, default_host_deallocator, nullptr};
+    }
 #if MIOPEN_USE_ROCBLAS
     rhandle_ = CreateRocblasHandle();
 #endif
@@ -73,10 +111,17 @@ void Handle::SetStream(miopenAcceleratorQueue_t /* streamID */) const {}
 
 miopenAcceleratorQueue_t Handle::GetStream() const { return {}; }
 
-void Handle::SetAllocator(miopenAllocatorFunction /* allocator */,
-                          miopenDeallocatorFunction /* deallocator */,
-                          void* /* allocatorContext */) const
+void Handle::SetAllocator(miopenAllocatorFunction allocator,
+                          miopenDeallocatorFunction deallocator,
+                          void* allocatorContext) const
 {
+    // Without host execution there is nothing to allocate for.
+    if(!this->impl->host_execution)
+        return;
+    if(allocator == nullptr || deallocator == nullptr)
+        this->impl->allocator = {default_host_allocator, default_host_deallocator, nullptr};
+    else
+        this->impl->allocator = {allocator, deallocator, allocatorContext};
 }
 
 void Handle::EnableProfiling(bool enable) const { this->impl->enable_profiling = enable; }
@@ -86,23 +131,29 @@ float Handle::GetKernelTime() const { return this->impl->profiling_result; }
 Allocator::ManageDataPtr Handle::Create(std::size_t sz) const { return this->impl->allocator(sz); }
 
 Allocator::ManageDataPtr&
-Handle::WriteTo(const void* /* data */, Allocator::ManageDataPtr& ddata, std::size_t /* sz */) const
+Handle::WriteTo(const void* data, Allocator::ManageDataPtr& ddata, std::size_t sz) const
 {
+    if(this->impl->host_execution && sz != 0)
+        std::memcpy(ddata.get(), data, sz);
     return ddata;
 }
 
-void Handle::ReadTo(void* /* data */,
-                    const Allocator::ManageDataPtr& /* ddata */,
-                    std::size_t /* sz */) const
+void Handle::ReadTo(void* data, const Allocator::ManageDataPtr& ddata, std::size_t sz) const
 {
+    if(this->impl->host_execution && sz != 0)
+        std::memcpy(data, ddata.get(), sz);
 }
 
-void Handle::Copy(ConstData_t /* src */, Data_t /* dest */, std::size_t /* size */) const {}
+void Handle::Copy(ConstData_t src, Data_t dest, std::size_t size) const
+{
+    if(this->impl->host_execution && size != 0)
+        std::memmove(dest, src, size);
+}
 
 KernelInvoke Handle::AddKernel(const std::string& /* algorithm */,
                                const std::string& /* network_config */,
                                const std::string& /* program_name */,
-                               const std::string& /* kernel_name */,
+                               const std::string& kernel_name,
                                const std::vector<size_t>& /* vld */,
                                const std::vector<size_t>& /* vgd */,
                                const std::string& /* params */,
@@ -110,12 +161,16 @@ KernelInvoke Handle::AddKernel(const std::string& /* algorithm */,
                                bool /* is_kernel_str */,
                                const std::string& /* kernel_src */) const
 {
+    CheckNoHostExecution(*this->impl, "kernel " + kernel_name);
     return {};
 }
 
 Invoker Handle::PrepareInvoker(const InvokerFactory& /* factory */,
-                               const std::vector<solver::KernelInfo>& /* kernels */) const
+                               const std::vector<solver::KernelInfo>& kernels) const
 {
+    CheckNoHostExecution(*this->impl,
+                         kernels.empty() ? std::string{"invoker"}
+                                         : "kernel " + kernels.front().kernel_name);
     return {};
 }
 
@@ -137,13 +192,18 @@ bool Handle::HasKernel(const std::string& /* algorithm */,
     return false;
 }
 
-KernelInvoke Handle::Run(Kernel /* k */) const { return {}; }
+KernelInvoke Handle::Run(Kernel /* k */) const
+{
+    CheckNoHostExecution(*this->impl, "a kernel");
+    return {};
+}
 
-Program Handle::LoadProgram(const std::string& /* program_name */,
+Program Handle::LoadProgram(const std::string& program_name,
                             std::string /* params */,
                             bool /* is_kernel_str */,
                             const std::string& /* kernel_src */) const
 {
+    CheckNoHostExecution(*this->impl, "program " + program_name);
     return {};
 }
 
@@ -212,6 +272,8 @@ shared<ConstData_t> Handle::CreateSubBuffer(ConstData_t data, std::size_t offset
     return {cdata + offset, null_deleter{}};
 }
 
+bool IsHostExecution(const Handle& handle) { return handle.impl->host_execution; }
+
 #if MIOPEN_USE_ROCBLAS
 rocblas_handle_ptr Handle::CreateRocblasHandle() const
 {
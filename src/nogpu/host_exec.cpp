@@ -0,0 +1,719 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Host execution of the primitives for the HIPNOGPU backend. The arithmetic is
+// done by the host references of the tests, which work on plain pointers (or
+// on host tensors for convolutions), so the library and the tests agree by
+// construction.
+
+#include <miopen/host_exec.hpp>
+#include <miopen/activ.hpp>
+#include <miopen/convolution.hpp>
+#include <miopen/errors.hpp>
+#include <miopen/par_for.hpp>
+#include <miopen/pooling.hpp>
+#include <miopen/tensor.hpp>
+#include <miopen/visit_float.hpp>
+
+#include "../../test/cpu_activ.hpp"
+#include "../../test/cpu_bn.hpp"
+#include "../../test/cpu_conv_blocked.hpp"
+#include "../../test/cpu_ctc.hpp"
+#include "../../test/cpu_pooling.hpp"
+#include "../../test/cpu_softmax.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <numeric>
+#include <vector>
+
+namespace miopen {
+namespace host {
+
+namespace {
+
+// Elements of a row handed to a thread at least, below that threading costs more.
+constexpr std::size_t min_elements_per_thread = 4096;
+
+template <class T>
+const T* Ptr(ConstData_t data, std::size_t offset)
+{
+    return static_cast<const T*>(data) + offset;
+}
+
+template <class T>
+T* Ptr(Data_t data, std::size_t offset)
+{
+    return static_cast<T*>(data) + offset;
+}
+
+/// Calls f(offsets) for every index of lens, with the offset of the element in
+/// each of the N layouts. The innermost dimension is walked in a row, the rows
+/// are split between threads.
+template <std::size_t N, class F>
+void ForEachElement(const std::vector<std::size_t>& lens,
+                    const std::array<std::vector<std::size_t>, N>& strides,
+                    F f)
+{
+    if(lens.empty())
+        return;
+    const auto inner = lens.back();
+    const auto rows  = std::accumulate(
+        lens.begin(), lens.end() - 1, std::size_t{1}, std::multiplies<std::size_t>());
+    if(inner == 0 || rows == 0)
+        return;
+
+    const auto grain = std::max<std::size_t>(1, min_elements_per_thread / inner);
+    miopen::par_for(rows, min_grain{grain}, [&](std::size_t row) {
+        std::array<std::size_t, N> base{};
+        auto rest = row;
+        for(auto d = lens.size() - 1; d-- > 0;)
+        {
+            const auto i = rest % lens[d];
+            rest /= lens[d];
+            for(std::size_t t = 0; t < N; ++t)
+                base[t] += i * strides[t][d];
+        }
+        for(std::size_t i = 0; i < inner; ++i)
+        {
+            auto offsets = base;
+            for(std::size_t t = 0; t < N; ++t)
+                offsets[t] += i * strides[t].back();
+            f(offsets);
+        }
+    });
+}
+
+/// Calls f(first, count) on blocks of [0, n) in parallel. For tensors that share
+/// one packed layout, whose elements can then be walked in memory order.
+template <class F>
+void ForEachBlock(std::size_t n, F f)
+{
+    const auto blocks = (n + min_elements_per_thread - 1) / min_elements_per_thread;
+    miopen::par_for(blocks, min_grain{1}, [&](std::size_t block) {
+        const auto first = block * min_elements_per_thread;
+        f(first, std::min(min_elements_per_thread, n - first));
+    });
+}
+
+bool IsSamePackedLayout(const TensorDescriptor& desc,
+                        std::initializer_list<const TensorDescriptor*> others)
+{
+    return desc.IsPacked() && std::all_of(others.begin(), others.end(), [&](auto other) {
+               return other->GetStrides() == desc.GetStrides();
+           });
+}
+
+template <class T>
+tensor<T> LoadTensor(const TensorDescriptor& desc, ConstData_t data)
+{
+    auto result  = tensor<T>{desc};
+    const auto p = static_cast<const T*>(data);
+    std::copy(p, p + result.data.size(), result.data.begin());
+    return result;
+}
+
+template <class T>
+void StoreTensor(const tensor<T>& t, Data_t data)
+{
+    std::copy(t.data.begin(), t.data.end(), static_cast<T*>(data));
+}
+
+cpu_softmax::view SoftmaxView(const TensorDescriptor& desc)
+{
+    cpu_softmax::view v{};
+    std::copy_n(desc.GetLengths().begin(), 4, v.lens.begin());
+    std::copy_n(desc.GetStrides().begin(), 4, v.strides.begin());
+    return v;
+}
+
+cpu_bn::shape BatchNormShape(const TensorDescriptor& xDesc)
+{
+    const auto& lens = xDesc.GetLengths();
+    return {lens[0],
+            lens[1],
+            std::accumulate(
+                lens.begin() + 2, lens.end(), std::size_t{1}, std::multiplies<std::size_t>())};
+}
+
+cpu_pooling::problem PoolingProblem(const PoolingDescriptor& desc,
+                                    const TensorDescriptor& xDesc,
+                                    const TensorDescriptor& yDesc)
+{
+    return cpu_pooling::make_problem(desc.GetMode(),
+                                     xDesc.GetLengths(),
+                                     xDesc.GetStrides(),
+                                     yDesc.GetLengths(),
+                                     yDesc.GetStrides(),
+                                     desc.GetLengths(),
+                                     desc.GetStrides(),
+                                     desc.GetPads(),
+                                     desc.GetWorkspaceIndexMode() ==
+                                         miopenPoolingWorkspaceIndexImage);
+}
+
+template <class F>
+void VisitIndexType(miopenIndexType_t type, F f)
+{
+    switch(type)
+    {
+    case miopenIndexUint8: f(std::uint8_t{}); break;
+    case miopenIndexUint16: f(std::uint16_t{}); break;
+    case miopenIndexUint32: f(std::uint32_t{}); break;
+    case miopenIndexUint64: f(std::uint64_t{}); break;
+    }
+}
+
+template <class F>
+void VisitConvDim(std::size_t spatial_dim, F f)
+{
+    switch(spatial_dim)
+    {
+    case 1: f(std::integral_constant<std::size_t, 1>{}); break;
+    case 2: f(std::integral_constant<std::size_t, 2>{}); break;
+    case 3: f(std::integral_constant<std::size_t, 3>{}); break;
+    default:
+        MIOPEN_THROW(miopenStatusNotImplemented,
+                     "Host execution supports 1 to 3 spatial dimensions");
+    }
+}
+
+std::vector<std::size_t> BroadcastStrides(const TensorDescriptor& desc)
+{
+    auto strides = desc.GetStrides();
+    for(std::size_t i = 0; i < strides.size(); ++i)
+        if(desc.GetLengths()[i] == 1)
+            strides[i] = 0;
+    return strides;
+}
+
+double ApplyTensorOp(miopenTensorOp_t op, double a, double b)
+{
+    switch(op)
+    {
+    case miopenTensorOpAdd: return a + b;
+    case miopenTensorOpMul: return a * b;
+    case miopenTensorOpMin: return std::min(a, b);
+    case miopenTensorOpMax: return std::max(a, b);
+    }
+    return a;
+}
+
+} // namespace
+
+void ActivationForward(const ActivationDescriptor& desc,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       const TensorDescriptor& yDesc,
+                       Data_t y,
+                       std::size_t xOffset,
+                       std::size_t yOffset)
+{
+    const auto p =
+        cpu_activ::params{desc.GetMode(), desc.GetAlpha(), desc.GetBeta(), desc.GetGamma()};
+    visit_float(xDesc.GetType(), [&](auto as_float) {
+        using T         = typename decltype(as_float)::type;
+        const auto* src = Ptr<T>(x, xOffset);
+        auto* dst       = Ptr<T>(y, yOffset);
+        if(IsSamePackedLayout(xDesc, {&yDesc}))
+        {
+            ForEachBlock(xDesc.GetElementSize(), [&](std::size_t first, std::size_t count) {
+                cpu_activ::forward(p, count, src + first, dst + first);
+            });
+            return;
+        }
+        ForEachElement<2>(xDesc.GetLengths(),
+                          {{xDesc.GetStrides(), yDesc.GetStrides()}},
+                          [&](const std::array<std::size_t, 2>& o) {
+                              dst[o[1]] = static_cast<T>(
+                                  cpu_activ::forward(p, static_cast<double>(src[o[0]])));
+                          });
+    });
+}
+
+void ActivationBackward(const ActivationDescriptor& desc,
+                        const TensorDescriptor& yDesc,
+                        ConstData_t y,
+                        const TensorDescriptor& dyDesc,
+                        ConstData_t dy,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& dxDesc,
+                        Data_t dx,
+                        std::size_t yOffset,
+                        std::size_t dyOffset,
+                        std::size_t xOffset,
+                        std::size_t dxOffset)
+{
+    const auto p =
+        cpu_activ::params{desc.GetMode(), desc.GetAlpha(), desc.GetBeta(), desc.GetGamma()};
+    visit_float(xDesc.GetType(), [&](auto as_float) {
+        using T         = typename decltype(as_float)::type;
+        const auto* yp  = Ptr<T>(y, yOffset);
+        const auto* dyp = Ptr<T>(dy, dyOffset);
+        const auto* xp  = Ptr<T>(x, xOffset);
+        auto* dxp       = Ptr<T>(dx, dxOffset);
+        if(IsSamePackedLayout(xDesc, {&yDesc, &dyDesc, &dxDesc}))
+        {
+            ForEachBlock(xDesc.GetElementSize(), [&](std::size_t first, std::size_t count) {
+                cpu_activ::backward(p, count, dyp + first, xp + first, yp + first, dxp + first);
+            });
+            return;
+        }
+        ForEachElement<4>(
+            xDesc.GetLengths(),
+            {{yDesc.GetStrides(), dyDesc.GetStrides(), xDesc.GetStrides(), dxDesc.GetStrides()}},
+            [&](const std::array<std::size_t, 4>& o) {
+                dxp[o[3]] = static_cast<T>(cpu_activ::backward(p,
+                                                               static_cast<double>(dyp[o[1]]),
+                                                               static_cast<double>(xp[o[2]]),
+                                                               static_cast<double>(yp[o[0]])));
+            });
+    });
+}
+
+void SoftmaxForward(const void* alpha,
+                    const void* beta,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    miopenSoftmaxAlgorithm_t algorithm,
+                    miopenSoftmaxMode_t mode,
+                    std::size_t xOffset,
+                    std::size_t yOffset)
+{
+    visit_float(xDesc.GetType(), [&](auto as_float) {
+        using T = typename decltype(as_float)::type;
+        cpu_softmax::forward(algorithm,
+                             mode,
+                             SoftmaxView(xDesc),
+                             Ptr<T>(x, xOffset),
+                             SoftmaxView(yDesc),
+                             Ptr<T>(y, yOffset),
+                             *static_cast<const float*>(alpha),
+                             *static_cast<const float*>(beta));
+    });
+}
+
+void SoftmaxBackward(const void* alpha,
+                     const TensorDescriptor& yDesc,
+                     ConstData_t y,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const void* beta,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     miopenSoftmaxAlgorithm_t algorithm,
+                     miopenSoftmaxMode_t mode,
+                     std::size_t yOffset,
+                     std::size_t dyOffset,
+                     std::size_t dxOffset)
+{
+    visit_float(yDesc.GetType(), [&](auto as_float) {
+        using T = typename decltype(as_float)::type;
+        cpu_softmax::backward(algorithm,
+                              mode,
+                              SoftmaxView(yDesc),
+                              Ptr<T>(y, yOffset),
+                              SoftmaxView(dyDesc),
+                              Ptr<T>(dy, dyOffset),
+                              SoftmaxView(dxDesc),
+                              Ptr<T>(dx, dxOffset),
+                              *static_cast<const float*>(alpha),
+                              *static_cast<const float*>(beta));
+    });
+}
+
+void PoolingForward(const PoolingDescriptor& desc,
+                    const TensorDescriptor& xDesc,
+                    ConstData_t x,
+                    const TensorDescriptor& yDesc,
+                    Data_t y,
+                    bool save_index,
+                    Data_t workSpace)
+{
+    const auto pb = PoolingProblem(desc, xDesc, yDesc);
+    visit_float(xDesc.GetType(), [&](auto as_float) {
+        using T = typename decltype(as_float)::type;
+        VisitIndexType(desc.GetIndexType(), [&](auto index) {
+            using Index = decltype(index);
+            cpu_pooling::forward(pb,
+                                 Ptr<T>(x, 0),
+                                 Ptr<T>(y, 0),
+                                 save_index && workSpace != nullptr ? Ptr<Index>(workSpace, 0)
+                                                                    : nullptr);
+        });
+    });
+}
+
+void PoolingBackward(const PoolingDescriptor& desc,
+                     const TensorDescriptor& dyDesc,
+                     ConstData_t dy,
+                     const TensorDescriptor& dxDesc,
+                     Data_t dx,
+                     ConstData_t workSpace)
+{
+    const auto pb = PoolingProblem(desc, dxDesc, dyDesc);
+    visit_float(dxDesc.GetType(), [&](auto as_float) {
+        using T = typename decltype(as_float)::type;
+        VisitIndexType(desc.GetIndexType(), [&](auto index) {
+            using Index = decltype(index);
+            cpu_pooling::backward(pb, Ptr<T>(dy, 0), Ptr<T>(dx, 0), Ptr<Index>(workSpace, 0));
+        });
+    });
+}
+
+void BatchNormForwardTraining(miopenBatchNormMode_t bn_mode,
+                              const TensorDescriptor& xDesc,
+                              ConstData_t x,
+                              Data_t y,
+                              const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                              ConstData_t bnScale,
+                              ConstData_t bnBias,
+                              double expAvgFactor,
+                              Data_t resultRunningMean,
+                              Data_t resultRunningVariance,
+                              double epsilon,
+                              Data_t resultSaveMean,
+                              Data_t resultSaveInvVariance)
+{
+    const auto shape = BatchNormShape(xDesc);
+    visit_float(xDesc.GetType(), [&](auto as_x) {
+        visit_float(bnScaleBiasMeanVarDesc.GetType(), [&](auto as_stat) {
+            using T = typename decltype(as_x)::type;
+            using U = typename decltype(as_stat)::type;
+            const auto train = bn_mode == miopenBNSpatial
+                                   ? cpu_bn::spatial_forward_train<T, T, U, U>
+                                   : cpu_bn::per_activation_forward_train<T, T, U, U>;
+            train(shape,
+                  Ptr<T>(x, 0),
+                  Ptr<T>(y, 0),
+                  Ptr<U>(bnScale, 0),
+                  Ptr<U>(bnBias, 0),
+                  epsilon,
+                  expAvgFactor,
+                  Ptr<U>(resultSaveMean, 0),
+                  Ptr<U>(resultSaveInvVariance, 0),
+                  Ptr<U>(resultRunningMean, 0),
+                  Ptr<U>(resultRunningVariance, 0));
+        });
+    });
+}
+
+void BatchNormForwardInference(miopenBatchNormMode_t bn_mode,
+                               const TensorDescriptor& xDesc,
+                               ConstData_t x,
+                               Data_t y,
+                               const TensorDescriptor& bnScaleBiasMeanVarDesc,
+                               ConstData_t bnScale,
+                               ConstData_t bnBias,
+                               ConstData_t estimatedMean,
+                               ConstData_t estimatedVariance,
+                               double epsilon)
+{
+    const auto shape = BatchNormShape(xDesc);
+    visit_float(xDesc.GetType(), [&](auto as_x) {
+        visit_float(bnScaleBiasMeanVarDesc.GetType(), [&](auto as_stat) {
+            using T = typename decltype(as_x)::type;
+            using U = typename decltype(as_stat)::type;
+            const auto infer = bn_mode == miopenBNSpatial
+                                   ? cpu_bn::spatial_forward_infer<T, T, U, U>
+                                   : cpu_bn::per_activation_forward_infer<T, T, U, U>;
+            infer(shape,
+                  Ptr<T>(x, 0),
+                  Ptr<T>(y, 0),
+                  Ptr<U>(bnScale, 0),
+                  Ptr<U>(bnBias, 0),
+                  epsilon,
+                  Ptr<U>(estimatedMean, 0),
+                  Ptr<U>(estimatedVariance, 0));
+        });
+    });
+}
+
+void BatchNormBackward(miopenBatchNormMode_t bn_mode,
+                       const TensorDescriptor& xDesc,
+                       ConstData_t x,
+                       ConstData_t dy,
+                       Data_t dx,
+                       const TensorDescriptor& bnScaleBiasDiffDesc,
+                       ConstData_t bnScale,
+                       Data_t resultBnScaleDiff,
+                       Data_t resultBnBiasDiff,
+                       double epsilon,
+                       ConstData_t savedMean,
+                       ConstData_t savedInvVariance)
+{
+    const auto shape = BatchNormShape(xDesc);
+    visit_float(xDesc.GetType(), [&](auto as_x) {
+        visit_float(bnScaleBiasDiffDesc.GetType(), [&](auto as_stat) {
+            using T = typename decltype(as_x)::type;
+            using U = typename decltype(as_stat)::type;
+            const auto backward = bn_mode == miopenBNSpatial
+                                      ? cpu_bn::spatial_backward<T, T, U, U, U>
+                                      : cpu_bn::per_activation_backward<T, T, U, U, U>;
+            backward(shape,
+                     Ptr<T>(x, 0),
+                     Ptr<T>(dy, 0),
+                     Ptr<T>(dx, 0),
+                     Ptr<U>(bnScale, 0),
+                     Ptr<U>(resultBnScaleDiff, 0),
+                     Ptr<U>(resultBnBiasDiff, 0),
+                     epsilon,
+                     Ptr<U>(savedMean, 0),
+                     Ptr<U>(savedInvVariance, 0));
+        });
+    });
+}
+
+void ConvolutionForward(const ConvolutionDescriptor& conv,
+                        const TensorDescriptor& xDesc,
+                        ConstData_t x,
+                        const TensorDescriptor& wDesc,
+                        ConstData_t w,
+                        const TensorDescriptor& yDesc,
+                        Data_t y)
+{
+    VisitConvDim(conv.GetSpatialDimension(), [&](auto dim) {
+        visit_float(xDesc.GetType(), [&](auto as_in) {
+            visit_float(yDesc.GetType(), [&](auto as_out) {
+                using Tin  = typename decltype(as_in)::type;
+                using Tout = typename decltype(as_out)::type;
+                auto out   = LoadTensor<Tout>(yDesc, y);
+                cpu_conv::forward<decltype(dim)::value>(LoadTensor<Tin>(xDesc, x),
+                                                        LoadTensor<Tin>(wDesc, w),
+                                                        out,
+                                                        conv.GetConvPads(),
+                                                        conv.GetConvStrides(),
+                                                        conv.GetConvDilations(),
+                                                        conv.GetGroupCount());
+                StoreTensor(out, y);
+            });
+        });
+    });
+}
+
+void ConvolutionBackwardData(const ConvolutionDescriptor& conv,
+                             const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& wDesc,
+                             ConstData_t w,
+                             const TensorDescriptor& dxDesc,
+                             Data_t dx)
+{
+    VisitConvDim(conv.GetSpatialDimension(), [&](auto dim) {
+        visit_float(dxDesc.GetType(), [&](auto as_float) {
+            using T = typename decltype(as_float)::type;
+            auto in = LoadTensor<T>(dxDesc, dx);
+            cpu_conv::backward_data<decltype(dim)::value>(in,
+                                                          LoadTensor<T>(wDesc, w),
+                                                          LoadTensor<T>(dyDesc, dy),
+                                                          conv.GetConvPads(),
+                                                          conv.GetConvStrides(),
+                                                          conv.GetConvDilations(),
+                                                          conv.GetGroupCount());
+            StoreTensor(in, dx);
+        });
+    });
+}
+
+void ConvolutionBackwardWeights(const ConvolutionDescriptor& conv,
+                                const TensorDescriptor& dyDesc,
+                                ConstData_t dy,
+                                const TensorDescriptor& xDesc,
+                                ConstData_t x,
+                                const TensorDescriptor& dwDesc,
+                                Data_t dw)
+{
+    VisitConvDim(conv.GetSpatialDimension(), [&](auto dim) {
+        visit_float(dwDesc.GetType(), [&](auto as_float) {
+            using T  = typename decltype(as_float)::type;
+            auto wei = LoadTensor<T>(dwDesc, dw);
+            cpu_conv::backward_weight<decltype(dim)::value>(LoadTensor<T>(xDesc, x),
+                                                            wei,
+                                                            LoadTensor<T>(dyDesc, dy),
+                                                            conv.GetConvPads(),
+                                                            conv.GetConvStrides(),
+                                                            conv.GetConvDilations(),
+                                                            conv.GetGroupCount());
+            StoreTensor(wei, dw);
+        });
+    });
+}
+
+void ConvolutionBackwardBias(const TensorDescriptor& dyDesc,
+                             ConstData_t dy,
+                             const TensorDescriptor& dbDesc,
+                             Data_t db)
+{
+    const auto& lens    = dyDesc.GetLengths();
+    const auto& strides = dyDesc.GetStrides();
+    const auto spatial  = std::accumulate(
+        lens.begin() + 2, lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+    visit_float(dyDesc.GetType(), [&](auto as_float) {
+        using T         = typename decltype(as_float)::type;
+        const auto* src = Ptr<T>(dy, 0);
+        auto* dst       = Ptr<T>(db, 0);
+        miopen::par_for(lens[1], [&](std::size_t k) {
+            double sum = 0;
+            for(std::size_t n = 0; n < lens[0]; ++n)
+            {
+                for(std::size_t s = 0; s < spatial; ++s)
+                {
+                    auto offset = n * strides[0] + k * strides[1];
+                    auto rest   = s;
+                    for(auto d = lens.size() - 1; d >= 2; --d)
+                    {
+                        offset += (rest % lens[d]) * strides[d];
+                        rest /= lens[d];
+                    }
+                    sum += static_cast<double>(src[offset]);
+                }
+            }
+            dst[k * dbDesc.GetStrides()[1]] = static_cast<T>(sum);
+        });
+    });
+}
+
+void CTCLoss(const TensorDescriptor& probsDesc,
+             ConstData_t probs,
+             const int* labels,
+             const int* labelLengths,
+             const int* inputLengths,
+             Data_t losses,
+             const TensorDescriptor& gradientsDesc,
+             Data_t gradients,
+             int blankLabelId,
+             bool applySoftmaxLayer)
+{
+    cpu_ctc::problem p;
+    p.max_time_step        = probsDesc.GetLengths()[0];
+    p.batch_size           = probsDesc.GetLengths()[1];
+    p.class_sz             = probsDesc.GetLengths()[2];
+    p.probs_strides[0]     = probsDesc.GetStrides()[0];
+    p.probs_strides[1]     = probsDesc.GetStrides()[1];
+    p.gradients_strides[0] = gradientsDesc.GetStrides()[0];
+    p.gradients_strides[1] = gradientsDesc.GetStrides()[1];
+    p.blank                = blankLabelId;
+    p.apply_softmax        = applySoftmaxLayer;
+    visit_float(probsDesc.GetType(), [&](auto as_float) {
+        using T = typename decltype(as_float)::type;
+        cpu_ctc::loss(p,
+                      Ptr<T>(probs, 0),
+                      labels,
+                      labelLengths,
+                      inputLengths,
+                      Ptr<T>(losses, 0),
+                      Ptr<T>(gradients, 0));
+    });
+}
+
+void OpTensor(miopenTensorOp_t tensorOp,
+              const void* alpha0,
+              const TensorDescriptor& aTensorDesc,
+              ConstData_t ATensor,
+              const void* alpha1,
+              const TensorDescriptor& bTensorDesc,
+              ConstData_t BTensor,
+              const void* beta,
+              const TensorDescriptor& cTensorDesc,
+              Data_t CTensor,
+              std::size_t Aoffset,
+              std::size_t Boffset,
+              std::size_t Coffset)
+{
+    // Same as the kernels: the scalars are float whatever the data type.
+    const double a0 = *static_cast<const float*>(alpha0);
+    const double a1 = *static_cast<const float*>(alpha1);
+    const double b  = *static_cast<const float*>(beta);
+    visit_float(cTensorDesc.GetType(), [&](auto as_float) {
+        using T       = typename decltype(as_float)::type;
+        const auto* A = Ptr<T>(ATensor, Aoffset);
+        const auto* B = Ptr<T>(BTensor, Boffset);
+        auto* C       = Ptr<T>(CTensor, Coffset);
+        ForEachElement<3>(
+            cTensorDesc.GetLengths(),
+            {{aTensorDesc.GetStrides(), BroadcastStrides(bTensorDesc), cTensorDesc.GetStrides()}},
+            [&](const std::array<std::size_t, 3>& o) {
+                auto r = ApplyTensorOp(tensorOp,
+                                       a0 * static_cast<double>(A[o[0]]),
+                                       a1 * static_cast<double>(B[o[1]]));
+                if(b != 0)
+                    r += b * static_cast<double>(C[o[2]]);
+                C[o[2]] = static_cast<T>(r);
+            });
+    });
+}
+
+void SetTensor(const TensorDescriptor& yDesc, Data_t y, const void* alpha, std::size_t offset)
+{
+    visit_float(yDesc.GetType(), [&](auto as_float) {
+        using T       = typename decltype(as_float)::type;
+        const T value = *as_float(alpha);
+        auto* dst     = Ptr<T>(y, offset);
+        ForEachElement<1>(yDesc.GetLengths(),
+                          {{yDesc.GetStrides()}},
+                          [&](const std::array<std::size_t, 1>& o) { dst[o[0]] = value; });
+    });
+}
+
+void ScaleTensor(const TensorDescriptor& yDesc, Data_t y, const void* alpha, std::size_t offset)
+{
+    visit_float(yDesc.GetType(), [&](auto as_float) {
+        using T            = typename decltype(as_float)::type;
+        const double value = static_cast<double>(*as_float(alpha));
+        auto* dst          = Ptr<T>(y, offset);
+        ForEachElement<1>(yDesc.GetLengths(),
+                          {{yDesc.GetStrides()}},
+                          [&](const std::array<std::size_t, 1>& o) {
+                              dst[o[0]] = static_cast<T>(static_cast<double>(dst[o[0]]) * value);
+                          });
+    });
+}
+
+void CopyTensor(const TensorDescriptor& srcDesc,
+                ConstData_t src,
+                const TensorDescriptor& dstDesc,
+                Data_t dst,
+                std::size_t srcOffset,
+                std::size_t dstOffset)
+{
+    visit_float(srcDesc.GetType(), [&](auto as_float) {
+        using T       = typename decltype(as_float)::type;
+        const auto* s = Ptr<T>(src, srcOffset);
+        auto* d       = Ptr<T>(dst, dstOffset);
+        ForEachElement<2>(srcDesc.GetLengths(),
+                          {{srcDesc.GetStrides(), dstDesc.GetStrides()}},
+                          [&](const std::array<std::size_t, 2>& o) { d[o[1]] = s[o[0]]; });
+    });
+}
+
+} // namespace host
+} // namespace miopen
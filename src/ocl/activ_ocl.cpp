@@ -24,6 +24,8 @@
  *
  *******************************************************************************/
 #include <miopen/activ.hpp>
+#include <miopen/config.h>
+#include <miopen/host_exec.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/float_equal.hpp>
@@ -46,6 +48,13 @@ miopenStatus_t ActivationDescriptor::Forward(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ActivationForward(*this, xDesc, x, yDesc, y, xOffset, yOffset);
+        return miopenStatusSuccess;
+    }
+#endif
     miopenStatus_t status = miopenStatusSuccess;
     mlo_construct_neuron construct_params(conv::Direction::Forward);
 
@@ -406,6 +415,25 @@ miopenStatus_t ActivationDescriptor::Backward(Handle& handle,
     {
         MIOPEN_THROW("Only alpha=1 and beta=0 is supported");
     }
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ActivationBackward(*this,
+                                 yDesc,
+                                 y,
+                                 dyDesc,
+                                 dy,
+                                 xDesc,
+                                 x,
+                                 dxDesc,
+                                 dx,
+                                 yOffset,
+                                 dyOffset,
+                                 xOffset,
+                                 dxOffset);
+        return miopenStatusSuccess;
+    }
+#endif
     miopenStatus_t status = miopenStatusSuccess;
 
     mlo_construct_neuron construct_params(conv::Direction::BackwardData);
@@ -26,8 +26,10 @@
 #include <miopen/batch_norm.hpp>
 
 #include <miopen/check_numerics.hpp>
+#include <miopen/config.h>
 #include <miopen/errors.hpp>
 #include <miopen/handle.hpp>
+#include <miopen/host_exec.hpp>
 #include <miopen/float_equal.hpp>
 #include <miopen/logger.hpp>
 #include <miopen/tensor.hpp>
@@ -107,6 +109,26 @@ void BatchNormForwardTraining(Handle& handle,
         miopen::checkNumericsInput(handle, bnScaleBiasMeanVarDesc, bnBias);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::BatchNormForwardTraining(bn_mode,
+                                       xDesc,
+                                       x,
+                                       y,
+                                       bnScaleBiasMeanVarDesc,
+                                       bnScale,
+                                       bnBias,
+                                       expAvgFactor,
+                                       resultRunningMean,
+                                       resultRunningVariance,
+                                       epsilon,
+                                       resultSaveMean,
+                                       resultSaveInvVariance);
+        return;
+    }
+#endif
+
     static const auto ctx = GetContext(handle);
 
     int n, c, h, w;
@@ -688,6 +710,23 @@ void BatchNormForwardInference(Handle& handle,
             MIOPEN_THROW(miopenStatusBadParm);
         }
 
+#if MIOPEN_MODE_NOGPU
+        if(IsHostExecution(handle))
+        {
+            host::BatchNormForwardInference(bn_mode,
+                                            xDesc,
+                                            x,
+                                            y,
+                                            bnScaleBiasMeanVarDesc,
+                                            bnScale,
+                                            bnBias,
+                                            estimatedMean,
+                                            estimatedVariance,
+                                            epsilon);
+            return;
+        }
+#endif
+
         bool bfpmixparm = false;
         bool bfp16parm  = false;
         bool bfp32parm  = true;
@@ -875,6 +914,25 @@ void BatchNormBackward(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::BatchNormBackward(bn_mode,
+                                xDesc,
+                                x,
+                                dy,
+                                dx,
+                                bnScaleBiasDiffDesc,
+                                bnScale,
+                                resultBnScaleDiff,
+                                resultBnBiasDiff,
+                                epsilon,
+                                savedMean,
+                                savedInvVariance);
+        return;
+    }
+#endif
+
     static const auto ctx = GetContext(handle);
 
     std::vector<size_t> vld;
@@ -36,11 +36,13 @@
 #include <miopen/finddb_kernel_cache_key.hpp>
 #include <miopen/find_controls.hpp>
 #include <miopen/float_equal.hpp>
+#include <miopen/host_exec.hpp>
 #include <miopen/invoker.hpp>
 #include <miopen/kernel.hpp>
 #include <miopen/solver.hpp>
 #include <miopen/tensor_ops.hpp>
 #include <miopen/tensor.hpp>
+#include <miopen/trace.hpp>
 #include <miopen/util.hpp>
 #include <miopen/visit_float.hpp>
 #include <miopen/datatype.hpp>
@@ -734,6 +736,7 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
                                                  size_t workSpaceSize,
                                                  bool exhaustiveSearch) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::FindConvFwdAlgorithm");
     MIOPEN_LOG_I("requestAlgoCount = " << requestAlgoCount << ", workspace = " << workSpaceSize);
     if(x == nullptr || w == nullptr || y == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "Buffers cannot be NULL");
@@ -746,6 +749,18 @@ void ConvolutionDescriptor::FindConvFwdAlgorithm(Handle& handle,
 
     *returnedAlgoCount = 0;
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        // Every algorithm runs the same host implementation, nothing to search.
+        *returnedAlgoCount      = 1;
+        perfResults[0].fwd_algo = miopenConvolutionFwdAlgoGEMM;
+        perfResults[0].time     = 0;
+        perfResults[0].memory   = 0;
+        return;
+    }
+#endif
+
     const ProblemDescription problem(xDesc, wDesc, yDesc, *this, conv::Direction::Forward);
     auto ctx = ConvolutionContext{problem};
     ctx.SetStream(&handle);
@@ -903,6 +918,15 @@ void ConvolutionDescriptor::ConvolutionForward(Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        ValidateGroupCount(xDesc, wDesc, *this);
+        host::ConvolutionForward(*this, xDesc, x, wDesc, w, yDesc, y);
+        return;
+    }
+#endif
+
     ConvForwardCheckNumerics(handle, tensors, [&]() {
         ValidateGroupCount(xDesc, wDesc, *this);
 
@@ -1903,6 +1927,7 @@ void ConvolutionDescriptor::GetForwardSolutions(Handle& handle,
                                                 miopenConvSolution_t* const solutions,
                                                 bool* const fallbackPathTaken) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::GetForwardSolutions");
     MIOPEN_LOG_I("");
     if(solutionCount == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "solutionCount cannot be nullptr");
@@ -2073,6 +2098,14 @@ void ConvolutionDescriptor::ConvolutionForwardImmediate(Handle& handle,
     if(!solver_id.IsValid())
         MIOPEN_THROW(miopenStatusBadParm);
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ConvolutionForward(*this, xDesc, x, wDesc, w, yDesc, y);
+        return;
+    }
+#endif
+
     ConvForwardCheckNumerics(handle, tensors, [&]() {
         auto ctx = ConvolutionContext{xDesc, wDesc, yDesc, *this, conv::Direction::Forward};
         ctx.SetStream(&handle);
@@ -2114,6 +2147,7 @@ void ConvolutionDescriptor::FindConvBwdDataAlgorithm(Handle& handle,
                                                      size_t workSpaceSize,
                                                      bool exhaustiveSearch) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::FindConvBwdDataAlgorithm");
     MIOPEN_LOG_I("requestAlgoCount = " << requestAlgoCount << ", workspace = " << workSpaceSize);
     if(dx == nullptr || w == nullptr || dy == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "Buffers cannot be NULL");
@@ -2128,6 +2162,18 @@ void ConvolutionDescriptor::FindConvBwdDataAlgorithm(Handle& handle,
 
     *returnedAlgoCount = 0;
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        // Every algorithm runs the same host implementation, nothing to search.
+        *returnedAlgoCount           = 1;
+        perfResults[0].bwd_data_algo = miopenConvolutionBwdDataAlgoGEMM;
+        perfResults[0].time          = 0;
+        perfResults[0].memory        = 0;
+        return;
+    }
+#endif
+
     AutoEnableProfiling enableProfiling{handle};
 
     const ProblemDescription problem(dxDesc, wDesc, dyDesc, *this, conv::Direction::BackwardData);
@@ -2505,6 +2551,15 @@ void ConvolutionDescriptor::ConvolutionBackwardData(Handle& handle,
     if(wDesc.GetType() == miopenInt8)
         MIOPEN_THROW(miopenStatusBadParm);
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        ValidateGroupCount(dxDesc, wDesc, *this);
+        host::ConvolutionBackwardData(*this, dyDesc, dy, wDesc, w, dxDesc, dx);
+        return;
+    }
+#endif
+
     ConvBwdCheckNumerics(handle, tensors, beta, [&]() {
         if(dyDesc.GetLengths()[1] != wDesc.GetLengths()[0])
         {
@@ -2857,6 +2912,7 @@ void ConvolutionDescriptor::GetBackwardSolutions(Handle& handle,
                                                  miopenConvSolution_t* solutions,
                                                  bool* const fallbackPathTaken) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::GetBackwardSolutions");
     MIOPEN_LOG_I("");
     if(solutionCount == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "solutionCount cannot be nullptr");
@@ -2937,6 +2993,14 @@ void ConvolutionDescriptor::ConvolutionBackwardImmediate(Handle& handle,
     if(wDesc.GetType() == miopenInt8)
         MIOPEN_THROW(miopenStatusBadParm);
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ConvolutionBackwardData(*this, dyDesc, dy, wDesc, w, dxDesc, dx);
+        return;
+    }
+#endif
+
     static const float beta = 0.0f;
     ConvBwdCheckNumerics(handle, tensors, &beta, [&]() {
         if(dyDesc.GetLengths()[1] != wDesc.GetLengths()[0])
@@ -2985,6 +3049,7 @@ void ConvolutionDescriptor::FindConvBwdWeightsAlgorithm(Handle& handle,
                                                         size_t workSpaceSize,
                                                         bool exhaustiveSearch) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::FindConvBwdWeightsAlgorithm");
     MIOPEN_LOG_I("requestAlgoCount = " << requestAlgoCount << ", workspace = " << workSpaceSize);
     if(x == nullptr || dw == nullptr || dy == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "Buffers cannot be NULL");
@@ -2999,6 +3064,18 @@ void ConvolutionDescriptor::FindConvBwdWeightsAlgorithm(Handle& handle,
 
     *returnedAlgoCount = 0;
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        // Every algorithm runs the same host implementation, nothing to search.
+        *returnedAlgoCount              = 1;
+        perfResults[0].bwd_weights_algo = miopenConvolutionBwdWeightsAlgoGEMM;
+        perfResults[0].time             = 0;
+        perfResults[0].memory           = 0;
+        return;
+    }
+#endif
+
     AutoEnableProfiling enableProfiling{handle};
 
     auto problem =
@@ -3275,6 +3352,15 @@ void ConvolutionDescriptor::ConvolutionBackwardWeights(Handle& handle,
     if(xDesc.GetType() == miopenInt8)
         MIOPEN_THROW(miopenStatusBadParm);
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        ValidateGroupCount(xDesc, dwDesc, *this);
+        host::ConvolutionBackwardWeights(*this, dyDesc, dy, xDesc, x, dwDesc, dw);
+        return;
+    }
+#endif
+
     ConvWrwCheckNumerics(handle, tensors, beta, [&]() {
         ValidateGroupCount(xDesc, dwDesc, *this);
 
@@ -3535,6 +3621,7 @@ void ConvolutionDescriptor::GetWrwSolutions(Handle& handle,
                                             miopenConvSolution_t* solutions,
                                             bool* const fallbackPathTaken) const
 {
+    MIOPEN_TRACE_SCOPE("ConvolutionDescriptor::GetWrwSolutions");
     MIOPEN_LOG_I("");
     if(solutionCount == nullptr)
         MIOPEN_THROW(miopenStatusBadParm, "solutionCount cannot be nullptr");
@@ -3614,6 +3701,14 @@ void ConvolutionDescriptor::ConvolutionWrwImmediate(Handle& handle,
     if(xDesc.GetType() == miopenInt8)
         MIOPEN_THROW(miopenStatusBadParm);
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ConvolutionBackwardWeights(*this, dyDesc, dy, xDesc, x, dwDesc, dw);
+        return;
+    }
+#endif
+
     float beta = 0;
     ConvWrwCheckNumerics(handle, tensors, &beta, [&]() {
         ValidateGroupCount(xDesc, dwDesc, *this);
@@ -3667,6 +3762,14 @@ void ConvolutionBackwardBias(const Handle& handle,
         miopen::checkNumericsInput(handle, dyDesc, dy);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ConvolutionBackwardBias(dyDesc, dy, dbDesc, db);
+        return;
+    }
+#endif
+
     std::size_t out_n, out_k, stride_n, stride_k;
     std::tie(out_n, out_k)       = tie_pick<0, 1>()(dyDesc.GetLengths());
     std::tie(stride_n, stride_k) = tie_pick<0, 1>()(dyDesc.GetStrides());
@@ -30,6 +30,7 @@
 #include <miopen/db.hpp>
 #include <miopen/env.hpp>
 #include <miopen/find_db.hpp>
+#include <miopen/host_exec.hpp>
 #include <miopen/util.hpp>
 #include <miopen/solver.hpp>
 #include <miopen/float_equal.hpp>
@@ -107,6 +108,23 @@ void CTCLossDescriptor::CTCLoss(const Handle& handle,
         }
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::CTCLoss(probsDesc,
+                      probs,
+                      labels,
+                      labelLengths,
+                      inputLengths,
+                      losses,
+                      gradientsDesc,
+                      gradients,
+                      blank_label_id,
+                      apply_softmax_layer);
+        return;
+    }
+#endif
+
     int max_S_len       = 2 * max_label_len + 1;
     int lb_prime_offset = 4 * batch_size + total_label_len;
     int problog_offset  = lb_prime_offset + batch_size * max_S_len;
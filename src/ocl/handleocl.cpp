@@ -35,9 +35,11 @@
 #include <miopen/kernel_cache.hpp>
 #include <miopen/load_file.hpp>
 #include <miopen/logger.hpp>
+#include <miopen/perf_counters.hpp>
 #include <miopen/manage_ptr.hpp>
 #include <miopen/ocldeviceinfo.hpp>
 #include <miopen/timer.hpp>
+#include <miopen/trace.hpp>
 
 #if MIOPEN_USE_MIOPENGEMM
 #include <miopen/gemm_geometry.hpp>
@@ -328,6 +330,7 @@ KernelInvoke Handle::AddKernel(const std::string& algorithm,
 Invoker Handle::PrepareInvoker(const InvokerFactory& factory,
                                const std::vector<solver::KernelInfo>& kernels) const
 {
+    MIOPEN_TRACE_SCOPE("Handle::PrepareInvoker");
     std::vector<Kernel> built;
     for(auto& k : kernels)
     {
@@ -384,14 +387,36 @@ Program Handle::LoadProgram(const std::string& program_name,
                             bool is_kernel_str,
                             const std::string& kernel_src) const
 {
+    MIOPEN_TRACE_SCOPE_DETAIL("Handle::LoadProgram", program_name);
     auto hsaco = miopen::LoadBinary(this->GetTargetProperties(),
                                     this->GetMaxComputeUnits(),
                                     program_name,
                                     params,
                                     is_kernel_str);
+#if MIOPEN_ENABLE_SQLITE_KERN_CACHE
+    std::string content_key;
+    if(hsaco.empty())
+    {
+        // An identical kernel may have been built by another MIOpen version
+        // or with an equivalent set of options.
+        content_key = miopen::GetKernelContentKey(
+            this->GetTargetProperties(), program_name, params, is_kernel_str, kernel_src);
+        hsaco = miopen::LoadBinaryByContent(this->GetTargetProperties(), content_key);
+        if(!hsaco.empty())
+            miopen::SaveBinary(hsaco,
+                               this->GetTargetProperties(),
+                               this->GetMaxComputeUnits(),
+                               program_name,
+                               params,
+                               is_kernel_str);
+    }
+#endif
     if(hsaco.empty())
     {
+        MIOPEN_TRACE_SCOPE_DETAIL("Handle::BuildProgram", program_name);
         CompileTimer ct;
+        Timer timer;
+        timer.start();
         auto p = miopen::LoadProgram(miopen::GetContext(this->GetStream()),
                                      miopen::GetDevice(this->GetStream()),
                                      this->GetTargetProperties(),
@@ -400,6 +425,28 @@ Program Handle::LoadProgram(const std::string& program_name,
                                      is_kernel_str,
                                      kernel_src);
         ct.Log("Kernel", is_kernel_str ? std::string() : program_name);
+        const auto compile_ms = timer.elapsed_ms();
+        counters::Add(counters::Source::KernDb, counters::Counter::Compiles);
+        counters::Add(counters::Source::KernDb,
+                      counters::Counter::CompileTimeUs,
+                      static_cast<std::uint64_t>(compile_ms * 1000));
+        if(!is_kernel_str)
+        {
+            // The compile time is only a hint, failing to record it must not fail the build.
+            try
+            {
+                miopen::SaveCompileTime(compile_ms,
+                                        this->GetTargetProperties(),
+                                        this->GetMaxComputeUnits(),
+                                        program_name,
+                                        params);
+            }
+            catch(const std::exception& ex)
+            {
+                MIOPEN_LOG_W("Unable to save the compile time of " << program_name << ": "
+                                                                   << ex.what());
+            }
+        }
 
 // Save to cache
 #if MIOPEN_ENABLE_SQLITE_KERN_CACHE
@@ -411,6 +458,7 @@ Program Handle::LoadProgram(const std::string& program_name,
                            program_name,
                            params,
                            is_kernel_str);
+        miopen::SaveBinaryByContent(binary, this->GetTargetProperties(), content_key);
 #else
         auto path = miopen::GetCachePath(false) / boost::filesystem::unique_path();
         miopen::SaveProgramBinary(p, path.string());
@@ -23,6 +23,8 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/config.h>
+#include <miopen/host_exec.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/mlo_internal.hpp>
 #include <miopen/pooling.hpp>
@@ -148,6 +150,13 @@ miopenStatus_t PoolingDescriptor::Forward(Handle& handle,
                                         "backward pass is requested");
         }
     }
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::PoolingForward(*this, xDesc, x, yDesc, y, save_index, workSpace);
+        return miopenStatusSuccess;
+    }
+#endif
     int pooling_method =
         (mode == miopenPoolingMax)
             ? MLO_POOLING_OP_MAX
@@ -437,6 +446,13 @@ miopenStatus_t PoolingDescriptor::Backward(Handle& handle,
     {
         throw std::invalid_argument("workSpace cannot be NULL in Backward Pooling MAX mode");
     }
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::PoolingBackward(*this, dyDesc, dy, dxDesc, dx, workSpace);
+        return miopenStatusSuccess;
+    }
+#endif
     int pooling_method =
         (mode == miopenPoolingMax)
             ? MLO_POOLING_OP_MAX
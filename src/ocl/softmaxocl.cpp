@@ -23,6 +23,8 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <miopen/config.h>
+#include <miopen/host_exec.hpp>
 #include <miopen/kernel_cache.hpp>
 #include <miopen/softmax.hpp>
 #include <miopen/float_equal.hpp>
@@ -78,6 +80,15 @@ miopenStatus_t SoftmaxForward(const Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "Tensor dimension lengths do not match.");
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::SoftmaxForward(
+            alpha, beta, xDesc, x, yDesc, y, algorithm, mode, x_offset, y_offset);
+        return miopenStatusSuccess;
+    }
+#endif
+
     int n, c, h, w;
     std::tie(n, c, h, w) = tien<4>(yDesc.GetLengths());
 
@@ -353,6 +364,26 @@ miopenStatus_t SoftmaxBackward(const Handle& handle,
         miopen::checkNumericsInput(handle, yDesc, y);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::SoftmaxBackward(alpha,
+                              yDesc,
+                              y,
+                              dyDesc,
+                              dy,
+                              beta,
+                              dxDesc,
+                              dx,
+                              algorithm,
+                              mode,
+                              y_offset,
+                              dy_offset,
+                              dx_offset);
+        return miopenStatusSuccess;
+    }
+#endif
+
     int n, c, h, w;
     std::tie(n, c, h, w) = tien<4>(dxDesc.GetLengths());
 
@@ -27,6 +27,7 @@
 #include <miopen/errors.hpp>
 #include <miopen/float_equal.hpp>
 #include <miopen/handle.hpp>
+#include <miopen/host_exec.hpp>
 #include <miopen/tensor_ops.hpp>
 #include <miopen/datatype.hpp>
 #include <miopen/visit_float.hpp>
@@ -1292,6 +1293,28 @@ void OpTensor(const Handle& handle,
         }
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        if(is_squash)
+            MIOPEN_THROW(miopenStatusNotImplemented, "Host execution does not squash B");
+        host::OpTensor(tensorOp,
+                       alpha0,
+                       aTensorDesc,
+                       ATensor,
+                       alpha1,
+                       bTensorDesc,
+                       BTensor,
+                       beta,
+                       cTensorDesc,
+                       CTensor,
+                       Aoffset,
+                       Boffset,
+                       Coffset);
+        return;
+    }
+#endif
+
     auto bsize = blens.size();
     if(bsize == 3)
     {
@@ -1404,6 +1427,14 @@ void SetTensor(const Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::SetTensor(yDesc, y, alpha, offset);
+        return;
+    }
+#endif
+
     const TensorDescriptor yDesc_flat = GetFlattenedTensorDescriptor(yDesc);
 
 #ifndef NDEBUG
@@ -1563,6 +1594,14 @@ void ScaleTensor(const Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm);
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::ScaleTensor(yDesc, y, alpha, offset);
+        return;
+    }
+#endif
+
     const TensorDescriptor yDesc_flat = GetFlattenedTensorDescriptor(yDesc);
 
 #ifndef NDEBUG
@@ -1741,6 +1780,14 @@ void CopyTensor(const Handle& handle,
         MIOPEN_THROW(miopenStatusBadParm, "Tensor dimension lengths do not match.");
     }
 
+#if MIOPEN_MODE_NOGPU
+    if(IsHostExecution(handle))
+    {
+        host::CopyTensor(srcDesc, src, dstDesc, dst, srcOffset, dstOffset);
+        return;
+    }
+#endif
+
     auto flat_descriptors = GetConsistentFlattenedTensorDescriptors(srcDesc, dstDesc);
     const TensorDescriptor& srcDesc_flat = std::get<0>(flat_descriptors);
     const TensorDescriptor& dstDesc_flat = std::get<1>(flat_descriptors);
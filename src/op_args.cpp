@@ -23,20 +23,28 @@
  * SOFTWARE.
  *
  *******************************************************************************/
+#include <atomic>
 #include <cassert>
 #include <miopen/fusion.hpp>
 #include <miopen/logger.hpp>
 
 namespace miopen {
 
+static std::size_t NextVersion()
+{
+    static std::atomic<std::size_t> version{0};
+    return ++version;
+}
+
 // operator args
-OperatorArgs::OperatorArgs() {}
+OperatorArgs::OperatorArgs() : version(NextVersion()) {}
 
 void OperatorArgs::ins_arg(std::string name, OpKernelArg v)
 {
     args_map.emplace(std::make_pair(name, v));
     //    args_map[name] = std::move(v);
     args_vec.push_back(v);
+    version = NextVersion();
 }
 
 std::ostream& operator<<(std::ostream& stream, const OperatorArgs&) // x )
@@ -0,0 +1,267 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/perf_counters.hpp>
+
+#include <miopen/env.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace miopen {
+namespace counters {
+
+/// Writes the counters every this many seconds, 0 disables the dump.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_COUNTERS_DUMP_INTERVAL)
+
+/// File the dump is appended to, stderr when unset.
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_COUNTERS_DUMP_FILE)
+
+namespace {
+
+constexpr auto n_sources  = static_cast<std::size_t>(Source::Count);
+constexpr auto n_counters = static_cast<std::size_t>(Counter::Count);
+
+struct ThreadCounters
+{
+    std::array<std::atomic<std::uint64_t>, n_sources * n_counters> values{};
+};
+
+std::size_t Index(Source source, Counter counter)
+{
+    return static_cast<std::size_t>(source) * n_counters + static_cast<std::size_t>(counter);
+}
+
+/// The counters of the threads are folded into the retired ones when they exit.
+/// The registry is never destroyed, so the counters can be updated from the
+/// destructors of static objects. The dump thread is stopped at exit.
+class Registry
+{
+    public:
+    static Registry& Get()
+    {
+        static auto* const registry = new Registry{};
+        return *registry;
+    }
+
+    void Register(ThreadCounters& counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.push_back(&counters);
+    }
+
+    void Retire(ThreadCounters& counters)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(std::size_t i = 0; i < retired.size(); ++i)
+            retired[i] += counters.values[i].load(std::memory_order_relaxed);
+        threads.erase(std::find(threads.begin(), threads.end(), &counters));
+    }
+
+    // Counts from the threads which have already retired their counters.
+    void AddRetired(std::size_t index, std::uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        retired[index] += value;
+    }
+
+    Values Sum(Source source)
+    {
+        Values sum{};
+        std::lock_guard<std::mutex> lock(mutex);
+        for(std::size_t i = 0; i < n_counters; ++i)
+            sum[i] = retired[Index(source, static_cast<Counter>(i))];
+        for(const auto thread : threads)
+            for(std::size_t i = 0; i < n_counters; ++i)
+                sum[i] += thread->values[Index(source, static_cast<Counter>(i))].load(
+                    std::memory_order_relaxed);
+        for(std::size_t i = 0; i < n_counters; ++i)
+            sum[i] -= baseline[Index(source, static_cast<Counter>(i))];
+        return sum;
+    }
+
+    // The threads keep counting from their values, the sums start over from here.
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        baseline = retired;
+        for(const auto thread : threads)
+            for(std::size_t i = 0; i < baseline.size(); ++i)
+                baseline[i] += thread->values[i].load(std::memory_order_relaxed);
+    }
+
+    private:
+    std::mutex mutex;
+    std::vector<ThreadCounters*> threads;
+    std::array<std::uint64_t, n_sources * n_counters> retired{};
+    std::array<std::uint64_t, n_sources * n_counters> baseline{};
+
+    std::thread dumper;
+    std::mutex dump_mutex;
+    std::condition_variable dump_wakeup;
+    bool stopping = false;
+
+    Registry()
+    {
+        const auto interval = std::chrono::seconds{Value(MIOPEN_COUNTERS_DUMP_INTERVAL{})};
+        if(interval.count() == 0)
+            return;
+        dumper = std::thread([this, interval]() { RunDump(interval); });
+        std::atexit([]() { Get().StopDump(); });
+    }
+
+    void RunDump(std::chrono::seconds interval)
+    {
+        std::unique_lock<std::mutex> lock(dump_mutex);
+        while(!stopping)
+        {
+            dump_wakeup.wait_for(lock, interval);
+            Dump();
+        }
+    }
+
+    void StopDump()
+    {
+        {
+            std::lock_guard<std::mutex> lock(dump_mutex);
+            stopping = true;
+        }
+        dump_wakeup.notify_one();
+        dumper.join();
+    }
+
+    static void Dump()
+    {
+        const auto path = GetStringEnv(MIOPEN_COUNTERS_DUMP_FILE{});
+        if(path == nullptr)
+        {
+            WriteJson(std::cerr);
+            return;
+        }
+        std::ofstream file(path, std::ios::app);
+        WriteJson(file);
+    }
+};
+
+// Retires the counters of the thread when it exits.
+class ThreadCountersHolder
+{
+    public:
+    explicit ThreadCountersHolder(bool& exited_) : exited(exited_)
+    {
+        Registry::Get().Register(counters);
+    }
+    ThreadCountersHolder(const ThreadCountersHolder&) = delete;
+    ThreadCountersHolder& operator=(const ThreadCountersHolder&) = delete;
+    ~ThreadCountersHolder()
+    {
+        Registry::Get().Retire(counters);
+        exited = true;
+    }
+
+    ThreadCounters counters;
+
+    private:
+    bool& exited;
+};
+
+} // namespace
+
+void Add(Source source, Counter counter, std::uint64_t value)
+{
+    // Destructors of thread_local and static objects may count after the holder is gone.
+    thread_local bool exited = false;
+    if(exited)
+    {
+        Registry::Get().AddRetired(Index(source, counter), value);
+        return;
+    }
+    thread_local ThreadCountersHolder holder{exited};
+    auto& slot = holder.counters.values[Index(source, counter)];
+    // Only this thread writes the slot, there is no need for an atomic increment.
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+Values Get(Source source) { return Registry::Get().Sum(source); }
+
+void Reset() { Registry::Get().Reset(); }
+
+const char* ToString(Source source)
+{
+    switch(source)
+    {
+    case Source::KernelCache: return "kernel_cache";
+    case Source::InvokerCache: return "invoker_cache";
+    case Source::ReadonlyRamDb: return "readonly_ram_db";
+    case Source::PlainTextDb: return "plain_text_db";
+    case Source::SQLitePerfDb: return "sqlite_perf_db";
+    case Source::KernDb: return "kern_db";
+    case Source::Count: break;
+    }
+    return "<Unknown>";
+}
+
+const char* ToString(Counter counter)
+{
+    switch(counter)
+    {
+    case Counter::Lookups: return "lookups";
+    case Counter::Hits: return "hits";
+    case Counter::Misses: return "misses";
+    case Counter::BytesRead: return "bytes_read";
+    case Counter::Compiles: return "compiles";
+    case Counter::CompileTimeUs: return "compile_time_us";
+    case Counter::Count: break;
+    }
+    return "<Unknown>";
+}
+
+void WriteJson(std::ostream& os)
+{
+    os << "{\"time\": " << std::time(nullptr);
+    for(std::size_t s = 0; s < n_sources; ++s)
+    {
+        const auto source = static_cast<Source>(s);
+        const auto values = Get(source);
+        os << ", \"" << ToString(source) << "\": {";
+        for(std::size_t c = 0; c < n_counters; ++c)
+            os << (c == 0 ? "" : ", ") << '"' << ToString(static_cast<Counter>(c))
+               << "\": " << values[c];
+        os << '}';
+    }
+    os << '}' << std::endl;
+}
+
+} // namespace counters
+} // namespace miopen
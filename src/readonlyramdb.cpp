@@ -27,6 +27,8 @@
 #include <miopen/readonlyramdb.hpp>
 #include <miopen/logger.hpp>
 #include <miopen/errors.hpp>
+#include <miopen/perf_counters.hpp>
+#include <miopen/trace.hpp>
 
 #if MIOPEN_EMBED_DB
 #include <miopen_data.hpp>
@@ -71,15 +73,16 @@ ReadonlyRamDb& ReadonlyRamDb::GetCached(const std::string& path,
 }
 
 template <class TFunc>
-static auto Measure(const std::string& funcName, TFunc&& func)
+static auto Measure(const char* funcName, TFunc&& func)
 {
+    MIOPEN_TRACE_SCOPE(funcName);
     if(!miopen::IsLogging(LoggingLevel::Info))
         return func();
 
     const auto start = std::chrono::high_resolution_clock::now();
     func();
     const auto end = std::chrono::high_resolution_clock::now();
-    MIOPEN_LOG_I("Db::" << funcName << " time: " << (end - start).count() * .000001f << " ms");
+    MIOPEN_LOG_I(funcName << " time: " << (end - start).count() * .000001f << " ms");
 }
 
 void ReadonlyRamDb::ParseAndLoadDb(std::istream& input_stream,
@@ -94,12 +97,14 @@ void ReadonlyRamDb::ParseAndLoadDb(std::istream& input_stream,
         return;
     }
 
-    auto line   = std::string{};
-    auto n_line = 0;
+    auto line       = std::string{};
+    auto n_line     = 0;
+    auto bytes_read = std::uint64_t{0};
 
     while(std::getline(input_stream, line))
     {
         ++n_line;
+        bytes_read += line.size() + 1;
 
         if(line.empty())
             continue;
@@ -118,11 +123,12 @@ void ReadonlyRamDb::ParseAndLoadDb(std::istream& input_stream,
 
         cache.emplace(key, CacheItem{n_line, contents});
     }
+    counters::Add(counters::Source::ReadonlyRamDb, counters::Counter::BytesRead, bytes_read);
 }
 
 void ReadonlyRamDb::Prefetch(const std::string& path, bool warn_if_unreadable)
 {
-    Measure("Prefetch", [this, &path, warn_if_unreadable]() {
+    Measure("Db::Prefetch", [this, &path, warn_if_unreadable]() {
 
         constexpr bool isEmbedded = MIOPEN_EMBED_DB;
         if(!testing_find_db_path_override() && isEmbedded)
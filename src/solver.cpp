@@ -32,9 +32,13 @@
 #include <miopen/par_for.hpp>
 #include <miopen/stringutils.hpp>
 #include <miopen/any_solver.hpp>
+#include <miopen/binary_cache.hpp>
+#include <miopen/logger.hpp>
 #include <miopen/timer.hpp>
 
 #include <boost/range/adaptor/transformed.hpp>
+#include <algorithm>
+#include <numeric>
 #include <ostream>
 
 namespace miopen {
@@ -53,18 +57,70 @@ std::ostream& operator<<(std::ostream& os, const KernelInfo& k)
     return os << "} '" << k.comp_options << '\'';
 }
 
+// Rough build cost of a kernel per byte of its main source file, used when
+// the kernel has never been compiled on this target. HIP sources pull in large
+// headers, so their own size underestimates the work much more than for OpenCL
+// or assembly.
+static float EstimateCompileTimeFromSource(const std::string& kernel_file)
+{
+    std::size_t src_size = 0;
+    try
+    {
+        src_size = GetKernelSrc(kernel_file).size();
+    }
+    catch(const Exception&)
+    {
+        return 0.0f;
+    }
+
+    if(EndsWith(kernel_file, ".s"))
+        return src_size * 0.01f;
+    if(EndsWith(kernel_file, ".cpp"))
+        return src_size * 0.5f;
+    return src_size * 0.05f;
+}
+
+static float EstimateCompileTime(const Handle& h, const KernelInfo& k)
+{
+    // The recorded time is only a hint for ordering the builds.
+    try
+    {
+        const auto known = LoadCompileTime(
+            h.GetTargetProperties(), h.GetMaxComputeUnits(), k.kernel_file, k.comp_options);
+        if(known)
+            return *known;
+    }
+    catch(const std::exception& ex)
+    {
+        MIOPEN_LOG_W("Unable to load the compile time of " << k.kernel_file << ": " << ex.what());
+    }
+    return EstimateCompileTimeFromSource(k.kernel_file);
+}
+
 std::vector<Program> PrecompileKernels(const Handle& h, const std::vector<KernelInfo>& kernels)
 {
     CompileTimer ct;
     std::vector<Program> programs(kernels.size());
 
+    // Start the longest builds first so they do not become the tail of the batch.
+    std::vector<float> costs(kernels.size());
+    std::transform(kernels.begin(), kernels.end(), costs.begin(), [&](const KernelInfo& k) {
+        return EstimateCompileTime(h, k);
+    });
+    std::vector<std::size_t> order(kernels.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto lhs, auto rhs) {
+        return costs[lhs] > costs[rhs];
+    });
+
     // clang-format off
-    par_for(kernels.size(),
-            max_threads{Value(MIOPEN_COMPILE_PARALLEL_LEVEL{}, 20)},
-            [&](auto i) {
-                const KernelInfo& k = kernels[i];
-                programs[i]         = h.LoadProgram(k.kernel_file, k.comp_options, false, "");
-            });
+    par_for_dynamic(kernels.size(),
+                    max_threads{Value(MIOPEN_COMPILE_PARALLEL_LEVEL{}, 20)},
+                    [&](auto i) {
+                        const auto idx      = order[i];
+                        const KernelInfo& k = kernels[idx];
+                        programs[idx]       = h.LoadProgram(k.kernel_file, k.comp_options, false, "");
+                    });
     // clang-format on
     ct.Log("PrecompileKernels");
     return programs;
@@ -0,0 +1,262 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include <miopen/trace.hpp>
+
+#include <miopen/env.hpp>
+#include <miopen/logger.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace miopen {
+namespace trace {
+
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_TRACE_FILE)
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_TRACE_BUFFER_SIZE)
+
+namespace {
+
+struct Event
+{
+    const char* name = nullptr;
+    std::string detail;
+    Clock::time_point begin;
+    Clock::time_point end;
+};
+
+std::size_t GetCapacity()
+{
+    static const auto capacity =
+        std::max<std::size_t>(Value(MIOPEN_TRACE_BUFFER_SIZE{}, 65536), 1);
+    return capacity;
+}
+
+// Ring of the last events of a thread, grown as the events come in. The mutex is
+// only contended while writing the trace out.
+struct ThreadBuffer
+{
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::size_t recorded = 0;
+    std::size_t tid      = 0;
+};
+
+struct RetiredEvent
+{
+    std::size_t tid;
+    Event event;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadBuffer*> buffers;
+    // Events of the threads that have exited, the oldest are dropped past the capacity.
+    std::deque<RetiredEvent> retired;
+    std::size_t retired_dropped = 0;
+    std::size_t next_tid        = 0;
+
+    const Clock::time_point origin = Clock::now();
+
+    Registry()
+    {
+        if(GetStringEnv(MIOPEN_TRACE_FILE{}) != nullptr)
+            std::atexit([]() { Get().WriteFile(); });
+    }
+
+    void Register(ThreadBuffer& buffer)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.tid = next_tid++;
+        buffers.push_back(&buffer);
+    }
+
+    void Retire(ThreadBuffer& buffer)
+    {
+        std::lock_guard<std::mutex> registry_lock(mutex);
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        const auto capacity = GetCapacity();
+        const auto start    = buffer.recorded > capacity ? buffer.recorded - capacity : 0;
+        retired_dropped += start;
+        for(auto i = start; i < buffer.recorded; ++i)
+            retired.push_back({buffer.tid, std::move(buffer.events[i % capacity])});
+        while(retired.size() > capacity)
+        {
+            retired.pop_front();
+            ++retired_dropped;
+        }
+        buffer.events   = {};
+        buffer.recorded = 0;
+        buffers.erase(std::find(buffers.begin(), buffers.end(), &buffer));
+    }
+
+    // Leaked so the threads that exit after the main one can still retire their events.
+    static Registry& Get()
+    {
+        static auto* const registry = new Registry{};
+        return *registry;
+    }
+
+    // Runs after the destructors of the thread_local objects of the exiting thread.
+    void WriteFile()
+    {
+        const auto path = GetStringEnv(MIOPEN_TRACE_FILE{});
+        if(path == nullptr)
+            return;
+        std::ofstream file(path);
+        Write(file);
+        if(!file)
+            MIOPEN_LOG_E("Failed to write the trace to <" << path << ">");
+    }
+};
+
+void WriteJsonString(std::ostream& os, const std::string& s)
+{
+    static const char* const hex = "0123456789abcdef";
+    os << '"';
+    for(const auto c : s)
+    {
+        if(c == '"' || c == '\\')
+            os << '\\' << c;
+        else if(static_cast<unsigned char>(c) < 0x20)
+            os << "\\u00" << hex[static_cast<unsigned char>(c) >> 4] << hex[c & 0xf];
+        else
+            os << c;
+    }
+    os << '"';
+}
+
+double Microseconds(Clock::duration d)
+{
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+void WriteEvent(std::ostream& os,
+                bool first,
+                int pid,
+                std::size_t tid,
+                Clock::time_point origin,
+                const Event& event)
+{
+    os << (first ? "\n" : ",\n") << "{\"name\": \"" << event.name
+       << "\", \"cat\": \"miopen\", \"ph\": \"X\", \"pid\": " << pid << ", \"tid\": " << tid
+       << ", \"ts\": " << Microseconds(event.begin - origin)
+       << ", \"dur\": " << Microseconds(event.end - event.begin);
+    if(!event.detail.empty())
+    {
+        os << ", \"args\": {\"detail\": ";
+        WriteJsonString(os, event.detail);
+        os << "}";
+    }
+    os << "}";
+}
+
+// Hands the events of the thread over to the registry when the thread exits.
+struct ThreadBufferHolder
+{
+    ThreadBufferHolder() : registry(Registry::Get()) { registry.Register(buffer); }
+    ThreadBufferHolder(const ThreadBufferHolder&) = delete;
+    ThreadBufferHolder& operator=(const ThreadBufferHolder&) = delete;
+    ~ThreadBufferHolder() { registry.Retire(buffer); }
+
+    Registry& registry;
+    ThreadBuffer buffer;
+};
+
+} // namespace
+
+bool IsEnabled()
+{
+    static const bool enabled = [] {
+        if(GetStringEnv(MIOPEN_TRACE_FILE{}) == nullptr)
+            return false;
+        // Sets the origin of the timestamps before the first span begins.
+        Registry::Get();
+        return true;
+    }();
+    return enabled;
+}
+
+void Record(const char* name, std::string detail, Clock::time_point begin, Clock::time_point end)
+{
+    thread_local ThreadBufferHolder holder;
+    auto& buffer = holder.buffer;
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if(buffer.events.size() < GetCapacity())
+        buffer.events.emplace_back();
+    auto& event  = buffer.events[buffer.recorded++ % GetCapacity()];
+    event.name   = name;
+    event.detail = std::move(detail);
+    event.begin  = begin;
+    event.end    = end;
+}
+
+void Write(std::ostream& os)
+{
+#ifndef _WIN32
+    const auto pid = getpid();
+#else
+    const auto pid = 0;
+#endif
+    auto& registry = Registry::Get();
+    std::lock_guard<std::mutex> registry_lock(registry.mutex);
+
+    std::size_t dropped = registry.retired_dropped;
+    bool first          = true;
+    os << "{\"traceEvents\": [";
+    for(const auto& retired : registry.retired)
+    {
+        WriteEvent(os, first, pid, retired.tid, registry.origin, retired.event);
+        first = false;
+    }
+    const auto capacity = GetCapacity();
+    for(const auto buffer : registry.buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        const auto start = buffer->recorded > capacity ? buffer->recorded - capacity : 0;
+        dropped += start;
+        for(auto i = start; i < buffer->recorded; ++i)
+        {
+            WriteEvent(os, first, pid, buffer->tid, registry.origin, buffer->events[i % capacity]);
+            first = false;
+        }
+    }
+    os << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped\": " << dropped << "}}"
+       << std::endl;
+}
+
+} // namespace trace
+} // namespace miopen
@@ -31,6 +31,9 @@
 #include <miopen/md5.hpp>
 #include "test.hpp"
 
+#include <cmath>
+#include <vector>
+
 #if MIOPEN_ENABLE_SQLITE
 std::string random_string(size_t length)
 {
@@ -130,6 +133,109 @@ void check_kern_db()
         CHECK(err_db.RemoveRecordUnsafe(cfg0));
     }
 }
+
+void check_kern_db_compile_time()
+{
+    miopen::KernelCompileTime rec0{"kernel1", random_string(512), 1234.5f};
+
+    miopen::KernDb empty_db("", false, "gfx906", 60);
+    CHECK(!empty_db.FindCompileTimeUnsafe(rec0));
+    CHECK(!empty_db.StoreCompileTimeUnsafe(rec0));
+
+    {
+        miopen::TempFile temp_file("tmp-kerndb");
+        miopen::KernDb clean_db(std::string(temp_file), false, "gfx906", 60);
+
+        CHECK(!clean_db.FindCompileTimeUnsafe(rec0));
+        CHECK(clean_db.StoreCompileTimeUnsafe(rec0));
+        auto readout = clean_db.FindCompileTimeUnsafe(rec0);
+        CHECK(readout);
+        CHECK(std::abs(readout.get() - rec0.compile_time_ms) < 0.01f);
+
+        // A rebuild replaces the previous duration
+        rec0.compile_time_ms = 42.0f;
+        CHECK(clean_db.StoreCompileTimeUnsafe(rec0));
+        readout = clean_db.FindCompileTimeUnsafe(rec0);
+        CHECK(readout);
+        CHECK(std::abs(readout.get() - rec0.compile_time_ms) < 0.01f);
+    }
+}
+
+void check_kern_db_eviction()
+{
+    miopen::TempFile temp_file("tmp-kerndb");
+    std::vector<miopen::KernelConfig> kernels;
+    for(auto i = 0; i < 4; ++i)
+        kernels.push_back({"kernel" + std::to_string(i), random_string(64), random_string(1024)});
+
+    {
+        miopen::KernDb db(std::string(temp_file),
+                          false,
+                          "gfx906",
+                          60,
+                          [](std::string str, bool* success) {
+                              *success = false;
+                              return str;
+                          },
+                          miopen::decompress);
+        for(const auto& kernel : kernels)
+            CHECK(db.StoreRecordUnsafe(kernel));
+        CHECK(db.FindRecordUnsafe(kernels[0]));
+        CHECK(!db.FindRecordUnsafe(miopen::KernelConfig{"kernel4", "", ""}));
+        db.MaintainUnsafe();
+
+        auto stats = db.GetStatsUnsafe();
+        CHECK(stats.entries == 4);
+        CHECK(stats.bytes == 4 * 1024);
+        CHECK(stats.hits == 1);
+        CHECK(stats.misses == 1);
+
+        // The least recently used are kernel1 and kernel2
+        CHECK(db.EvictUnsafe(2 * 1024) == 2);
+        CHECK(db.FindRecordUnsafe(kernels[0]));
+        CHECK(!db.FindRecordUnsafe(kernels[1]));
+        CHECK(!db.FindRecordUnsafe(kernels[2]));
+        CHECK(db.FindRecordUnsafe(kernels[3]));
+        CHECK(db.EvictUnsafe(2 * 1024) == 0);
+    }
+
+    // Counters persist between the runs
+    miopen::KernDb db(std::string(temp_file), false, "gfx906", 60);
+    const auto stats = db.GetStatsUnsafe();
+    CHECK(stats.entries == 2);
+    CHECK(stats.hits == 3);
+    CHECK(stats.misses == 3);
+}
+
+void check_kern_db_manifest()
+{
+    miopen::KernelManifestEntry entry0{"app", "kernel1", random_string(512)};
+    miopen::KernelManifestEntry entry1{"app", "kernel0", random_string(512)};
+    miopen::KernelManifestEntry other_app{"other", "kernel2", random_string(512)};
+
+    miopen::KernDb empty_db("", false, "gfx906", 60);
+    CHECK(empty_db.LoadManifestUnsafe("app").empty());
+    CHECK(!empty_db.StoreManifestEntryUnsafe(entry0));
+
+    {
+        miopen::TempFile temp_file("tmp-kerndb");
+        miopen::KernDb clean_db(std::string(temp_file), false, "gfx906", 60);
+
+        CHECK(clean_db.LoadManifestUnsafe("app").empty());
+        CHECK(clean_db.StoreManifestEntryUnsafe(entry0));
+        CHECK(clean_db.StoreManifestEntryUnsafe(entry1));
+        CHECK(clean_db.StoreManifestEntryUnsafe(other_app));
+        // Duplicates do not change the order of the first use
+        CHECK(clean_db.StoreManifestEntryUnsafe(entry0));
+
+        const auto manifest = clean_db.LoadManifestUnsafe("app");
+        CHECK(manifest.size() == 2);
+        CHECK(manifest[0].kernel_name == entry0.kernel_name);
+        CHECK(manifest[0].kernel_args == entry0.kernel_args);
+        CHECK(manifest[1].kernel_name == entry1.kernel_name);
+        CHECK(manifest[1].kernel_args == entry1.kernel_args);
+    }
+}
 #endif
 
 void check_cache_file()
@@ -145,13 +251,36 @@ void check_cache_str()
     CHECK(p.filename().string() == name + ".o");
 }
 
+void check_normalize_compile_options()
+{
+    // Order of definitions does not matter, the last definition of a name wins
+    const auto options  = "-O3 -DMIOPEN_USE_FP32=1 -DMIOPEN_USE_FP16=0";
+    const auto permuted = "-DMIOPEN_USE_FP16=1 -O3 -DMIOPEN_USE_FP16=0 -DMIOPEN_USE_FP32=1";
+    CHECK(miopen::NormalizeCompileOptions(options) == miopen::NormalizeCompileOptions(permuted));
+    CHECK(miopen::NormalizeCompileOptions("-DMIOPEN_USE_FP32=1") !=
+          miopen::NormalizeCompileOptions("-DMIOPEN_USE_FP32=0"));
+
+    // Definitions the kernel source does not name may be used by its headers
+    CHECK(miopen::NormalizeCompileOptions("-DMIOPEN_USE_FP16=1 -DMIOPEN_USE_FP32=0") !=
+          miopen::NormalizeCompileOptions("-DMIOPEN_USE_FP16=0 -DMIOPEN_USE_FP32=1"));
+    CHECK(miopen::NormalizeCompileOptions("-Wa,-defsym,B=1 -Wa,-defsym,A=1") ==
+          "-Wa,-defsym,A=1 -Wa,-defsym,B=1");
+
+    // Other options keep their order
+    CHECK(miopen::NormalizeCompileOptions("-O3 -mllvm -foo -O2") == "-O3 -mllvm -foo -O2");
+}
+
 int main()
 {
     check_cache_file();
     check_cache_str();
+    check_normalize_compile_options();
 #if MIOPEN_ENABLE_SQLITE
     check_bz2_compress();
     check_bz2_decompress();
     check_kern_db();
+    check_kern_db_compile_time();
+    check_kern_db_manifest();
+    check_kern_db_eviction();
 #endif
 }
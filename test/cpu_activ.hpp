@@ -0,0 +1,174 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_ACTIV_HPP
+#define GUARD_CPU_ACTIV_HPP
+
+// Activation functions on the host, element by element in double. The formulas
+// are the ones of the library kernels: backward takes dy, x and y because some
+// derivatives are cheaper from the output.
+//
+// The array versions resolve the mode once, so their loops have no switch and
+// vectorize: the math comes from cpu_math and both sides of every condition
+// are computed and selected.
+
+#include <miopen/miopen.h>
+
+#include "cpu_math.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+namespace cpu_activ {
+
+// Softrelu derivative input is clamped there, exp overflows beyond.
+constexpr double bnll_threshold = 50;
+
+struct params
+{
+    miopenActivationMode_t mode;
+    double alpha;
+    double beta;
+    double gamma;
+};
+
+template <miopenActivationMode_t Mode>
+using mode_constant = std::integral_constant<miopenActivationMode_t, Mode>;
+
+// Calls f with the mode as a compile time constant.
+template <class F>
+void visit_mode(miopenActivationMode_t mode, F f)
+{
+    switch(mode)
+    {
+    case miopenActivationPASTHRU: f(mode_constant<miopenActivationPASTHRU>{}); return;
+    case miopenActivationLOGISTIC: f(mode_constant<miopenActivationLOGISTIC>{}); return;
+    case miopenActivationTANH: f(mode_constant<miopenActivationTANH>{}); return;
+    case miopenActivationRELU: f(mode_constant<miopenActivationRELU>{}); return;
+    case miopenActivationSOFTRELU: f(mode_constant<miopenActivationSOFTRELU>{}); return;
+    case miopenActivationABS: f(mode_constant<miopenActivationABS>{}); return;
+    case miopenActivationPOWER: f(mode_constant<miopenActivationPOWER>{}); return;
+    case miopenActivationCLIPPEDRELU: f(mode_constant<miopenActivationCLIPPEDRELU>{}); return;
+    case miopenActivationLEAKYRELU: f(mode_constant<miopenActivationLEAKYRELU>{}); return;
+    case miopenActivationELU: f(mode_constant<miopenActivationELU>{}); return;
+    }
+    f(mode_constant<miopenActivationPASTHRU>{});
+}
+
+template <miopenActivationMode_t Mode>
+double forward(mode_constant<Mode>, const params& p, double x)
+{
+    using cpu_math::select;
+    switch(Mode)
+    {
+    case miopenActivationPASTHRU: return x;
+    case miopenActivationLOGISTIC: return 1 / (1 + cpu_math::exp(-x));
+    case miopenActivationTANH: return p.beta * cpu_math::tanh(p.alpha * x);
+    case miopenActivationRELU: return select(x > 0, x, 0.0);
+    case miopenActivationSOFTRELU:
+        // max(x, 0) + log(1 + exp(-|x|)), the two branches of the kernel in one
+        return select(x > 0, x, 0.0) + cpu_math::log1p(cpu_math::exp(-std::abs(x)));
+    case miopenActivationABS: return std::abs(x);
+    case miopenActivationPOWER: {
+        const auto v = p.alpha + p.beta * x;
+        return select(v <= std::numeric_limits<double>::epsilon(), 0.0, cpu_math::pow(v, p.gamma));
+    }
+    case miopenActivationCLIPPEDRELU: return select(x > p.alpha, p.alpha, select(x > 0, x, 0.0));
+    case miopenActivationLEAKYRELU: return select(x > 0, x, x * p.alpha);
+    case miopenActivationELU: return select(x > 0, x, p.alpha * cpu_math::expm1(x));
+    }
+    return x;
+}
+
+template <miopenActivationMode_t Mode>
+double backward(mode_constant<Mode>, const params& p, double dy, double x, double y)
+{
+    using cpu_math::select;
+    switch(Mode)
+    {
+    case miopenActivationPASTHRU: return dy;
+    case miopenActivationLOGISTIC: return dy * y * (1 - y);
+    case miopenActivationTANH: return dy * p.alpha * (p.beta - y * y / p.beta);
+    case miopenActivationRELU: return select(x > 0, dy, 0.0);
+    case miopenActivationSOFTRELU: {
+        const auto e = cpu_math::exp(select(x > bnll_threshold, bnll_threshold, x));
+        return dy * e / (e + 1);
+    }
+    case miopenActivationABS: return dy * select(x > 0, 1.0, -1.0);
+    case miopenActivationPOWER: {
+        const auto v = p.alpha + p.beta * x;
+        return select(v <= std::numeric_limits<double>::epsilon(), 0.0, p.gamma * p.beta * y / v);
+    }
+    case miopenActivationCLIPPEDRELU: return select(x > 0, select(x <= p.alpha, dy, 0.0), 0.0);
+    case miopenActivationLEAKYRELU: return dy * select(x > 0, 1.0, p.alpha);
+    case miopenActivationELU: return dy * select(x > 0, 1.0, y + p.alpha);
+    }
+    return dy;
+}
+
+inline double forward(const params& p, double x)
+{
+    double y = x;
+    visit_mode(p.mode, [&](auto mode) { y = forward(mode, p, x); });
+    return y;
+}
+
+inline double backward(const params& p, double dy, double x, double y)
+{
+    double dx = dy;
+    visit_mode(p.mode, [&](auto mode) { dx = backward(mode, p, dy, x, y); });
+    return dx;
+}
+
+// y[i] = forward(p, x[i]) for i < n.
+template <class T, class U>
+void forward(const params& p, std::size_t n, const T* x, U* y)
+{
+    visit_mode(p.mode, [&](auto mode) {
+        for(std::size_t i = 0; i < n; ++i)
+            y[i] = static_cast<U>(forward(mode, p, static_cast<double>(x[i])));
+    });
+}
+
+// dx[i] = backward(p, dy[i], x[i], y[i]) for i < n.
+template <class T, class U>
+void backward(const params& p, std::size_t n, const T* dy, const T* x, const T* y, U* dx)
+{
+    visit_mode(p.mode, [&](auto mode) {
+        for(std::size_t i = 0; i < n; ++i)
+            dx[i] = static_cast<U>(backward(mode,
+                                            p,
+                                            static_cast<double>(dy[i]),
+                                            static_cast<double>(x[i]),
+                                            static_cast<double>(y[i])));
+    });
+}
+
+} // namespace cpu_activ
+
+#endif // GUARD_CPU_ACTIV_HPP
@@ -0,0 +1,255 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the host batch normalization against the two pass definitions.
+
+#include "test.hpp"
+#include "cpu_bn.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+static bool near(double x, double y) { return std::fabs(x - y) <= 1e-9 * (1 + std::fabs(y)); }
+
+static bool near(const std::vector<double>& x, const std::vector<double>& y)
+{
+    for(std::size_t i = 0; i < x.size(); ++i)
+        if(!near(x[i], y[i]))
+            return false;
+    return true;
+}
+
+struct problem
+{
+    cpu_bn::shape s;
+    std::vector<double> x;
+    std::vector<double> dy;
+    std::vector<double> scale;
+    std::vector<double> bias;
+
+    problem(cpu_bn::shape shape, std::size_t params, double offset) : s(shape)
+    {
+        std::mt19937 gen(static_cast<unsigned>(s.n * 131 + s.c * 17 + s.spatial));
+        std::uniform_real_distribution<double> dist(-1, 1);
+        x.resize(s.n * s.c * s.spatial);
+        dy.resize(x.size());
+        for(auto& v : x)
+            v = offset + dist(gen);
+        for(auto& v : dy)
+            v = dist(gen);
+        scale.resize(params);
+        bias.resize(params);
+        for(auto& v : scale)
+            v = dist(gen);
+        for(auto& v : bias)
+            v = dist(gen);
+    }
+
+    // Indices of the elements that share statistics with the parameter p.
+    std::vector<std::size_t> members(std::size_t p) const
+    {
+        std::vector<std::size_t> idx;
+        const bool spatial = scale.size() == s.c;
+        const auto ci      = spatial ? p : p / s.spatial;
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            for(std::size_t i = 0; i < s.spatial; ++i)
+            {
+                if(spatial || i == p % s.spatial)
+                    idx.push_back(s.row(ni, ci) + i);
+            }
+        }
+        return idx;
+    }
+};
+
+static void check(const problem& pb)
+{
+    const double eps    = 1e-5;
+    const double factor = 0.1;
+    const bool spatial  = pb.scale.size() == pb.s.c;
+    const auto params   = pb.scale.size();
+
+    std::vector<double> y(pb.x.size());
+    std::vector<double> dx(pb.x.size());
+    std::vector<double> mean(params);
+    std::vector<double> inv(params);
+    std::vector<double> run_mean(params, 0.5);
+    std::vector<double> run_var(params, 2);
+    std::vector<double> dscale(params);
+    std::vector<double> dbias(params);
+    if(spatial)
+    {
+        cpu_bn::spatial_forward_train(pb.s,
+                                      pb.x.data(),
+                                      y.data(),
+                                      pb.scale.data(),
+                                      pb.bias.data(),
+                                      eps,
+                                      factor,
+                                      mean.data(),
+                                      inv.data(),
+                                      run_mean.data(),
+                                      run_var.data());
+        cpu_bn::spatial_backward<double, double, double, double, double>(pb.s,
+                                                                         pb.x.data(),
+                                                                         pb.dy.data(),
+                                                                         dx.data(),
+                                                                         pb.scale.data(),
+                                                                         dscale.data(),
+                                                                         dbias.data(),
+                                                                         eps,
+                                                                         nullptr,
+                                                                         nullptr);
+    }
+    else
+    {
+        cpu_bn::per_activation_forward_train(pb.s,
+                                             pb.x.data(),
+                                             y.data(),
+                                             pb.scale.data(),
+                                             pb.bias.data(),
+                                             eps,
+                                             factor,
+                                             mean.data(),
+                                             inv.data(),
+                                             run_mean.data(),
+                                             run_var.data());
+        cpu_bn::per_activation_backward<double, double, double, double, double>(pb.s,
+                                                                                pb.x.data(),
+                                                                                pb.dy.data(),
+                                                                                dx.data(),
+                                                                                pb.scale.data(),
+                                                                                dscale.data(),
+                                                                                dbias.data(),
+                                                                                eps,
+                                                                                nullptr,
+                                                                                nullptr);
+    }
+
+    std::vector<double> y_ref(pb.x.size());
+    std::vector<double> dx_ref(pb.x.size());
+    for(std::size_t p = 0; p < params; ++p)
+    {
+        const auto idx = pb.members(p);
+        const auto m   = static_cast<double>(idx.size());
+        double sum     = 0;
+        for(auto i : idx)
+            sum += pb.x[i];
+        const auto mu = sum / m;
+        double sq     = 0;
+        for(auto i : idx)
+            sq += (pb.x[i] - mu) * (pb.x[i] - mu);
+        const auto var = sq / m;
+        const auto iv  = 1 / std::sqrt(var + eps);
+        EXPECT(near(mean[p], mu));
+        EXPECT(near(inv[p], iv));
+        EXPECT(near(run_mean[p], 0.5 * (1 - factor) + mu * factor));
+        const auto unbiased = m > 1 ? var * m / (m - 1) : var;
+        EXPECT(near(run_var[p], 2 * (1 - factor) + unbiased * factor));
+
+        double db = 0;
+        double ds = 0;
+        for(auto i : idx)
+        {
+            y_ref[i] = pb.scale[p] * (pb.x[i] - mu) * iv + pb.bias[p];
+            db += pb.dy[i];
+            ds += (pb.x[i] - mu) * iv * pb.dy[i];
+        }
+        EXPECT(near(dbias[p], db));
+        EXPECT(near(dscale[p], ds));
+        for(auto i : idx)
+            dx_ref[i] = pb.scale[p] * iv / m * (m * pb.dy[i] - db - (pb.x[i] - mu) * iv * ds);
+    }
+    EXPECT(near(y, y_ref));
+    EXPECT(near(dx, dx_ref));
+
+    // Inference with the batch statistics matches training, and with the saved
+    // statistics the backward pass matches recomputing them.
+    std::vector<double> y_infer(pb.x.size());
+    std::vector<double> dx_saved(pb.x.size());
+    if(spatial)
+    {
+        cpu_bn::spatial_forward_infer<double, double, double, double>(pb.s,
+                                                                      pb.x.data(),
+                                                                      y_infer.data(),
+                                                                      pb.scale.data(),
+                                                                      pb.bias.data(),
+                                                                      eps,
+                                                                      nullptr,
+                                                                      nullptr);
+        cpu_bn::spatial_backward(pb.s,
+                                 pb.x.data(),
+                                 pb.dy.data(),
+                                 dx_saved.data(),
+                                 pb.scale.data(),
+                                 dscale.data(),
+                                 dbias.data(),
+                                 eps,
+                                 mean.data(),
+                                 inv.data());
+    }
+    else
+    {
+        cpu_bn::per_activation_forward_infer<double, double, double, double>(pb.s,
+                                                                             pb.x.data(),
+                                                                             y_infer.data(),
+                                                                             pb.scale.data(),
+                                                                             pb.bias.data(),
+                                                                             eps,
+                                                                             nullptr,
+                                                                             nullptr);
+        cpu_bn::per_activation_backward(pb.s,
+                                        pb.x.data(),
+                                        pb.dy.data(),
+                                        dx_saved.data(),
+                                        pb.scale.data(),
+                                        dscale.data(),
+                                        dbias.data(),
+                                        eps,
+                                        mean.data(),
+                                        inv.data());
+    }
+    EXPECT(near(y_infer, y));
+    EXPECT(near(dx_saved, dx));
+}
+
+int main()
+{
+    // Rows longer than a reduction block, 3D spatial sizes, a single image
+    const std::vector<cpu_bn::shape> shapes = {
+        {4, 3, 37 * 41}, {2, 5, 3 * 7 * 11}, {1, 2, 9}, {16, 8, 1}};
+    for(const auto& s : shapes)
+    {
+        check(problem{s, s.c, 0});
+        check(problem{s, s.c * s.spatial, 0});
+        // Large mean relative to the spread
+        check(problem{s, s.c, 1e4});
+        check(problem{s, s.c * s.spatial, 1e4});
+    }
+}
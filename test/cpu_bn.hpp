@@ -0,0 +1,448 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_BN_HPP
+#define GUARD_CPU_BN_HPP
+
+// Batch normalization on the host, for packed N x C x <spatial> data. Channels
+// are processed in parallel. The statistics are gathered in one pass over the
+// data: each block of a row is reduced while it is in cache, and the blocks are
+// merged with the pairwise update of Chan et al. (per activation, Welford's
+// update over the batch). All the arithmetic is done in double. Optional
+// outputs and inputs may be null.
+
+#include <miopen/par_for.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cpu_bn {
+
+// Elements reduced at once before being merged into the running moments.
+constexpr std::size_t block = 1024;
+
+struct shape
+{
+    std::size_t n;
+    std::size_t c;
+    std::size_t spatial;
+
+    std::size_t row(std::size_t ni, std::size_t ci) const { return (ni * c + ci) * spatial; }
+};
+
+template <class F>
+void par_for(std::size_t n, F f)
+{
+    miopen::par_for_dynamic(n, miopen::max_threads{std::thread::hardware_concurrency()}, f);
+}
+
+struct moments
+{
+    double count = 0;
+    double mean  = 0;
+    // Sum of the squared deviations from the mean
+    double m2 = 0;
+
+    void merge(const moments& other)
+    {
+        if(other.count == 0)
+            return;
+        const auto total = count + other.count;
+        const auto delta = other.mean - mean;
+        mean += delta * (other.count / total);
+        m2 += other.m2 + delta * delta * (count * other.count / total);
+        count = total;
+    }
+
+    double variance() const { return count == 0 ? 0 : m2 / count; }
+};
+
+template <class T>
+moments block_moments(const T* x, std::size_t len)
+{
+    moments m;
+    m.count    = static_cast<double>(len);
+    double sum = 0;
+    for(std::size_t i = 0; i < len; ++i)
+        sum += static_cast<double>(x[i]);
+    m.mean = sum / m.count;
+    for(std::size_t i = 0; i < len; ++i)
+    {
+        const auto d = static_cast<double>(x[i]) - m.mean;
+        m.m2 += d * d;
+    }
+    return m;
+}
+
+template <class T>
+moments channel_moments(const shape& s, const T* x, std::size_t ci)
+{
+    moments m;
+    for(std::size_t ni = 0; ni < s.n; ++ni)
+    {
+        const auto* row = x + s.row(ni, ci);
+        for(std::size_t i = 0; i < s.spatial; i += block)
+            m.merge(block_moments(row + i, std::min(block, s.spatial - i)));
+    }
+    return m;
+}
+
+// Welford's update over the batch, vectorized along the row of one channel.
+template <class T>
+void activation_moments(const shape& s,
+                        const T* x,
+                        std::size_t ci,
+                        std::vector<double>& mean,
+                        std::vector<double>& variance)
+{
+    mean.assign(s.spatial, 0);
+    variance.assign(s.spatial, 0);
+    for(std::size_t ni = 0; ni < s.n; ++ni)
+    {
+        const auto* row = x + s.row(ni, ci);
+        const auto inv  = 1.0 / static_cast<double>(ni + 1);
+        for(std::size_t i = 0; i < s.spatial; ++i)
+        {
+            const auto v = static_cast<double>(row[i]);
+            const auto d = v - mean[i];
+            mean[i] += d * inv;
+            variance[i] += d * (v - mean[i]);
+        }
+    }
+    for(auto& v : variance)
+        v /= static_cast<double>(s.n);
+}
+
+inline double inv_std(double variance, double epsilon)
+{
+    return 1.0 / std::sqrt(variance + epsilon);
+}
+
+// The unbiased estimate of the variance used by the running averages.
+inline double unbiased(double variance, double count)
+{
+    return count > 1 ? count / (count - 1) * variance : variance;
+}
+
+template <class Tstat>
+void update_running(
+    Tstat* running_mean, Tstat* running_var, std::size_t i, double factor, double mean, double var)
+{
+    if(running_mean != nullptr)
+        running_mean[i] =
+            static_cast<Tstat>(static_cast<double>(running_mean[i]) * (1 - factor) + mean * factor);
+    if(running_var != nullptr)
+        running_var[i] =
+            static_cast<Tstat>(static_cast<double>(running_var[i]) * (1 - factor) + var * factor);
+}
+
+// y = (x - mean) * a + b over len elements
+template <class Tx, class Ty>
+void normalize(const Tx* x, Ty* y, std::size_t len, double mean, double a, double b)
+{
+    for(std::size_t i = 0; i < len; ++i)
+        y[i] = static_cast<Ty>((static_cast<double>(x[i]) - mean) * a + b);
+}
+
+template <class Tx, class Ty, class Tscale, class Tstat>
+void spatial_forward_train(const shape& s,
+                           const Tx* x,
+                           Ty* y,
+                           const Tscale* scale,
+                           const Tscale* bias,
+                           double epsilon,
+                           double exp_avg_factor,
+                           Tstat* save_mean,
+                           Tstat* save_inv_var,
+                           Tstat* running_mean,
+                           Tstat* running_var)
+{
+    par_for(s.c, [&](std::size_t ci) {
+        const auto m   = channel_moments(s, x, ci);
+        const auto inv = inv_std(m.variance(), epsilon);
+        if(save_mean != nullptr)
+            save_mean[ci] = static_cast<Tstat>(m.mean);
+        if(save_inv_var != nullptr)
+            save_inv_var[ci] = static_cast<Tstat>(inv);
+        update_running(running_mean,
+                       running_var,
+                       ci,
+                       exp_avg_factor,
+                       m.mean,
+                       unbiased(m.variance(), m.count));
+
+        const auto a = static_cast<double>(scale[ci]) * inv;
+        const auto b = static_cast<double>(bias[ci]);
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+            normalize(x + s.row(ni, ci), y + s.row(ni, ci), s.spatial, m.mean, a, b);
+    });
+}
+
+// Uses the estimated mean and variance when given, the statistics of the batch otherwise.
+template <class Tx, class Ty, class Tscale, class Tstat>
+void spatial_forward_infer(const shape& s,
+                           const Tx* x,
+                           Ty* y,
+                           const Tscale* scale,
+                           const Tscale* bias,
+                           double epsilon,
+                           const Tstat* estimated_mean,
+                           const Tstat* estimated_var)
+{
+    par_for(s.c, [&](std::size_t ci) {
+        double mean = 0;
+        double var  = 0;
+        if(estimated_mean != nullptr && estimated_var != nullptr)
+        {
+            mean = static_cast<double>(estimated_mean[ci]);
+            var  = static_cast<double>(estimated_var[ci]);
+        }
+        else
+        {
+            const auto m = channel_moments(s, x, ci);
+            mean         = m.mean;
+            var          = m.variance();
+        }
+        const auto a = static_cast<double>(scale[ci]) * inv_std(var, epsilon);
+        const auto b = static_cast<double>(bias[ci]);
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+            normalize(x + s.row(ni, ci), y + s.row(ni, ci), s.spatial, mean, a, b);
+    });
+}
+
+// Uses the saved mean and inverse standard deviation when given, recomputes them
+// from x otherwise.
+template <class Tx, class Tdx, class Tscale, class Tgrad, class Tstat>
+void spatial_backward(const shape& s,
+                      const Tx* x,
+                      const Tx* dy,
+                      Tdx* dx,
+                      const Tscale* scale,
+                      Tgrad* dscale,
+                      Tgrad* dbias,
+                      double epsilon,
+                      const Tstat* saved_mean,
+                      const Tstat* saved_inv_var)
+{
+    const auto count = static_cast<double>(s.n * s.spatial);
+    par_for(s.c, [&](std::size_t ci) {
+        double mean = 0;
+        double inv  = 0;
+        if(saved_mean != nullptr && saved_inv_var != nullptr)
+        {
+            mean = static_cast<double>(saved_mean[ci]);
+            inv  = static_cast<double>(saved_inv_var[ci]);
+        }
+        else
+        {
+            const auto m = channel_moments(s, x, ci);
+            mean         = m.mean;
+            inv          = inv_std(m.variance(), epsilon);
+        }
+
+        double sum_dy      = 0;
+        double sum_dy_xhat = 0;
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr  = x + s.row(ni, ci);
+            const auto* dyr = dy + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+            {
+                const auto d = static_cast<double>(dyr[i]);
+                sum_dy += d;
+                sum_dy_xhat += (static_cast<double>(xr[i]) - mean) * inv * d;
+            }
+        }
+        dbias[ci]  = static_cast<Tgrad>(sum_dy);
+        dscale[ci] = static_cast<Tgrad>(sum_dy_xhat);
+
+        const auto a = static_cast<double>(scale[ci]) * inv / count;
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr  = x + s.row(ni, ci);
+            const auto* dyr = dy + s.row(ni, ci);
+            auto* dxr       = dx + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+            {
+                const auto xhat = (static_cast<double>(xr[i]) - mean) * inv;
+                dxr[i] = static_cast<Tdx>(
+                    a * (count * static_cast<double>(dyr[i]) - sum_dy - xhat * sum_dy_xhat));
+            }
+        }
+    });
+}
+
+template <class Tx, class Ty, class Tscale, class Tstat>
+void per_activation_forward_train(const shape& s,
+                                  const Tx* x,
+                                  Ty* y,
+                                  const Tscale* scale,
+                                  const Tscale* bias,
+                                  double epsilon,
+                                  double exp_avg_factor,
+                                  Tstat* save_mean,
+                                  Tstat* save_inv_var,
+                                  Tstat* running_mean,
+                                  Tstat* running_var)
+{
+    par_for(s.c, [&](std::size_t ci) {
+        std::vector<double> mean;
+        std::vector<double> var;
+        activation_moments(s, x, ci, mean, var);
+
+        std::vector<double> a(s.spatial);
+        for(std::size_t i = 0; i < s.spatial; ++i)
+        {
+            const auto j   = ci * s.spatial + i;
+            const auto inv = inv_std(var[i], epsilon);
+            if(save_mean != nullptr)
+                save_mean[j] = static_cast<Tstat>(mean[i]);
+            if(save_inv_var != nullptr)
+                save_inv_var[j] = static_cast<Tstat>(inv);
+            update_running(running_mean,
+                           running_var,
+                           j,
+                           exp_avg_factor,
+                           mean[i],
+                           unbiased(var[i], static_cast<double>(s.n)));
+            a[i] = static_cast<double>(scale[j]) * inv;
+        }
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr = x + s.row(ni, ci);
+            auto* yr       = y + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+                yr[i] = static_cast<Ty>((static_cast<double>(xr[i]) - mean[i]) * a[i] +
+                                        static_cast<double>(bias[ci * s.spatial + i]));
+        }
+    });
+}
+
+template <class Tx, class Ty, class Tscale, class Tstat>
+void per_activation_forward_infer(const shape& s,
+                                  const Tx* x,
+                                  Ty* y,
+                                  const Tscale* scale,
+                                  const Tscale* bias,
+                                  double epsilon,
+                                  const Tstat* estimated_mean,
+                                  const Tstat* estimated_var)
+{
+    par_for(s.c, [&](std::size_t ci) {
+        std::vector<double> mean;
+        std::vector<double> var;
+        if(estimated_mean != nullptr && estimated_var != nullptr)
+        {
+            mean.assign(estimated_mean + ci * s.spatial, estimated_mean + (ci + 1) * s.spatial);
+            var.assign(estimated_var + ci * s.spatial, estimated_var + (ci + 1) * s.spatial);
+        }
+        else
+        {
+            activation_moments(s, x, ci, mean, var);
+        }
+
+        std::vector<double> a(s.spatial);
+        for(std::size_t i = 0; i < s.spatial; ++i)
+            a[i] = static_cast<double>(scale[ci * s.spatial + i]) * inv_std(var[i], epsilon);
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr = x + s.row(ni, ci);
+            auto* yr       = y + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+                yr[i] = static_cast<Ty>((static_cast<double>(xr[i]) - mean[i]) * a[i] +
+                                        static_cast<double>(bias[ci * s.spatial + i]));
+        }
+    });
+}
+
+template <class Tx, class Tdx, class Tscale, class Tgrad, class Tstat>
+void per_activation_backward(const shape& s,
+                             const Tx* x,
+                             const Tx* dy,
+                             Tdx* dx,
+                             const Tscale* scale,
+                             Tgrad* dscale,
+                             Tgrad* dbias,
+                             double epsilon,
+                             const Tstat* saved_mean,
+                             const Tstat* saved_inv_var)
+{
+    const auto count = static_cast<double>(s.n);
+    par_for(s.c, [&](std::size_t ci) {
+        std::vector<double> mean;
+        std::vector<double> inv;
+        if(saved_mean != nullptr && saved_inv_var != nullptr)
+        {
+            mean.assign(saved_mean + ci * s.spatial, saved_mean + (ci + 1) * s.spatial);
+            inv.assign(saved_inv_var + ci * s.spatial, saved_inv_var + (ci + 1) * s.spatial);
+        }
+        else
+        {
+            activation_moments(s, x, ci, mean, inv);
+            for(auto& v : inv)
+                v = inv_std(v, epsilon);
+        }
+
+        std::vector<double> sum_dy(s.spatial);
+        std::vector<double> sum_dy_xhat(s.spatial);
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr  = x + s.row(ni, ci);
+            const auto* dyr = dy + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+            {
+                const auto d = static_cast<double>(dyr[i]);
+                sum_dy[i] += d;
+                sum_dy_xhat[i] += (static_cast<double>(xr[i]) - mean[i]) * inv[i] * d;
+            }
+        }
+        for(std::size_t i = 0; i < s.spatial; ++i)
+        {
+            dbias[ci * s.spatial + i]  = static_cast<Tgrad>(sum_dy[i]);
+            dscale[ci * s.spatial + i] = static_cast<Tgrad>(sum_dy_xhat[i]);
+        }
+
+        for(std::size_t ni = 0; ni < s.n; ++ni)
+        {
+            const auto* xr  = x + s.row(ni, ci);
+            const auto* dyr = dy + s.row(ni, ci);
+            auto* dxr       = dx + s.row(ni, ci);
+            for(std::size_t i = 0; i < s.spatial; ++i)
+            {
+                const auto xhat = (static_cast<double>(xr[i]) - mean[i]) * inv[i];
+                const auto a    = static_cast<double>(scale[ci * s.spatial + i]) * inv[i] / count;
+                dxr[i]          = static_cast<Tdx>(
+                    a * (count * static_cast<double>(dyr[i]) - sum_dy[i] - xhat * sum_dy_xhat[i]));
+            }
+        }
+    });
+}
+
+} // namespace cpu_bn
+
+#endif
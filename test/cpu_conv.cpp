@@ -0,0 +1,146 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the implicit GEMM host convolution against the direct definitions.
+// Small integer data makes both exact, so the results must match bit to bit.
+
+#include "test.hpp"
+#include "serialize.hpp"
+#include "cpu_conv.hpp"
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+struct small_integer
+{
+    std::size_t seed = 0;
+
+    template <class... Ts>
+    double operator()(Ts... xs) const
+    {
+        std::array<std::size_t, sizeof...(Ts)> ids = {{static_cast<std::size_t>(xs)...}};
+        const auto dot = std::accumulate(
+            ids.begin(), ids.end(), seed, [](auto acc, auto x) { return acc * 31 + x; });
+        return static_cast<double>(dot % 7) - 3;
+    }
+};
+
+struct conv_case
+{
+    std::vector<std::size_t> in;
+    std::vector<std::size_t> wei;
+    std::vector<int> pads;
+    std::vector<int> strides;
+    std::vector<int> dilations;
+    std::size_t groups;
+};
+
+static std::vector<std::size_t> out_lengths(const conv_case& cc)
+{
+    std::vector<std::size_t> out = {cc.in[0], cc.wei[0]};
+    for(std::size_t i = 0; i < cc.pads.size(); ++i)
+    {
+        const auto filter = (cc.wei[i + 2] - 1) * cc.dilations[i] + 1;
+        out.push_back((cc.in[i + 2] + 2 * cc.pads[i] - filter) / cc.strides[i] + 1);
+    }
+    return out;
+}
+
+// Same lengths, channels innermost.
+static tensor<float> make_channels_last(const std::vector<std::size_t>& lens)
+{
+    std::vector<std::size_t> strides(lens.size());
+    std::size_t stride = lens[1];
+    for(auto i = lens.size() - 1; i >= 2; --i)
+    {
+        strides[i] = stride;
+        stride *= lens[i];
+    }
+    strides[1] = 1;
+    strides[0] = stride;
+    return tensor<float>{lens, strides};
+}
+
+template <std::size_t ConvDim>
+void check_case(const conv_case& cc, bool channels_last)
+{
+    const auto out_lens = out_lengths(cc);
+    auto in  = channels_last ? make_channels_last(cc.in) : tensor<float>{cc.in};
+    auto wei = channels_last ? make_channels_last(cc.wei) : tensor<float>{cc.wei};
+    auto out = channels_last ? make_channels_last(out_lens) : tensor<float>{out_lens};
+    in.generate(small_integer{1});
+    wei.generate(small_integer{2});
+    out.generate(small_integer{3});
+
+    auto out_ref = out;
+    auto out_res = out;
+    cpu_convolution_forward_impl<ConvDim>(
+        in, wei, out_ref, cc.pads, cc.strides, cc.dilations, cc.groups);
+    cpu_conv::forward<ConvDim>(in, wei, out_res, cc.pads, cc.strides, cc.dilations, cc.groups);
+    EXPECT(out_ref.data == out_res.data);
+
+    auto in_ref = in;
+    auto in_res = in;
+    cpu_convolution_backward_data_impl<ConvDim>(
+        in_ref, wei, out, cc.pads, cc.strides, cc.dilations, cc.groups);
+    cpu_conv::backward_data<ConvDim>(
+        in_res, wei, out, cc.pads, cc.strides, cc.dilations, cc.groups);
+    EXPECT(in_ref.data == in_res.data);
+
+    auto wei_ref = wei;
+    auto wei_res = wei;
+    cpu_convolution_backward_weight_impl<ConvDim>(
+        in, wei_ref, out, cc.pads, cc.strides, cc.dilations, cc.groups);
+    cpu_conv::backward_weight<ConvDim>(
+        in, wei_res, out, cc.pads, cc.strides, cc.dilations, cc.groups);
+    EXPECT(wei_ref.data == wei_res.data);
+
+    // Single precision accumulation is exact on this data too.
+    cpu_conv::forward<ConvDim, float>(
+        in, wei, out_res, cc.pads, cc.strides, cc.dilations, cc.groups);
+    EXPECT(out_ref.data == out_res.data);
+    cpu_convolution_forward<float>(
+        ConvDim, in, wei, out_res, cc.pads, cc.strides, cc.dilations, cc.groups);
+    EXPECT(out_ref.data == out_res.data);
+}
+
+int main()
+{
+    // 1x1, more channels and output points than a tile
+    check_case<2>({{2, 20, 9, 9}, {40, 20, 1, 1}, {0, 0}, {1, 1}, {1, 1}, 1}, false);
+    // Padding, stride and dilation
+    check_case<2>({{3, 5, 11, 13}, {7, 5, 3, 3}, {1, 2}, {2, 1}, {1, 2}, 1}, false);
+    check_case<2>({{3, 5, 11, 13}, {7, 5, 3, 3}, {1, 2}, {2, 1}, {1, 2}, 1}, true);
+    // Groups and depthwise
+    check_case<2>({{2, 12, 8, 8}, {18, 4, 3, 3}, {1, 1}, {1, 1}, {1, 1}, 3}, false);
+    check_case<2>({{2, 10, 7, 7}, {10, 1, 3, 3}, {1, 1}, {2, 2}, {1, 1}, 10}, true);
+    // Stride larger than the filter
+    check_case<2>({{1, 3, 17, 17}, {4, 3, 2, 2}, {0, 0}, {3, 3}, {1, 1}, 1}, false);
+    check_case<1>({{2, 6, 31}, {4, 3, 5}, {2}, {2}, {1}, 2}, false);
+    check_case<3>({{1, 4, 6, 7, 8}, {6, 4, 3, 3, 3}, {1, 1, 1}, {1, 2, 1}, {1, 1, 2}, 1}, false);
+    check_case<3>({{2, 3, 5, 5, 5}, {2, 3, 2, 3, 1}, {0, 1, 0}, {2, 1, 1}, {1, 1, 1}, 1}, true);
+}
@@ -36,6 +36,7 @@
 #include <miopen/tensor.hpp>
 #include <utility>
 
+#include "cpu_conv_blocked.hpp"
 #include "tensor_holder.hpp"
 #include <miopen/stringutils.hpp>
 #include <miopen/functional.hpp>
@@ -294,7 +295,11 @@ void cpu_convolution_backward_weight_impl(const tensor<Tin>& in,
     });
 }
 
-template <typename Tin, typename Twei, typename Tout, typename Range>
+// The *_impl functions above are the straightforward definitions of the convolutions.
+// The entry points below use the much faster implicit GEMM engine from
+// cpu_conv_blocked.hpp, which accumulates in Tacc, double by default.
+
+template <class Tacc = double, typename Tin, typename Twei, typename Tout, typename Range>
 void cpu_convolution_forward(std::size_t spatial_dim,
                              const tensor<Tin>& in,
                              const tensor<Twei>& wei,
@@ -308,22 +313,22 @@ void cpu_convolution_forward(std::size_t spatial_dim,
     {
     case 1:
     {
-        cpu_convolution_forward_impl<1>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::forward<1, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 2:
     {
-        cpu_convolution_forward_impl<2>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::forward<2, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 3:
     {
-        cpu_convolution_forward_impl<3>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::forward<3, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 4:
     {
-        cpu_convolution_forward_impl<4>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::forward<4, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     default: { MIOPEN_THROW("not belong to any case");
@@ -331,7 +336,7 @@ void cpu_convolution_forward(std::size_t spatial_dim,
     }
 }
 
-template <typename Tin, typename Twei, typename Tout, typename Range>
+template <class Tacc = double, typename Tin, typename Twei, typename Tout, typename Range>
 void cpu_convolution_backward_data(std::size_t spatial_dim,
                                    tensor<Tin>& in,
                                    const tensor<Twei>& wei,
@@ -345,22 +350,22 @@ void cpu_convolution_backward_data(std::size_t spatial_dim,
     {
     case 1:
     {
-        cpu_convolution_backward_data_impl<1>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_data<1, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 2:
     {
-        cpu_convolution_backward_data_impl<2>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_data<2, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 3:
     {
-        cpu_convolution_backward_data_impl<3>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_data<3, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 4:
     {
-        cpu_convolution_backward_data_impl<4>(in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_data<4, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     default: { MIOPEN_THROW("not belong to any case");
@@ -368,7 +373,7 @@ void cpu_convolution_backward_data(std::size_t spatial_dim,
     }
 }
 
-template <typename Tin, typename Twei, typename Tout, typename Range>
+template <class Tacc = double, typename Tin, typename Twei, typename Tout, typename Range>
 void cpu_convolution_backward_weight(std::size_t spatial_dim,
                                      const tensor<Tin>& in,
                                      tensor<Twei>& wei,
@@ -382,26 +387,22 @@ void cpu_convolution_backward_weight(std::size_t spatial_dim,
     {
     case 1:
     {
-        cpu_convolution_backward_weight_impl<1>(
-            in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_weight<1, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 2:
     {
-        cpu_convolution_backward_weight_impl<2>(
-            in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_weight<2, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 3:
     {
-        cpu_convolution_backward_weight_impl<3>(
-            in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_weight<3, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     case 4:
     {
-        cpu_convolution_backward_weight_impl<4>(
-            in, wei, out, pads, strides, dilations, group_count);
+        cpu_conv::backward_weight<4, Tacc>(in, wei, out, pads, strides, dilations, group_count);
         break;
     }
     default: { MIOPEN_THROW("not belong to any case");
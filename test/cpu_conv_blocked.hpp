@@ -0,0 +1,470 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_CONV_BLOCKED_HPP
+#define GUARD_CPU_CONV_BLOCKED_HPP
+
+// Implicit GEMM convolution on the host. The filter taps are resolved into input
+// offsets per tile of output points, and the GEMMs run over these tiles so that the
+// inner loops are contiguous and vectorizable. The tensors are read and written in
+// place through their strides: only the tiles of a work item are converted to the
+// accumulation type, so any layout works without copies of the whole tensors.
+
+#include <miopen/par_for.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "tensor_holder.hpp"
+
+namespace cpu_conv {
+
+// Output points per tile: the innermost loops run over them.
+constexpr std::size_t p_tile = 64;
+// Rows of the im2col matrix (input channel x filter tap) kept in cache at once.
+constexpr std::size_t cr_tile = 256;
+constexpr std::size_t k_tile  = 16;
+constexpr std::size_t c_tile  = 8;
+
+template <class F>
+void par_for(std::size_t n, F f)
+{
+    miopen::par_for_dynamic(n, miopen::max_threads{std::thread::hardware_concurrency()}, f);
+}
+
+template <std::size_t ConvDim>
+struct problem
+{
+    std::size_t n      = 0;
+    std::size_t groups = 0;
+    // Per group
+    std::size_t c = 0;
+    std::size_t k = 0;
+
+    std::size_t in_spatial  = 1;
+    std::size_t wei_spatial = 1;
+    std::size_t out_spatial = 1;
+
+    std::array<std::ptrdiff_t, ConvDim> in_len{};
+    std::array<std::size_t, ConvDim> wei_len{};
+    std::array<std::size_t, ConvDim> out_len{};
+    // Spatial strides of a packed input channel and of the input tensor.
+    std::array<std::ptrdiff_t, ConvDim> in_stride{};
+    std::array<std::ptrdiff_t, ConvDim> in_tensor_stride{};
+    std::array<std::size_t, ConvDim> out_tensor_stride{};
+    std::array<std::ptrdiff_t, ConvDim> pad{};
+    std::array<std::ptrdiff_t, ConvDim> stride{};
+    std::array<std::ptrdiff_t, ConvDim> dilation{};
+
+    std::size_t in_nstride  = 0;
+    std::size_t in_cstride  = 0;
+    std::size_t wei_kstride = 0;
+    std::size_t wei_cstride = 0;
+    std::size_t out_nstride = 0;
+    std::size_t out_cstride = 0;
+    // Offset of each filter tap within a channel of the filter tensor.
+    std::vector<std::size_t> wei_offsets;
+
+    template <class Tin, class Twei, class Tout, class Range>
+    problem(const tensor<Tin>& in,
+            const tensor<Twei>& wei,
+            const tensor<Tout>& out,
+            const Range& pads,
+            const Range& strides,
+            const Range& dilations,
+            std::size_t group_count)
+        : n(in.desc.GetLengths()[0]),
+          groups(group_count),
+          c(wei.desc.GetLengths()[1]),
+          k(wei.desc.GetLengths()[0] / group_count),
+          in_nstride(in.desc.GetStrides()[0]),
+          in_cstride(in.desc.GetStrides()[1]),
+          wei_kstride(wei.desc.GetStrides()[0]),
+          wei_cstride(wei.desc.GetStrides()[1]),
+          out_nstride(out.desc.GetStrides()[0]),
+          out_cstride(out.desc.GetStrides()[1])
+    {
+        for(std::size_t i = 0; i < ConvDim; ++i)
+        {
+            in_len[i]            = in.desc.GetLengths()[i + 2];
+            wei_len[i]           = wei.desc.GetLengths()[i + 2];
+            out_len[i]           = out.desc.GetLengths()[i + 2];
+            in_tensor_stride[i]  = in.desc.GetStrides()[i + 2];
+            out_tensor_stride[i] = out.desc.GetStrides()[i + 2];
+            pad[i]               = static_cast<std::ptrdiff_t>(pads[i]);
+            stride[i]            = static_cast<std::ptrdiff_t>(strides[i]);
+            dilation[i]          = static_cast<std::ptrdiff_t>(dilations[i]);
+            in_spatial *= in_len[i];
+            wei_spatial *= wei_len[i];
+            out_spatial *= out_len[i];
+        }
+        std::ptrdiff_t s = 1;
+        for(std::size_t i = ConvDim; i-- > 0; s *= in_len[i])
+            in_stride[i] = s;
+
+        wei_offsets.resize(wei_spatial);
+        for(std::size_t r = 0; r < wei_spatial; ++r)
+        {
+            for(std::size_t i = ConvDim, rest = r; i-- > 0; rest /= wei_len[i])
+                wei_offsets[r] += (rest % wei_len[i]) * wei.desc.GetStrides()[i + 2];
+        }
+    }
+
+    std::size_t in_channel(std::size_t ni, std::size_t ci) const
+    {
+        return ni * in_nstride + ci * in_cstride;
+    }
+    std::size_t wei_channel(std::size_t ki, std::size_t ci) const
+    {
+        return ki * wei_kstride + ci * wei_cstride;
+    }
+    std::size_t out_channel(std::size_t ni, std::size_t ki) const
+    {
+        return ni * out_nstride + ki * out_cstride;
+    }
+
+    // Offset of the input point s within a channel of the input tensor.
+    std::size_t in_offset(std::size_t s) const
+    {
+        std::size_t offset = 0;
+        for(std::size_t i = ConvDim, rest = s; i-- > 0; rest /= in_len[i])
+            offset += (rest % in_len[i]) * in_tensor_stride[i];
+        return offset;
+    }
+
+    // Resolves the filter taps for the output points p0 to p0 + pt: taps[r * p_tile + p]
+    // is the offset of the input point of the tap r within its channel, for the spatial
+    // strides of the channel, or -1 if it is in the padding.
+    void tile_taps(std::size_t p0,
+                   std::size_t pt,
+                   const std::array<std::ptrdiff_t, ConvDim>& strides,
+                   std::vector<std::ptrdiff_t>& taps) const
+    {
+        // Input coordinates of the output points for the first tap.
+        std::array<std::vector<std::ptrdiff_t>, ConvDim> origin;
+        for(auto& o : origin)
+            o.resize(pt);
+        for(std::size_t p = 0; p < pt; ++p)
+        {
+            for(std::size_t i = ConvDim, rest = p0 + p; i-- > 0; rest /= out_len[i])
+                origin[i][p] = static_cast<std::ptrdiff_t>(rest % out_len[i]) * stride[i] - pad[i];
+        }
+
+        taps.resize(wei_spatial * p_tile);
+        for(std::size_t r = 0; r < wei_spatial; ++r)
+        {
+            auto* dst = &taps[r * p_tile];
+            std::fill_n(dst, pt, 0);
+            for(std::size_t i = ConvDim, rest = r; i-- > 0; rest /= wei_len[i])
+            {
+                const auto shift = static_cast<std::ptrdiff_t>(rest % wei_len[i]) * dilation[i];
+                for(std::size_t p = 0; p < pt; ++p)
+                {
+                    const auto x = origin[i][p] + shift;
+                    if(dst[p] < 0 || x < 0 || x >= in_len[i])
+                        dst[p] = -1;
+                    else
+                        dst[p] += x * strides[i];
+                }
+            }
+        }
+    }
+
+    // Offsets of the output points p0 to p0 + pt within a channel of the output tensor.
+    void tile_outputs(std::size_t p0, std::size_t pt, std::vector<std::size_t>& outs) const
+    {
+        outs.assign(pt, 0);
+        for(std::size_t p = 0; p < pt; ++p)
+        {
+            for(std::size_t i = ConvDim, rest = p0 + p; i-- > 0; rest /= out_len[i])
+                outs[p] += (rest % out_len[i]) * out_tensor_stride[i];
+        }
+    }
+
+    std::size_t tiles(std::size_t len, std::size_t tile) const { return (len + tile - 1) / tile; }
+};
+
+template <std::size_t ConvDim,
+          class Tacc = double,
+          typename Tin,
+          typename Twei,
+          typename Tout,
+          typename Range>
+void forward(const tensor<Tin>& in,
+             const tensor<Twei>& wei,
+             tensor<Tout>& out,
+             const Range& pads,
+             const Range& strides,
+             const Range& dilations,
+             std::size_t group_count)
+{
+    const problem<ConvDim> pb{in, wei, out, pads, strides, dilations, group_count};
+
+    const auto crs     = pb.c * pb.wei_spatial;
+    const auto k_tiles = pb.tiles(pb.k, k_tile);
+    const auto p_tiles = pb.tiles(pb.out_spatial, p_tile);
+
+    par_for(pb.n * pb.groups * k_tiles * p_tiles, [&](std::size_t item) {
+        const auto p0 = (item % p_tiles) * p_tile;
+        const auto k0 = (item / p_tiles % k_tiles) * k_tile;
+        const auto g  = item / p_tiles / k_tiles % pb.groups;
+        const auto n  = item / p_tiles / k_tiles / pb.groups;
+        const auto pt = std::min(p_tile, pb.out_spatial - p0);
+        const auto kt = std::min(k_tile, pb.k - k0);
+
+        std::vector<std::ptrdiff_t> taps;
+        pb.tile_taps(p0, pt, pb.in_tensor_stride, taps);
+        std::vector<Tacc> acc(kt * p_tile);
+        std::vector<Tacc> col(cr_tile * p_tile);
+        std::vector<Tacc> w(kt * cr_tile);
+        for(std::size_t cr0 = 0; cr0 < crs; cr0 += cr_tile)
+        {
+            const auto crt = std::min(cr_tile, crs - cr0);
+            for(std::size_t cr = 0; cr < crt; ++cr)
+            {
+                const auto c      = (cr0 + cr) / pb.wei_spatial;
+                const auto r      = (cr0 + cr) % pb.wei_spatial;
+                const auto* plane = &in.data[pb.in_channel(n, g * pb.c + c)];
+                const auto* tap   = &taps[r * p_tile];
+                auto* dst         = &col[cr * p_tile];
+                for(std::size_t p = 0; p < pt; ++p)
+                    dst[p] = tap[p] < 0 ? Tacc(0) : Tacc(plane[tap[p]]);
+            }
+
+            for(std::size_t k = 0; k < kt; ++k)
+            {
+                const auto* src = &wei.data[pb.wei_channel(g * pb.k + k0 + k, 0)];
+                for(std::size_t cr = 0; cr < crt; ++cr)
+                {
+                    const auto c = (cr0 + cr) / pb.wei_spatial;
+                    const auto r = (cr0 + cr) % pb.wei_spatial;
+                    w[k * cr_tile + cr] = Tacc(src[pb.wei_channel(0, c) + pb.wei_offsets[r]]);
+                }
+            }
+
+            for(std::size_t k = 0; k < kt; ++k)
+            {
+                const auto* wk = &w[k * cr_tile];
+                auto* dst      = &acc[k * p_tile];
+                for(std::size_t cr = 0; cr < crt; ++cr)
+                {
+                    const auto wv   = wk[cr];
+                    const auto* src = &col[cr * p_tile];
+                    for(std::size_t p = 0; p < pt; ++p)
+                        dst[p] += wv * src[p];
+                }
+            }
+        }
+
+        std::vector<std::size_t> outs;
+        pb.tile_outputs(p0, pt, outs);
+        for(std::size_t k = 0; k < kt; ++k)
+        {
+            auto* dst       = &out.data[pb.out_channel(n, g * pb.k + k0 + k)];
+            const auto* src = &acc[k * p_tile];
+            for(std::size_t p = 0; p < pt; ++p)
+                dst[outs[p]] = Tout(src[p]);
+        }
+    });
+}
+
+template <std::size_t ConvDim,
+          class Tacc = double,
+          typename Tin,
+          typename Twei,
+          typename Tout,
+          typename Range>
+void backward_data(tensor<Tin>& in,
+                   const tensor<Twei>& wei,
+                   const tensor<Tout>& out,
+                   const Range& pads,
+                   const Range& strides,
+                   const Range& dilations,
+                   std::size_t group_count)
+{
+    const problem<ConvDim> pb{in, wei, out, pads, strides, dilations, group_count};
+
+    const auto c_tiles = pb.tiles(pb.c, c_tile);
+
+    // Every work item owns a few input channels of one batch, so the scatter needs no
+    // synchronization. It accumulates them packed and writes them once complete.
+    par_for(pb.n * pb.groups * c_tiles, [&](std::size_t item) {
+        const auto c0 = (item % c_tiles) * c_tile;
+        const auto g  = item / c_tiles % pb.groups;
+        const auto n  = item / c_tiles / pb.groups;
+        const auto ct = std::min(c_tile, pb.c - c0);
+        std::vector<Tacc> in_acc(ct * pb.in_spatial);
+
+        // Filter values of the channels of the item: w[(k * ct + c) * wei_spatial + r].
+        std::vector<Tacc> w(pb.k * ct * pb.wei_spatial);
+        for(std::size_t k = 0; k < pb.k; ++k)
+        {
+            for(std::size_t c = 0; c < ct; ++c)
+            {
+                const auto* src = &wei.data[pb.wei_channel(g * pb.k + k, c0 + c)];
+                for(std::size_t r = 0; r < pb.wei_spatial; ++r)
+                    w[(k * ct + c) * pb.wei_spatial + r] = Tacc(src[pb.wei_offsets[r]]);
+            }
+        }
+
+        std::vector<std::ptrdiff_t> taps;
+        std::vector<std::size_t> outs;
+        std::vector<Tacc> dy(pb.k * p_tile);
+        std::vector<Tacc> col(p_tile);
+        for(std::size_t p0 = 0; p0 < pb.out_spatial; p0 += p_tile)
+        {
+            const auto pt = std::min(p_tile, pb.out_spatial - p0);
+            pb.tile_taps(p0, pt, pb.in_stride, taps);
+            pb.tile_outputs(p0, pt, outs);
+            for(std::size_t k = 0; k < pb.k; ++k)
+            {
+                const auto* src = &out.data[pb.out_channel(n, g * pb.k + k)];
+                for(std::size_t p = 0; p < pt; ++p)
+                    dy[k * p_tile + p] = Tacc(src[outs[p]]);
+            }
+
+            for(std::size_t c = 0; c < ct; ++c)
+            {
+                for(std::size_t r = 0; r < pb.wei_spatial; ++r)
+                {
+                    // Row (c, r) of the transposed filter times the output gradients.
+                    std::fill_n(col.begin(), pt, Tacc(0));
+                    for(std::size_t k = 0; k < pb.k; ++k)
+                    {
+                        const auto wv   = w[(k * ct + c) * pb.wei_spatial + r];
+                        const auto* src = &dy[k * p_tile];
+                        for(std::size_t p = 0; p < pt; ++p)
+                            col[p] += wv * src[p];
+                    }
+
+                    const auto* tap = &taps[r * p_tile];
+                    auto* dst       = &in_acc[c * pb.in_spatial];
+                    for(std::size_t p = 0; p < pt; ++p)
+                    {
+                        if(tap[p] >= 0)
+                            dst[tap[p]] += col[p];
+                    }
+                }
+            }
+        }
+
+        for(std::size_t c = 0; c < ct; ++c)
+        {
+            auto* dst       = &in.data[pb.in_channel(n, g * pb.c + c0 + c)];
+            const auto* src = &in_acc[c * pb.in_spatial];
+            for(std::size_t s = 0; s < pb.in_spatial; ++s)
+                dst[pb.in_offset(s)] = Tin(src[s]);
+        }
+    });
+}
+
+template <std::size_t ConvDim,
+          class Tacc = double,
+          typename Tin,
+          typename Twei,
+          typename Tout,
+          typename Range>
+void backward_weight(const tensor<Tin>& in,
+                     tensor<Twei>& wei,
+                     const tensor<Tout>& out,
+                     const Range& pads,
+                     const Range& strides,
+                     const Range& dilations,
+                     std::size_t group_count)
+{
+    const problem<ConvDim> pb{in, wei, out, pads, strides, dilations, group_count};
+
+    const auto k_tiles = pb.tiles(pb.k, k_tile);
+    const auto c_tiles = pb.tiles(pb.c, c_tile);
+
+    par_for(pb.groups * k_tiles * c_tiles, [&](std::size_t item) {
+        const auto c0   = (item % c_tiles) * c_tile;
+        const auto k0   = (item / c_tiles % k_tiles) * k_tile;
+        const auto g    = item / c_tiles / k_tiles;
+        const auto ct   = std::min(c_tile, pb.c - c0);
+        const auto kt   = std::min(k_tile, pb.k - k0);
+        const auto ctrs = ct * pb.wei_spatial;
+
+        std::vector<Tacc> acc(kt * ctrs);
+        // Transposed im2col tile: one row of (channel, tap) values per output point.
+        std::vector<Tacc> col(p_tile * ctrs);
+        std::vector<Tacc> dy(p_tile);
+        std::vector<std::ptrdiff_t> taps;
+        std::vector<std::size_t> outs;
+        for(std::size_t p0 = 0; p0 < pb.out_spatial; p0 += p_tile)
+        {
+            const auto pt = std::min(p_tile, pb.out_spatial - p0);
+            pb.tile_taps(p0, pt, pb.in_tensor_stride, taps);
+            pb.tile_outputs(p0, pt, outs);
+            for(std::size_t n = 0; n < pb.n; ++n)
+            {
+                for(std::size_t c = 0; c < ct; ++c)
+                {
+                    const auto* plane = &in.data[pb.in_channel(n, g * pb.c + c0 + c)];
+                    for(std::size_t r = 0; r < pb.wei_spatial; ++r)
+                    {
+                        const auto* tap = &taps[r * p_tile];
+                        for(std::size_t p = 0; p < pt; ++p)
+                            col[p * ctrs + c * pb.wei_spatial + r] =
+                                tap[p] < 0 ? Tacc(0) : Tacc(plane[tap[p]]);
+                    }
+                }
+
+                for(std::size_t k = 0; k < kt; ++k)
+                {
+                    const auto* src = &out.data[pb.out_channel(n, g * pb.k + k0 + k)];
+                    for(std::size_t p = 0; p < pt; ++p)
+                        dy[p] = Tacc(src[outs[p]]);
+                    auto* dst = &acc[k * ctrs];
+                    for(std::size_t p = 0; p < pt; ++p)
+                    {
+                        const auto ov   = dy[p];
+                        const auto* row = &col[p * ctrs];
+                        for(std::size_t cr = 0; cr < ctrs; ++cr)
+                            dst[cr] += ov * row[cr];
+                    }
+                }
+            }
+        }
+
+        for(std::size_t k = 0; k < kt; ++k)
+        {
+            for(std::size_t c = 0; c < ct; ++c)
+            {
+                auto* dst       = &wei.data[pb.wei_channel(g * pb.k + k0 + k, c0 + c)];
+                const auto* src = &acc[(k * ct + c) * pb.wei_spatial];
+                for(std::size_t r = 0; r < pb.wei_spatial; ++r)
+                    dst[pb.wei_offsets[r]] = Twei(src[r]);
+            }
+        }
+    });
+}
+
+} // namespace cpu_conv
+
+#endif
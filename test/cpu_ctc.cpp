@@ -0,0 +1,230 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the host CTC loss against the sum over all the alignments of short
+// inputs, and its gradients against finite differences of the loss.
+
+#include "test.hpp"
+#include "cpu_ctc.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+struct sample
+{
+    std::vector<int> label;
+    int input_length;
+};
+
+struct batch
+{
+    cpu_ctc::problem p;
+    std::vector<sample> samples;
+    std::vector<double> probs;
+
+    std::vector<int> labels() const
+    {
+        std::vector<int> result;
+        for(const auto& s : samples)
+            result.insert(result.end(), s.label.begin(), s.label.end());
+        return result;
+    }
+
+    std::vector<int> label_lengths() const
+    {
+        std::vector<int> result;
+        for(const auto& s : samples)
+            result.push_back(static_cast<int>(s.label.size()));
+        return result;
+    }
+
+    std::vector<int> input_lengths() const
+    {
+        std::vector<int> result;
+        for(const auto& s : samples)
+            result.push_back(s.input_length);
+        return result;
+    }
+
+    double& prob(std::size_t t, std::size_t b, std::size_t c)
+    {
+        return probs[t * p.probs_strides[0] + b * p.probs_strides[1] + c];
+    }
+
+    void run(std::vector<double>& losses, std::vector<double>& grads) const
+    {
+        const auto lab = labels();
+        const auto ll  = label_lengths();
+        const auto il  = input_lengths();
+        losses.assign(p.batch_size, 0);
+        grads.assign(p.max_time_step * p.gradients_strides[0], 42);
+        cpu_ctc::loss(
+            p, probs.data(), lab.data(), ll.data(), il.data(), losses.data(), grads.data());
+    }
+};
+
+// Batches one padding class wide in the probabilities, packed gradients.
+static batch make_batch(std::size_t classes, int blank, bool softmax, std::vector<sample> samples)
+{
+    batch result;
+    result.samples = samples;
+    for(const auto& s : samples)
+        result.p.max_time_step =
+            std::max(result.p.max_time_step, static_cast<std::size_t>(s.input_length));
+    result.p.batch_size           = samples.size();
+    result.p.class_sz             = classes;
+    result.p.probs_strides[1]     = classes + 1;
+    result.p.probs_strides[0]     = samples.size() * (classes + 1);
+    result.p.gradients_strides[1] = classes;
+    result.p.gradients_strides[0] = samples.size() * classes;
+    result.p.blank                = blank;
+    result.p.apply_softmax        = softmax;
+    result.probs.resize(result.p.max_time_step * result.p.probs_strides[0]);
+    for(std::size_t i = 0; i < result.probs.size(); ++i)
+        result.probs[i] = std::sin(0.7 * static_cast<double>(i) + 0.3) * 2;
+    return result;
+}
+
+// -log of the sum over the paths that collapse to the label of the products of
+// their probabilities.
+static double brute_force_loss(batch& bt, std::size_t b)
+{
+    const auto& s      = bt.samples[b];
+    const auto classes = bt.p.class_sz;
+    const auto steps   = static_cast<std::size_t>(s.input_length);
+
+    std::vector<std::vector<double>> prob(steps, std::vector<double>(classes));
+    for(std::size_t t = 0; t < steps; ++t)
+    {
+        double sum = 0;
+        for(std::size_t c = 0; c < classes; ++c)
+        {
+            prob[t][c] = std::exp(bt.prob(t, b, c));
+            sum += prob[t][c];
+        }
+        if(bt.p.apply_softmax)
+            for(std::size_t c = 0; c < classes; ++c)
+                prob[t][c] /= sum;
+    }
+
+    double total = 0;
+    std::vector<std::size_t> path(steps, 0);
+    for(;;)
+    {
+        std::vector<int> collapsed;
+        double product = 1;
+        for(std::size_t t = 0; t < steps; ++t)
+        {
+            product *= prob[t][path[t]];
+            const auto c = static_cast<int>(path[t]);
+            if(c != bt.p.blank && (t == 0 || path[t - 1] != path[t]))
+                collapsed.push_back(c);
+        }
+        if(collapsed == s.label)
+            total += product;
+
+        std::size_t t = 0;
+        while(t < steps && ++path[t] == classes)
+            path[t++] = 0;
+        if(t == steps)
+            break;
+    }
+    return -std::log(total);
+}
+
+static void check_losses(batch bt)
+{
+    std::vector<double> losses;
+    std::vector<double> grads;
+    bt.run(losses, grads);
+    for(std::size_t b = 0; b < bt.p.batch_size; ++b)
+        EXPECT(std::abs(losses[b] - brute_force_loss(bt, b)) < 1e-9);
+}
+
+// With the softmax layer the gradient is the one of the logits, without it the
+// one of the probabilities, whose logarithms are the inputs.
+static void check_gradients(batch bt)
+{
+    std::vector<double> losses;
+    std::vector<double> grads;
+    bt.run(losses, grads);
+
+    const double h = 1e-6;
+    for(std::size_t b = 0; b < bt.p.batch_size; ++b)
+    {
+        for(std::size_t t = 0; t < bt.p.max_time_step; ++t)
+        {
+            for(std::size_t c = 0; c < bt.p.class_sz; ++c)
+            {
+                const auto g =
+                    grads[t * bt.p.gradients_strides[0] + b * bt.p.gradients_strides[1] + c];
+                if(t >= static_cast<std::size_t>(bt.samples[b].input_length))
+                {
+                    EXPECT(g == 0);
+                    continue;
+                }
+
+                auto& x          = bt.prob(t, b, c);
+                const auto saved = x;
+                std::vector<double> plus;
+                std::vector<double> minus;
+                std::vector<double> unused;
+                if(bt.p.apply_softmax)
+                {
+                    x = saved + h;
+                    bt.run(plus, unused);
+                    x = saved - h;
+                    bt.run(minus, unused);
+                }
+                else
+                {
+                    x = std::log(std::exp(saved) + h);
+                    bt.run(plus, unused);
+                    x = std::log(std::exp(saved) - h);
+                    bt.run(minus, unused);
+                }
+                x = saved;
+                EXPECT(std::abs((plus[b] - minus[b]) / (2 * h) - g) < 1e-5);
+            }
+        }
+    }
+}
+
+int main()
+{
+    // Repeated labels, a blank that is not class 0, an empty label, and the
+    // shortest input for a label
+    const std::vector<sample> samples = {
+        {{1, 2}, 5}, {{1, 1}, 4}, {{}, 3}, {{2, 0, 2}, 5}, {{0, 1}, 2}};
+    check_losses(make_batch(3, 0, true, {samples[0], samples[1], samples[2]}));
+    check_losses(make_batch(4, 3, true, samples));
+    check_losses(make_batch(4, 3, false, samples));
+
+    check_gradients(make_batch(3, 0, true, {samples[0], samples[1], samples[2]}));
+    check_gradients(make_batch(4, 3, true, samples));
+    check_gradients(make_batch(4, 3, false, samples));
+}
@@ -0,0 +1,310 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_CTC_HPP
+#define GUARD_CPU_CTC_HPP
+
+// CTC loss and its gradient on the host, in double, for probabilities laid out
+// time x batch x classes with the classes contiguous. The results are the ones
+// of the log domain formulas of the library kernel: the log likelihood is
+// clamped to `cutoff`, and the gradient is taken with respect to the logits
+// when the softmax layer is applied, or to the probabilities otherwise.
+//
+// The samples of the batch run in parallel, longest first, each thread with
+// its own scratch buffers sized once for the longest sample it gets. Within a
+// sample the alpha and beta recursions run on probabilities rescaled to a sum
+// of one at every time step, the scales summing up to the log likelihood. A
+// time step is then an array loop of multiply-adds over the label positions,
+// which do not depend on each other: the missing transitions read a zero
+// padding or are multiplied by a zero mask, and the loop vectorizes.
+//
+// With the alpha of a time step and the beta before its emission, the
+// posterior of each label position comes out normalized, so the gradient
+// needs no division by the probabilities except for the inputs without the
+// softmax layer.
+
+#include <miopen/par_for.hpp>
+
+#include "cpu_math.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace cpu_ctc {
+
+constexpr double cutoff = -1e20;
+
+struct problem
+{
+    std::size_t max_time_step = 0;
+    std::size_t batch_size    = 0;
+    std::size_t class_sz      = 0;
+    // Strides of the time and batch dimensions
+    std::size_t probs_strides[2]     = {0, 0};
+    std::size_t gradients_strides[2] = {0, 0};
+    int blank                        = 0;
+    bool apply_softmax               = true;
+};
+
+namespace detail {
+
+struct scratch
+{
+    // input length x classes
+    std::vector<double> prob;
+    // input length rows of two zeros then the label positions
+    std::vector<double> alpha;
+    // the label positions then two zeros
+    std::vector<double> beta;
+    std::vector<double> beta_next;
+    std::vector<double> emit;
+    std::vector<double> posterior;
+    std::vector<double> grad;
+    std::vector<int> label_prime;
+    // label_prime.size() + 2 entries: 1 where position s can be reached from s - 2
+    std::vector<double> skip;
+};
+
+// The sum of the transitions into each position from the previous row, which
+// is readable at s + Dir and s + 2 * Dir.
+template <int Dir>
+void transitions(const double* prev, const double* skip, std::size_t n, double* cur)
+{
+    for(std::size_t s = 0; s < n; ++s)
+    {
+        const auto i = static_cast<std::ptrdiff_t>(s);
+        cur[s]       = prev[i] + prev[i + Dir] + skip[s] * prev[i + 2 * Dir];
+    }
+}
+
+// Rescales v to a sum of one, returns the log of the sum. Zero rows stay zero.
+inline double rescale(double* v, std::size_t n)
+{
+    double sum = 0;
+    for(std::size_t s = 0; s < n; ++s)
+        sum += v[s];
+    const auto inv = cpu_math::select(sum > 0, 1 / sum, 0.0);
+    for(std::size_t s = 0; s < n; ++s)
+        v[s] *= inv;
+    return cpu_math::log(sum);
+}
+
+template <class T, class U>
+void run_sample(const problem& p,
+                const T* probs,
+                const int* label,
+                std::size_t label_length,
+                std::size_t input_length,
+                std::size_t b,
+                scratch& w,
+                U* loss,
+                U* gradients)
+{
+    using cpu_math::select;
+    const auto classes = p.class_sz;
+    const auto len     = 2 * label_length + 1;
+    const auto width   = len + 2;
+    const auto blank   = std::min(std::max(p.blank, 0), static_cast<int>(classes) - 1);
+
+    for(auto t = input_length; t < p.max_time_step; ++t)
+    {
+        auto* dst = gradients + t * p.gradients_strides[0] + b * p.gradients_strides[1];
+        std::fill(dst, dst + classes, U(0));
+    }
+    if(input_length == 0)
+    {
+        // Only the empty label, with probability one
+        *loss = U(0);
+        return;
+    }
+
+    w.label_prime.assign(len, blank);
+    for(std::size_t i = 0; i < label_length; ++i)
+        w.label_prime[2 * i + 1] = label[i];
+    w.skip.assign(len + 2, 0.0);
+    for(std::size_t s = 2; s < len; ++s)
+        w.skip[s] = (w.label_prime[s] != blank && w.label_prime[s] != w.label_prime[s - 2]);
+
+    w.prob.resize(input_length * classes);
+    for(std::size_t t = 0; t < input_length; ++t)
+    {
+        const auto* src = probs + t * p.probs_strides[0] + b * p.probs_strides[1];
+        auto* dst       = w.prob.data() + t * classes;
+        for(std::size_t c = 0; c < classes; ++c)
+            dst[c] = static_cast<double>(src[c]);
+        const auto max_val = p.apply_softmax ? *std::max_element(dst, dst + classes) : 0.0;
+        double sum         = 0;
+        for(std::size_t c = 0; c < classes; ++c)
+        {
+            dst[c] = cpu_math::exp(dst[c] - max_val);
+            sum += dst[c];
+        }
+        if(!p.apply_softmax)
+            continue;
+        for(std::size_t c = 0; c < classes; ++c)
+            dst[c] /= sum;
+    }
+
+    w.emit.resize(len);
+    const auto emissions = [&](std::size_t t) {
+        const auto* row = w.prob.data() + t * classes;
+        for(std::size_t s = 0; s < len; ++s)
+            w.emit[s] = row[w.label_prime[s]];
+        return w.emit.data();
+    };
+
+    // Forward: alpha row t at w.alpha[t * width + 2], after the emission of t
+    w.alpha.assign(input_length * width, 0.0);
+    double log_likelihood = 0;
+    for(std::size_t t = 0; t < input_length; ++t)
+    {
+        const auto* e = emissions(t);
+        auto* cur     = w.alpha.data() + t * width + 2;
+        if(t == 0)
+        {
+            cur[0] = 1;
+            if(len > 1)
+                cur[1] = 1;
+        }
+        else
+        {
+            transitions<-1>(cur - width, w.skip.data(), len, cur);
+        }
+        for(std::size_t s = 0; s < len; ++s)
+            cur[s] *= e[s];
+        log_likelihood += rescale(cur, len);
+    }
+    {
+        const auto* last = w.alpha.data() + (input_length - 1) * width + 2;
+        log_likelihood += cpu_math::log(last[len - 1] + last[static_cast<std::ptrdiff_t>(len) - 2]);
+    }
+    const auto lx = select(log_likelihood > cutoff, log_likelihood, cutoff);
+    *loss         = static_cast<U>(-lx);
+
+    // Backward: beta of t before the emission of t, which gives the posterior
+    // of the positions at t with the alpha after it. beta_next is the one of
+    // t + 1 after its emission.
+    w.beta.assign(width, 0.0);
+    w.beta_next.assign(width, 0.0);
+    w.posterior.resize(len);
+    w.grad.resize(classes);
+    for(std::size_t j = 0; j < input_length; ++j)
+    {
+        const auto t = input_length - 1 - j;
+        if(j == 0)
+        {
+            w.beta[len - 1] = 1;
+            if(len > 1)
+                w.beta[len - 2] = 1;
+        }
+        else
+        {
+            transitions<1>(w.beta_next.data(), w.skip.data() + 2, len, w.beta.data());
+        }
+
+        const auto* a = w.alpha.data() + t * width + 2;
+        for(std::size_t s = 0; s < len; ++s)
+            w.posterior[s] = a[s] * w.beta[s];
+        rescale(w.posterior.data(), len);
+        std::fill(w.grad.begin(), w.grad.end(), 0.0);
+        for(std::size_t s = 0; s < len; ++s)
+            w.grad[w.label_prime[s]] += w.posterior[s];
+
+        const auto* y = w.prob.data() + t * classes;
+        auto* dst     = gradients + t * p.gradients_strides[0] + b * p.gradients_strides[1];
+        if(p.apply_softmax)
+        {
+            for(std::size_t c = 0; c < classes; ++c)
+                dst[c] = static_cast<U>(y[c] - w.grad[c]);
+        }
+        else
+        {
+            for(std::size_t c = 0; c < classes; ++c)
+                dst[c] = static_cast<U>(select(w.grad[c] > 0, -w.grad[c] / y[c], 0.0));
+        }
+
+        if(t > 0)
+        {
+            const auto* e = emissions(t);
+            for(std::size_t s = 0; s < len; ++s)
+                w.beta_next[s] = w.beta[s] * e[s];
+            rescale(w.beta_next.data(), len);
+        }
+    }
+}
+
+} // namespace detail
+
+// losses[b] and the gradients of the whole tensor. labels holds the labels of
+// the batch one after the other; they are expected to be validated already.
+template <class T, class U>
+void loss(const problem& p,
+          const T* probs,
+          const int* labels,
+          const int* label_lengths,
+          const int* input_lengths,
+          U* losses,
+          U* gradients)
+{
+    const auto n = p.batch_size;
+    std::vector<std::size_t> label_offsets(n, 0);
+    for(std::size_t b = 1; b < n; ++b)
+        label_offsets[b] = label_offsets[b - 1] + label_lengths[b - 1];
+
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    const auto work = [&](std::size_t b) {
+        return static_cast<std::size_t>(input_lengths[b]) * (2 * label_lengths[b] + 1 + p.class_sz);
+    };
+    std::stable_sort(order.begin(), order.end(), [&](auto x, auto y) { return work(x) > work(y); });
+
+    const auto threads =
+        std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), n));
+    std::vector<detail::scratch> arenas(threads);
+    std::atomic<std::size_t> next{0};
+    miopen::par_for(threads, miopen::max_threads{threads}, [&](std::size_t thread) {
+        for(auto i = next++; i < n; i = next++)
+        {
+            const auto b = order[i];
+            detail::run_sample(p,
+                               probs,
+                               labels + label_offsets[b],
+                               label_lengths[b],
+                               input_lengths[b],
+                               b,
+                               arenas[thread],
+                               losses + b,
+                               gradients);
+        }
+    });
+}
+
+} // namespace cpu_ctc
+
+#endif // GUARD_CPU_CTC_HPP
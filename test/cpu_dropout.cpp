@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the lane parallel xorwow generator against the plain sequential one:
+// jumps with the precalculated matrices must land where stepping does.
+
+#include "test.hpp"
+#include "cpu_dropout.hpp"
+
+#include <vector>
+
+// Matrix times vector one bit at a time, as the kernels do it.
+static void scalar_mat_vec(const unsigned int* matrix, unsigned int* vec)
+{
+    unsigned int result[XORWOW_DIM] = {0};
+    for(unsigned int i = 0; i < XORWOW_DIM; i++)
+        for(unsigned int j = 0; j < XORWOW_BITS; j++)
+            if(bool(vec[i] & (1U << j)))
+                for(unsigned int k = 0; k < XORWOW_DIM; k++)
+                    result[k] ^= matrix[XORWOW_DIM * (i * XORWOW_BITS + j) + k];
+    std::copy(std::begin(result), std::end(result), vec);
+}
+
+static prngStates scalar_init(unsigned long long seed, unsigned long long subsequence)
+{
+    auto state = cpu_dropout::seed_state(seed);
+    auto* vec  = &state.x;
+    for(unsigned int m = 0; subsequence != 0; ++m, subsequence >>= XORWOW_JUMP_LOG2)
+        for(unsigned int c = 0; c < (subsequence & XORWOW_JUMP_LOG2_MASK); ++c)
+            scalar_mat_vec(precalc_xorwow_skipahead_sequence_matrices[m], vec);
+    return state;
+}
+
+static bool same(const prngStates& a, const prngStates& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w && a.v == b.v && a.d == b.d;
+}
+
+static void check_init(unsigned long long seed, std::size_t n)
+{
+    std::vector<prngStates> states(n);
+    cpu_dropout::init_states(states.data(), n, seed);
+    for(std::size_t gid = 0; gid < n; gid += 37)
+        EXPECT(same(states[gid], scalar_init(seed, gid)));
+    EXPECT(same(states[n - 1], scalar_init(seed, n - 1)));
+}
+
+static void check_mask(std::size_t glb_sz, std::size_t n, float rate)
+{
+    std::vector<prngStates> states(glb_sz);
+    cpu_dropout::init_states(states.data(), glb_sz, 17);
+
+    auto stepped = states;
+    std::vector<unsigned char> expected(n);
+    for(std::size_t i = 0; i < n; ++i)
+        expected[i] = cpu_dropout::uniform(cpu_dropout::next(stepped[i % glb_sz])) > rate;
+
+    std::vector<unsigned char> mask(n, 2);
+    cpu_dropout::generate_mask(states.data(), glb_sz, n, rate, mask.data());
+    EXPECT(mask == expected);
+
+    // Same draws in ranges of rows, all but the first one starting with a jump
+    const auto rows = (n + glb_sz - 1) / glb_sz;
+    std::vector<unsigned char> split(n, 2);
+    for(std::size_t first = 0; first < glb_sz; first += cpu_dropout::block_size)
+    {
+        std::size_t row0 = 0;
+        for(auto row1 : {rows / 3, rows / 3 + 1, rows - 1, rows})
+        {
+            cpu_dropout::generate_rows(
+                states.data(), glb_sz, n, rate, split.data(), first, row0, row1);
+            row0 = std::max(row0, row1);
+        }
+    }
+    EXPECT(split == expected);
+}
+
+int main()
+{
+    check_init(0, 1);
+    check_init(0x123456789abcULL, 300);
+    check_init(42, MAX_PRNG_STATE);
+
+    check_mask(256, 1, 0.5f);
+    check_mask(256, 100000, 0.3f);
+    check_mask(768, 768 * 50 + 100, 0.7f);
+    // Last block of states narrower than a lane block
+    check_mask(700, 700 * 40 + 699, 0.5f);
+    check_mask(MAX_PRNG_STATE, 3 * MAX_PRNG_STATE + 5, 0.1f);
+}
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_DROPOUT_HPP
+#define GUARD_CPU_DROPOUT_HPP
+
+// The xorwow generator of the dropout kernels on the host.
+//
+// States are processed in blocks of 256 lanes stored by component, so the
+// generator step and the bit matrix products run across the lanes in SIMD: the
+// matrix rows are selected with masks made of the lane bits instead of branches.
+// Jumps use the precalculated matrices of the kernels, which lets
+// generate_mask() split the draws of a state between threads and still produce
+// the masks of the kernels bit for bit.
+
+#include <miopen/dropout.hpp>
+#include <miopen/par_for.hpp>
+#include <miopen/precalc_xorwow_skipahead_matrices.hpp>
+#include <miopen/precalc_xorwow_skipahead_sequence_matrices.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace cpu_dropout {
+
+static_assert(XORWOW_PRECALC_MATRICES_NUM * XORWOW_JUMP_LOG2 >= 64,
+              "the precalculated matrices must cover any 64 bit jump");
+
+using matrices = unsigned int[XORWOW_PRECALC_MATRICES_NUM][XORWOW_PRECALC_MATRICES_SZ];
+
+constexpr float two_pow32_inv    = 2.3283064e-10f;
+constexpr unsigned int weyl_step = 362437;
+constexpr std::size_t block_size = 256;
+// A jump costs about as much as a few thousand rows of draws.
+constexpr std::size_t min_rows_split = 8192;
+
+// The five xorshift words then the Weyl value, component major.
+struct lanes
+{
+    unsigned int v[XORWOW_DIM + 1][block_size];
+};
+
+inline float uniform(unsigned int u) { return two_pow32_inv + (u * two_pow32_inv); }
+
+inline unsigned int next(prngStates& s)
+{
+    const unsigned int t = s.x ^ (s.x >> 2);
+    s.x                  = s.y;
+    s.y                  = s.z;
+    s.z                  = s.w;
+    s.w                  = s.v;
+    s.v                  = (s.v ^ (s.v << 4)) ^ (t ^ (t << 1));
+    s.d += weyl_step;
+    return s.d + s.v;
+}
+
+inline void load(lanes& l, const prngStates* states, std::size_t count)
+{
+    for(std::size_t s = 0; s < block_size; ++s)
+    {
+        const auto st = s < count ? states[s] : prngStates{};
+        l.v[0][s]     = st.x;
+        l.v[1][s]     = st.y;
+        l.v[2][s]     = st.z;
+        l.v[3][s]     = st.w;
+        l.v[4][s]     = st.v;
+        l.v[5][s]     = st.d;
+    }
+}
+
+inline void store(const lanes& l, prngStates* states, std::size_t count)
+{
+    for(std::size_t s = 0; s < count; ++s)
+        states[s] = {l.v[0][s], l.v[1][s], l.v[2][s], l.v[3][s], l.v[4][s], l.v[5][s]};
+}
+
+// dst = matrix * src for the xorshift words of every lane.
+inline void mat_vec(const unsigned int* matrix, const lanes& src, lanes& dst)
+{
+    for(std::size_t k = 0; k < XORWOW_DIM; ++k)
+        std::fill(std::begin(dst.v[k]), std::end(dst.v[k]), 0u);
+
+    for(std::size_t i = 0; i < XORWOW_DIM; ++i)
+    {
+        for(unsigned int j = 0; j < XORWOW_BITS; ++j)
+        {
+            const auto* row = matrix + XORWOW_DIM * (i * XORWOW_BITS + j);
+            for(std::size_t k = 0; k < XORWOW_DIM; ++k)
+            {
+                const auto r = row[k];
+                if(r == 0)
+                    continue;
+                for(std::size_t s = 0; s < block_size; ++s)
+                    dst.v[k][s] ^= r & (0u - ((src.v[i][s] >> j) & 1u));
+            }
+        }
+    }
+}
+
+// Advances each lane s by skip[s] steps of the sequence the matrices describe:
+// digit m of the skip in base 2^XORWOW_JUMP_LOG2 applies matrix m that many
+// times. The Weyl value is not touched.
+inline void skipahead(lanes& l, const unsigned long long* skip, const matrices& mats)
+{
+    unsigned long long rest[block_size];
+    std::copy(skip, skip + block_size, std::begin(rest));
+
+    lanes product;
+    for(std::size_t m = 0; m < XORWOW_PRECALC_MATRICES_NUM; ++m)
+    {
+        unsigned long long any = 0;
+        unsigned int most      = 0;
+        for(std::size_t s = 0; s < block_size; ++s)
+        {
+            any |= rest[s];
+            most = std::max(most, static_cast<unsigned int>(rest[s] & XORWOW_JUMP_LOG2_MASK));
+        }
+        if(any == 0)
+            break;
+
+        for(unsigned int c = 1; c <= most; ++c)
+        {
+            mat_vec(mats[m], l, product);
+            for(std::size_t k = 0; k < XORWOW_DIM; ++k)
+            {
+                for(std::size_t s = 0; s < block_size; ++s)
+                {
+                    const auto digit = static_cast<unsigned int>(rest[s] & XORWOW_JUMP_LOG2_MASK);
+                    const auto keep  = 0u - static_cast<unsigned int>(digit >= c);
+                    l.v[k][s]        = (product.v[k][s] & keep) | (l.v[k][s] & ~keep);
+                }
+            }
+        }
+
+        for(std::size_t s = 0; s < block_size; ++s)
+            rest[s] >>= XORWOW_JUMP_LOG2;
+    }
+}
+
+// Same jump for all the lanes, with the Weyl value advanced as well.
+inline void skipahead(lanes& l, unsigned long long skip)
+{
+    unsigned long long skips[block_size];
+    std::fill(std::begin(skips), std::end(skips), skip);
+    skipahead(l, skips, precalc_xorwow_skipahead_matrices);
+    for(std::size_t s = 0; s < block_size; ++s)
+        l.v[XORWOW_DIM][s] += static_cast<unsigned int>(skip) * weyl_step;
+}
+
+// State of the rocRAND xorwow generator for a seed, at offset 0 of the
+// subsequence.
+inline prngStates seed_state(unsigned long long seed)
+{
+    prngStates s{123456789, 362436069, 521288629, 88675123, 5783321, 6615241};
+
+    // Adopt constants choice of rocRAND (https://github.com/ROCmSoftwarePlatform/rocRAND)
+    const unsigned int s0 = static_cast<unsigned int>(seed) ^ 0x2c7f967fU;
+    const unsigned int s1 = static_cast<unsigned int>(seed >> 32) ^ 0xa03697cbU;
+    const unsigned int t0 = 1228688033 * s0;
+    const unsigned int t1 = 2073658381 * s1;
+    s.x += t0;
+    s.y ^= t0;
+    s.z += t1;
+    s.w ^= t1;
+    s.v += t0;
+    s.d += t1 + t0;
+    return s;
+}
+
+// states[gid] is the state of subsequence gid for gid < n, as the state
+// initialization kernel sets it.
+inline void init_states(prngStates* states, std::size_t n, unsigned long long seed)
+{
+    const auto first  = seed_state(seed);
+    const auto blocks = (n + block_size - 1) / block_size;
+    miopen::par_for(blocks, miopen::min_grain{1}, [&](std::size_t b) {
+        const auto base  = b * block_size;
+        const auto count = std::min(block_size, n - base);
+
+        std::vector<prngStates> seeded(block_size, first);
+        unsigned long long subsequences[block_size];
+        for(std::size_t s = 0; s < block_size; ++s)
+            subsequences[s] = base + s;
+
+        lanes l;
+        load(l, seeded.data(), block_size);
+        skipahead(l, subsequences, precalc_xorwow_skipahead_sequence_matrices);
+        store(l, states + base, count);
+    });
+}
+
+// The part of generate_mask() drawn by the states [first, first + block_size)
+// in the rows [row0, row1), row r being the elements [r * glb_sz, (r + 1) * glb_sz).
+inline void generate_rows(const prngStates* states,
+                          std::size_t glb_sz,
+                          std::size_t n,
+                          float rate,
+                          unsigned char* mask,
+                          std::size_t first,
+                          std::size_t row0,
+                          std::size_t row1)
+{
+    const auto width = std::min(block_size, glb_sz - first);
+
+    lanes l;
+    load(l, states + first, width);
+    if(row0 > 0)
+        skipahead(l, row0);
+
+    // The words rotate through the slots instead of being moved: after k rows the
+    // oldest word is in slot k % XORWOW_DIM and the newest in the one before.
+    std::size_t oldest = 0;
+    auto* d            = l.v[XORWOW_DIM];
+    for(std::size_t r = row0; r < row1; ++r)
+    {
+        const auto start = r * glb_sz + first;
+        if(start >= n)
+            break;
+        auto* x          = l.v[oldest];
+        const auto* v    = l.v[(oldest + XORWOW_DIM - 1) % XORWOW_DIM];
+        auto* out        = mask + start;
+        const auto count = std::min(width, n - start);
+        for(std::size_t s = 0; s < count; ++s)
+        {
+            const unsigned int t  = x[s] ^ (x[s] >> 2);
+            const unsigned int nv = (v[s] ^ (v[s] << 4)) ^ (t ^ (t << 1));
+            x[s]                  = nv;
+            d[s] += weyl_step;
+            out[s] = static_cast<unsigned char>(uniform(d[s] + nv) > rate);
+        }
+        oldest = (oldest + 1) % XORWOW_DIM;
+    }
+}
+
+// mask[i] = uniform(next(states[i % glb_sz])) > rate for i < n, the draws of
+// each state taken in order of i. The states are left untouched, like the
+// forward kernel does.
+inline void generate_mask(const prngStates* states,
+                          std::size_t glb_sz,
+                          std::size_t n,
+                          float rate,
+                          unsigned char* mask)
+{
+    if(n == 0 || glb_sz == 0)
+        return;
+
+    // Blocks of states are independent. When there are fewer of them than threads
+    // the draws of a block are split in ranges of rows too, each range starting
+    // with a jump of its states.
+    const std::size_t rows          = (n + glb_sz - 1) / glb_sz;
+    const std::size_t state_blocks  = (glb_sz + block_size - 1) / block_size;
+    const std::size_t threads       = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t wanted_splits = (threads + state_blocks - 1) / state_blocks;
+    const std::size_t splits =
+        std::max<std::size_t>(1, std::min(wanted_splits, rows / min_rows_split));
+    const std::size_t rows_per_split = (rows + splits - 1) / splits;
+
+    miopen::par_for(state_blocks * splits, miopen::min_grain{1}, [&](std::size_t task) {
+        const auto row0 = task / state_blocks * rows_per_split;
+        generate_rows(states,
+                      glb_sz,
+                      n,
+                      rate,
+                      mask,
+                      task % state_blocks * block_size,
+                      row0,
+                      std::min(rows, row0 + rows_per_split));
+    });
+}
+
+} // namespace cpu_dropout
+
+#endif // GUARD_CPU_DROPOUT_HPP
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_LRN_HPP
+#define GUARD_CPU_LRN_HPP
+
+// Window sums of the LRN references. Every value enters and leaves a running
+// sum once, so the cost does not depend on the LRN size; the running sums of a
+// whole line are updated together, which vectorizes.
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace cpu_lrn {
+
+// out line i = sum of the in lines [i - lo, i + hi] clipped to [0, n), for n
+// contiguous lines of m values.
+inline void
+sliding_sums(std::size_t n, std::size_t m, int lo, int hi, const double* in, double* out)
+{
+    const auto line = [&](int i) { return in + static_cast<std::size_t>(i) * m; };
+    const auto last = static_cast<int>(n) - 1;
+    for(int i = 0; i <= last; ++i)
+    {
+        auto* o = out + static_cast<std::size_t>(i) * m;
+        if(i == 0)
+        {
+            std::fill(o, o + m, 0.0);
+            for(int e = 0; e <= std::min(hi, last); ++e)
+                std::transform(o, o + m, line(e), o, std::plus<double>{});
+            continue;
+        }
+        std::copy(o - m, o, o);
+        if(i + hi <= last)
+            std::transform(o, o + m, line(i + hi), o, std::plus<double>{});
+        if(i - lo - 1 >= 0)
+            std::transform(o, o + m, line(i - lo - 1), o, std::minus<double>{});
+    }
+}
+
+// Both axes of a height x width plane, rows first.
+inline void box_sums(std::size_t height,
+                     std::size_t width,
+                     int lo,
+                     int hi,
+                     const double* in,
+                     double* out)
+{
+    std::vector<double> rows(height * width);
+    for(std::size_t h = 0; h < height; ++h)
+        sliding_sums(width, 1, lo, hi, in + h * width, rows.data() + h * width);
+    sliding_sums(height, width, lo, hi, rows.data(), out);
+}
+
+} // namespace cpu_lrn
+
+#endif // GUARD_CPU_LRN_HPP
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the host math functions against libm, in ulp of the libm result, and
+// their special values.
+
+#include "test.hpp"
+#include "cpu_math.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+static double ulp_error(double x, double ref)
+{
+    if(x == ref || (std::isnan(x) && std::isnan(ref)))
+        return 0;
+    if(!std::isfinite(x) || !std::isfinite(ref))
+        return std::numeric_limits<double>::infinity();
+    return std::abs(x - ref) / std::abs(std::nextafter(ref, 2 * ref + 1) - ref);
+}
+
+template <class F, class G>
+static double max_ulp_error(F f, G ref, double lo, double hi)
+{
+    std::mt19937_64 gen(17);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    double max_error = 0;
+    for(int i = 0; i < 100000; ++i)
+    {
+        const auto x = dist(gen);
+        max_error    = std::max(max_error, ulp_error(f(x), ref(x)));
+    }
+    return max_error;
+}
+
+int main()
+{
+    const auto inf = std::numeric_limits<double>::infinity();
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+
+    // Up to the overflow, down to the subnormals
+    EXPECT(max_ulp_error([](double x) { return cpu_math::exp(x); },
+                         [](double x) { return std::exp(x); },
+                         -745,
+                         709.7) <= 2);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::expm1(x); },
+                         [](double x) { return std::expm1(x); },
+                         -50,
+                         700) <= 3);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::expm1(x); },
+                         [](double x) { return std::expm1(x); },
+                         -1e-6,
+                         1e-6) <= 3);
+    // Over the exponent range
+    EXPECT(max_ulp_error([](double x) { return cpu_math::log(std::exp(x)); },
+                         [](double x) { return std::log(std::exp(x)); },
+                         -744,
+                         709) <= 2);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::log1p(x); },
+                         [](double x) { return std::log1p(x); },
+                         -0.999,
+                         10) <= 3);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::log1p(x); },
+                         [](double x) { return std::log1p(x); },
+                         -1e-5,
+                         1e-5) <= 3);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::tanh(x); },
+                         [](double x) { return std::tanh(x); },
+                         -30,
+                         30) <= 4);
+    EXPECT(max_ulp_error([](double x) { return cpu_math::pow(x, 0.75); },
+                         [](double x) { return std::pow(x, 0.75); },
+                         1e-3,
+                         1e3) <= 16);
+
+    EXPECT(cpu_math::exp(-inf) == 0);
+    EXPECT(cpu_math::exp(inf) == inf);
+    EXPECT(cpu_math::exp(0) == 1);
+    EXPECT(cpu_math::expm1(-inf) == -1);
+    EXPECT(cpu_math::log(0) == -inf);
+    EXPECT(cpu_math::log(1) == 0);
+    EXPECT(cpu_math::log(inf) == inf);
+    EXPECT(std::isnan(cpu_math::log(-1)));
+    EXPECT(ulp_error(cpu_math::log(std::numeric_limits<double>::denorm_min()),
+                     std::log(std::numeric_limits<double>::denorm_min())) <= 1);
+    EXPECT(cpu_math::log1p(-1) == -inf);
+    EXPECT(cpu_math::tanh(inf) == 1);
+    EXPECT(cpu_math::tanh(-inf) == -1);
+    EXPECT(std::isnan(cpu_math::exp(nan)));
+    EXPECT(std::isnan(cpu_math::expm1(nan)));
+    EXPECT(std::isnan(cpu_math::log(nan)));
+    EXPECT(std::isnan(cpu_math::tanh(nan)));
+}
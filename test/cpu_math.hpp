@@ -0,0 +1,198 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_MATH_HPP
+#define GUARD_CPU_MATH_HPP
+
+// exp, expm1, log, log1p, tanh and pow in double without libm calls and without
+// branches, so loops over arrays of them vectorize. Range reduction plus a
+// polynomial; the error is a few ulp (test/cpu_math.cpp checks the bound), far
+// below the tolerance of any verification using them.
+//
+// GCC vectorizes the 64 bit masks of select from SSE4.1 on (x86-64-v2); with
+// plain SSE2 the loops stay scalar, and slower than libm for exp and log.
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace cpu_math {
+
+namespace detail {
+
+constexpr double ln2_hi = 6.93147180369123816490e-01;
+constexpr double ln2_lo = 1.90821492927058770002e-10;
+constexpr double log2e  = 1.44269504088896338700e+00;
+constexpr double sqrt2  = 1.41421356237309514547e+00;
+// Adding it rounds a double below 2^51 to an integer, which ends up in the low
+// bits of the sum.
+constexpr double round_shift = 6755399441055744.0;
+
+inline double from_bits(std::uint64_t u)
+{
+    double x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+inline std::uint64_t to_bits(double x)
+{
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+// 2^n for t = n + round_shift, n in [-1022, 1023]
+inline double exp2_shifted(double t) { return from_bits((to_bits(t) + 1023) << 52); }
+
+// x = n ln2 + r with |r| <= ln2 / 2, 2^n = scale_hi * scale_lo.
+struct reduced
+{
+    double r;
+    double scale_hi;
+    double scale_lo;
+};
+
+// x in [-750, 710]. 2^n is split in two factors to stay in the normal range
+// down to the subnormal results.
+inline reduced reduce(double x)
+{
+    const double n  = (x * log2e + round_shift) - round_shift;
+    const double t1 = n * 0.5 + round_shift;
+    const double t2 = (n - (t1 - round_shift)) + round_shift;
+    return {(x - n * ln2_hi) - n * ln2_lo, exp2_shifted(t1), exp2_shifted(t2)};
+}
+
+// expm1(r) for |r| <= ln2 / 2, Taylor to degree 13 (remainder below 2^-58).
+inline double expm1_reduced(double r)
+{
+    double p = 1.0 / 6227020800.0;
+    p        = p * r + 1.0 / 479001600.0;
+    p        = p * r + 1.0 / 39916800.0;
+    p        = p * r + 1.0 / 3628800.0;
+    p        = p * r + 1.0 / 362880.0;
+    p        = p * r + 1.0 / 40320.0;
+    p        = p * r + 1.0 / 5040.0;
+    p        = p * r + 1.0 / 720.0;
+    p        = p * r + 1.0 / 120.0;
+    p        = p * r + 1.0 / 24.0;
+    p        = p * r + 1.0 / 6.0;
+    p        = p * r + 0.5;
+    return r + r * r * p;
+}
+
+// log(m) for m in [sqrt(1/2), sqrt(2)) as 2 atanh(s), s = (m - 1) / (m + 1).
+inline double log_reduced(double m)
+{
+    const double f  = m - 1.0;
+    const double s  = f / (2.0 + f);
+    const double s2 = s * s;
+    double p        = 1.0 / 21;
+    p               = p * s2 + 1.0 / 19;
+    p               = p * s2 + 1.0 / 17;
+    p               = p * s2 + 1.0 / 15;
+    p               = p * s2 + 1.0 / 13;
+    p               = p * s2 + 1.0 / 11;
+    p               = p * s2 + 1.0 / 9;
+    p               = p * s2 + 1.0 / 7;
+    p               = p * s2 + 1.0 / 5;
+    p               = p * s2 + 1.0 / 3;
+    // 2s = f - s f, f is exact and stays the leading term
+    return f - s * (f - 2.0 * s2 * p);
+}
+
+} // namespace detail
+
+// c ? a : b on the bits, for the callers' loops too. Both sides are computed
+// either way; a conditional expression would be a branch for the compiler
+// under trapping math, and the loop would not vectorize.
+inline double select(bool c, double a, double b)
+{
+    const std::uint64_t m = -static_cast<std::uint64_t>(c);
+    return detail::from_bits((detail::to_bits(a) & m) | (detail::to_bits(b) & ~m));
+}
+
+inline double clamp(double x, double lo, double hi)
+{
+    return select(x < lo, lo, select(x > hi, hi, x));
+}
+
+// NaN propagates through the arithmetic of all of them.
+
+inline double exp(double x)
+{
+    const auto red = detail::reduce(clamp(x, -750.0, 710.0));
+    return (1.0 + detail::expm1_reduced(red.r)) * red.scale_hi * red.scale_lo;
+}
+
+inline double expm1(double x)
+{
+    const auto red     = detail::reduce(clamp(x, -40.0, 710.0));
+    const double scale = red.scale_hi * red.scale_lo;
+    return scale * detail::expm1_reduced(red.r) + (scale - 1.0);
+}
+
+inline double log(double x)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    // Subnormals are scaled into the normal range first.
+    const bool tiny       = x < std::numeric_limits<double>::min();
+    const std::uint64_t u = detail::to_bits(select(tiny, x * 18014398509481984.0, x)); // 2^54
+    // The exponent field, as a double without an integer conversion
+    const double field =
+        detail::from_bits(((u >> 52) & 0x7ff) | detail::to_bits(detail::round_shift)) -
+        detail::round_shift;
+    const double m     = detail::from_bits((u & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+    const bool big     = m > detail::sqrt2;
+    const double e     = field - 1023.0 + select(big, 1.0, 0.0) - select(tiny, 54.0, 0.0);
+    const double y     = e * detail::ln2_hi +
+                       (detail::log_reduced(select(big, m * 0.5, m)) + e * detail::ln2_lo);
+    const double res   = select(x == inf, inf, y + (x - x));
+    return select(x == 0, -inf, select(x < 0, nan, res));
+}
+
+inline double log1p(double x)
+{
+    // The rounding error of 1 + x, put back to first order. Exact for u = 1.
+    const double u = 1.0 + x;
+    return cpu_math::log(u) + select(u > 0, (x - (u - 1.0)) / u, 0.0);
+}
+
+inline double tanh(double x)
+{
+    // tanh rounds to 1 beyond 20
+    const double a = clamp(select(x < 0, -x, x), 0.0, 20.0);
+    const double e = cpu_math::expm1(2.0 * a);
+    const double t = e / (e + 2.0);
+    return select(x < 0, -t, t);
+}
+
+// For x > 0, the only case of the references.
+inline double pow(double x, double y) { return cpu_math::exp(y * cpu_math::log(x)); }
+
+} // namespace cpu_math
+
+#endif // GUARD_CPU_MATH_HPP
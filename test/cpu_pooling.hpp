@@ -0,0 +1,394 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_POOLING_HPP
+#define GUARD_CPU_POOLING_HPP
+
+// Pooling on the host for N x C x <1 to 3 spatial dims> data with any strides.
+// Planes are processed in parallel, and the windows of a plane are reduced one
+// dimension at a time with sliding windows: a monotonic deque for the maximum
+// and running sums over blocks of the kernel size for the average, so the cost
+// per dimension does not depend on the kernel size. Max pooling can save the position
+// of each maximum in the same format as the library kernels: the offset in the
+// window, or in the image when image_index is set, stored at the index of the
+// output.
+
+#include <miopen/miopen.h>
+#include <miopen/par_for.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace cpu_pooling {
+
+struct problem
+{
+    miopenPoolingMode_t mode;
+    std::size_t n = 0;
+    std::size_t c = 0;
+    // Spatial dims are padded at the front to three.
+    std::array<std::size_t, 3> in{{1, 1, 1}};
+    std::array<std::size_t, 3> out{{1, 1, 1}};
+    std::array<std::size_t, 5> in_strides{};
+    std::array<std::size_t, 5> out_strides{};
+    std::array<int, 3> kernel{{1, 1, 1}};
+    std::array<int, 3> stride{{1, 1, 1}};
+    std::array<int, 3> pad{{0, 0, 0}};
+    bool image_index = false;
+
+    std::size_t in_offset(std::size_t plane, std::size_t d, std::size_t h, std::size_t w) const
+    {
+        return (plane / c) * in_strides[0] + (plane % c) * in_strides[1] + d * in_strides[2] +
+               h * in_strides[3] + w * in_strides[4];
+    }
+
+    std::size_t out_offset(std::size_t plane, std::size_t d, std::size_t h, std::size_t w) const
+    {
+        return (plane / c) * out_strides[0] + (plane % c) * out_strides[1] + d * out_strides[2] +
+               h * out_strides[3] + w * out_strides[4];
+    }
+};
+
+template <class Range, class Lens>
+problem make_problem(miopenPoolingMode_t mode,
+                     const Lens& in_lens,
+                     const Lens& in_strides,
+                     const Lens& out_lens,
+                     const Lens& out_strides,
+                     const Range& kernel,
+                     const Range& stride,
+                     const Range& pad,
+                     bool image_index = false)
+{
+    problem pb;
+    pb.mode        = mode;
+    pb.image_index = image_index;
+    pb.n           = in_lens[0];
+    pb.c           = in_lens[1];
+    const auto spatial = in_lens.size() - 2;
+    const auto skip    = 3 - spatial;
+    for(std::size_t i = 0; i < spatial; ++i)
+    {
+        pb.in[skip + i]              = in_lens[i + 2];
+        pb.out[skip + i]             = out_lens[i + 2];
+        pb.in_strides[2 + skip + i]  = in_strides[i + 2];
+        pb.out_strides[2 + skip + i] = out_strides[i + 2];
+        pb.kernel[skip + i]          = kernel[i];
+        pb.stride[skip + i]          = stride[i];
+        pb.pad[skip + i]             = pad[i];
+    }
+    pb.in_strides[0]  = in_strides[0];
+    pb.in_strides[1]  = in_strides[1];
+    pb.out_strides[0] = out_strides[0];
+    pb.out_strides[1] = out_strides[1];
+    return pb;
+}
+
+template <class F>
+void par_for(std::size_t n, F f)
+{
+    miopen::par_for_dynamic(n, miopen::max_threads{std::thread::hardware_concurrency()}, f);
+}
+
+// Input positions [first, second) along a dimension covered by an output point.
+inline std::pair<std::size_t, std::size_t>
+window_bounds(const problem& pb, std::size_t dim, std::size_t o)
+{
+    const auto start = static_cast<int>(o) * pb.stride[dim] - pb.pad[dim];
+    const auto lo    = std::min<std::size_t>(std::max(start, 0), pb.in[dim]);
+    const auto hi    = std::min<std::size_t>(std::max(start + pb.kernel[dim], 0), pb.in[dim]);
+    return {lo, std::max(lo, hi)};
+}
+
+// Dense D x H x W values of a plane. For max pooling, args holds the position
+// (d * H + h) * W + w in the image of each value.
+struct dense
+{
+    std::array<std::size_t, 3> lens;
+    std::vector<double> values;
+    std::vector<std::size_t> args;
+};
+
+// Reduces the windows along one dimension. The maximum of a window is its first
+// in the order of the positions, an empty window has no maximum and sums to 0.
+// A window overlaps at most two blocks of kernel size, so its sum is the sum of a
+// suffix of one block and a prefix of the next: nothing is subtracted, and large
+// values do not cancel the small ones as in a sliding sum.
+inline dense slide(const problem& pb, const dense& in, std::size_t dim, bool max)
+{
+    dense out;
+    out.lens      = in.lens;
+    out.lens[dim] = pb.out[dim];
+    out.values.resize(out.lens[0] * out.lens[1] * out.lens[2]);
+    if(max)
+        out.args.resize(out.values.size());
+
+    std::size_t outer = 1;
+    std::size_t inner = 1;
+    for(std::size_t i = 0; i < dim; ++i)
+        outer *= in.lens[i];
+    for(auto i = dim + 1; i < 3; ++i)
+        inner *= in.lens[i];
+    const auto len = in.lens[dim];
+
+    const auto block = static_cast<std::size_t>(pb.kernel[dim]);
+    // Positions of decreasing values, each pushed once per line.
+    std::vector<std::size_t> deque(len);
+    std::vector<double> prefix(len);
+    std::vector<double> suffix(len);
+    for(std::size_t a = 0; a < outer; ++a)
+    {
+        for(std::size_t b = 0; b < inner; ++b)
+        {
+            const auto at_in  = [&](std::size_t i) { return (a * len + i) * inner + b; };
+            const auto at_out = [&](std::size_t o) { return (a * pb.out[dim] + o) * inner + b; };
+            std::size_t head = 0;
+            std::size_t tail = 0;
+            std::size_t next = 0;
+            if(!max)
+            {
+                for(std::size_t i = 0; i < len; ++i)
+                    prefix[i] = in.values[at_in(i)] + (i % block == 0 ? 0 : prefix[i - 1]);
+                for(auto i = len; i-- > 0;)
+                {
+                    const auto last = (i + 1) % block == 0 || i + 1 == len;
+                    suffix[i]       = in.values[at_in(i)] + (last ? 0 : suffix[i + 1]);
+                }
+            }
+            for(std::size_t o = 0; o < pb.out[dim]; ++o)
+            {
+                const auto bounds = window_bounds(pb, dim, o);
+                if(max)
+                {
+                    for(next = std::max(next, bounds.first); next < bounds.second; ++next)
+                    {
+                        const auto v = in.values[at_in(next)];
+                        while(tail > head && in.values[at_in(deque[tail - 1])] < v)
+                            --tail;
+                        deque[tail++] = next;
+                    }
+                    while(head < tail && deque[head] < bounds.first)
+                        ++head;
+                    if(head == tail)
+                    {
+                        out.values[at_out(o)] = -std::numeric_limits<double>::infinity();
+                        out.args[at_out(o)]   = 0;
+                    }
+                    else
+                    {
+                        out.values[at_out(o)] = in.values[at_in(deque[head])];
+                        out.args[at_out(o)]   = in.args[at_in(deque[head])];
+                    }
+                }
+                else if(bounds.first == bounds.second)
+                {
+                    out.values[at_out(o)] = 0;
+                }
+                else
+                {
+                    const auto lo = bounds.first;
+                    const auto hi = bounds.second - 1;
+                    // A window in one block is cut by the image, so it starts or ends the block.
+                    if(lo / block != hi / block)
+                        out.values[at_out(o)] = suffix[lo] + prefix[hi];
+                    else if(lo % block == 0)
+                        out.values[at_out(o)] = prefix[hi];
+                    else
+                        out.values[at_out(o)] = suffix[lo];
+                }
+            }
+        }
+    }
+    return out;
+}
+
+// Maximum or sum of the window of every output point of a plane, in the order
+// of the output points.
+template <class T>
+dense pool_plane(const problem& pb, std::size_t plane, const T* x, bool max)
+{
+    dense image;
+    image.lens = pb.in;
+    image.values.resize(pb.in[0] * pb.in[1] * pb.in[2]);
+    if(max)
+        image.args.resize(image.values.size());
+    for(std::size_t d = 0, i = 0; d < pb.in[0]; ++d)
+    {
+        for(std::size_t h = 0; h < pb.in[1]; ++h)
+        {
+            for(std::size_t w = 0; w < pb.in[2]; ++w, ++i)
+            {
+                image.values[i] = static_cast<double>(x[pb.in_offset(plane, d, h, w)]);
+                if(max)
+                    image.args[i] = i;
+            }
+        }
+    }
+    // Innermost dimension first, so that the maximum is the first in the order d, h, w.
+    for(std::size_t dim = 3; dim-- > 0;)
+        image = slide(pb, image, dim, max);
+    return image;
+}
+
+// Input positions covered by an output point, clamped to the image.
+struct window
+{
+    std::array<int, 3> start;
+    std::array<std::size_t, 3> lo;
+    std::array<std::size_t, 3> hi;
+    // Divisor of the average
+    std::size_t size;
+
+    window(const problem& pb, const std::array<std::size_t, 3>& o)
+    {
+        std::size_t clamped = 1;
+        std::size_t full    = 1;
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+            start[i] = static_cast<int>(o[i]) * pb.stride[i] - pb.pad[i];
+            lo[i]    = static_cast<std::size_t>(std::max(start[i], 0));
+            hi[i]    = std::min<std::size_t>(std::max(start[i] + pb.kernel[i], 0), pb.in[i]);
+            hi[i]    = std::max(hi[i], lo[i]);
+            clamped *= std::max<std::size_t>(hi[i] - lo[i], 1);
+            full *= pb.kernel[i];
+        }
+        size = pb.mode == miopenPoolingAverageInclusive ? full : clamped;
+    }
+
+    std::size_t index(const problem& pb, std::size_t d, std::size_t h, std::size_t w) const
+    {
+        if(pb.image_index)
+            return (d * pb.in[1] + h) * pb.in[2] + w;
+        const auto kd = static_cast<int>(d) - start[0];
+        const auto kh = static_cast<int>(h) - start[1];
+        const auto kw = static_cast<int>(w) - start[2];
+        return static_cast<std::size_t>((kd * pb.kernel[1] + kh) * pb.kernel[2] + kw);
+    }
+
+    template <class F>
+    void for_each(F f) const
+    {
+        for(auto d = lo[0]; d < hi[0]; ++d)
+            for(auto h = lo[1]; h < hi[1]; ++h)
+                for(auto w = lo[2]; w < hi[2]; ++w)
+                    f(d, h, w);
+    }
+};
+
+template <class F>
+void for_each_output(const problem& pb, std::size_t plane, F f)
+{
+    for(std::size_t d = 0; d < pb.out[0]; ++d)
+        for(std::size_t h = 0; h < pb.out[1]; ++h)
+            for(std::size_t w = 0; w < pb.out[2]; ++w)
+                f(window{pb, {{d, h, w}}}, pb.out_offset(plane, d, h, w));
+}
+
+// indices may be null, it is only written by max pooling.
+template <class T, class Index>
+void forward(const problem& pb, const T* x, T* y, Index* indices)
+{
+    const auto max = pb.mode == miopenPoolingMax;
+    par_for(pb.n * pb.c, [&](std::size_t plane) {
+        const auto pooled = pool_plane(pb, plane, x, max);
+        std::size_t o     = 0;
+        for_each_output(pb, plane, [&](const window& win, std::size_t out) {
+            const auto v = pooled.values[o];
+            if(max)
+            {
+                // A window without a value above the lowest double has no maximum.
+                const auto found = v > std::numeric_limits<double>::lowest();
+                y[out]           = static_cast<T>(found ? v : 0);
+                if(indices != nullptr)
+                {
+                    const auto arg = pooled.args[o];
+                    indices[out]   = static_cast<Index>(
+                        found ? win.index(pb,
+                                          arg / (pb.in[1] * pb.in[2]),
+                                          arg / pb.in[2] % pb.in[1],
+                                          arg % pb.in[2])
+                              : 0);
+                }
+            }
+            else
+            {
+                y[out] = static_cast<T>(v / win.size);
+            }
+            ++o;
+        });
+    });
+}
+
+// Max pooling needs the indices saved by forward.
+template <class T, class Index>
+void backward(const problem& pb, const T* dy, T* dx, const Index* indices)
+{
+    par_for(pb.n * pb.c, [&](std::size_t plane) {
+        std::vector<double> acc(pb.in[0] * pb.in[1] * pb.in[2]);
+        const auto at = [&](std::size_t d, std::size_t h, std::size_t w) -> double& {
+            return acc[(d * pb.in[1] + h) * pb.in[2] + w];
+        };
+
+        for_each_output(pb, plane, [&](const window& win, std::size_t out) {
+            const auto g = static_cast<double>(dy[out]);
+            if(pb.mode == miopenPoolingMax)
+            {
+                const auto idx = static_cast<std::size_t>(indices[out]);
+                if(pb.image_index)
+                {
+                    at(idx / (pb.in[1] * pb.in[2]), idx / pb.in[2] % pb.in[1], idx % pb.in[2]) +=
+                        g;
+                    return;
+                }
+                const auto d = win.start[0] + static_cast<int>(idx / (pb.kernel[1] * pb.kernel[2]));
+                const auto h = win.start[1] + static_cast<int>(idx / pb.kernel[2] % pb.kernel[1]);
+                const auto w = win.start[2] + static_cast<int>(idx % pb.kernel[2]);
+                if(d >= 0 && h >= 0 && w >= 0 && d < static_cast<int>(pb.in[0]) &&
+                   h < static_cast<int>(pb.in[1]) && w < static_cast<int>(pb.in[2]))
+                    at(d, h, w) += g;
+            }
+            else
+            {
+                const auto share = g / win.size;
+                win.for_each(
+                    [&](std::size_t d, std::size_t h, std::size_t w) { at(d, h, w) += share; });
+            }
+        });
+
+        for(std::size_t d = 0; d < pb.in[0]; ++d)
+            for(std::size_t h = 0; h < pb.in[1]; ++h)
+                for(std::size_t w = 0; w < pb.in[2]; ++w)
+                    dx[pb.in_offset(plane, d, h, w)] = static_cast<T>(at(d, h, w));
+    });
+}
+
+} // namespace cpu_pooling
+
+#endif // GUARD_CPU_POOLING_HPP
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_REDUCE_HPP
+#define GUARD_CPU_REDUCE_HPP
+
+// Tensor reduction on the host. A plan splits the dimensions once into the
+// invariant ones (kept in the output) and the reduced ones, with their
+// strides, so no index vector is built per element. The reduced space of each
+// output is walked in blocks of consecutive points, the innermost reduced
+// dimension as a plain strided loop. Blocks of all outputs run in parallel and
+// the partial results of an output are merged pairwise, left to right. Outputs
+// with fewer points than a block are grouped into one task instead.
+//
+// The operation is given as step(acc, value, index), which folds one element
+// of flat index `index` (row major over the reduced dimensions) into acc. A
+// partial result is folded into the one on its left the same way, which keeps
+// the first index of the extremum and the last index of a NaN, as a
+// sequential pass would.
+
+#include <miopen/par_for.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace cpu_reduce {
+
+// Reduced points folded in sequence before the pairwise merge.
+constexpr std::size_t block = 1024;
+
+struct space
+{
+    std::vector<std::size_t> lens;
+    std::vector<std::size_t> strides;
+
+    std::size_t size() const
+    {
+        return std::accumulate(
+            lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>());
+    }
+};
+
+struct plan
+{
+    space invariant;
+    // Offsets of the invariant points in the output
+    std::vector<std::size_t> out_strides;
+    space reduced;
+};
+
+// Dimensions whose output length differs from the input one are reduced.
+template <class Int>
+plan make_plan(const std::vector<Int>& in_lens,
+               const std::vector<Int>& in_strides,
+               const std::vector<Int>& out_lens,
+               const std::vector<Int>& out_strides)
+{
+    plan p;
+    for(std::size_t d = 0; d < in_lens.size(); ++d)
+    {
+        if(in_lens[d] == 1)
+            continue;
+        auto& s = in_lens[d] == out_lens[d] ? p.invariant : p.reduced;
+        s.lens.push_back(in_lens[d]);
+        s.strides.push_back(in_strides[d]);
+        if(in_lens[d] == out_lens[d])
+            p.out_strides.push_back(out_strides[d]);
+    }
+    return p;
+}
+
+// Offset with the given strides of the flat position i (row major) of s.
+inline std::size_t
+offset_of(const space& s, const std::vector<std::size_t>& strides, std::size_t i)
+{
+    std::size_t offset = 0;
+    for(auto d = s.lens.size(); d-- > 0;)
+    {
+        offset += i % s.lens[d] * strides[d];
+        i /= s.lens[d];
+    }
+    return offset;
+}
+
+// Calls f(flat index, offset) for the points [first, last) of s in order. idx
+// is scratch space, kept by the caller across calls.
+template <class F>
+void for_each_point(
+    const space& s, std::size_t first, std::size_t last, std::vector<std::size_t>& idx, F f)
+{
+    if(s.lens.empty())
+    {
+        if(first < last)
+            f(0, 0);
+        return;
+    }
+    idx.resize(s.lens.size());
+    auto rest = first;
+    for(auto d = s.lens.size(); d-- > 0;)
+    {
+        idx[d] = rest % s.lens[d];
+        rest /= s.lens[d];
+    }
+    auto offset       = offset_of(s, s.strides, first);
+    const auto inner  = s.lens.size() - 1;
+    const auto stride = s.strides[inner];
+    for(auto i = first; i < last;)
+    {
+        const auto run = std::min(last - i, s.lens[inner] - idx[inner]);
+        for(std::size_t j = 0; j < run; ++j)
+            f(i + j, offset + j * stride);
+        i += run;
+        offset += run * stride;
+        idx[inner] += run;
+        // Carry into the outer dimensions
+        for(auto d = inner; d > 0 && idx[d] == s.lens[d]; --d)
+        {
+            offset -= idx[d] * s.strides[d];
+            idx[d] = 0;
+            ++idx[d - 1];
+            offset += s.strides[d - 1];
+        }
+    }
+}
+
+template <class T>
+struct partial
+{
+    T value;
+    int index;
+};
+
+// Calls store(output offset, partial) once per invariant point, with the
+// reduction of load(input offset) over the reduced points.
+template <class T, class Load, class Step, class Store>
+void run(const plan& p, T init, Load load, Step step, Store store)
+{
+    const auto outputs = p.invariant.size();
+    const auto points  = p.reduced.size();
+    const auto blocks  = std::max<std::size_t>(1, (points + block - 1) / block);
+    const auto items   = outputs * blocks;
+    // Outputs of few points are grouped, a task still folds about a block.
+    const auto group =
+        blocks > 1 ? 1 : std::max<std::size_t>(1, block / std::max<std::size_t>(1, points));
+
+    std::vector<partial<T>> partials(items, partial<T>{init, 0});
+    miopen::par_for_dynamic(
+        (items + group - 1) / group,
+        miopen::max_threads{std::thread::hardware_concurrency()},
+        [&](std::size_t task) {
+            std::vector<std::size_t> idx;
+            for(auto item = task * group; item < std::min(items, (task + 1) * group); ++item)
+            {
+                const auto base  = offset_of(p.invariant, p.invariant.strides, item / blocks);
+                const auto first = item % blocks * block;
+                auto& acc        = partials[item];
+                for_each_point(p.reduced,
+                               first,
+                               std::min(points, first + block),
+                               idx,
+                               [&](std::size_t i, std::size_t offset) {
+                                   step(acc, load(base + offset), static_cast<int>(i));
+                               });
+            }
+        });
+
+    miopen::par_for(outputs, [&](std::size_t out) {
+        auto* part = partials.data() + out * blocks;
+        for(std::size_t width = 1; width < blocks; width *= 2)
+            for(std::size_t i = 0; i + width < blocks; i += 2 * width)
+                step(part[i], part[i + width].value, part[i + width].index);
+        store(offset_of(p.invariant, p.out_strides, out), part[0]);
+    });
+}
+
+} // namespace cpu_reduce
+
+#endif // GUARD_CPU_REDUCE_HPP
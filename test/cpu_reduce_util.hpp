@@ -214,7 +214,7 @@ inline bool float_equal_zero<half_float::half>(half_float::half x)
 
 template <typename compType>
 static inline void binop_with_nan_check(miopenNanPropagation_t nanOpt,
-                                        std::function<void(compType&, compType)> opReduce,
+                                        const std::function<void(compType&, compType)>& opReduce,
                                         compType& accuVal,
                                         compType currVal)
 {
@@ -230,12 +230,13 @@ static inline void binop_with_nan_check(miopenNanPropagation_t nanOpt,
 };
 
 template <typename compType>
-static inline void binop_with_nan_check2(miopenNanPropagation_t nanOpt,
-                                         std::function<void(compType&, compType, bool&)> opReduce,
-                                         compType& accuVal,
-                                         compType currVal,
-                                         int& accuIndex,
-                                         int currIndex)
+static inline void
+binop_with_nan_check2(miopenNanPropagation_t nanOpt,
+                      const std::function<void(compType&, compType, bool&)>& opReduce,
+                      compType& accuVal,
+                      compType currVal,
+                      int& accuIndex,
+                      int currIndex)
 {
     if(nanOpt == MIOPEN_NOT_PROPAGATE_NAN)
     {
@@ -0,0 +1,199 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_CPU_SOFTMAX_HPP
+#define GUARD_CPU_SOFTMAX_HPP
+
+// Softmax on the host for N x C x H x W data with any strides, in double.
+// Instance mode normalizes over C x H x W for each image, channel mode over C
+// for each pixel. Channel mode works on blocks of pixels so that the reductions
+// over the channels run along contiguous rows.
+
+#include <miopen/miopen.h>
+#include <miopen/par_for.hpp>
+
+#include "cpu_math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace cpu_softmax {
+
+// Pixels handled together in channel mode.
+constexpr std::size_t pixel_block = 64;
+
+struct view
+{
+    std::array<std::size_t, 4> lens;
+    std::array<std::size_t, 4> strides;
+
+    std::size_t offset(std::size_t n, std::size_t c, std::size_t s) const
+    {
+        return n * strides[0] + c * strides[1] + (s / lens[3]) * strides[2] +
+               (s % lens[3]) * strides[3];
+    }
+};
+
+template <class F>
+void par_for(std::size_t n, F f)
+{
+    miopen::par_for_dynamic(n, miopen::max_threads{std::thread::hardware_concurrency()}, f);
+}
+
+// Calls f(n, first pixel, pixel count) for each independent part of the problem.
+template <class F>
+void for_each_part(const view& v, miopenSoftmaxMode_t mode, F f)
+{
+    const auto pixels = v.lens[2] * v.lens[3];
+    if(pixels == 0)
+        return;
+    const auto block =
+        mode == MIOPEN_SOFTMAX_MODE_INSTANCE ? pixels : std::min(pixels, pixel_block);
+    const auto blocks = (pixels + block - 1) / block;
+    par_for(v.lens[0] * blocks, [&](std::size_t item) {
+        const auto first = item % blocks * block;
+        f(item / blocks, first, std::min(block, pixels - first));
+    });
+}
+
+template <class T>
+double blend(double alpha, double result, double beta, T old)
+{
+    // beta = 0 must not propagate NaNs from the uninitialized output
+    return beta == 0 ? alpha * result : alpha * result + beta * static_cast<double>(old);
+}
+
+template <class Tx, class Ty>
+void forward(miopenSoftmaxAlgorithm_t algorithm,
+             miopenSoftmaxMode_t mode,
+             const view& xv,
+             const Tx* x,
+             const view& yv,
+             Ty* y,
+             double alpha = 1,
+             double beta  = 0)
+{
+    const auto channels = xv.lens[1];
+    const bool instance = mode == MIOPEN_SOFTMAX_MODE_INSTANCE;
+    for_each_part(xv, mode, [&](std::size_t n, std::size_t first, std::size_t count) {
+        std::vector<double> v(channels * count);
+        for(std::size_t c = 0; c < channels; ++c)
+            for(std::size_t s = 0; s < count; ++s)
+                v[c * count + s] = static_cast<double>(x[xv.offset(n, c, first + s)]);
+
+        // One statistic for the whole image in instance mode, one per pixel otherwise
+        const auto stats = instance ? 1 : count;
+        const auto stat  = [&](std::size_t s) { return instance ? 0 : s; };
+        std::vector<double> max(stats, algorithm == MIOPEN_SOFTMAX_FAST
+                                           ? 0.0
+                                           : std::numeric_limits<double>::lowest());
+        std::vector<double> sum(stats, 0.0);
+        if(algorithm != MIOPEN_SOFTMAX_FAST)
+            for(std::size_t c = 0; c < channels; ++c)
+                for(std::size_t s = 0; s < count; ++s)
+                    max[stat(s)] = std::max(max[stat(s)], v[c * count + s]);
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            for(std::size_t s = 0; s < count; ++s)
+            {
+                auto& e = v[c * count + s];
+                e -= max[stat(s)];
+                const auto exp_e = cpu_math::exp(e);
+                sum[stat(s)] += exp_e;
+                if(algorithm != MIOPEN_SOFTMAX_LOG)
+                    e = exp_e;
+            }
+        }
+
+        if(algorithm == MIOPEN_SOFTMAX_LOG)
+            for(auto& s : sum)
+                s = cpu_math::log(s);
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            for(std::size_t s = 0; s < count; ++s)
+            {
+                const auto e      = v[c * count + s];
+                const auto result = algorithm == MIOPEN_SOFTMAX_LOG ? e - sum[stat(s)]
+                                                                    : e / sum[stat(s)];
+                auto& out = y[yv.offset(n, c, first + s)];
+                out       = static_cast<Ty>(blend(alpha, result, beta, out));
+            }
+        }
+    });
+}
+
+template <class Ty, class Tdx>
+void backward(miopenSoftmaxAlgorithm_t algorithm,
+              miopenSoftmaxMode_t mode,
+              const view& yv,
+              const Ty* y,
+              const view& dyv,
+              const Ty* dy,
+              const view& dxv,
+              Tdx* dx,
+              double alpha = 1,
+              double beta  = 0)
+{
+    const auto channels = yv.lens[1];
+    const bool instance = mode == MIOPEN_SOFTMAX_MODE_INSTANCE;
+    for_each_part(yv, mode, [&](std::size_t n, std::size_t first, std::size_t count) {
+        const auto stats = instance ? 1 : count;
+        const auto stat  = [&](std::size_t s) { return instance ? 0 : s; };
+        std::vector<double> dot(stats, 0.0);
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            for(std::size_t s = 0; s < count; ++s)
+            {
+                const auto d = static_cast<double>(dy[dyv.offset(n, c, first + s)]);
+                dot[stat(s)] += algorithm == MIOPEN_SOFTMAX_LOG
+                                    ? d
+                                    : d * static_cast<double>(y[yv.offset(n, c, first + s)]);
+            }
+        }
+
+        for(std::size_t c = 0; c < channels; ++c)
+        {
+            for(std::size_t s = 0; s < count; ++s)
+            {
+                const auto yy     = static_cast<double>(y[yv.offset(n, c, first + s)]);
+                const auto d      = static_cast<double>(dy[dyv.offset(n, c, first + s)]);
+                const auto result = algorithm == MIOPEN_SOFTMAX_LOG
+                                        ? d - dot[stat(s)] * cpu_math::exp(yy)
+                                        : (d - dot[stat(s)]) * yy;
+                auto& out = dx[dxv.offset(n, c, first + s)];
+                out       = static_cast<Tdx>(blend(alpha, result, beta, out));
+            }
+        }
+    });
+}
+
+} // namespace cpu_softmax
+
+#endif // GUARD_CPU_SOFTMAX_HPP
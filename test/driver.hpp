@@ -31,6 +31,7 @@
 #include "tensor_holder.hpp"
 #include "test.hpp"
 #include "verify.hpp"
+#include "verify_cache.hpp"
 
 #include <functional>
 #include <deque>
@@ -110,7 +111,24 @@ auto cpu_async(V& v, Ts&&... xs) -> std::future<decltype(v.cpu(xs...))>
     return std::async(std::launch::deferred, [&] { return v.cpu(xs...); });
 }
 
+// Waits for a future when leaving the scope, so that a task referring to the locals of the
+// scope ends before them, including when an exception leaves the scope.
+template <class T>
+struct wait_on_exit
+{
+    std::future<T>& f;
+    ~wait_on_exit()
+    {
+        if(f.valid())
+            f.wait();
+    }
+};
+
 MIOPEN_DECLARE_ENV_VAR(MIOPEN_VERIFY_CACHE_PATH)
+MIOPEN_DECLARE_ENV_VAR(MIOPEN_VERIFY_CACHE_SIZE)
+
+// Seed of std::rand() for every test configuration
+constexpr unsigned int test_seed = 65521;
 
 struct test_driver
 {
@@ -171,8 +189,9 @@ struct test_driver
     std::string program_name;
     std::deque<argument> arguments;
     std::unordered_map<std::string, std::size_t> argument_index;
-    int cache_version      = 1;
+    int cache_version      = 2;
     std::string cache_path = compute_cache_path();
+    int cache_size         = static_cast<int>(miopen::Value(MIOPEN_VERIFY_CACHE_SIZE{}, 8192));
     miopenDataType_t type  = miopenFloat;
     bool full_set          = false;
     bool verbose           = false;
@@ -210,6 +229,7 @@ struct test_driver
         v(rethrow, {"--rethrow"}, "Rethrow any exceptions found during verify");
         v(cache_path, {"--verification-cache", "-C"}, "Path to verification cache");
         v(disabled_cache, {"--disable-verification-cache"}, "Disable verification cache");
+        v(cache_size, {"--verification-cache-size"}, "Size limit of verification cache in MB");
         v(dry_run, {"--dry-run"}, "Dry run. Does not run the test, just prints the command.");
         v(config_iter_start,
           {"--config-iter-start", "-i"},
@@ -664,35 +684,51 @@ struct test_driver
         return boost::filesystem::exists(p);
     }
 
+    verify_cache::store get_verify_cache() const
+    {
+        return {boost::filesystem::path{miopen::ExpandUser(cache_path)} /
+                    std::to_string(cache_version),
+                static_cast<std::uintmax_t>(cache_size) * 1024 * 1024};
+    }
+
+    // Everything the cpu result depends on: the verified operation, the arguments
+    // its inputs are generated from and the seed of the generators.
+    template <class V, class Result>
+    std::string get_cache_key()
+    {
+        return miopen::get_type_name<V>() + "\n" + miopen::get_type_name<Result>() + "\n" +
+               get_command_args() + "\nseed " + std::to_string(test_seed);
+    }
+
+    /// Shared between the test binaries through the verification cache. The
+    /// lookup runs with the cpu computation, so miss is only set once the
+    /// result is ready. The task refers to miss, v and xs, the future must be
+    /// waited for before they go away.
     template <class V, class... Ts>
     auto run_cpu(bool retry, bool& miss, V& v, Ts&&... xs) -> std::future<decltype(v.cpu(xs...))>
     {
         using result_type = decltype(v.cpu(xs...));
+        miss              = true;
         if(is_cache_disabled() or not is_const_cpu(v, xs...))
             return cpu_async(v, xs...);
-        auto key = miopen::get_type_name<V>() + "-" + miopen::md5(get_command_args());
-        auto p =
-            boost::filesystem::path{miopen::ExpandUser(cache_path)} / std::to_string(cache_version);
-        if(!boost::filesystem::exists(p))
-            boost::filesystem::create_directories(p);
-        auto f = p / key;
-        if(boost::filesystem::exists(f) and not retry)
-        {
-            miss = false;
-            return detach_async([=] {
-                result_type result;
-                load(f.string(), result);
+        auto key   = get_cache_key<std::decay_t<V>, result_type>();
+        auto cache = get_verify_cache();
+        return detach_async([=, &miss, &v, &xs...] {
+            result_type result;
+            std::string data;
+            if(not retry and cache.read(key, data))
+            {
+                std::istringstream is{data};
+                serialize(is, result);
+                miss = false;
                 return result;
-            });
-        }
-        else
-        {
-            miss = true;
-            return then(cpu_async(v, xs...), [=](auto data) {
-                save(f.string(), data);
-                return data;
-            });
-        }
+            }
+            result = v.cpu(xs...);
+            std::ostringstream os;
+            serialize(os, result);
+            cache.write(key, os.str());
+            return result;
+        });
     }
 
     template <class V>
@@ -731,8 +767,9 @@ struct test_driver
         {
             auto&& h = get_handle();
             // Compute cpu
-            std::future<decltype(v.cpu(xs...))> cpuf;
             bool cache_miss = true;
+            std::future<decltype(v.cpu(xs...))> cpuf;
+            const wait_on_exit<decltype(v.cpu(xs...))> wait_cpu{cpuf};
             if(not no_validate)
             {
                 cpuf = run_cpu(false, cache_miss, v, xs...);
@@ -854,9 +891,9 @@ struct test_driver
             }
             else
             {
-                std::srand(65521);
+                std::srand(test_seed);
                 static_cast<Derived*>(this)->run();
-                std::srand(65521);
+                std::srand(test_seed);
             }
         }
         this->iteration++;
@@ -1030,10 +1067,10 @@ build_configs(Driver& d,
     std::vector<typename Driver::argument*> data_args = get_data_args<Driver>(d, arg_map);
 
     run_data(data_args.begin(), data_args.end(), [&] {
-        std::srand(65521);
+        std::srand(test_seed);
         std::vector<std::string> config = d.get_config();
         configs.push_back(config);
-        std::srand(65521);
+        std::srand(test_seed);
     });
     std::cout << " done." << std::endl;
     return configs;
@@ -1089,9 +1126,9 @@ void run_config(std::vector<std::string>& config,
     for(int j = 0; j < test_repeat_count; j++)
     {
         run_data(config_data_args.begin(), config_data_args.end(), [&] {
-            std::srand(65521);
+            std::srand(test_seed);
             config_driver.run();
-            std::srand(65521);
+            std::srand(test_seed);
         });
     }
 }
@@ -1232,7 +1269,7 @@ void test_drive_impl_1(std::string program_name, std::vector<std::string> as)
             data_args.push_back(&arg);
         }
     }
-    std::srand(65521);
+    std::srand(test_seed);
     for(int i = 0; i < d.repeat; i++)
     {
         d.iteration = 0;
@@ -0,0 +1,176 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// A compiled fusion plan keeps its kernel and bound arguments between executions: the
+// arguments must be bound again when they change, and the kernel must not be used through
+// another handle, even one reusing the address of the handle the plan was compiled with.
+
+#include "fusionHost.hpp"
+
+#include <miopen/manage_ptr.hpp>
+
+using ptr_FusionPlanDesc = MIOPEN_MANAGE_PTR(miopenFusionPlanDescriptor_t, miopenDestroyFusionPlan);
+using ptr_FusionPlanArgs = MIOPEN_MANAGE_PTR(miopenOperatorArgs_t, miopenDestroyOperatorArgs);
+
+struct bn_params
+{
+    tensor<float> scale;
+    tensor<float> bias;
+    tensor<float> mean;
+    tensor<float> variance;
+};
+
+static bn_params make_params(const miopen::TensorDescriptor& desc, int seed)
+{
+    const auto gen = [=](double offset) {
+        return [=](std::size_t, std::size_t c, std::size_t, std::size_t) {
+            return offset + 1e-2 * static_cast<double>((c * 37 + seed * 11) % 100);
+        };
+    };
+    return {tensor<float>{desc}.generate(gen(-0.5)),
+            tensor<float>{desc}.generate(gen(-0.25)),
+            tensor<float>{desc}.generate(gen(-0.1)),
+            tensor<float>{desc}.generate(gen(0.01))};
+}
+
+struct fusion_invoker_test
+{
+    const double epsilon = 1.0e-5;
+    tensor<float> input{2, 4, 8, 8};
+    miopen::TensorDescriptor bn_desc;
+    ptr_FusionPlanDesc plan;
+    miopenFusionOpDescriptor_t bn_op    = nullptr;
+    miopenFusionOpDescriptor_t activ_op = nullptr;
+    // Set again before each execution, as an application updating its arguments would.
+    ptr_FusionPlanArgs args;
+
+    fusion_invoker_test() : plan(nullptr), args(nullptr)
+    {
+        input.generate([](std::size_t n, std::size_t c, std::size_t h, std::size_t w) {
+            return 1e-2 * static_cast<double>((n * 613 + c * 547 + h * 701 + w * 877) % 200) -
+                   1.0;
+        });
+        miopen::DeriveBNTensorDescriptor(bn_desc, input.desc, miopenBNSpatial);
+
+        miopenFusionPlanDescriptor_t p;
+        miopenCreateFusionPlan(&p, miopenVerticalFusion, &input.desc);
+        plan = ptr_FusionPlanDesc{p};
+        miopenCreateOpBatchNormInference(plan.get(), &bn_op, miopenBNSpatial, &bn_desc);
+        miopenCreateOpActivationForward(plan.get(), &activ_op, miopenActivationRELU);
+
+        miopenOperatorArgs_t a;
+        miopenCreateOperatorArgs(&a);
+        args = ptr_FusionPlanArgs{a};
+    }
+
+    tensor<float> cpu(const bn_params& p) const
+    {
+        auto bn_out = input;
+        batchNormSpatialHostInference(input, bn_out, p.scale, p.bias, epsilon, p.mean, p.variance);
+        auto out = input;
+        activationHostInfer(miopenActivationRELU, 0.0, 0.0, 0.0, bn_out.data, out.data);
+        return out;
+    }
+
+    miopenStatus_t execute(miopen::Handle& handle, const bn_params& p, tensor<float>& out)
+    {
+        out               = input;
+        auto in_dev       = handle.Write(input.data);
+        auto out_dev      = handle.Write(out.data);
+        auto scale_dev    = handle.Write(p.scale.data);
+        auto bias_dev     = handle.Write(p.bias.data);
+        auto mean_dev     = handle.Write(p.mean.data);
+        auto variance_dev = handle.Write(p.variance.data);
+
+        const float alpha = 1.0f;
+        const float beta  = 0.0f;
+        miopenSetOpArgsBatchNormInference(args.get(),
+                                          bn_op,
+                                          &alpha,
+                                          &beta,
+                                          scale_dev.get(),
+                                          bias_dev.get(),
+                                          mean_dev.get(),
+                                          variance_dev.get(),
+                                          epsilon);
+        miopenSetOpArgsActivForward(args.get(), activ_op, &alpha, &beta, 0.0, 0.0, 0.0);
+        const auto status = miopenExecuteFusionPlan(&handle,
+                                                    plan.get(),
+                                                    &input.desc,
+                                                    in_dev.get(),
+                                                    &input.desc,
+                                                    out_dev.get(),
+                                                    args.get());
+        out.data = handle.Read<float>(out_dev, out.data.size());
+        return status;
+    }
+
+    void check(const std::string& what, miopen::Handle& handle, const bn_params& p)
+    {
+        tensor<float> out;
+        EXPECT(execute(handle, p, out) == miopenStatusSuccess);
+        const auto error = miopen::rms_range(cpu(p).data, out.data);
+        if(!(error < 1e-5))
+        {
+            std::cout << what << ": rms error " << error << std::endl;
+            EXPECT(error < 1e-5);
+        }
+    }
+
+    void run()
+    {
+        auto&& handle = get_handle();
+        if(miopenCompileFusionPlan(&handle, plan.get()) != miopenStatusSuccess)
+        {
+            std::cout << "BatchNorm+Activation Inference plan not supported." << std::endl;
+            return;
+        }
+        const auto params1 = make_params(bn_desc, 1);
+        const auto params2 = make_params(bn_desc, 2);
+
+        check("First execution", handle, params1);
+        check("Execution with new arguments", handle, params2);
+        check("Execution with the first arguments again", handle, params1);
+
+        {
+            // The plan is bound to the kernel of this handle until compiled again.
+            miopen::Handle other;
+            EXPECT(miopenCompileFusionPlan(&other, plan.get()) == miopenStatusSuccess);
+            check("Execution on a second handle", other, params2);
+            check("Execution on the first handle after the second", handle, params1);
+        }
+        // The new handle may get the address of the destroyed one, the plan must not run
+        // the kernel of the destroyed handle through it.
+        miopen::Handle recreated;
+        tensor<float> out;
+        EXPECT(execute(recreated, params2, out) != miopenStatusSuccess);
+        EXPECT(miopenCompileFusionPlan(&recreated, plan.get()) == miopenStatusSuccess);
+        check("Execution on a recreated handle", recreated, params2);
+        check("Execution on the first handle after the recreated", handle, params1);
+    }
+};
+
+int main() { run_test<fusion_invoker_test>(); }
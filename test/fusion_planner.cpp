@@ -0,0 +1,238 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the partitions of the fusion planner: every node in one group, the
+// groups in dependency order, the fused groups supported plans of one chain,
+// and the least traffic of all the partitions of the chains into runs.
+
+#include <miopen/convolution.hpp>
+#include <miopen/fusion_planner.hpp>
+
+#include "get_handle.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using node_list = std::vector<miopen::FusionGraphNode>;
+
+static std::shared_ptr<miopen::FusionOpDescriptor> conv(std::size_t c, std::size_t k)
+{
+    miopen::ConvolutionDescriptor conv_desc({1, 1}, {1, 1}, {1, 1});
+    miopen::TensorDescriptor filter{miopenFloat, {k, c, 3, 3}};
+    return std::make_shared<miopen::ConvForwardOpDescriptor>(conv_desc, filter);
+}
+
+static std::shared_ptr<miopen::FusionOpDescriptor> bias(std::size_t k)
+{
+    return std::make_shared<miopen::BiasFusionOpDescriptor>(
+        miopen::TensorDescriptor{miopenFloat, {1, k, 1, 1}});
+}
+
+static std::shared_ptr<miopen::FusionOpDescriptor> bn(std::size_t k)
+{
+    return std::make_shared<miopen::BatchNormInferenceFusionOpDescriptor>(
+        miopenBNSpatial, miopen::TensorDescriptor{miopenFloat, {1, k, 1, 1}});
+}
+
+static std::shared_ptr<miopen::FusionOpDescriptor> relu()
+{
+    return std::make_shared<miopen::ActivFwdFusionOpDescriptor>(miopenActivationRELU);
+}
+
+static miopen::FusionGraphNode after(int input, std::shared_ptr<miopen::FusionOpDescriptor> op)
+{
+    return {std::move(op), input, {}};
+}
+
+static bool fuses(const node_list& nodes,
+                  const std::vector<int>& run,
+                  const miopen::TensorDescriptor& input)
+{
+    auto&& handle = get_handle();
+    miopen::FusionPlanDescriptor plan{miopenVerticalFusion, input};
+    for(auto n : run)
+    {
+        try
+        {
+            if(plan.AddOp(nodes[n].op) != miopenStatusSuccess)
+                return false;
+        }
+        catch(const miopen::Exception&)
+        {
+            return false;
+        }
+    }
+    return plan.isSupported(handle);
+}
+
+// Tries every split of every chain into runs.
+static std::size_t brute_force_traffic(const node_list& nodes)
+{
+    std::vector<miopen::TensorDescriptor> in(nodes.size());
+    std::vector<miopen::TensorDescriptor> out(nodes.size());
+    std::vector<int> consumers(nodes.size(), 0);
+    std::vector<int> next(nodes.size(), -1);
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        const auto input = nodes[i].input;
+        in[i]            = input >= 0 ? out[input] : nodes[i].input_desc;
+        nodes[i].op->SetInputDesc(in[i]);
+        nodes[i].op->GetOutputDesc(out[i]);
+        if(input >= 0)
+        {
+            consumers[input]++;
+            next[input] = static_cast<int>(i);
+        }
+    }
+
+    std::size_t total = 0;
+    for(std::size_t i = 0; i < nodes.size(); i++)
+    {
+        if(nodes[i].input >= 0 && consumers[nodes[i].input] == 1)
+            continue;
+        std::vector<int> chain = {static_cast<int>(i)};
+        while(consumers[chain.back()] == 1)
+            chain.push_back(next[chain.back()]);
+
+        auto best = std::numeric_limits<std::size_t>::max();
+        // Bit j of cuts ends a run after chain[j]
+        for(std::size_t cuts = 0; cuts < (std::size_t{1} << (chain.size() - 1)); cuts++)
+        {
+            std::size_t traffic = 0;
+            std::size_t first   = 0;
+            for(std::size_t j = 0; j < chain.size(); j++)
+            {
+                if(j + 1 < chain.size() && (cuts & (std::size_t{1} << j)) == 0)
+                    continue;
+                const std::vector<int> run(chain.begin() + first, chain.begin() + j + 1);
+                if(run.size() > 1 && !fuses(nodes, run, in[run.front()]))
+                {
+                    traffic = std::numeric_limits<std::size_t>::max();
+                    break;
+                }
+                traffic += in[run.front()].GetNumBytes() + out[run.back()].GetNumBytes();
+                first = j + 1;
+            }
+            best = std::min(best, traffic);
+        }
+        total += best;
+    }
+    return total;
+}
+
+static std::vector<miopen::FusionGroup> check_partition(const node_list& nodes)
+{
+    auto&& handle      = get_handle();
+    const auto optimal = brute_force_traffic(nodes);
+    const auto groups  = miopen::PlanFusion(handle, nodes);
+
+    std::vector<int> group_of(nodes.size(), -1);
+    std::vector<int> consumers(nodes.size(), 0);
+    std::size_t unfused_traffic = 0;
+    std::size_t traffic         = 0;
+    for(const auto& node : nodes)
+    {
+        if(node.input >= 0)
+            consumers[node.input]++;
+        miopen::TensorDescriptor out;
+        node.op->GetOutputDesc(out);
+        unfused_traffic += node.op->input_desc.GetNumBytes() + out.GetNumBytes();
+    }
+
+    for(std::size_t g = 0; g < groups.size(); g++)
+    {
+        const auto& group = groups[g];
+        EXPECT(!group.nodes.empty());
+        EXPECT((group.plan != nullptr) == (group.nodes.size() > 1));
+        if(group.plan != nullptr)
+            EXPECT(group.plan->isSupported(handle));
+        traffic += group.traffic;
+        for(std::size_t i = 0; i < group.nodes.size(); i++)
+        {
+            const auto n = group.nodes[i];
+            EXPECT(group_of[n] == -1);
+            group_of[n]      = static_cast<int>(g);
+            const auto input = nodes[n].input;
+            if(i > 0)
+            {
+                // Runs of a chain only
+                EXPECT(input == group.nodes[i - 1]);
+                EXPECT(consumers[input] == 1);
+            }
+            else if(input >= 0)
+            {
+                // Producers run first
+                EXPECT(group_of[input] >= 0 && group_of[input] < static_cast<int>(g));
+            }
+        }
+    }
+    for(auto g : group_of)
+        EXPECT(g >= 0);
+    EXPECT(traffic <= unfused_traffic);
+    EXPECT(traffic == optimal);
+    return groups;
+}
+
+int main()
+{
+    const miopen::TensorDescriptor input{miopenFloat, {2, 16, 14, 14}};
+
+    // Conv, bias and activation run as one plan when the device has a kernel for it
+    {
+        const node_list nodes = {{conv(16, 32), -1, input}, after(0, bias(32)), after(1, relu())};
+        const auto supported  = fuses(nodes, {0, 1, 2}, input);
+        const auto groups     = check_partition(nodes);
+        if(supported)
+        {
+            EXPECT(groups.size() == 1);
+            EXPECT(groups.front().plan != nullptr);
+        }
+    }
+
+    // Conv, bias, activation and batch norm, activation
+    check_partition({{conv(16, 32), -1, input},
+                     after(0, bias(32)),
+                     after(1, relu()),
+                     after(2, bn(32)),
+                     after(3, relu())});
+
+    // The activation output feeds two branches
+    check_partition({{conv(16, 16), -1, input},
+                     after(0, relu()),
+                     after(1, conv(16, 16)),
+                     after(2, bias(16)),
+                     after(1, bn(16)),
+                     after(4, relu())});
+
+    // Operators that cannot lead a plan
+    check_partition({{relu(), -1, input}, after(0, bias(16)), after(1, bn(16))});
+
+    EXPECT(throws([] {
+        auto&& handle = get_handle();
+        miopen::PlanFusion(handle, {after(1, relu()), after(0, relu())});
+    }));
+}
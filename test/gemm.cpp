@@ -0,0 +1,128 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the blocked host GEMM against the definition for every transpose
+// combination. Small integer data makes both exact.
+
+#include "test.hpp"
+#include "gemm.hpp"
+
+#include <cstddef>
+#include <vector>
+
+static std::vector<float> make_matrix(std::size_t rows, std::size_t ld, std::size_t seed)
+{
+    std::vector<float> m(rows * ld);
+    for(std::size_t i = 0; i < m.size(); ++i)
+        m[i] = static_cast<float>((i * 31 + seed) % 7) - 3;
+    return m;
+}
+
+static void check_case(bool trans_a,
+                       bool trans_b,
+                       std::size_t m,
+                       std::size_t n,
+                       std::size_t k,
+                       double alpha,
+                       double beta)
+{
+    // Leading dimensions larger than the rows to catch stride mixups.
+    const auto lda = (trans_a ? m : k) + 3;
+    const auto ldb = (trans_b ? k : n) + 1;
+    const auto ldc = n + 2;
+    const auto a   = make_matrix(trans_a ? k : m, lda, 1);
+    const auto b   = make_matrix(trans_b ? n : k, ldb, 2);
+    auto c_ref     = make_matrix(m, ldc, 3);
+    auto c_res     = c_ref;
+
+    for(std::size_t i = 0; i < m; ++i)
+    {
+        for(std::size_t j = 0; j < n; ++j)
+        {
+            double x = 0;
+            for(std::size_t p = 0; p < k; ++p)
+                x += (trans_a ? a[p * lda + i] : a[i * lda + p]) *
+                     (trans_b ? b[j * ldb + p] : b[p * ldb + j]);
+            auto& y = c_ref[i * ldc + j];
+            y       = static_cast<float>(beta * y + alpha * x);
+        }
+    }
+
+    cpu_gemm::gemm(
+        trans_a, trans_b, m, n, k, alpha, a.data(), lda, b.data(), ldb, beta, c_res.data(), ldc);
+    EXPECT(c_ref == c_res);
+
+    cpu_gemm::gemm<float>(
+        trans_a, trans_b, m, n, k, alpha, a.data(), lda, b.data(), ldb, 0, c_res.data(), ldc);
+    cpu_gemm::gemm<float>(
+        trans_a, trans_b, m, n, k, 0, a.data(), lda, b.data(), ldb, 1, c_res.data(), ldc);
+    std::vector<float> c_twice = c_res;
+    cpu_gemm::gemm<float>(
+        trans_a, trans_b, m, n, k, alpha, a.data(), lda, b.data(), ldb, 1, c_twice.data(), ldc);
+    for(std::size_t i = 0; i < m; ++i)
+        for(std::size_t j = 0; j < n; ++j)
+            EXPECT(c_twice[i * ldc + j] == 2 * c_res[i * ldc + j]);
+}
+
+int main()
+{
+    for(auto trans_a : {false, true})
+    {
+        for(auto trans_b : {false, true})
+        {
+            // Smaller than a register block
+            check_case(trans_a, trans_b, 3, 5, 7, 1, 0);
+            // Partial tiles in every dimension, more than one k step
+            check_case(trans_a, trans_b, 67, 131, 300, 2, 1);
+            check_case(trans_a, trans_b, 17, 268, 67, 1, -1);
+            // Large enough to run on several threads
+            check_case(trans_a, trans_b, 130, 260, 40, -1, 2);
+            // Empty reduction scales C only
+            check_case(trans_a, trans_b, 9, 10, 0, 1, 3);
+        }
+    }
+
+    // The accessor interface
+    const std::size_t m = 37;
+    const std::size_t n = 45;
+    const std::size_t k = 29;
+    const auto a        = make_matrix(m, k, 4);
+    const auto b        = make_matrix(k, n, 5);
+    std::vector<double> c(m * n);
+    gemm(m, n, k, with_stride(a.data(), k), with_stride(b.data(), n), [&](int i, int j, double x) {
+        c[i * n + j] = x;
+    });
+    for(std::size_t i = 0; i < m; ++i)
+    {
+        for(std::size_t j = 0; j < n; ++j)
+        {
+            double x = 0;
+            for(std::size_t p = 0; p < k; ++p)
+                x += a[i * k + p] * b[p * n + j];
+            EXPECT(c[i * n + j] == x);
+        }
+    }
+}
@@ -29,22 +29,140 @@
 #include "ford.hpp"
 #include <miopen/returns.hpp>
 
-template <class AF, class BF, class CF>
-void gemm(std::size_t n, std::size_t m, std::size_t k, AF a, BF b, CF c)
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Cache blocked GEMM on the host. Both operands are packed once into panels of
+// the accumulation type, zero padded to the register block, and the output is
+// computed in mc x nc tiles, kc steps at a time, by an mr x nr register kernel.
+namespace cpu_gemm {
+
+constexpr std::size_t mr = 4;
+constexpr std::size_t nr = 4;
+constexpr std::size_t mc = 64;
+constexpr std::size_t nc = 128;
+constexpr std::size_t kc = 256;
+
+// Below this many multiply-adds starting the threads costs more than it saves.
+constexpr std::size_t min_parallel_work = std::size_t{1} << 18;
+
+template <class F>
+void par_for(std::size_t n, bool parallel, F f)
 {
-    auto inner_loop = [&](int i, int j) {
-        double x = 0.0;
-        ford(k)([&](int kk) { x += a(i, kk) * b(kk, j); });
-        c(i, j, x);
-    };
-    if(n * m > 32)
-    {
-        par_ford(n, m)(inner_loop);
-    }
-    else
+    miopen::par_for_dynamic(
+        n, miopen::max_threads{parallel ? std::thread::hardware_concurrency() : 1}, f);
+}
+
+// c[i * ldc + j] += sum(a[p * mr + i] * b[p * nr + j]) over p < kb
+template <class Tacc>
+void micro_kernel(std::size_t kb, const Tacc* a, const Tacc* b, Tacc* c, std::size_t ldc)
+{
+    Tacc r[mr][nr] = {};
+    for(std::size_t p = 0; p < kb; ++p)
     {
-        ford(n, m)(inner_loop);
+        for(std::size_t i = 0; i < mr; ++i)
+        {
+            const auto ai = a[p * mr + i];
+            for(std::size_t j = 0; j < nr; ++j)
+                r[i][j] += ai * b[p * nr + j];
+        }
     }
+    for(std::size_t i = 0; i < mr; ++i)
+        for(std::size_t j = 0; j < nr; ++j)
+            c[i * ldc + j] += r[i][j];
+}
+
+// Computes x(i, j) = sum(a(i, p) * b(p, j)) over p < k for i < m, j < n and
+// calls c(i, j, x) once for each of them.
+template <class Tacc, class AF, class BF, class CF>
+void run(std::size_t m, std::size_t n, std::size_t k, AF a, BF b, CF c)
+{
+    if(m == 0 || n == 0)
+        return;
+    const bool parallel = m * n * k >= min_parallel_work;
+    const auto m_panels = (m + mr - 1) / mr;
+    const auto n_panels = (n + nr - 1) / nr;
+
+    std::vector<Tacc> pa(m_panels * mr * k);
+    std::vector<Tacc> pb(n_panels * nr * k);
+    par_for(m_panels, parallel, [&](std::size_t ip) {
+        auto* dst = &pa[ip * mr * k];
+        for(std::size_t p = 0; p < k; ++p)
+            for(std::size_t r = 0; r < mr; ++r)
+                dst[p * mr + r] = ip * mr + r < m ? Tacc(a(ip * mr + r, p)) : Tacc(0);
+    });
+    par_for(n_panels, parallel, [&](std::size_t jp) {
+        auto* dst = &pb[jp * nr * k];
+        for(std::size_t p = 0; p < k; ++p)
+            for(std::size_t r = 0; r < nr; ++r)
+                dst[p * nr + r] = jp * nr + r < n ? Tacc(b(p, jp * nr + r)) : Tacc(0);
+    });
+
+    const auto m_tiles = (m + mc - 1) / mc;
+    const auto n_tiles = (n + nc - 1) / nc;
+    par_for(m_tiles * n_tiles, parallel, [&](std::size_t t) {
+        const auto i0 = (t / n_tiles) * mc;
+        const auto j0 = (t % n_tiles) * nc;
+        const auto mb = std::min(mc, m - i0);
+        const auto nb = std::min(nc, n - j0);
+
+        std::vector<Tacc> acc(mc * nc);
+        for(std::size_t p0 = 0; p0 < k; p0 += kc)
+        {
+            const auto kb = std::min(kc, k - p0);
+            for(std::size_t jr = 0; jr < nb; jr += nr)
+            {
+                const auto* b_panel = &pb[(j0 + jr) / nr * nr * k + p0 * nr];
+                for(std::size_t ir = 0; ir < mb; ir += mr)
+                {
+                    const auto* a_panel = &pa[(i0 + ir) / mr * mr * k + p0 * mr];
+                    micro_kernel(kb, a_panel, b_panel, &acc[ir * nc + jr], nc);
+                }
+            }
+        }
+        for(std::size_t i = 0; i < mb; ++i)
+            for(std::size_t j = 0; j < nb; ++j)
+                c(i0 + i, j0 + j, acc[i * nc + j]);
+    });
+}
+
+// C = alpha * op(A) * op(B) + beta * C with row major m x n C, where op(A) is m x k
+// and op(B) is k x n. A transposed operand is stored as its k x m (k x n) transpose.
+template <class Tacc = double, class T>
+void gemm(bool trans_a,
+          bool trans_b,
+          std::size_t m,
+          std::size_t n,
+          std::size_t k,
+          double alpha,
+          const T* a,
+          std::size_t lda,
+          const T* b,
+          std::size_t ldb,
+          double beta,
+          T* c,
+          std::size_t ldc)
+{
+    const auto op_a = [&](std::size_t i, std::size_t p) {
+        return trans_a ? a[p * lda + i] : a[i * lda + p];
+    };
+    const auto op_b = [&](std::size_t p, std::size_t j) {
+        return trans_b ? b[j * ldb + p] : b[p * ldb + j];
+    };
+    run<Tacc>(m, n, k, op_a, op_b, [&](std::size_t i, std::size_t j, Tacc x) {
+        auto& y = c[i * ldc + j];
+        y       = T(Tacc(beta) * Tacc(y) + Tacc(alpha) * x);
+    });
+}
+
+} // namespace cpu_gemm
+
+template <class AF, class BF, class CF>
+void gemm(std::size_t n, std::size_t m, std::size_t k, AF a, BF b, CF c)
+{
+    cpu_gemm::run<double>(n, m, k, a, b, c);
 }
 
 struct with_stride_impl
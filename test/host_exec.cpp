@@ -0,0 +1,750 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Runs the primitives which MIOPEN_NOGPU_HOST_EXECUTION=1 executes on the host
+// through the C API, and compares their results with the host references. Only
+// registered for the HIPNOGPU backend, with the variable set.
+
+#include <miopen/miopen.h>
+#include <miopen/activ.hpp>
+#include <miopen/convolution.hpp>
+#include <miopen/ctc.hpp>
+#include <miopen/handle.hpp>
+#include <miopen/lrn.hpp>
+#include <miopen/pooling.hpp>
+#include <miopen/tensor.hpp>
+
+#include "cpu_activ.hpp"
+#include "cpu_bn.hpp"
+#include "cpu_conv.hpp"
+#include "cpu_ctc.hpp"
+#include "cpu_pooling.hpp"
+#include "cpu_softmax.hpp"
+#include "tensor_holder.hpp"
+#include "test.hpp"
+#include "verify.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// The library runs the same references, only the dispatch can make a difference.
+constexpr double tolerance = 1e-6;
+
+struct host_exec_test
+{
+    miopenHandle_t handle{};
+    std::mt19937 gen{20210301};
+
+    host_exec_test() { EXPECT(miopenCreate(&handle) == miopenStatusSuccess); }
+    ~host_exec_test() { miopenDestroy(handle); }
+    host_exec_test(const host_exec_test&) = delete;
+    host_exec_test& operator=(const host_exec_test&) = delete;
+
+    miopen::Handle& h() const { return miopen::deref(handle); }
+
+    tensor<float> random(std::vector<std::size_t> lens, float lo = -2, float hi = 2)
+    {
+        auto t = tensor<float>{lens};
+        std::uniform_real_distribution<float> dist(lo, hi);
+        std::generate(t.data.begin(), t.data.end(), [&] { return dist(gen); });
+        return t;
+    }
+
+    auto write(const tensor<float>& t) const { return h().Write(t.data); }
+
+    void read(tensor<float>& t, const miopen::Allocator::ManageDataPtr& p) const
+    {
+        t.data = h().Read<float>(p, t.data.size());
+    }
+
+    static void
+    verify(const std::string& what, const tensor<float>& result, const tensor<float>& ref)
+    {
+        const auto error = miopen::rms_range(result.data, ref.data);
+        if(!(error <= tolerance))
+            std::cout << what << ":" << std::endl;
+        EXPECT_OP(error, <=, tolerance);
+    }
+
+    static cpu_softmax::view softmax_view(const miopen::TensorDescriptor& desc)
+    {
+        cpu_softmax::view v{};
+        std::copy_n(desc.GetLengths().begin(), 4, v.lens.begin());
+        std::copy_n(desc.GetStrides().begin(), 4, v.strides.begin());
+        return v;
+    }
+
+    void activation()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        for(auto mode : {miopenActivationRELU,
+                         miopenActivationLEAKYRELU,
+                         miopenActivationTANH,
+                         miopenActivationLOGISTIC,
+                         miopenActivationELU})
+        {
+            auto desc       = miopen::ActivationDescriptor{mode, 0.5, 0.75, 1.25};
+            const auto p    = cpu_activ::params{mode, 0.5, 0.75, 1.25};
+            auto x          = random({2, 3, 5, 7});
+            auto dy         = random({2, 3, 5, 7});
+            auto y          = tensor<float>{x.desc.GetLengths()};
+            auto dx         = tensor<float>{x.desc.GetLengths()};
+            auto x_dev      = write(x);
+            auto y_dev      = write(y);
+            auto dy_dev     = write(dy);
+            auto dx_dev     = write(dx);
+
+            STATUS(miopenActivationForward(
+                handle, &desc, &alpha, &x.desc, x_dev.get(), &beta, &y.desc, y_dev.get()));
+            read(y, y_dev);
+            auto y_ref = tensor<float>{x.desc.GetLengths()};
+            cpu_activ::forward(p, x.data.size(), x.data.data(), y_ref.data.data());
+            verify("activation forward " + std::to_string(mode), y, y_ref);
+
+            STATUS(miopenActivationBackward(handle,
+                                            &desc,
+                                            &alpha,
+                                            &y.desc,
+                                            y_dev.get(),
+                                            &dy.desc,
+                                            dy_dev.get(),
+                                            &x.desc,
+                                            x_dev.get(),
+                                            &beta,
+                                            &dx.desc,
+                                            dx_dev.get()));
+            read(dx, dx_dev);
+            auto dx_ref = tensor<float>{x.desc.GetLengths()};
+            cpu_activ::backward(
+                p, x.data.size(), dy.data.data(), x.data.data(), y.data.data(), dx_ref.data.data());
+            verify("activation backward " + std::to_string(mode), dx, dx_ref);
+        }
+    }
+
+    void softmax()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        for(auto algo : {MIOPEN_SOFTMAX_ACCURATE, MIOPEN_SOFTMAX_LOG})
+        {
+            for(auto mode : {MIOPEN_SOFTMAX_MODE_INSTANCE, MIOPEN_SOFTMAX_MODE_CHANNEL})
+            {
+                const auto what = "softmax " + std::to_string(algo) + " " + std::to_string(mode);
+                auto x          = random({2, 5, 3, 4});
+                auto dy         = random({2, 5, 3, 4});
+                auto y          = tensor<float>{x.desc.GetLengths()};
+                auto dx         = tensor<float>{x.desc.GetLengths()};
+                auto x_dev      = write(x);
+                auto y_dev      = write(y);
+                auto dy_dev     = write(dy);
+                auto dx_dev     = write(dx);
+                const auto v    = softmax_view(x.desc);
+
+                STATUS(miopenSoftmaxForward_V2(handle,
+                                               &alpha,
+                                               &x.desc,
+                                               x_dev.get(),
+                                               &beta,
+                                               &y.desc,
+                                               y_dev.get(),
+                                               algo,
+                                               mode));
+                read(y, y_dev);
+                auto y_ref = tensor<float>{x.desc.GetLengths()};
+                cpu_softmax::forward(algo, mode, v, x.data.data(), v, y_ref.data.data());
+                verify(what + " forward", y, y_ref);
+
+                STATUS(miopenSoftmaxBackward_V2(handle,
+                                                &alpha,
+                                                &y.desc,
+                                                y_dev.get(),
+                                                &dy.desc,
+                                                dy_dev.get(),
+                                                &beta,
+                                                &dx.desc,
+                                                dx_dev.get(),
+                                                algo,
+                                                mode));
+                read(dx, dx_dev);
+                auto dx_ref = tensor<float>{x.desc.GetLengths()};
+                cpu_softmax::backward(
+                    algo, mode, v, y.data.data(), v, dy.data.data(), v, dx_ref.data.data());
+                verify(what + " backward", dx, dx_ref);
+            }
+        }
+    }
+
+    void pooling()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        for(auto mode : {miopenPoolingMax, miopenPoolingAverage, miopenPoolingAverageInclusive})
+        {
+            const auto what = "pooling " + std::to_string(mode);
+            auto desc       = miopen::PoolingDescriptor{
+                mode, miopenPaddingDefault, std::vector<int>{3, 3}, {2, 2}, {1, 1}};
+            desc.SetIndexType(miopenIndexUint32);
+            auto x           = random({2, 3, 9, 8});
+            auto y           = tensor<float>{desc.GetForwardOutputTensor(x.desc)};
+            auto dy          = random(y.desc.GetLengths());
+            auto dx          = tensor<float>{x.desc.GetLengths()};
+            const bool max   = mode == miopenPoolingMax;
+            const auto ws_sz = max ? desc.GetWorkSpaceSize(y.desc) : 0;
+            auto x_dev       = write(x);
+            auto y_dev       = write(y);
+            auto dy_dev      = write(dy);
+            auto dx_dev      = write(dx);
+            auto ws_dev      = h().Create(ws_sz);
+
+            STATUS(miopenPoolingForward(handle,
+                                        &desc,
+                                        &alpha,
+                                        &x.desc,
+                                        x_dev.get(),
+                                        &beta,
+                                        &y.desc,
+                                        y_dev.get(),
+                                        max,
+                                        ws_dev.get(),
+                                        ws_sz));
+            read(y, y_dev);
+            const auto pb = cpu_pooling::make_problem(mode,
+                                                      x.desc.GetLengths(),
+                                                      x.desc.GetStrides(),
+                                                      y.desc.GetLengths(),
+                                                      y.desc.GetStrides(),
+                                                      desc.GetLengths(),
+                                                      desc.GetStrides(),
+                                                      desc.GetPads());
+            auto y_ref       = tensor<float>{y.desc.GetLengths()};
+            auto indices_ref = std::vector<std::uint32_t>(max ? y.data.size() : 0);
+            cpu_pooling::forward(
+                pb, x.data.data(), y_ref.data.data(), max ? indices_ref.data() : nullptr);
+            verify(what + " forward", y, y_ref);
+
+            STATUS(miopenPoolingBackward(handle,
+                                         &desc,
+                                         &alpha,
+                                         &y.desc,
+                                         y_dev.get(),
+                                         &dy.desc,
+                                         dy_dev.get(),
+                                         &x.desc,
+                                         x_dev.get(),
+                                         &beta,
+                                         &dx.desc,
+                                         dx_dev.get(),
+                                         ws_dev.get()));
+            read(dx, dx_dev);
+            auto dx_ref = tensor<float>{x.desc.GetLengths()};
+            cpu_pooling::backward(pb,
+                                  dy.data.data(),
+                                  dx_ref.data.data(),
+                                  max ? indices_ref.data() : nullptr);
+            verify(what + " backward", dx, dx_ref);
+        }
+    }
+
+    void batch_norm()
+    {
+        using T = float;
+
+        const float alpha    = 1;
+        const float beta     = 0;
+        const double epsilon = 1e-5;
+        const double exp_avg = 0.1;
+        const auto lens      = std::vector<std::size_t>{3, 4, 5, 6};
+        const auto shape     = cpu_bn::shape{lens[0], lens[1], lens[2] * lens[3]};
+        for(auto mode : {miopenBNSpatial, miopenBNPerActivation})
+        {
+            const bool spatial   = mode == miopenBNSpatial;
+            const auto what      = "batch norm " + std::to_string(mode);
+            const auto stat_lens = spatial ? std::vector<std::size_t>{1, lens[1], 1, 1}
+                                           : std::vector<std::size_t>{1, lens[1], lens[2], lens[3]};
+            const auto infer     = spatial ? cpu_bn::spatial_forward_infer<T, T, T, T>
+                                           : cpu_bn::per_activation_forward_infer<T, T, T, T>;
+            const auto train     = spatial ? cpu_bn::spatial_forward_train<T, T, T, T>
+                                           : cpu_bn::per_activation_forward_train<T, T, T, T>;
+            const auto backward  = spatial ? cpu_bn::spatial_backward<T, T, T, T, T>
+                                           : cpu_bn::per_activation_backward<T, T, T, T, T>;
+
+            auto x            = random(lens);
+            auto dy           = random(lens);
+            auto scale        = random(stat_lens, 0.5, 1.5);
+            auto bias         = random(stat_lens);
+            auto running_mean = random(stat_lens);
+            auto running_var  = random(stat_lens, 0.5, 1.5);
+            auto y            = tensor<float>{lens};
+            auto dx           = tensor<float>{lens};
+            auto save_mean    = tensor<float>{stat_lens};
+            auto save_inv_var = tensor<float>{stat_lens};
+            auto dscale       = tensor<float>{stat_lens};
+            auto dbias        = tensor<float>{stat_lens};
+
+            auto x_dev            = write(x);
+            auto dy_dev           = write(dy);
+            auto scale_dev        = write(scale);
+            auto bias_dev         = write(bias);
+            auto running_mean_dev = write(running_mean);
+            auto running_var_dev  = write(running_var);
+            auto y_dev            = write(y);
+            auto dx_dev           = write(dx);
+            auto save_mean_dev    = write(save_mean);
+            auto save_inv_var_dev = write(save_inv_var);
+            auto dscale_dev       = write(dscale);
+            auto dbias_dev        = write(dbias);
+
+            // Inference first, while the running statistics are the initial ones.
+            STATUS(miopenBatchNormalizationForwardInference(handle,
+                                                            mode,
+                                                            const_cast<float*>(&alpha),
+                                                            const_cast<float*>(&beta),
+                                                            &x.desc,
+                                                            x_dev.get(),
+                                                            &y.desc,
+                                                            y_dev.get(),
+                                                            &scale.desc,
+                                                            scale_dev.get(),
+                                                            bias_dev.get(),
+                                                            running_mean_dev.get(),
+                                                            running_var_dev.get(),
+                                                            epsilon));
+            read(y, y_dev);
+            auto y_ref = tensor<float>{lens};
+            infer(shape,
+                  x.data.data(),
+                  y_ref.data.data(),
+                  scale.data.data(),
+                  bias.data.data(),
+                  epsilon,
+                  running_mean.data.data(),
+                  running_var.data.data());
+            verify(what + " inference", y, y_ref);
+
+            STATUS(miopenBatchNormalizationForwardTraining(handle,
+                                                           mode,
+                                                           const_cast<float*>(&alpha),
+                                                           const_cast<float*>(&beta),
+                                                           &x.desc,
+                                                           x_dev.get(),
+                                                           &y.desc,
+                                                           y_dev.get(),
+                                                           &scale.desc,
+                                                           scale_dev.get(),
+                                                           bias_dev.get(),
+                                                           exp_avg,
+                                                           running_mean_dev.get(),
+                                                           running_var_dev.get(),
+                                                           epsilon,
+                                                           save_mean_dev.get(),
+                                                           save_inv_var_dev.get()));
+            read(y, y_dev);
+            auto running_mean_out = running_mean;
+            auto running_var_out  = running_var;
+            read(running_mean_out, running_mean_dev);
+            read(running_var_out, running_var_dev);
+            read(save_mean, save_mean_dev);
+            read(save_inv_var, save_inv_var_dev);
+            auto save_mean_ref    = tensor<float>{stat_lens};
+            auto save_inv_var_ref = tensor<float>{stat_lens};
+            train(shape,
+                  x.data.data(),
+                  y_ref.data.data(),
+                  scale.data.data(),
+                  bias.data.data(),
+                  epsilon,
+                  exp_avg,
+                  save_mean_ref.data.data(),
+                  save_inv_var_ref.data.data(),
+                  running_mean.data.data(),
+                  running_var.data.data());
+            verify(what + " training", y, y_ref);
+            verify(what + " running mean", running_mean_out, running_mean);
+            verify(what + " running variance", running_var_out, running_var);
+            verify(what + " saved mean", save_mean, save_mean_ref);
+            verify(what + " saved inverse variance", save_inv_var, save_inv_var_ref);
+
+            STATUS(miopenBatchNormalizationBackward(handle,
+                                                    mode,
+                                                    &alpha,
+                                                    &beta,
+                                                    &alpha,
+                                                    &beta,
+                                                    &x.desc,
+                                                    x_dev.get(),
+                                                    &dy.desc,
+                                                    dy_dev.get(),
+                                                    &dx.desc,
+                                                    dx_dev.get(),
+                                                    &scale.desc,
+                                                    scale_dev.get(),
+                                                    dscale_dev.get(),
+                                                    dbias_dev.get(),
+                                                    epsilon,
+                                                    save_mean_dev.get(),
+                                                    save_inv_var_dev.get()));
+            read(dx, dx_dev);
+            read(dscale, dscale_dev);
+            read(dbias, dbias_dev);
+            auto dx_ref     = tensor<float>{lens};
+            auto dscale_ref = tensor<float>{stat_lens};
+            auto dbias_ref  = tensor<float>{stat_lens};
+            backward(shape,
+                     x.data.data(),
+                     dy.data.data(),
+                     dx_ref.data.data(),
+                     scale.data.data(),
+                     dscale_ref.data.data(),
+                     dbias_ref.data.data(),
+                     epsilon,
+                     save_mean_ref.data.data(),
+                     save_inv_var_ref.data.data());
+            verify(what + " backward data", dx, dx_ref);
+            verify(what + " backward scale", dscale, dscale_ref);
+            verify(what + " backward bias", dbias, dbias_ref);
+        }
+    }
+
+    void convolution()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        auto conv         = miopen::ConvolutionDescriptor{{1, 1}, {2, 2}, {1, 1}};
+        auto x            = random({2, 3, 9, 10});
+        auto w            = random({4, 3, 3, 3});
+        auto y            = tensor<float>{conv.GetForwardOutputTensor(x.desc, w.desc)};
+        auto dy           = random(y.desc.GetLengths());
+        auto dx           = tensor<float>{x.desc.GetLengths()};
+        auto dw           = tensor<float>{w.desc.GetLengths()};
+        auto db           = tensor<float>{std::vector<std::size_t>{1, 4, 1, 1}};
+        auto x_dev        = write(x);
+        auto w_dev        = write(w);
+        auto y_dev        = write(y);
+        auto dy_dev       = write(dy);
+        auto dx_dev       = write(dx);
+        auto dw_dev       = write(dw);
+        auto db_dev       = write(db);
+        auto perf         = miopenConvAlgoPerf_t{};
+        auto count        = 0;
+
+        STATUS(miopenFindConvolutionForwardAlgorithm(handle,
+                                                     &x.desc,
+                                                     x_dev.get(),
+                                                     &w.desc,
+                                                     w_dev.get(),
+                                                     &conv,
+                                                     &y.desc,
+                                                     y_dev.get(),
+                                                     1,
+                                                     &count,
+                                                     &perf,
+                                                     nullptr,
+                                                     0,
+                                                     false));
+        EXPECT(count == 1);
+        STATUS(miopenConvolutionForward(handle,
+                                        &alpha,
+                                        &x.desc,
+                                        x_dev.get(),
+                                        &w.desc,
+                                        w_dev.get(),
+                                        &conv,
+                                        perf.fwd_algo,
+                                        &beta,
+                                        &y.desc,
+                                        y_dev.get(),
+                                        nullptr,
+                                        0));
+        read(y, y_dev);
+        auto y_ref = tensor<float>{y.desc.GetLengths()};
+        cpu_convolution_forward(conv.GetSpatialDimension(),
+                                x,
+                                w,
+                                y_ref,
+                                conv.GetConvPads(),
+                                conv.GetConvStrides(),
+                                conv.GetConvDilations(),
+                                conv.GetGroupCount());
+        verify("convolution forward", y, y_ref);
+
+        STATUS(miopenFindConvolutionBackwardDataAlgorithm(handle,
+                                                          &dy.desc,
+                                                          dy_dev.get(),
+                                                          &w.desc,
+                                                          w_dev.get(),
+                                                          &conv,
+                                                          &dx.desc,
+                                                          dx_dev.get(),
+                                                          1,
+                                                          &count,
+                                                          &perf,
+                                                          nullptr,
+                                                          0,
+                                                          false));
+        EXPECT(count == 1);
+        STATUS(miopenConvolutionBackwardData(handle,
+                                             &alpha,
+                                             &dy.desc,
+                                             dy_dev.get(),
+                                             &w.desc,
+                                             w_dev.get(),
+                                             &conv,
+                                             perf.bwd_data_algo,
+                                             &beta,
+                                             &dx.desc,
+                                             dx_dev.get(),
+                                             nullptr,
+                                             0));
+        read(dx, dx_dev);
+        auto dx_ref = tensor<float>{x.desc.GetLengths()};
+        cpu_convolution_backward_data(conv.GetSpatialDimension(),
+                                      dx_ref,
+                                      w,
+                                      dy,
+                                      conv.GetConvPads(),
+                                      conv.GetConvStrides(),
+                                      conv.GetConvDilations(),
+                                      conv.GetGroupCount());
+        verify("convolution backward data", dx, dx_ref);
+
+        STATUS(miopenFindConvolutionBackwardWeightsAlgorithm(handle,
+                                                             &dy.desc,
+                                                             dy_dev.get(),
+                                                             &x.desc,
+                                                             x_dev.get(),
+                                                             &conv,
+                                                             &dw.desc,
+                                                             dw_dev.get(),
+                                                             1,
+                                                             &count,
+                                                             &perf,
+                                                             nullptr,
+                                                             0,
+                                                             false));
+        EXPECT(count == 1);
+        STATUS(miopenConvolutionBackwardWeights(handle,
+                                                &alpha,
+                                                &dy.desc,
+                                                dy_dev.get(),
+                                                &x.desc,
+                                                x_dev.get(),
+                                                &conv,
+                                                perf.bwd_weights_algo,
+                                                &beta,
+                                                &dw.desc,
+                                                dw_dev.get(),
+                                                nullptr,
+                                                0));
+        read(dw, dw_dev);
+        auto dw_ref = tensor<float>{w.desc.GetLengths()};
+        cpu_convolution_backward_weight(conv.GetSpatialDimension(),
+                                        x,
+                                        dw_ref,
+                                        dy,
+                                        conv.GetConvPads(),
+                                        conv.GetConvStrides(),
+                                        conv.GetConvDilations(),
+                                        conv.GetGroupCount());
+        verify("convolution backward weights", dw, dw_ref);
+
+        STATUS(miopenConvolutionBackwardBias(
+            handle, &alpha, &dy.desc, dy_dev.get(), &beta, &db.desc, db_dev.get()));
+        read(db, db_dev);
+        auto db_ref = tensor<float>{db.desc.GetLengths()};
+        dy.for_each([&](auto n, auto k, auto i, auto j) { db_ref(0, k, 0, 0) += dy(n, k, i, j); });
+        verify("convolution backward bias", db, db_ref);
+    }
+
+    void tensor_ops()
+    {
+        const float alpha0 = 1.5;
+        const float alpha1 = -0.5;
+        const float beta   = 0.25;
+        for(auto op : {miopenTensorOpAdd, miopenTensorOpMul, miopenTensorOpMin, miopenTensorOpMax})
+        {
+            auto a     = random({2, 3, 4, 5});
+            auto b     = random({1, 3, 1, 1});
+            auto c     = random({2, 3, 4, 5});
+            auto a_dev = write(a);
+            auto b_dev = write(b);
+            auto c_dev = write(c);
+            STATUS(miopenOpTensor(handle,
+                                  op,
+                                  &alpha0,
+                                  &a.desc,
+                                  a_dev.get(),
+                                  &alpha1,
+                                  &b.desc,
+                                  b_dev.get(),
+                                  &beta,
+                                  &c.desc,
+                                  c_dev.get()));
+            auto c_ref = c;
+            read(c, c_dev);
+            c_ref.for_each([&](auto n, auto k, auto i, auto j) {
+                const double x = alpha0 * a(n, k, i, j);
+                const double y = alpha1 * b(0, k, 0, 0);
+                const double r = op == miopenTensorOpAdd
+                                     ? x + y
+                                     : op == miopenTensorOpMul
+                                           ? x * y
+                                           : op == miopenTensorOpMin ? std::min(x, y)
+                                                                     : std::max(x, y);
+                c_ref(n, k, i, j) = r + beta * c_ref(n, k, i, j);
+            });
+            verify("op tensor " + std::to_string(op), c, c_ref);
+        }
+
+        const float value = 0.375;
+        auto t            = random({2, 3, 4, 5});
+        auto t_dev        = write(t);
+        STATUS(miopenSetTensor(handle, &t.desc, t_dev.get(), &value));
+        read(t, t_dev);
+        auto t_ref = tensor<float>{t.desc.GetLengths()};
+        std::fill(t_ref.data.begin(), t_ref.data.end(), value);
+        verify("set tensor", t, t_ref);
+
+        t     = random({2, 3, 4, 5});
+        t_dev = write(t);
+        STATUS(miopenScaleTensor(handle, &t.desc, t_dev.get(), &alpha1));
+        t_ref = t;
+        read(t, t_dev);
+        for(auto& v : t_ref.data)
+            v *= alpha1;
+        verify("scale tensor", t, t_ref);
+    }
+
+    void ctc()
+    {
+        const std::size_t steps   = 10;
+        const std::size_t batch   = 3;
+        const std::size_t classes = 6;
+        auto desc                 = miopen::CTCLossDescriptor{};
+        desc.blank_label_id       = 0;
+        desc.apply_softmax_layer  = true;
+
+        auto probs                    = random({steps, batch, classes});
+        auto gradients                = tensor<float>{probs.desc.GetLengths()};
+        auto losses                   = tensor<float>{batch};
+        const std::vector<int> labels = {1, 2, 3, 4, 4, 2, 5, 1, 3};
+        const std::vector<int> label_lengths = {3, 2, 4};
+        const std::vector<int> input_lengths = {10, 8, 9};
+
+        std::size_t ws_sz = 0;
+        STATUS(miopenGetCTCLossWorkspaceSize(handle,
+                                             &probs.desc,
+                                             &gradients.desc,
+                                             labels.data(),
+                                             label_lengths.data(),
+                                             input_lengths.data(),
+                                             MIOPEN_CTC_LOSS_ALGO_DETERMINISTIC,
+                                             &desc,
+                                             &ws_sz));
+        auto probs_dev     = write(probs);
+        auto gradients_dev = write(gradients);
+        auto losses_dev    = write(losses);
+        auto ws_dev        = h().Create(ws_sz);
+        STATUS(miopenCTCLoss(handle,
+                             &probs.desc,
+                             probs_dev.get(),
+                             labels.data(),
+                             label_lengths.data(),
+                             input_lengths.data(),
+                             losses_dev.get(),
+                             &gradients.desc,
+                             gradients_dev.get(),
+                             MIOPEN_CTC_LOSS_ALGO_DETERMINISTIC,
+                             &desc,
+                             ws_dev.get(),
+                             ws_sz));
+        read(losses, losses_dev);
+        read(gradients, gradients_dev);
+
+        cpu_ctc::problem p;
+        p.max_time_step        = steps;
+        p.batch_size           = batch;
+        p.class_sz             = classes;
+        p.probs_strides[0]     = probs.desc.GetStrides()[0];
+        p.probs_strides[1]     = probs.desc.GetStrides()[1];
+        p.gradients_strides[0] = gradients.desc.GetStrides()[0];
+        p.gradients_strides[1] = gradients.desc.GetStrides()[1];
+        p.blank                = desc.blank_label_id;
+        p.apply_softmax        = desc.apply_softmax_layer;
+        auto losses_ref        = tensor<float>{batch};
+        auto gradients_ref     = tensor<float>{probs.desc.GetLengths()};
+        cpu_ctc::loss(p,
+                      probs.data.data(),
+                      labels.data(),
+                      label_lengths.data(),
+                      input_lengths.data(),
+                      losses_ref.data.data(),
+                      gradients_ref.data.data());
+        verify("ctc loss", losses, losses_ref);
+        verify("ctc gradients", gradients, gradients_ref);
+    }
+
+    // The primitives without a host implementation must fail rather than
+    // leave their outputs untouched.
+    void unsupported()
+    {
+        const float alpha = 1;
+        const float beta  = 0;
+        auto desc         = miopen::LRNDescriptor{miopenLRNCrossChannel, 5, {1e-4, 0.75, 1}};
+        auto x            = random({2, 8, 4, 4});
+        auto y            = tensor<float>{x.desc.GetLengths()};
+        auto x_dev        = write(x);
+        auto y_dev        = write(y);
+        EXPECT(miopenLRNForward(handle,
+                                &desc,
+                                &alpha,
+                                &x.desc,
+                                x_dev.get(),
+                                &beta,
+                                &y.desc,
+                                y_dev.get(),
+                                false,
+                                nullptr) == miopenStatusNotImplemented);
+    }
+
+    void run()
+    {
+        activation();
+        softmax();
+        pooling();
+        batch_norm();
+        convolution();
+        tensor_ops();
+        ctc();
+        unsupported();
+    }
+};
+
+int main() { run_test<host_exec_test>(); }
@@ -28,6 +28,7 @@
 #include "verify.hpp"
 #include "get_handle.hpp"
 #include "tensor_holder.hpp"
+#include "cpu_lrn.hpp"
 #include <miopen/miopen.h>
 #include <miopen/tensor.hpp>
 #include <miopen/stringutils.hpp>
@@ -67,45 +68,37 @@ struct verify_lrn_foward
         if(mode == miopenLRNCrossChannel)
         {
             auto alphaoverarea = alpha / lrn_n;
-            par_ford(n_batch, channels, height, width)([&](int b, int c, int h, int w) {
-
-                int start = c < radius_lower ? 0 : (c - radius_lower);
-                int end   = (c + radius_upper + 1) > channels ? channels : (c + radius_upper + 1);
-
-                double scale = 0;
-                for(int k = start; k < end; k++)
-                {
-                    scale += std::pow(input(b, k, h, w), 2);
-                }
-
-                scale *= alphaoverarea;
-                scale += K;
-                scale = std::pow(scale, -beta);
-
-                output(b, c, h, w) = static_cast<T>(scale * input(b, c, h, w));
+            // The channels of one image row at a time
+            par_ford(n_batch, height)([&](int b, int h) {
+                std::vector<double> sqr(channels * width);
+                std::vector<double> sums(channels * width);
+                ford(channels, width)([&](int c, int w) {
+                    sqr[c * width + w] = std::pow(input(b, c, h, w), 2);
+                });
+                cpu_lrn::sliding_sums(
+                    channels, width, radius_lower, radius_upper, sqr.data(), sums.data());
+
+                ford(channels, width)([&](int c, int w) {
+                    const double scale = std::pow(sums[c * width + w] * alphaoverarea + K, -beta);
+                    output(b, c, h, w) = static_cast<T>(scale * input(b, c, h, w));
+                });
             });
         }
         else
         {
             double alphaoverarea = radius_upper == 0 ? 1 : alpha / (lrn_n * lrn_n);
-            par_ford(n_batch, channels, height, width)([&](int b, int c, int h, int w) {
-                double scale = 0;
-                int left     = (w - radius_lower) < 0 ? 0 : (w - radius_lower);
-                int right    = (w + radius_upper + 1) > width ? width : (w + radius_upper + 1);
-                int top      = (h - radius_lower) < 0 ? 0 : (h - radius_lower);
-                int bottom   = (h + radius_upper + 1) > height ? height : (h + radius_upper + 1);
-
-                for(int i = left; i < right; i++)
-                {
-                    for(int j = top; j < bottom; j++)
-                    {
-                        scale += std::pow(input(b, c, j, i), 2);
-                    }
-                }
-                scale *= alphaoverarea;
-                scale += K;
-                scale = std::pow(scale, -beta);
-                output(b, c, h, w) = static_cast<T>(scale * input(b, c, h, w));
+            par_ford(n_batch, channels)([&](int b, int c) {
+                std::vector<double> sqr(height * width);
+                std::vector<double> sums(height * width);
+                ford(height, width)(
+                    [&](int h, int w) { sqr[h * width + w] = std::pow(input(b, c, h, w), 2); });
+                cpu_lrn::box_sums(
+                    height, width, radius_lower, radius_upper, sqr.data(), sums.data());
+
+                ford(height, width)([&](int h, int w) {
+                    const double scale = std::pow(sums[h * width + w] * alphaoverarea + K, -beta);
+                    output(b, c, h, w) = static_cast<T>(scale * input(b, c, h, w));
+                });
             });
         }
 
@@ -185,46 +178,44 @@ struct verify_lrn_bwd
             auto adjust_area       = lrn_n * lrn_n;
             auto cache_ratio_value = 2 * alpha * beta / adjust_area;
 
-            par_ford(n_batch, channels, height, width)([&](int b, int c, int h, int w) {
-
-                int left   = w < radius_upper ? 0 : (w - radius_upper);
-                int right  = (w + radius_lower + 1) > width ? width : (w + radius_lower + 1);
-                int top    = h < radius_upper ? 0 : (h - radius_upper);
-                int bottom = (h + radius_lower + 1) > height ? height : (h + radius_lower + 1);
-
-                double ydy = 0;
-                for(int i = left; i < right; i++)
-                {
-                    for(int j = top; j < bottom; j++)
-                    {
-                        ydy += (double(inputY(b, c, j, i) * inputDY(b, c, j, i)) /
-                                double(scale(b, c, j, i)));
-                    }
-                }
-
-                routputDX(b, c, h, w) = static_cast<T>(
-                    std::pow(static_cast<double>(scale(b, c, h, w)), -beta) * inputDY(b, c, h, w) -
-                    cache_ratio_value * inputX(b, c, h, w) * ydy);
+            par_ford(n_batch, channels)([&](int b, int c) {
+                std::vector<double> ratio(height * width);
+                std::vector<double> ydy(height * width);
+                ford(height, width)([&](int h, int w) {
+                    ratio[h * width + w] = double(inputY(b, c, h, w) * inputDY(b, c, h, w)) /
+                                           double(scale(b, c, h, w));
+                });
+                cpu_lrn::box_sums(
+                    height, width, radius_upper, radius_lower, ratio.data(), ydy.data());
+
+                ford(height, width)([&](int h, int w) {
+                    routputDX(b, c, h, w) = static_cast<T>(
+                        std::pow(static_cast<double>(scale(b, c, h, w)), -beta) *
+                            inputDY(b, c, h, w) -
+                        cache_ratio_value * inputX(b, c, h, w) * ydy[h * width + w]);
+                });
             });
         }
         else
         {
             auto cache_ratio_value = 2 * alpha * beta / lrn_n;
 
-            par_ford(n_batch, channels, height, width)([&](int b, int c, int h, int w) {
-                int start = c < radius_upper ? 0 : (c - radius_upper);
-                int end   = (c + radius_lower + 1) > channels ? channels : (c + radius_lower + 1);
-
-                double ydy = 0;
-                for(auto k = start; k < end; k++)
-                {
-                    ydy += (double(inputY(b, k, h, w) * inputDY(b, k, h, w)) /
-                            double(scale(b, k, h, w)));
-                }
-
-                routputDX(b, c, h, w) = static_cast<T>(
-                    std::pow(static_cast<double>(scale(b, c, h, w)), -beta) * inputDY(b, c, h, w) -
-                    cache_ratio_value * inputX(b, c, h, w) * ydy);
+            par_ford(n_batch, height)([&](int b, int h) {
+                std::vector<double> ratio(channels * width);
+                std::vector<double> ydy(channels * width);
+                ford(channels, width)([&](int c, int w) {
+                    ratio[c * width + w] = double(inputY(b, c, h, w) * inputDY(b, c, h, w)) /
+                                           double(scale(b, c, h, w));
+                });
+                cpu_lrn::sliding_sums(
+                    channels, width, radius_upper, radius_lower, ratio.data(), ydy.data());
+
+                ford(channels, width)([&](int c, int w) {
+                    routputDX(b, c, h, w) = static_cast<T>(
+                        std::pow(static_cast<double>(scale(b, c, h, w)), -beta) *
+                            inputDY(b, c, h, w) -
+                        cache_ratio_value * inputX(b, c, h, w) * ydy[c * width + w]);
+                });
             });
         }
 
@@ -584,8 +584,7 @@ void verify_forward_lstm<T>::LSTMFwdCPUVerify(
             int prelayer_shift = (li - 1) * batch_n_cpu * hy_stride + bi * 5 * hy_h;
             if(use_dropout)
             {
-                auto dropout_states_tmp = dropout_states_host;
-                size_t drop_out_offset  = (li - 1) * batch_n_cpu * hy_h * bi;
+                size_t drop_out_offset = (li - 1) * batch_n_cpu * hy_h * bi;
 
                 DropoutForwardVerify<T>(handle,
                                         dropoutDesc,
@@ -594,7 +593,7 @@ void verify_forward_lstm<T>::LSTMFwdCPUVerify(
                                         miopen::deref(dropout_outputTensor),
                                         dropout_hid_state,
                                         dropout_reservespace_host,
-                                        dropout_states_tmp,
+                                        dropout_states_host,
                                         prelayer_shift,
                                         drop_out_offset,
                                         drop_out_offset);
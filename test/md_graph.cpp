@@ -0,0 +1,131 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Checks the compiled constraints of the fusion metadata graphs against the
+// parse tree evaluation they replace, on random operator attributes.
+
+#include <miopen/md_graph.hpp>
+#include <miopen/mdg_expr.hpp>
+
+#include "test.hpp"
+
+#include <random>
+#include <set>
+
+using attr_map = std::unordered_map<std::string, int>;
+
+static bool parse_tree_match(const miopen::MDGraph_edge& edge,
+                             const std::function<bool(const std::string&, int&)>& attr_fun,
+                             attr_map& syms)
+{
+    miopen::tree_visit v(attr_fun);
+    for(const auto& c : edge.constraints)
+    {
+        miopen::MDGExprParser p;
+        boost::spirit::utree e;
+        auto f = c.text.cbegin();
+        EXPECT(
+            boost::spirit::qi::phrase_parse(f, c.text.cend(), p, boost::spirit::ascii::space, e));
+        const auto r = boost::spirit::utree::visit(e, v);
+        v.tabl.insert(r.tabl.begin(), r.tabl.end());
+        syms = v.tabl;
+        if(!r.b_res)
+            return false;
+    }
+    return true;
+}
+
+static void check_graph(miopen::miopenFusionOp_t op)
+{
+    miopen::FusionMDGraph g;
+    miopen::FusionMDGraph::Init(g, op);
+    // The plans share the graph
+    miopen::FusionMDGraph other;
+    miopen::FusionMDGraph::Init(other, op);
+    EXPECT(g.graph == other.graph);
+
+    std::set<std::string> assigned;
+    for(const auto& src : g.graph->edge_list)
+        for(const auto& dst : src.second)
+            for(const auto& edge : dst.second)
+                for(const auto& c : edge.constraints)
+                    if(c.assign >= 0)
+                        assigned.insert(g.graph->symbols.names[c.assign]);
+
+    std::mt19937 gen(op);
+    for(int i = 0; i < 200; ++i)
+    {
+        attr_map attrs;
+        for(const auto& name : g.graph->symbols.names)
+        {
+            if(assigned.count(name) == 0)
+                attrs[name] = gen() % 4 == 0 ? 1 << (gen() % 30) : gen() % 7;
+        }
+        int calls           = 0;
+        const auto attr_fun = [&](const std::string& sym, int& val) {
+            ++calls;
+            const auto it = attrs.find(sym);
+            if(it == attrs.end())
+                return false;
+            val = it->second;
+            return true;
+        };
+
+        miopen::MDGraph_attrs lookup(g.graph->symbols, attr_fun);
+        for(const auto& src : g.graph->edge_list)
+        {
+            for(const auto& dst : src.second)
+            {
+                for(const auto& edge : dst.second)
+                {
+                    attr_map expected;
+                    attr_map actual;
+                    EXPECT(parse_tree_match(edge, attr_fun, expected) ==
+                           g.CmpOpKey(edge, lookup, actual));
+                    EXPECT(expected == actual);
+                }
+            }
+        }
+        // Every symbol is looked up once for all the edges
+        calls = 0;
+        for(const auto& src : g.graph->edge_list)
+            for(const auto& dst : src.second)
+                for(const auto& edge : dst.second)
+                {
+                    attr_map syms;
+                    g.CmpOpKey(edge, lookup, syms);
+                }
+        EXPECT(calls == 0);
+    }
+}
+
+int main()
+{
+    check_graph(miopen::miopenFusionOpConvForward);
+    check_graph(miopen::miopenFusionOpBatchNormInference);
+    check_graph(miopen::miopenFusionOpBatchNormFwdTrain);
+    check_graph(miopen::miopenFusionOpBatchNormBwdTrain);
+}
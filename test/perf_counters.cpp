@@ -0,0 +1,90 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "test.hpp"
+
+#include <miopen/perf_counters.hpp>
+
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using miopen::counters::Counter;
+using miopen::counters::Source;
+
+static std::uint64_t get(Source source, Counter counter)
+{
+    return miopen::counters::Get(source)[static_cast<std::size_t>(counter)];
+}
+
+int main()
+{
+    miopen::counters::Reset();
+    EXPECT(get(Source::PlainTextDb, Counter::Lookups) == 0);
+
+    // Threads that exited still count.
+    std::vector<std::thread> threads;
+    for(auto t = 0; t < 4; ++t)
+        threads.emplace_back([] {
+            for(auto i = 0; i < 1000; ++i)
+                miopen::counters::AddLookup(Source::PlainTextDb, i % 4 != 0);
+            miopen::counters::Add(Source::PlainTextDb, Counter::BytesRead, 100);
+        });
+    for(auto& thread : threads)
+        thread.join();
+
+    EXPECT(get(Source::PlainTextDb, Counter::Lookups) == 4000);
+    EXPECT(get(Source::PlainTextDb, Counter::Hits) == 3000);
+    EXPECT(get(Source::PlainTextDb, Counter::Misses) == 1000);
+    EXPECT(get(Source::PlainTextDb, Counter::BytesRead) == 400);
+    EXPECT(get(Source::KernDb, Counter::Lookups) == 0);
+
+    std::ostringstream ss;
+    miopen::counters::WriteJson(ss);
+    EXPECT(ss.str().find("\"plain_text_db\": {\"lookups\": 4000, \"hits\": 3000") !=
+           std::string::npos);
+
+    miopen::counters::Reset();
+    miopen::counters::Add(Source::KernDb, Counter::Compiles);
+    EXPECT(get(Source::PlainTextDb, Counter::Lookups) == 0);
+    EXPECT(get(Source::KernDb, Counter::Compiles) == 1);
+
+    // A thread that counts across a reset and then exits only keeps the counts after it.
+    std::promise<void> counted;
+    std::promise<void> reset;
+    std::thread thread([&] {
+        miopen::counters::Add(Source::KernDb, Counter::Compiles, 10);
+        counted.set_value();
+        reset.get_future().wait();
+        miopen::counters::Add(Source::KernDb, Counter::Compiles, 5);
+    });
+    counted.get_future().wait();
+    miopen::counters::Reset();
+    reset.set_value();
+    thread.join();
+    EXPECT(get(Source::KernDb, Counter::Compiles) == 5);
+}
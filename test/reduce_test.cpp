@@ -38,83 +38,28 @@
 #include <limits>
 #include <iostream>
 
+#include "cpu_reduce.hpp"
 #include "cpu_reduce_util.hpp"
 
-static void get_all_indexes(const std::vector<std::size_t>& dimLengths,
-                            int dim,
-                            std::vector<std::vector<std::size_t>>& indexes)
+// dst = alpha * accuVal + beta * dst
+template <class T, class compType>
+static void store_scaled(T alpha, T beta, compType accuVal, T& dst)
 {
-    if(dim < dimLengths.size())
-    {
-        std::vector<std::vector<std::size_t>> updated_indexes;
-
-        if(dim == 0)
-        {
-            assert(indexes.size() == 0);
-            assert(dimLengths[dim] > 0);
-            for(std::size_t i = 0; i < dimLengths[dim]; i++)
-            {
-                std::vector<std::size_t> index = {i};
-
-                updated_indexes.push_back(index);
-            };
-        }
-        else
-        {
-            // go through all the current indexes
-            for(const auto& index : indexes)
-                for(std::size_t i = 0; i < dimLengths[dim]; i++)
-                {
-                    auto index_new = index;
-                    index_new.push_back(i);
-
-                    updated_indexes.push_back(index_new);
-                };
-        };
+    using reduce::float_equal_one;
+    using reduce::float_equal_zero;
+    using reduce::convert_type;
 
-        // update to the indexes (output)
-        indexes = updated_indexes;
-
-        // further to construct the indexes from the updated status
-        get_all_indexes(dimLengths, dim + 1, indexes);
-    };
-};
-
-static std::size_t get_offset_from_index(const std::vector<std::size_t>& strides,
-                                         const std::vector<std::size_t>& index)
-{
-    std::size_t offset = 0;
+    // scale the accumulated value
+    if(!float_equal_one(alpha))
+        accuVal *= convert_type<compType>(alpha);
 
-    assert(strides.size() == index.size());
+    // scale the prior dst value and add it to the accumulated value
+    if(!float_equal_zero(beta))
+        accuVal += convert_type<compType>(dst * beta);
 
-    for(int i = 0; i < index.size(); i++)
-        offset += strides[i] * index[i];
-
-    return (offset);
-};
-
-static std::size_t get_flatten_offset(const std::vector<std::size_t>& lengths,
-                                      const std::vector<std::size_t>& index)
-{
-    std::size_t offset = 0;
-
-    assert(lengths.size() == index.size() && lengths.size() > 0);
-
-    int len            = lengths.size();
-    std::size_t stride = 1;
-
-    // for len==1, the loop is not executed
-    for(int i = len - 1; i > 0; i--)
-    {
-        offset += stride * index[i];
-
-        stride *= lengths[i];
-    };
-
-    offset += stride * index[0];
-
-    return (offset);
-};
+    // store the reduced value to dst location
+    dst = convert_type<T>(accuVal);
+}
 
 template <class T, bool toVerifyData>
 struct verify_reduce_with_indices
@@ -248,137 +193,29 @@ struct verify_reduce_with_indices
     {
         using reduce::ReduceOpFn2;
         using reduce::ReduceOpZeroVal;
-        using reduce::float_equal_one;
-        using reduce::float_equal_zero;
         using reduce::convert_type;
-        using reduce::binop_with_nan_check;
         using reduce::binop_with_nan_check2;
 
-        auto inLengths  = input.desc.GetLengths();
-        auto outLengths = output.desc.GetLengths();
-        auto inStrides  = input.desc.GetStrides();
-        auto outStrides = output.desc.GetStrides();
-
         // replicate
         auto res         = output;
         auto res_indices = indices;
 
-        std::vector<std::size_t> invariantLengths;
-        std::vector<std::size_t> toReduceLengths;
-
-        std::vector<int> invariantDims;
-        std::vector<int> toReduceDims;
-
-        for(int i = 0; i < inLengths.size(); i++)
-            if(inLengths[i] == outLengths[i])
-                invariantDims.push_back(i);
-            else
-                toReduceDims.push_back(i);
-
-        invariantLengths.resize(invariantDims.size());
-        for(int i               = 0; i < invariantDims.size(); i++)
-            invariantLengths[i] = inLengths[invariantDims[i]];
-
-        toReduceLengths.resize(toReduceDims.size());
-        for(int i              = 0; i < toReduceDims.size(); i++)
-            toReduceLengths[i] = inLengths[toReduceDims[i]];
-
-        bool reduceAllDims = invariantDims.empty();
-
         auto opReduce = ReduceOpFn2<compType>(reduceOp);
 
-        if(reduceAllDims)
-        {
-            std::vector<std::vector<std::size_t>> indexes_1;
-
-            get_all_indexes(inLengths, 0, indexes_1);
-
-            compType accuVal = ReduceOpZeroVal<compType>(reduceOp);
-            int accuIndex    = 0;
-
-            // go through indexes of the invariant dimensions
-            for(const auto& src_index : indexes_1)
-            {
-                auto src_offset = get_offset_from_index(inStrides, src_index);
-
-                auto currVal = convert_type<compType>(input.data[src_offset]);
-
-                int currIndex = get_flatten_offset(inLengths, src_index);
-                binop_with_nan_check2(nanOpt, opReduce, accuVal, currVal, accuIndex, currIndex);
-            };
-
-            // scale the accumulated value
-            if(!float_equal_one(alpha))
-                accuVal *= convert_type<compType>(alpha);
-
-            // scale the prior dst value and add it to the accumulated value
-            if(!float_equal_zero(beta))
-            {
-                accuVal += convert_type<compType>(output.data[0] * beta);
-            };
-
-            // store the reduced value to dst location
-            res.data[0]         = convert_type<T>(accuVal);
-            res_indices.data[0] = accuIndex;
-        }
-        else
-        {
-            std::vector<std::vector<std::size_t>> indexes_1, indexes_2;
-
-            get_all_indexes(invariantLengths, 0, indexes_1);
-            get_all_indexes(toReduceLengths, 0, indexes_2);
-
-            // go through indexes of the invariant dimensions
-            for(const auto& index_1 : indexes_1)
-            {
-                std::vector<std::size_t> src_index;
-                std::vector<std::size_t> dst_index;
-
-                src_index.resize(inLengths.size());
-                dst_index.resize(inLengths.size());
-
-                std::fill(dst_index.begin(), dst_index.end(), 0);
-
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    dst_index[invariantDims[k]] = index_1[k];
-
-                int dst_offset = get_offset_from_index(outStrides, dst_index);
-
-                // generate the part of the index belonging to the invariant dims
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    src_index[invariantDims[k]] = index_1[k];
-
-                compType accuVal = ReduceOpZeroVal<compType>(reduceOp);
-                int accuIndex    = 0;
-
-                // go through indexes of the toReduce dimensions
-                for(const auto& index_2 : indexes_2)
-                {
-                    // generate the part of the index belonging to the toReduce dims
-                    for(int k                      = 0; k < toReduceDims.size(); k++)
-                        src_index[toReduceDims[k]] = index_2[k];
-
-                    auto src_offset = get_offset_from_index(inStrides, src_index);
-
-                    auto currVal = convert_type<compType>(input.data[src_offset]);
-
-                    auto currIndex = get_flatten_offset(toReduceLengths, index_2);
-                    binop_with_nan_check2(nanOpt, opReduce, accuVal, currVal, accuIndex, currIndex);
-                };
-
-                // scale the accumulated value
-                if(!float_equal_one(alpha))
-                    accuVal *= convert_type<compType>(alpha);
-
-                // scale the prior dst value and add it to the accumulated value
-                if(!float_equal_zero(beta))
-                    accuVal += convert_type<compType>(output.data[dst_offset] * beta);
-
-                // store the reduced value to dst location
-                res.data[dst_offset]         = convert_type<T>(accuVal);
-                res_indices.data[dst_offset] = accuIndex; // store the index
-            };
-        };
+        cpu_reduce::run(
+            cpu_reduce::make_plan(input.desc.GetLengths(),
+                                  input.desc.GetStrides(),
+                                  output.desc.GetLengths(),
+                                  output.desc.GetStrides()),
+            ReduceOpZeroVal<compType>(reduceOp),
+            [&](std::size_t src_offset) { return convert_type<compType>(input.data[src_offset]); },
+            [&](cpu_reduce::partial<compType>& accu, compType currVal, int currIndex) {
+                binop_with_nan_check2(nanOpt, opReduce, accu.value, currVal, accu.index, currIndex);
+            },
+            [&](std::size_t dst_offset, const cpu_reduce::partial<compType>& accu) {
+                store_scaled(alpha, beta, accu.value, res.data[dst_offset]);
+                res_indices.data[dst_offset] = accu.index; // store the index
+            });
 
         return (std::make_tuple(res, res_indices));
     }
@@ -503,128 +340,27 @@ struct verify_reduce_no_indices
     {
         using reduce::ReduceOpFn;
         using reduce::ReduceOpZeroVal;
-        using reduce::float_equal_one;
-        using reduce::float_equal_zero;
         using reduce::convert_type;
         using reduce::binop_with_nan_check;
-        using reduce::binop_with_nan_check2;
-
-        auto inLengths  = input.desc.GetLengths();
-        auto outLengths = output.desc.GetLengths();
-        auto inStrides  = input.desc.GetStrides();
-        auto outStrides = output.desc.GetStrides();
 
         // replicate
         auto res = output;
 
-        std::vector<std::size_t> invariantLengths;
-        std::vector<std::size_t> toReduceLengths;
-
-        std::vector<int> invariantDims;
-        std::vector<int> toReduceDims;
-
-        for(int i = 0; i < inLengths.size(); i++)
-            if(inLengths[i] == outLengths[i])
-                invariantDims.push_back(i);
-            else
-                toReduceDims.push_back(i);
-
-        invariantLengths.resize(invariantDims.size());
-        for(int i               = 0; i < invariantDims.size(); i++)
-            invariantLengths[i] = inLengths[invariantDims[i]];
-
-        toReduceLengths.resize(toReduceDims.size());
-        for(int i              = 0; i < toReduceDims.size(); i++)
-            toReduceLengths[i] = inLengths[toReduceDims[i]];
-
-        bool reduceAllDims = invariantDims.empty();
-
         auto opReduce = ReduceOpFn<compType>(reduceOp);
 
-        if(reduceAllDims)
-        {
-            std::vector<std::vector<std::size_t>> indexes_1;
-
-            get_all_indexes(inLengths, 0, indexes_1);
-
-            compType accuVal = ReduceOpZeroVal<compType>(reduceOp);
-
-            // go through indexes of the invariant dimensions
-            for(const auto& src_index : indexes_1)
-            {
-                auto src_offset = get_offset_from_index(inStrides, src_index);
-
-                auto currVal = convert_type<compType>(input.data[src_offset]);
-
-                binop_with_nan_check(nanOpt, opReduce, accuVal, currVal);
-            };
-
-            // scale the accumulated value
-            if(!float_equal_one(alpha))
-                accuVal *= convert_type<compType>(alpha);
-
-            // scale the prior dst value and add it to the accumulated value
-            if(!float_equal_one(beta))
-                accuVal += convert_type<compType>(output.data[0] * beta);
-
-            // store the reduced value to dst location
-            res.data[0] = convert_type<T>(accuVal);
-        }
-        else
-        {
-            std::vector<std::vector<std::size_t>> indexes_1, indexes_2;
-
-            get_all_indexes(invariantLengths, 0, indexes_1);
-            get_all_indexes(toReduceLengths, 0, indexes_2);
-
-            // go through indexes of the invariant dimensions
-            for(const auto& index_1 : indexes_1)
-            {
-                std::vector<std::size_t> src_index;
-                std::vector<std::size_t> dst_index;
-
-                src_index.resize(inLengths.size());
-                dst_index.resize(inLengths.size());
-
-                std::fill(dst_index.begin(), dst_index.end(), 0);
-
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    dst_index[invariantDims[k]] = index_1[k];
-
-                int dst_offset = get_offset_from_index(outStrides, dst_index);
-
-                // generate the part of the index belonging to the invariant dims
-                for(int k                       = 0; k < invariantDims.size(); k++)
-                    src_index[invariantDims[k]] = index_1[k];
-
-                compType accuVal = ReduceOpZeroVal<compType>(reduceOp);
-
-                // go through indexes of the toReduce dimensions
-                for(const auto& index_2 : indexes_2)
-                {
-                    // generate the part of the index belonging to the toReduce dims
-                    for(int k                      = 0; k < toReduceDims.size(); k++)
-                        src_index[toReduceDims[k]] = index_2[k];
-
-                    auto src_offset = get_offset_from_index(inStrides, src_index);
-
-                    auto currVal = convert_type<compType>(input.data[src_offset]);
-
-                    binop_with_nan_check(nanOpt, opReduce, accuVal, currVal);
-                };
-
-                // scale the accumulated value
-                if(!float_equal_one(alpha))
-                    accuVal *= convert_type<compType>(alpha);
-
-                // scale the prior dst value and add it to the accumulated value
-                if(!float_equal_zero(beta))
-                    accuVal += convert_type<compType>(output.data[dst_offset] * beta);
-
-                // store the reduced value to dst location
-                res.data[dst_offset] = convert_type<T>(accuVal);
-            };
-        };
+        cpu_reduce::run(
+            cpu_reduce::make_plan(input.desc.GetLengths(),
+                                  input.desc.GetStrides(),
+                                  output.desc.GetLengths(),
+                                  output.desc.GetStrides()),
+            ReduceOpZeroVal<compType>(reduceOp),
+            [&](std::size_t src_offset) { return convert_type<compType>(input.data[src_offset]); },
+            [&](cpu_reduce::partial<compType>& accu, compType currVal, int) {
+                binop_with_nan_check(nanOpt, opReduce, accu.value, currVal);
+            },
+            [&](std::size_t dst_offset, const cpu_reduce::partial<compType>& accu) {
+                store_scaled(alpha, beta, accu.value, res.data[dst_offset]);
+            });
 
         return (res);
     }
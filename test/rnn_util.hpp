@@ -34,8 +34,10 @@
 #include <vector>
 #include <cstdlib>
 
+#include "gemm.hpp"
+
 #define RNN_MM_TRANSPOSE 1
-#define RNN_MM_USEPARAGEMM 0
+#define RNN_MM_USEPARAGEMM 1
 
 inline void createTensorDescArray(std::vector<miopen::TensorDescriptor>& td,
                                   std::vector<miopenTensorDescriptor_t>& ptd,
@@ -158,9 +160,6 @@ void RNN_mm_cpu(const Dtype* a_ptr,
                 double d_alpha,
                 double d_beta)
 {
-
-    auto alpha = Dtype(d_alpha);
-    auto beta  = Dtype(d_beta);
     if((!(a_flags & RNN_MM_TRANSPOSE) && !(b_flags & RNN_MM_TRANSPOSE) &&
         ((a_cols != b_rows) || (a_rows != c_rows) || (b_cols != c_cols))) ||
        ((a_flags & RNN_MM_TRANSPOSE) && (b_flags & RNN_MM_TRANSPOSE) &&
@@ -177,6 +176,8 @@ void RNN_mm_cpu(const Dtype* a_ptr,
 
     size_t inner_loop = (!(a_flags & RNN_MM_TRANSPOSE)) ? a_cols : a_rows;
 #if(!RNN_MM_USEPARAGEMM)
+    auto alpha = Dtype(d_alpha);
+    auto beta  = Dtype(d_beta);
     if(!(a_flags & RNN_MM_TRANSPOSE) && !(b_flags & RNN_MM_TRANSPOSE))
     {
 
@@ -262,48 +263,22 @@ void RNN_mm_cpu(const Dtype* a_ptr,
                 c_ptr[n * c_stride + k] = beta * c_ptr[n * c_stride + k] + alpha * mm_e;
             }
         }
-#else
-    auto c_out = [&](int i, int j, double x) {
-        c_ptr[i * c_stride + j] = beta * c_ptr[i * c_stride + j] + alpha * x;
-    };
-
-    if(!(a_flags & RNN_MM_TRANSPOSE) && !(b_flags & RNN_MM_TRANSPOSE))
-    {
-        gemm(c_rows,
-             c_cols,
-             inner_loop,
-             with_stride(a_ptr, a_stride),
-             with_stride(b_ptr, b_stride),
-             c_out);
     }
-    else if((a_flags & RNN_MM_TRANSPOSE) && !(b_flags & RNN_MM_TRANSPOSE))
-    {
-        gemm(c_rows,
-             c_cols,
-             inner_loop,
-             miopen::flip(with_stride(a_ptr, a_stride)),
-             with_stride(b_ptr, b_stride),
-             c_out);
-    }
-    else if(!(a_flags & RNN_MM_TRANSPOSE) && (b_flags & RNN_MM_TRANSPOSE))
-    {
-        gemm(c_rows,
-             c_cols,
-             inner_loop,
-             with_stride(a_ptr, a_stride),
-             miopen::flip(with_stride(b_ptr, b_stride)),
-             c_out);
-    }
-    else
-    {
-        gemm(c_rows,
-             c_cols,
-             inner_loop,
-             miopen::flip(with_stride(a_ptr, a_stride)),
-             miopen::flip(with_stride(b_ptr, b_stride)),
-             c_out);
+#else
+    cpu_gemm::gemm((a_flags & RNN_MM_TRANSPOSE) != 0,
+                   (b_flags & RNN_MM_TRANSPOSE) != 0,
+                   c_rows,
+                   c_cols,
+                   inner_loop,
+                   d_alpha,
+                   a_ptr,
+                   a_stride,
+                   b_ptr,
+                   b_stride,
+                   d_beta,
+                   c_ptr,
+                   c_stride);
 #endif
-    }
 }
 
 #endif
@@ -232,8 +232,7 @@ void RNNFwdTrainCPUVerify(miopen::Handle& handle,
             int prelayer_shift = (li - 1) * batch_n * hy_h * bi + numlayer * batch_n * hy_h * bi;
             if(use_dropout)
             {
-                auto dropout_states_tmp = dropout_states_host;
-                size_t drop_out_offset  = (li - 1) * batch_n * hy_h * bi;
+                size_t drop_out_offset = (li - 1) * batch_n * hy_h * bi;
 
                 DropoutForwardVerify<T>(handle,
                                         dropoutDesc,
@@ -242,7 +241,7 @@ void RNNFwdTrainCPUVerify(miopen::Handle& handle,
                                         miopen::deref(dropout_outputTensor),
                                         dropout_hid_state,
                                         dropout_reservespace_host,
-                                        dropout_states_tmp,
+                                        dropout_states_host,
                                         prelayer_shift,
                                         drop_out_offset,
                                         drop_out_offset);
@@ -28,6 +28,7 @@
 
 #include "ford.hpp"
 #include "network_data.hpp"
+#include "serialize.hpp"
 #include <miopen/tensor.hpp>
 #include <miopen/functional.hpp>
 #include <miopen/type_name.hpp>
@@ -0,0 +1,75 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "test.hpp"
+
+#include <miopen/trace.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+static std::size_t count(const std::string& s, const std::string& what)
+{
+    std::size_t n = 0;
+    for(auto pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1))
+        ++n;
+    return n;
+}
+
+int main()
+{
+    using miopen::trace::Clock;
+
+    const auto begin = Clock::now();
+    miopen::trace::Record("Test::Outer", "", begin, begin + std::chrono::microseconds(20));
+    miopen::trace::Record(
+        "Test::Inner", "\"quoted\"\n", begin, begin + std::chrono::microseconds(10));
+    std::thread([&] {
+        miopen::trace::Record("Test::Thread", "", begin, begin + std::chrono::microseconds(5));
+    }).join();
+    // The events of exited threads are kept after their buffers are released.
+    for(auto i = 0; i < 8; ++i)
+    {
+        std::thread([&] {
+            miopen::trace::Record("Test::Short", "", begin, begin + std::chrono::microseconds(1));
+        }).join();
+    }
+
+    std::ostringstream ss;
+    miopen::trace::Write(ss);
+    const auto json = ss.str();
+
+    EXPECT(json.find("{\"traceEvents\": [") == 0);
+    EXPECT(count(json, "\"ph\": \"X\"") == 11);
+    EXPECT(count(json, "\"name\": \"Test::") == 11);
+    EXPECT(count(json, "\"name\": \"Test::Short\"") == 8);
+    EXPECT(json.find("\"detail\": \"\\\"quoted\\\"\\u000a\"") != std::string::npos);
+    EXPECT(json.find("\"tid\": 0") != std::string::npos);
+    EXPECT(json.find("\"tid\": 1") != std::string::npos);
+    EXPECT(json.find("\"tid\": 9") != std::string::npos);
+    EXPECT(json.find("\"dropped\": 0") != std::string::npos);
+}
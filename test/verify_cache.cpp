@@ -0,0 +1,135 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "test.hpp"
+#include "verify_cache.hpp"
+
+#include <miopen/tmp_dir.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string floats(std::size_t n, bool integers)
+{
+    std::mt19937 gen{n};
+    std::uniform_real_distribution<float> dist{-16, 16};
+    std::vector<float> v(n);
+    for(auto& x : v)
+        x = integers ? static_cast<float>(static_cast<int>(dist(gen))) : dist(gen);
+    return {reinterpret_cast<const char*>(v.data()), n * sizeof(float)};
+}
+
+static void check_round_trip(const std::string& raw)
+{
+    const auto c = verify_cache::compress(raw);
+    std::string back;
+    EXPECT(verify_cache::decompress(c.data(), c.data() + c.size(), raw.size(), back));
+    EXPECT(back == raw);
+    // A truncated or resized stream is rejected
+    if(not raw.empty())
+    {
+        EXPECT(not verify_cache::decompress(c.data(), c.data() + c.size(), raw.size() + 1, back));
+        EXPECT(not verify_cache::decompress(c.data(), c.data() + c.size() / 2, raw.size(), back));
+    }
+}
+
+static void test_compression()
+{
+    check_round_trip("");
+    check_round_trip("a");
+    check_round_trip("abcdefg");
+    check_round_trip(std::string(1001, '\0'));
+    check_round_trip(floats(1000, false) + "xyz");
+    check_round_trip(floats(4096, true));
+    // Integer valued floats have zero low mantissa bytes
+    EXPECT(verify_cache::compress(floats(4096, true)).size() < 4096 * sizeof(float) * 3 / 4);
+}
+
+static void test_store()
+{
+    const miopen::TmpDir dir{"verify_cache"};
+    const verify_cache::store cache{dir.path, 1024 * 1024};
+    std::string data;
+
+    EXPECT(not cache.read("a", data));
+    cache.write("a", floats(100, true));
+    EXPECT(cache.read("a", data));
+    EXPECT(data == floats(100, true));
+    EXPECT(not cache.read("b", data));
+
+    // A damaged entry is a miss
+    {
+        std::fstream f{cache.path_of("a").string(),
+                       std::ios::in | std::ios::out | std::ios::binary};
+        f.seekp(verify_cache::header_size + 5);
+        f.put('\x7f');
+    }
+    EXPECT(not cache.read("a", data));
+    cache.write("a", floats(100, true));
+    EXPECT(cache.read("a", data));
+}
+
+static void test_eviction()
+{
+    const miopen::TmpDir dir{"verify_cache"};
+    const auto entry = floats(1000, false);
+    const auto now   = std::time(nullptr);
+    std::string data;
+
+    // No room at all
+    verify_cache::store cache{dir.path, 0};
+    cache.write("a", entry);
+    EXPECT(not cache.read("a", data));
+
+    // Room for three entries
+    cache.max_size = 1024 * 1024;
+    cache.write("a", entry);
+    cache.max_size = 3 * boost::filesystem::file_size(cache.path_of("a")) + 1;
+
+    // Entries used in the order c, a, b
+    cache.write("b", entry);
+    cache.write("c", entry);
+    boost::filesystem::last_write_time(cache.path_of("c"), now - 30);
+    boost::filesystem::last_write_time(cache.path_of("a"), now - 20);
+    boost::filesystem::last_write_time(cache.path_of("b"), now - 10);
+
+    cache.write("d", entry);
+    EXPECT(not cache.read("c", data));
+    EXPECT(cache.read("a", data));
+    EXPECT(cache.read("b", data));
+    EXPECT(cache.read("d", data));
+}
+
+int main()
+{
+    test_compression();
+    test_store();
+    test_eviction();
+}
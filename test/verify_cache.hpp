@@ -0,0 +1,331 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2021 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#ifndef GUARD_MIOPEN_TEST_VERIFY_CACHE_HPP
+#define GUARD_MIOPEN_TEST_VERIFY_CACHE_HPP
+
+// Content addressed store for the cpu results of the tests, shared by all the
+// test binaries and by concurrent runs.
+//
+// An entry is named by the md5 of a key describing how the result is computed
+// and lives in <root>/<first two digits>/<digest>. It is written to a temporary
+// file renamed into place, so a reader finds either no entry or a complete one,
+// and its header holds the size and a checksum of the data so that anything
+// else reads as a miss. Reads map the file instead of streaming it. The
+// modification time of an entry is its last use: writes evict the least
+// recently used entries once the store is over its size limit. Scanning the
+// store is expensive, so a process only does it when its estimate of the size
+// crosses the limit and every trim_interval writes, to account for the entries
+// of the other processes.
+
+#include <miopen/md5.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace verify_cache {
+
+// Results are mostly arrays of 4 byte floats. Grouping their bytes by position
+// gathers the exponent bytes, and the low mantissa bytes that are zero for the
+// integer valued data of most tests, into runs of equal bytes.
+constexpr std::size_t shuffle_width = 4;
+constexpr std::size_t min_run       = 4;
+constexpr char magic[8]             = {'M', 'I', 'O', 'V', 'C', '0', '0', '1'};
+constexpr std::size_t header_size   = sizeof(magic) + 2 * sizeof(std::uint64_t);
+// Temporary files older than this are left over by a crashed writer.
+constexpr std::time_t stale_seconds = 3600;
+constexpr std::size_t trim_interval = 64;
+
+inline std::uint64_t checksum(const std::string& s)
+{
+    std::uint64_t h = 14695981039346656037ull;
+    for(auto c : s)
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+}
+
+inline std::string shuffle(const std::string& s, bool inverse)
+{
+    const auto n = s.size() / shuffle_width;
+    std::string out(s.size(), 0);
+    for(std::size_t b = 0; b < shuffle_width; ++b)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            if(inverse)
+                out[i * shuffle_width + b] = s[b * n + i];
+            else
+                out[b * n + i] = s[i * shuffle_width + b];
+        }
+    }
+    std::copy(s.begin() + n * shuffle_width, s.end(), out.begin() + n * shuffle_width);
+    return out;
+}
+
+inline void put_varint(std::string& out, std::uint64_t x)
+{
+    for(; x >= 0x80; x >>= 7)
+        out.push_back(static_cast<char>(x | 0x80));
+    out.push_back(static_cast<char>(x));
+}
+
+inline bool get_varint(const char*& p, const char* last, std::uint64_t& x)
+{
+    x = 0;
+    for(unsigned int shift = 0; p != last and shift < 64; shift += 7)
+    {
+        const auto b = static_cast<unsigned char>(*p++);
+        x |= std::uint64_t{b & 0x7fu} << shift;
+        if((b & 0x80u) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Sequence of <literal count> <literals> <repeat count> [<repeated byte>] on
+// the shuffled bytes.
+inline std::string compress(const std::string& raw)
+{
+    const auto s = shuffle(raw, false);
+    std::string out;
+    std::size_t literals = 0;
+    std::size_t i        = 0;
+    while(i < s.size())
+    {
+        auto j = i + 1;
+        while(j < s.size() and s[j] == s[i])
+            ++j;
+        if(j - i >= min_run)
+        {
+            put_varint(out, i - literals);
+            out.append(s, literals, i - literals);
+            put_varint(out, j - i);
+            out.push_back(s[i]);
+            literals = j;
+        }
+        i = j;
+    }
+    put_varint(out, s.size() - literals);
+    out.append(s, literals, s.size() - literals);
+    put_varint(out, 0);
+    return out;
+}
+
+// False when the data is not the compression of size bytes.
+inline bool decompress(const char* first, const char* last, std::size_t size, std::string& raw)
+{
+    std::string s;
+    s.reserve(size);
+    while(first != last)
+    {
+        std::uint64_t literals = 0;
+        std::uint64_t repeats  = 0;
+        if(not get_varint(first, last, literals) or literals > size - s.size() or
+           literals > static_cast<std::uint64_t>(last - first))
+            return false;
+        s.append(first, literals);
+        first += literals;
+        if(not get_varint(first, last, repeats) or repeats > size - s.size())
+            return false;
+        if(repeats > 0)
+        {
+            if(first == last)
+                return false;
+            s.append(repeats, *first++);
+        }
+    }
+    if(s.size() != size)
+        return false;
+    raw = shuffle(s, true);
+    return true;
+}
+
+inline void put_u64(std::string& out, std::uint64_t x)
+{
+    out.append(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+inline std::uint64_t get_u64(const char* p)
+{
+    std::uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+struct store
+{
+    boost::filesystem::path root;
+    std::uintmax_t max_size;
+
+    boost::filesystem::path path_of(const std::string& key) const
+    {
+        const auto digest = miopen::md5(key);
+        return root / digest.substr(0, 2) / digest;
+    }
+
+    bool read(const std::string& key, std::string& raw) const
+    {
+        namespace bip = boost::interprocess;
+        const auto p  = path_of(key);
+        boost::system::error_code ec;
+        if(not boost::filesystem::is_regular_file(p, ec))
+            return false;
+        try
+        {
+            const bip::file_mapping file(p.string().c_str(), bip::read_only);
+            const bip::mapped_region region(file, bip::read_only);
+            const auto* data = static_cast<const char*>(region.get_address());
+            const auto size  = region.get_size();
+            if(size < header_size or not std::equal(magic, magic + sizeof(magic), data))
+                return false;
+            const auto raw_size = get_u64(data + sizeof(magic));
+            const auto sum      = get_u64(data + sizeof(magic) + sizeof(std::uint64_t));
+            if(not decompress(data + header_size, data + size, raw_size, raw) or
+               checksum(raw) != sum)
+                return false;
+        }
+        catch(const bip::interprocess_exception&)
+        {
+            return false;
+        }
+        boost::filesystem::last_write_time(p, std::time(nullptr), ec);
+        return true;
+    }
+
+    void write(const std::string& key, const std::string& raw) const
+    {
+        const auto p = path_of(key);
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(p.parent_path(), ec);
+
+        std::string entry(magic, sizeof(magic));
+        put_u64(entry, raw.size());
+        put_u64(entry, checksum(raw));
+        entry += compress(raw);
+
+        const auto tmp = p.parent_path() / boost::filesystem::unique_path(
+                                               p.filename().string() + ".%%%%%%%%.tmp");
+        {
+            std::ofstream os{tmp.string(), std::ios::binary};
+            os.write(entry.data(), entry.size());
+            if(not os)
+            {
+                os.close();
+                boost::filesystem::remove(tmp, ec);
+                return;
+            }
+        }
+        // Replaces the entry of a concurrent writer of the same key, which holds
+        // the same result.
+        boost::filesystem::rename(tmp, p, ec);
+        if(ec)
+        {
+            boost::filesystem::remove(tmp, ec);
+            return;
+        }
+
+        // The stores of a root are short lived, the estimates are kept per process.
+        struct estimate
+        {
+            bool scanned        = false;
+            std::uintmax_t size = 0;
+            std::size_t writes  = 0;
+        };
+        static std::mutex mutex;
+        static std::map<std::string, estimate> estimates;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& e = estimates[root.string()];
+        e.size += entry.size();
+        if(++e.writes % trim_interval != 0 and e.scanned and e.size <= max_size)
+            return;
+        e.size    = trim();
+        e.scanned = true;
+    }
+
+    // Evicts the least recently used entries until the store fits in max_size and
+    // returns the size left. Files vanishing meanwhile are removed by another process
+    // doing the same.
+    std::uintmax_t trim() const
+    {
+        struct file
+        {
+            std::time_t time;
+            std::uintmax_t size;
+            boost::filesystem::path path;
+        };
+        std::vector<file> files;
+        std::uintmax_t total = 0;
+        const auto now       = std::time(nullptr);
+
+        boost::system::error_code ec;
+        boost::filesystem::recursive_directory_iterator it{root, ec};
+        for(const boost::filesystem::recursive_directory_iterator last; it != last and not ec;
+            it.increment(ec))
+        {
+            boost::system::error_code fec;
+            const auto& path = it->path();
+            if(not boost::filesystem::is_regular_file(path, fec))
+                continue;
+            const auto size = boost::filesystem::file_size(path, fec);
+            const auto time = boost::filesystem::last_write_time(path, fec);
+            if(fec)
+                continue;
+            total += size;
+            // Temporary files of running writers are not candidates.
+            if(path.extension() == ".tmp" and now - time < stale_seconds)
+                continue;
+            files.push_back({time, size, path});
+        }
+        if(total <= max_size)
+            return total;
+
+        std::sort(files.begin(), files.end(), [](const file& x, const file& y) {
+            return x.time < y.time;
+        });
+        for(const auto& f : files)
+        {
+            if(total <= max_size)
+                break;
+            boost::filesystem::remove(f.path, ec);
+            total -= f.size;
+        }
+        return total;
+    }
+};
+
+} // namespace verify_cache
+
+#endif // GUARD_MIOPEN_TEST_VERIFY_CACHE_HPP